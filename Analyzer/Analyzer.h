@@ -216,7 +216,8 @@ class ColumnVar : public Expr {
                                                col_info_->column_id,
                                                col_info_->name,
                                                ti,
-                                               col_info_->is_rowid);
+                                               col_info_->is_rowid,
+                                               col_info_->is_delete);
       type_info = ti;
     }
   }
@@ -15,16 +15,23 @@
 #include "ArrowStorage.h"
 #include "ArrowStorageUtils.h"
 
+#include "OSDependent/omnisci_fs.h"
 #include "Shared/ArrowUtil.h"
 #include "Shared/measure.h"
+#include "Shared/scope.h"
 #include "Shared/threading.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 
+#include <arrow/array/concatenate.h>
+#include <arrow/compute/api.h>
 #include <arrow/csv/reader.h>
 #include <arrow/io/api.h>
+#include <arrow/ipc/api.h>
 #include <arrow/json/reader.h>
+#include <arrow/util/bitmap_ops.h>
+#include <arrow/util/byte_size.h>
 #include <arrow/util/decimal.h>
 #include <arrow/util/value_parsing.h>
 #include <parquet/api/reader.h>
@@ -32,6 +39,18 @@
 
 #pragma GCC diagnostic pop
 
+#include <rapidjson/document.h>
+#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/writer.h>
+
+#include <condition_variable>
+#include <deque>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <future>
+
 using namespace std::string_literals;
 
 namespace {
@@ -39,6 +58,9 @@ namespace {
 size_t computeTotalStringsLength(std::shared_ptr<arrow::ChunkedArray> arr,
                                  size_t offset,
                                  size_t rows) {
+  if (!rows) {
+    return 0;
+  }
   size_t start_offset = offset;
   size_t chunk_no = 0;
   while (static_cast<size_t>(arr->chunk(chunk_no)->length()) <= start_offset) {
@@ -62,18 +84,656 @@ size_t computeTotalStringsLength(std::shared_ptr<arrow::ChunkedArray> arr,
   return total_bytes;
 }
 
+struct ArrowCsvOptions {
+  arrow::csv::ReadOptions read_options;
+  arrow::csv::ParseOptions parse_options;
+  arrow::csv::ConvertOptions convert_options;
+};
+
+ArrowCsvOptions getArrowCsvOptions(const ArrowStorage::CsvParseOptions& parse_options,
+                                   const ColumnInfoList& col_infos) {
+  ArrowCsvOptions res;
+
+  res.parse_options = arrow::csv::ParseOptions::Defaults();
+  res.parse_options.quoting = false;
+  res.parse_options.escaping = false;
+  res.parse_options.newlines_in_values = false;
+  res.parse_options.delimiter = parse_options.delimiter;
+
+  res.read_options = arrow::csv::ReadOptions::Defaults();
+  res.read_options.use_threads = true;
+  res.read_options.block_size = parse_options.block_size;
+  res.read_options.autogenerate_column_names = !parse_options.header && col_infos.empty();
+  res.read_options.skip_rows = parse_options.header && !col_infos.empty()
+                                   ? (parse_options.skip_rows + 1)
+                                   : parse_options.skip_rows;
+
+  res.convert_options = arrow::csv::ConvertOptions::Defaults();
+  res.convert_options.check_utf8 = false;
+  res.convert_options.include_columns = res.read_options.column_names;
+  res.convert_options.strings_can_be_null = true;
+
+  bool need_time_parser = false;
+  for (auto& col_info : col_infos) {
+    if (!col_info->is_rowid && !col_info->is_delete) {
+      res.read_options.column_names.push_back(col_info->name);
+      res.convert_options.column_types.emplace(col_info->name,
+                                               getArrowImportType(col_info->type));
+      if (col_info->type.get_type() == kTIME) {
+        need_time_parser = true;
+      }
+    }
+  }
+  // There is no built-in converter for TIME types in Arrow 5.0 CSV reader and
+  // therefore we add a parser to parse it as a custom datetime.
+  // We will be able to switch to buil-in converter starting from Arrow 6.0.
+  if (need_time_parser) {
+    res.convert_options.timestamp_parsers.push_back(
+        arrow::TimestampParser::MakeISO8601());
+    res.convert_options.timestamp_parsers.push_back(
+        arrow::TimestampParser::MakeStrptime("%H:%M:%S"));
+  }
+
+  return res;
+}
+
+// Queue between stages of a batched import. Producers block while the queue is
+// full, so every stage holds a bounded number of batches.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+  // Returns false when the queue was closed and the item is dropped.
+  bool push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+    items_.push_back(std::move(item));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  // Returns false when the queue is closed and all its items are consumed.
+  bool pop(T& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return false;
+    }
+    item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  // No more items are accepted, the queued ones are still consumed.
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+  // Close the queue and drop the queued items, used when any stage fails.
+  void cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    items_.clear();
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+ private:
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::deque<T> items_;
+  bool closed_ = false;
+};
+
+std::unique_ptr<parquet::arrow::FileReader> openParquetFile(
+    const std::string& file_name) {
+  auto file_result = arrow::io::ReadableFile::Open(file_name.c_str());
+  ARROW_THROW_NOT_OK(file_result.status());
+  auto inp = file_result.ValueOrDie();
+
+  auto parquet_reader = parquet::ParquetFileReader::Open(inp);
+
+  std::unique_ptr<parquet::arrow::FileReader> arrow_reader;
+  // Allow multithreding.
+  parquet::ArrowReaderProperties prop(true);
+  auto st = parquet::arrow::FileReader::Make(
+      arrow::default_memory_pool(), std::move(parquet_reader), prop, &arrow_reader);
+  if (!st.ok()) {
+    throw std::runtime_error(st.ToString());
+  }
+
+  return arrow_reader;
+}
+
+constexpr int kPersistedTableVersion = 1;
+constexpr const char* kPersistedTableMetaFile = "table.json";
+
+// Each persistTable call writes files of a new generation. Files of the previous
+// generation stay in place until the metadata referencing new files is written.
+std::string getFilePrefix(const char* kind, int generation) {
+  return kind + "_"s + std::to_string(generation) + "_";
+}
+
+std::filesystem::path getFragmentFilePath(const std::filesystem::path& dir,
+                                          int generation,
+                                          size_t frag_idx) {
+  return dir / (getFilePrefix("fragment", generation) + std::to_string(frag_idx) +
+                ".arrow");
+}
+
+std::filesystem::path getDictFilePath(const std::filesystem::path& dir,
+                                      int generation,
+                                      int dict_id) {
+  return dir /
+         (getFilePrefix("dict", generation) + std::to_string(dict_id) + ".arrow");
+}
+
+// Flushes a written file or a directory entry to disk.
+void syncPath(const std::filesystem::path& path) {
+  int fd = omnisci::open(path.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open "s + path.string());
+  }
+  int res = omnisci::fsync(fd);
+  omnisci::close(fd);
+  if (res) {
+    throw std::runtime_error("Cannot flush "s + path.string() + " to disk");
+  }
+}
+
+// The file is written to a temporary path and renamed when it is flushed to disk.
+// The directory itself is flushed along with the metadata file.
+void writeIpcFile(const std::filesystem::path& file_path,
+                  std::shared_ptr<arrow::RecordBatch> batch) {
+  auto tmp_path = file_path;
+  tmp_path += ".tmp";
+  auto file_result = arrow::io::FileOutputStream::Open(tmp_path.string());
+  ARROW_THROW_NOT_OK(file_result.status());
+  auto file = file_result.ValueOrDie();
+  auto writer_result = arrow::ipc::MakeFileWriter(file, batch->schema());
+  ARROW_THROW_NOT_OK(writer_result.status());
+  auto writer = writer_result.ValueOrDie();
+  ARROW_THROW_NOT_OK(writer->WriteRecordBatch(*batch));
+  ARROW_THROW_NOT_OK(writer->Close());
+  ARROW_THROW_NOT_OK(file->Close());
+  syncPath(tmp_path);
+  std::filesystem::rename(tmp_path, file_path);
+}
+
+// Writes the document to a temporary file which replaces the target file only
+// when it is completely written and flushed to disk.
+void writeJsonFileAtomically(const std::filesystem::path& file_path,
+                             const rapidjson::Document& doc) {
+  auto tmp_path = file_path;
+  tmp_path += ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::trunc);
+    rapidjson::OStreamWrapper stream(file);
+    rapidjson::Writer<rapidjson::OStreamWrapper,
+                      rapidjson::UTF8<>,
+                      rapidjson::UTF8<>,
+                      rapidjson::CrtAllocator,
+                      rapidjson::kWriteNanAndInfFlag>
+        writer(stream);
+    doc.Accept(writer);
+    file.flush();
+    if (!file) {
+      throw std::runtime_error("Cannot write "s + tmp_path.string());
+    }
+  }
+  syncPath(tmp_path);
+  std::filesystem::rename(tmp_path, file_path);
+  syncPath(file_path.parent_path());
+}
+
+// Returns the generation of a table persisted to the directory or zero if there
+// is no readable table metadata.
+int getPersistedGeneration(const std::filesystem::path& dir) {
+  std::ifstream meta_file(dir / kPersistedTableMetaFile);
+  if (!meta_file) {
+    return 0;
+  }
+  rapidjson::IStreamWrapper meta_stream(meta_file);
+  rapidjson::Document doc;
+  doc.ParseStream<rapidjson::kParseNanAndInfFlag>(meta_stream);
+  if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("generation") ||
+      !doc["generation"].IsInt()) {
+    return 0;
+  }
+  return doc["generation"].GetInt();
+}
+
+// Removes data files of other generations and leftovers of interrupted writes.
+// Files are unlinked rather than overwritten, tables loaded from them keep their
+// memory mappings valid.
+void removeStalePersistedFiles(const std::filesystem::path& dir, int generation) {
+  auto frag_prefix = getFilePrefix("fragment", generation);
+  auto dict_prefix = getFilePrefix("dict", generation);
+  for (auto& entry : std::filesystem::directory_iterator(dir)) {
+    auto file_name = entry.path().filename().string();
+    auto ext = entry.path().extension().string();
+    if (ext == ".tmp" ||
+        (ext == ".arrow" && file_name.rfind(frag_prefix, 0) != 0 &&
+         file_name.rfind(dict_prefix, 0) != 0 &&
+         (file_name.rfind("fragment_", 0) == 0 || file_name.rfind("dict_", 0) == 0))) {
+      std::filesystem::remove(entry.path());
+    }
+  }
+}
+
+// Buffers of the returned batch reference the mapped file and keep it alive.
+// Buffer sizes are validated, so that a truncated or corrupted file is reported
+// instead of being read out of bounds.
+std::shared_ptr<arrow::RecordBatch> readIpcFile(const std::filesystem::path& file_path) {
+  auto check_status = [&file_path](const arrow::Status& status) {
+    if (!status.ok()) {
+      throw std::runtime_error("Cannot read "s + file_path.string() + ": " +
+                               status.ToString());
+    }
+  };
+  auto file_result =
+      arrow::io::MemoryMappedFile::Open(file_path.string(), arrow::io::FileMode::READ);
+  check_status(file_result.status());
+  auto reader_result = arrow::ipc::RecordBatchFileReader::Open(file_result.ValueOrDie());
+  check_status(reader_result.status());
+  auto reader = reader_result.ValueOrDie();
+  if (reader->num_record_batches() != 1) {
+    throw std::runtime_error("Unexpected number of record batches in "s +
+                             file_path.string());
+  }
+  auto batch_result = reader->ReadRecordBatch(0);
+  check_status(batch_result.status());
+  auto batch = batch_result.ValueOrDie();
+  check_status(batch->Validate());
+  return batch;
+}
+
+std::shared_ptr<arrow::Array> concatenateChunks(
+    std::shared_ptr<arrow::ChunkedArray> arr) {
+  if (arr->num_chunks() == 1) {
+    return arr->chunk(0);
+  }
+  if (arr->num_chunks() == 0) {
+    auto res = arrow::MakeEmptyArray(arr->type());
+    ARROW_THROW_NOT_OK(res.status());
+    return res.ValueOrDie();
+  }
+  auto res = arrow::Concatenate(arr->chunks());
+  ARROW_THROW_NOT_OK(res.status());
+  return res.ValueOrDie();
+}
+
+size_t getArrowElemSize(const arrow::DataType& type) {
+  const auto* fixed_type = dynamic_cast<const arrow::FixedWidthType*>(&type);
+  CHECK(fixed_type);
+  return fixed_type->bit_width() / 8;
+}
+
+// Varlen arrays use byte offsets and mark nulls with negative offsets. Such
+// arrays cannot be handled by IPC writer and are stored as regular list arrays.
+std::shared_ptr<arrow::Array> toPersistedVarLenArray(
+    std::shared_ptr<arrow::ChunkedArray> arr) {
+  auto list_type = std::dynamic_pointer_cast<arrow::ListType>(arr->type());
+  CHECK(list_type);
+  int32_t elem_size = static_cast<int32_t>(getArrowElemSize(*list_type->value_type()));
+  int64_t rows = arr->length();
+
+  auto offsets_buf = arrow::AllocateBuffer((rows + 1) * sizeof(int32_t)).ValueOrDie();
+  auto offsets_ptr = reinterpret_cast<int32_t*>(offsets_buf->mutable_data());
+  auto bitmap_buf = arrow::AllocateBuffer((rows + 7) / 8).ValueOrDie();
+  auto bitmap_ptr = bitmap_buf->mutable_data();
+  std::fill(bitmap_ptr, bitmap_ptr + bitmap_buf->size(), 0);
+
+  auto value_type = list_type->value_type();
+  arrow::ArrayVector values;
+  int64_t null_count = 0;
+  int64_t row = 0;
+  offsets_ptr[0] = 0;
+  for (auto& chunk : arr->chunks()) {
+    auto chunk_list = std::dynamic_pointer_cast<arrow::ListArray>(chunk);
+    CHECK(chunk_list);
+    const int32_t* offsets = chunk->data()->GetValues<int32_t>(1);
+    for (int64_t i = 0; i < chunk->length(); ++i, ++row) {
+      int32_t elems = (std::abs(offsets[i + 1]) - std::abs(offsets[i])) / elem_size;
+      offsets_ptr[row + 1] = offsets_ptr[row] + elems;
+      if (offsets[i + 1] < 0) {
+        ++null_count;
+      } else {
+        bitmap_ptr[row / 8] |= static_cast<uint8_t>(1 << (row % 8));
+      }
+    }
+    int32_t start = std::abs(offsets[0]) / elem_size;
+    int32_t end = std::abs(offsets[chunk->length()]) / elem_size;
+    values.push_back(chunk_list->values()->Slice(start, end - start));
+  }
+
+  auto values_arr =
+      concatenateChunks(std::make_shared<arrow::ChunkedArray>(values, value_type));
+  return std::make_shared<arrow::ListArray>(list_type,
+                                            rows,
+                                            std::move(offsets_buf),
+                                            values_arr,
+                                            std::move(bitmap_buf),
+                                            null_count);
+}
+
+// Returns null for arrays not written by toPersistedVarLenArray.
+std::shared_ptr<arrow::Array> fromPersistedVarLenArray(
+    std::shared_ptr<arrow::Array> arr) {
+  auto list_arr = std::dynamic_pointer_cast<arrow::ListArray>(arr);
+  if (!list_arr ||
+      !dynamic_cast<const arrow::FixedWidthType*>(list_arr->value_type().get())) {
+    return nullptr;
+  }
+  int32_t elem_size = static_cast<int32_t>(getArrowElemSize(*list_arr->value_type()));
+  int64_t rows = list_arr->length();
+
+  auto offsets_buf = arrow::AllocateBuffer((rows + 1) * sizeof(int32_t)).ValueOrDie();
+  auto offsets_ptr = reinterpret_cast<int32_t*>(offsets_buf->mutable_data());
+  const int32_t* offsets = list_arr->raw_value_offsets();
+  offsets_ptr[0] = offsets[0] * elem_size;
+  for (int64_t i = 0; i < rows; ++i) {
+    offsets_ptr[i + 1] =
+        list_arr->IsNull(i) ? -offsets[i + 1] * elem_size : offsets[i + 1] * elem_size;
+  }
+
+  return std::make_shared<arrow::ListArray>(
+      list_arr->type(), rows, std::move(offsets_buf), list_arr->values());
+}
+
+// Persisted arrays have an element per row for all column types. Fixed length
+// arrays are stored as flat arrays of elements in memory and therefore are
+// wrapped into fixed size lists.
+std::shared_ptr<arrow::Array> toPersistedArray(std::shared_ptr<arrow::ChunkedArray> arr,
+                                               const SQLTypeInfo& type,
+                                               size_t rows) {
+  if (type.is_fixlen_array()) {
+    auto values = concatenateChunks(arr);
+    auto elems = static_cast<int32_t>(values->length() / rows);
+    return std::make_shared<arrow::FixedSizeListArray>(
+        arrow::fixed_size_list(values->type(), elems), rows, values);
+  }
+  if (type.is_varlen_array()) {
+    return toPersistedVarLenArray(arr);
+  }
+  return concatenateChunks(arr);
+}
+
+// Returns null if the array doesn't match the column type.
+std::shared_ptr<arrow::Array> fromPersistedArray(std::shared_ptr<arrow::Array> arr,
+                                                 const SQLTypeInfo& type) {
+  if (type.is_fixlen_array()) {
+    auto list_arr = std::dynamic_pointer_cast<arrow::FixedSizeListArray>(arr);
+    return list_arr ? list_arr->values() : nullptr;
+  }
+  if (type.is_varlen_array()) {
+    return fromPersistedVarLenArray(arr);
+  }
+  return arr;
+}
+
+rapidjson::Value typeToJson(const SQLTypeInfo& type,
+                            rapidjson::Document::AllocatorType& alloc) {
+  rapidjson::Value res(rapidjson::kObjectType);
+  res.AddMember("type", static_cast<int>(type.get_type()), alloc);
+  res.AddMember("subtype", static_cast<int>(type.get_subtype()), alloc);
+  res.AddMember("dimension", type.get_dimension(), alloc);
+  res.AddMember("scale", type.get_scale(), alloc);
+  res.AddMember("notnull", type.get_notnull(), alloc);
+  res.AddMember("compression", static_cast<int>(type.get_compression()), alloc);
+  res.AddMember("comp_param", type.get_comp_param(), alloc);
+  res.AddMember("size", type.get_size(), alloc);
+  return res;
+}
+
+SQLTypeInfo jsonToType(const rapidjson::Value& val) {
+  SQLTypeInfo res(static_cast<SQLTypes>(val["type"].GetInt()),
+                  val["dimension"].GetInt(),
+                  val["scale"].GetInt(),
+                  val["notnull"].GetBool(),
+                  static_cast<EncodingType>(val["compression"].GetInt()),
+                  val["comp_param"].GetInt(),
+                  static_cast<SQLTypes>(val["subtype"].GetInt()));
+  res.set_size(val["size"].GetInt());
+  return res;
+}
+
+// Checks the structure of persisted table metadata, so that it can be read with
+// no further checks. Chunk stats are checked when converted to datums.
+void checkPersistedTableMeta(const rapidjson::Document& doc,
+                             const std::filesystem::path& file_path) {
+  auto check = [&file_path](bool cond) {
+    if (!cond) {
+      throw std::runtime_error("Malformed table metadata in "s + file_path.string());
+    }
+  };
+  auto is_int = [](const rapidjson::Value& obj, const char* name) {
+    return obj.HasMember(name) && obj[name].IsInt();
+  };
+  auto is_uint64 = [](const rapidjson::Value& obj, const char* name) {
+    return obj.HasMember(name) && obj[name].IsUint64();
+  };
+  auto is_array = [](const rapidjson::Value& obj, const char* name) {
+    return obj.HasMember(name) && obj[name].IsArray();
+  };
+
+  check(!doc.HasParseError() && doc.IsObject() && is_int(doc, "version"));
+  check(doc["version"].GetInt() == kPersistedTableVersion);
+  check(is_int(doc, "generation") && is_uint64(doc, "fragment_size") &&
+        doc["fragment_size"].GetUint64() > 0 && is_array(doc, "columns") &&
+        is_array(doc, "fragments"));
+  for (auto& column : doc["columns"].GetArray()) {
+    check(column.IsObject() && column.HasMember("name") && column["name"].IsString() &&
+          column.HasMember("type") && column["type"].IsObject());
+    auto& type = column["type"];
+    for (auto name :
+         {"type", "subtype", "dimension", "scale", "compression", "comp_param", "size"}) {
+      check(is_int(type, name));
+    }
+    check(type.HasMember("notnull") && type["notnull"].IsBool());
+  }
+  for (auto& frag_meta : doc["fragments"].GetArray()) {
+    check(frag_meta.IsObject() && is_uint64(frag_meta, "row_count") &&
+          is_array(frag_meta, "chunks") &&
+          frag_meta["chunks"].Size() == doc["columns"].Size());
+    for (auto& chunk_meta : frag_meta["chunks"].GetArray()) {
+      check(chunk_meta.IsObject() && is_uint64(chunk_meta, "num_bytes") &&
+            is_uint64(chunk_meta, "num_elements") && chunk_meta.HasMember("has_nulls") &&
+            chunk_meta["has_nulls"].IsBool() && chunk_meta.HasMember("min") &&
+            chunk_meta.HasMember("max"));
+    }
+  }
+}
+
+// Datum fields used for stats follow mergeStats.
+rapidjson::Value datumToJson(const Datum& datum, const SQLTypeInfo& type) {
+  switch (type.is_array() ? type.get_subtype() : type.get_type()) {
+    case kBOOLEAN:
+    case kTINYINT:
+      return rapidjson::Value(static_cast<int64_t>(datum.tinyintval));
+    case kSMALLINT:
+      return rapidjson::Value(static_cast<int64_t>(datum.smallintval));
+    case kINT:
+      return rapidjson::Value(static_cast<int64_t>(datum.intval));
+    case kBIGINT:
+    case kNUMERIC:
+    case kDECIMAL:
+    case kTIME:
+    case kTIMESTAMP:
+    case kDATE:
+      return rapidjson::Value(static_cast<int64_t>(datum.bigintval));
+    case kFLOAT:
+      return rapidjson::Value(static_cast<double>(datum.floatval));
+    case kDOUBLE:
+      return rapidjson::Value(datum.doubleval);
+    case kVARCHAR:
+    case kCHAR:
+    case kTEXT:
+      if (type.get_compression() == kENCODING_DICT) {
+        return rapidjson::Value(static_cast<int64_t>(datum.intval));
+      }
+      // No stats are collected for none-encoded strings.
+      return rapidjson::Value(rapidjson::kNullType);
+    default:
+      break;
+  }
+  throw std::runtime_error("Cannot persist chunk stats of type "s + type.toString());
+}
+
+Datum jsonToDatum(const rapidjson::Value& val, const SQLTypeInfo& type) {
+  auto get_int = [&]() {
+    if (!val.IsInt64()) {
+      throw std::runtime_error("Unexpected chunk stats of type "s + type.toString());
+    }
+    return val.GetInt64();
+  };
+  auto get_double = [&]() {
+    if (!val.IsNumber()) {
+      throw std::runtime_error("Unexpected chunk stats of type "s + type.toString());
+    }
+    return val.GetDouble();
+  };
+  Datum res;
+  res.bigintval = 0;
+  switch (type.is_array() ? type.get_subtype() : type.get_type()) {
+    case kBOOLEAN:
+    case kTINYINT:
+      res.tinyintval = static_cast<int8_t>(get_int());
+      break;
+    case kSMALLINT:
+      res.smallintval = static_cast<int16_t>(get_int());
+      break;
+    case kINT:
+      res.intval = static_cast<int32_t>(get_int());
+      break;
+    case kBIGINT:
+    case kNUMERIC:
+    case kDECIMAL:
+    case kTIME:
+    case kTIMESTAMP:
+    case kDATE:
+      res.bigintval = get_int();
+      break;
+    case kFLOAT:
+      res.floatval = static_cast<float>(get_double());
+      break;
+    case kDOUBLE:
+      res.doubleval = get_double();
+      break;
+    case kVARCHAR:
+    case kCHAR:
+    case kTEXT:
+      if (type.get_compression() == kENCODING_DICT) {
+        res.intval = static_cast<int32_t>(get_int());
+      } else if (!val.IsNull()) {
+        throw std::runtime_error("Unexpected chunk stats of type "s + type.toString());
+      }
+      break;
+    default:
+      throw std::runtime_error("Cannot load chunk stats of type "s + type.toString());
+  }
+  return res;
+}
+
+// Makes an array with offsets starting at zero out of a slice of a varlen array,
+// so that its offsets can be fetched without a copy. Only the offsets and the
+// validity bitmap are copied, values are shared with the source array.
+std::shared_ptr<arrow::Array> rebase_varlen_offsets(std::shared_ptr<arrow::Array> arr) {
+  const auto& data = arr->data();
+  const int64_t length = arr->length();
+  const int32_t* offsets = data->GetValues<int32_t>(1);
+  // Negative offsets are used to mark null arrays.
+  const int32_t base = std::abs(offsets[0]);
+  if (!base) {
+    return arr;
+  }
+  auto offsets_res = arrow::AllocateBuffer((length + 1) * sizeof(int32_t));
+  ARROW_THROW_NOT_OK(offsets_res.status());
+  std::shared_ptr<arrow::Buffer> offsets_buf = std::move(offsets_res).ValueOrDie();
+  auto rebased = reinterpret_cast<int32_t*>(offsets_buf->mutable_data());
+  rebased[0] = 0;
+  for (int64_t i = 1; i <= length; ++i) {
+    if (offsets[i] == -base) {
+      // Null mark of an array starting at the fragment start cannot be rebased.
+      return arr;
+    }
+    rebased[i] = offsets[i] < 0 ? offsets[i] + base : offsets[i] - base;
+  }
+  const int32_t values_size = std::abs(offsets[length]) - base;
+
+  std::shared_ptr<arrow::Buffer> validity;
+  int64_t null_count = 0;
+  if (data->buffers[0] && data->null_count != 0) {
+    auto validity_res = arrow::internal::CopyBitmap(
+        arrow::default_memory_pool(), data->buffers[0]->data(), data->offset, length);
+    ARROW_THROW_NOT_OK(validity_res.status());
+    validity = std::move(validity_res).ValueOrDie();
+    null_count = data->null_count;
+  }
+
+  if (arr->type_id() == arrow::Type::LIST) {
+    // List offsets are in bytes.
+    auto values = arrow::MakeArray(data->child_data[0]);
+    const auto* elem_type =
+        dynamic_cast<const arrow::FixedWidthType*>(values->type().get());
+    CHECK(elem_type);
+    const int32_t elem_size = elem_type->bit_width() / 8;
+    values = values->Slice(base / elem_size, values_size / elem_size);
+    return arrow::MakeArray(arrow::ArrayData::Make(arr->type(),
+                                                   length,
+                                                   {validity, offsets_buf},
+                                                   {values->data()},
+                                                   null_count,
+                                                   0));
+  }
+  CHECK_EQ(arr->type_id(), arrow::Type::STRING);
+  return arrow::MakeArray(arrow::ArrayData::Make(
+      arr->type(),
+      length,
+      {validity, offsets_buf, arrow::SliceBuffer(data->buffers[2], base, values_size)},
+      null_count,
+      0));
+}
+
 }  // anonymous namespace
 
+ArrowStorage::~ArrowStorage() {
+  // Background compactions use storage's schema and dictionaries.
+  for (auto& pr : *tables_) {
+    if (pr.second->compaction.valid()) {
+      pr.second->compaction.wait();
+    }
+  }
+}
+
 void ArrowStorage::fetchBuffer(const ChunkKey& key,
                                Data_Namespace::AbstractBuffer* dest,
                                const size_t num_bytes) {
   CHECK_EQ(key[CHUNK_KEY_DB_IDX], db_id_);
-  CHECK_EQ(tables_.count(key[CHUNK_KEY_TABLE_IDX]), (size_t)1);
-  auto& table = *tables_.at(key[CHUNK_KEY_TABLE_IDX]);
+  auto vtable = getTable(key[CHUNK_KEY_TABLE_IDX]);
+  CHECK(vtable);
+  auto [data, frag_idx] =
+      getFragment(*vtable, key[CHUNK_KEY_TABLE_IDX], key[CHUNK_KEY_FRAGMENT_IDX]);
+  auto& table = *data;
 
   size_t col_idx = static_cast<size_t>(key[CHUNK_KEY_COLUMN_IDX] - 1);
-  size_t frag_idx = static_cast<size_t>(key[CHUNK_KEY_FRAGMENT_IDX] - 1);
-  CHECK_LT(frag_idx, table.fragments.size());
+  if (key[CHUNK_KEY_COLUMN_IDX] == table.delete_col_id) {
+    CHECK_EQ(key.size(), (size_t)4);
+    dest->reserve(num_bytes);
+    fetchDeleteFlags(table.fragments[frag_idx], dest, num_bytes);
+    dest->setSize(num_bytes);
+    return;
+  }
   CHECK_LT(col_idx, table.col_data.size());
 
   auto col_type =
@@ -114,22 +774,43 @@ std::unique_ptr<AbstractDataToken> ArrowStorage::getZeroCopyBufferMemory(
     const ChunkKey& key,
     size_t num_bytes) {
   CHECK_EQ(key[CHUNK_KEY_DB_IDX], db_id_);
-  CHECK_EQ(tables_.count(key[CHUNK_KEY_TABLE_IDX]), (size_t)1);
+  auto vtable = getTable(key[CHUNK_KEY_TABLE_IDX]);
+  CHECK(vtable);
 
   auto col_type =
       getColumnInfo(
           key[CHUNK_KEY_DB_IDX], key[CHUNK_KEY_TABLE_IDX], key[CHUNK_KEY_COLUMN_IDX])
           ->type;
 
-  if (!col_type.is_varlen_indeed()) {
-    auto& table = *tables_.at(key[CHUNK_KEY_TABLE_IDX]);
+  // Tokens keep referenced Arrow arrays alive, so the data version is not
+  // required after the call.
+  auto [data, frag_idx] =
+      getFragment(*vtable, key[CHUNK_KEY_TABLE_IDX], key[CHUNK_KEY_FRAGMENT_IDX]);
+  auto& table = *data;
+  size_t col_idx = static_cast<size_t>(key[CHUNK_KEY_COLUMN_IDX] - 1);
+  // Delete flags are expanded from the bitmap into a pool buffer.
+  if (key[CHUNK_KEY_COLUMN_IDX] == table.delete_col_id) {
+    return nullptr;
+  }
 
-    size_t col_idx = static_cast<size_t>(key[CHUNK_KEY_COLUMN_IDX] - 1);
-    size_t frag_idx = static_cast<size_t>(key[CHUNK_KEY_FRAGMENT_IDX] - 1);
+  if (!col_type.is_varlen_indeed()) {
     CHECK_EQ(key.size(), (size_t)4);
     size_t elem_size = col_type.get_size();
     auto& frag = table.fragments[frag_idx];
     size_t rows_to_fetch = num_bytes ? num_bytes / elem_size : frag.row_count;
+    // Compressed data is decoded once and shared by all tokens referencing it.
+    if (auto compressed = frag.getCompressed(col_idx)) {
+      CHECK_EQ(compressed->elem_size, elem_size);
+      auto decoded = getDecodedChunk(*compressed);
+      auto chunk = arrow::MakeArray(
+          arrow::ArrayData::Make(table.col_data[col_idx]->type(),
+                                 static_cast<int64_t>(compressed->num_elems),
+                                 {nullptr, decoded},
+                                 0));
+      const int8_t* ptr = reinterpret_cast<const int8_t*>(decoded->data());
+      size_t chunk_size = std::min(rows_to_fetch, compressed->num_elems) * elem_size;
+      return std::make_unique<ArrowChunkDataToken>(std::move(chunk), ptr, chunk_size);
+    }
     const auto* fixed_type =
         dynamic_cast<const arrow::FixedWidthType*>(table.col_data[col_idx]->type().get());
     CHECK(fixed_type);
@@ -148,11 +829,62 @@ std::unique_ptr<AbstractDataToken> ArrowStorage::getZeroCopyBufferMemory(
       size_t chunk_size = chunk->length() * arrow_elem_size;
       return std::make_unique<ArrowChunkDataToken>(std::move(chunk), ptr, chunk_size);
     }
+  } else {
+    CHECK_EQ(key.size(), (size_t)5);
+    return getZeroCopyVarLenBufferMemory(
+        table, frag_idx, col_idx, col_type, key[CHUNK_KEY_VARLEN_IDX] == 2);
   }
 
   return nullptr;
 }
 
+std::unique_ptr<AbstractDataToken> ArrowStorage::getZeroCopyVarLenBufferMemory(
+    const TableData& table,
+    size_t frag_idx,
+    size_t col_idx,
+    const SQLTypeInfo& col_type,
+    bool is_index_buffer) const {
+  auto& frag = table.fragments[frag_idx];
+  CHECK(!frag.getCompressed(col_idx));
+  auto data_to_fetch = table.col_data[col_idx]->Slice(
+      static_cast<int64_t>(frag.offset), static_cast<int64_t>(frag.row_count));
+  // Fragments spanning multiple chunks have to be copied to a contiguous buffer.
+  if (data_to_fetch->num_chunks() != 1) {
+    return nullptr;
+  }
+
+  auto chunk = data_to_fetch->chunk(0);
+  // Negative offsets are used to mark null arrays.
+  const int32_t* offsets = chunk->data()->GetValues<int32_t>(1);
+  if (is_index_buffer) {
+    // Offsets can be used as is only when they don't need to be rebased,
+    // i.e. when the fragment starts at the beginning of the chunk's data.
+    if (offsets[0] != 0) {
+      return nullptr;
+    }
+    const int8_t* ptr = reinterpret_cast<const int8_t*>(offsets);
+    size_t size = (frag.row_count + 1) * sizeof(uint32_t);
+    return std::make_unique<ArrowChunkDataToken>(std::move(chunk), ptr, size);
+  }
+
+  size_t start_offset = std::abs(offsets[0]);
+  size_t size = std::abs(offsets[frag.row_count]) - start_offset;
+  if (!size) {
+    return nullptr;
+  }
+
+  const int8_t* ptr;
+  if (col_type.is_string()) {
+    ptr = chunk->data()->GetValues<int8_t>(2, start_offset);
+  } else {
+    CHECK(col_type.is_varlen_array());
+    auto chunk_list = std::dynamic_pointer_cast<arrow::ListArray>(chunk);
+    CHECK(chunk_list);
+    ptr = chunk_list->values()->data()->GetValues<int8_t>(1, start_offset);
+  }
+  return std::make_unique<ArrowChunkDataToken>(std::move(chunk), ptr, size, col_type);
+}
+
 void ArrowStorage::fetchFixedLenData(const TableData& table,
                                      size_t frag_idx,
                                      size_t col_idx,
@@ -161,6 +893,21 @@ void ArrowStorage::fetchFixedLenData(const TableData& table,
                                      size_t elem_size) const {
   auto& frag = table.fragments[frag_idx];
   size_t rows_to_fetch = num_bytes ? num_bytes / elem_size : frag.row_count;
+  if (auto compressed = frag.getCompressed(col_idx)) {
+    // Reuse data decoded for zero-copy fetches when it is still alive.
+    std::shared_ptr<arrow::Buffer> decoded;
+    {
+      std::lock_guard<std::mutex> lock(compressed->decoded_mutex);
+      decoded = compressed->decoded.lock();
+    }
+    if (decoded) {
+      CHECK_LE(rows_to_fetch, compressed->num_elems);
+      memcpy(dest->getMemoryPtr(), decoded->data(), rows_to_fetch * elem_size);
+    } else {
+      decompressChunk(*compressed, rows_to_fetch, dest->getMemoryPtr());
+    }
+    return;
+  }
   const auto* fixed_type =
       dynamic_cast<const arrow::FixedWidthType*>(table.col_data[col_idx]->type().get());
   CHECK(fixed_type);
@@ -182,12 +929,25 @@ void ArrowStorage::fetchFixedLenData(const TableData& table,
   }
 }
 
+void ArrowStorage::fetchDeleteFlags(const DataFragment& frag,
+                                    Data_Namespace::AbstractBuffer* dest,
+                                    size_t num_bytes) const {
+  size_t rows_to_fetch = num_bytes ? num_bytes : frag.row_count;
+  int8_t* dst_ptr = dest->getMemoryPtr();
+  size_t bitmap_rows = std::min(rows_to_fetch, frag.deleted.size() * 64);
+  for (size_t i = 0; i < bitmap_rows; ++i) {
+    dst_ptr[i] = static_cast<int8_t>((frag.deleted[i >> 6] >> (i & 63)) & 1);
+  }
+  std::fill(dst_ptr + bitmap_rows, dst_ptr + rows_to_fetch, 0);
+}
+
 void ArrowStorage::fetchVarLenOffsets(const TableData& table,
                                       size_t frag_idx,
                                       size_t col_idx,
                                       Data_Namespace::AbstractBuffer* dest,
                                       size_t num_bytes) const {
   auto& frag = table.fragments[frag_idx];
+  CHECK(!frag.getCompressed(col_idx));
   CHECK_EQ(num_bytes, (frag.row_count + 1) * sizeof(uint32_t));
   // Number of fetched offsets is 1 greater than number of fetched rows.
   size_t rows_to_fetch = num_bytes ? num_bytes / sizeof(uint32_t) - 1 : frag.row_count;
@@ -213,6 +973,7 @@ void ArrowStorage::fetchVarLenData(const TableData& table,
                                    Data_Namespace::AbstractBuffer* dest,
                                    size_t num_bytes) const {
   auto& frag = table.fragments[frag_idx];
+  CHECK(!frag.getCompressed(col_idx));
   auto data_to_fetch =
       table.col_data[col_idx]->Slice(static_cast<int64_t>(frag.offset), frag.row_count);
   int8_t* dst_ptr = dest->getMemoryPtr();
@@ -238,6 +999,7 @@ void ArrowStorage::fetchVarLenArrayData(const TableData& table,
                                         size_t elem_size,
                                         size_t num_bytes) const {
   auto& frag = table.fragments[frag_idx];
+  CHECK(!frag.getCompressed(col_idx));
   auto data_to_fetch =
       table.col_data[col_idx]->Slice(static_cast<int64_t>(frag.offset), frag.row_count);
   int8_t* dst_ptr = dest->getMemoryPtr();
@@ -260,8 +1022,10 @@ void ArrowStorage::fetchVarLenArrayData(const TableData& table,
 
 TableFragmentsInfo ArrowStorage::getTableMetadata(int db_id, int table_id) const {
   CHECK_EQ(db_id, db_id_);
-  CHECK_EQ(tables_.count(table_id), (size_t)1);
-  auto& table = *tables_.at(table_id);
+  auto vtable = getTable(table_id);
+  CHECK(vtable);
+  auto data = vtable->getData();
+  auto& table = *data;
 
   if (table.fragments.empty()) {
     return getEmptyTableMetadata(table_id);
@@ -272,14 +1036,22 @@ TableFragmentsInfo ArrowStorage::getTableMetadata(int db_id, int table_id) const
   for (size_t frag_idx = 0; frag_idx < table.fragments.size(); ++frag_idx) {
     auto& frag = table.fragments[frag_idx];
     auto& frag_info = res.fragments.emplace_back();
-    frag_info.fragmentId = static_cast<int>(frag_idx + 1);
+    frag_info.fragmentId = frag.id;
     frag_info.physicalTableId = table_id;
     frag_info.setPhysicalNumTuples(frag.row_count);
     frag_info.deviceIds.push_back(0);  // Data_Namespace::DISK_LEVEL
     frag_info.deviceIds.push_back(0);  // Data_Namespace::CPU_LEVEL
     frag_info.deviceIds.push_back(0);  // Data_Namespace::GPU_LEVEL
+    // Metadata shares ownership of the data version, so its fragments stay
+    // readable by the query after compaction retires their ids.
     for (size_t col_idx = 0; col_idx < frag.metadata.size(); ++col_idx) {
-      frag_info.setChunkMetadata(static_cast<int>(col_idx + 1), frag.metadata[col_idx]);
+      frag_info.setChunkMetadata(
+          static_cast<int>(col_idx + 1),
+          std::shared_ptr<ChunkMetadata>(data, frag.metadata[col_idx].get()));
+    }
+    // Delete column is reported only when there are rows to filter out.
+    if (table.deleted_count) {
+      frag_info.setChunkMetadata(table.delete_col_id, getDeleteColumnMetadata(frag));
     }
   }
   return res;
@@ -365,13 +1137,20 @@ TableInfoPtr ArrowStorage::createTable(const std::string& table_name,
   }
   auto schema = arrow::schema(fields);
 
+  auto data = std::make_shared<TableData>();
+  data->fragment_size = options.fragment_size;
+  data->compression = options.compression;
+  data->compaction_threshold = options.compaction_threshold;
+  data->schema = schema;
+  auto vtable = std::make_shared<VersionedTable>();
+  vtable->setData(std::move(data));
+
   {
     mapd_unique_lock<mapd_shared_mutex> lock(data_mutex_);
-    auto [iter, inserted] = tables_.emplace(table_id, std::make_unique<TableData>());
+    auto tables = std::make_shared<TableMap>(*tables_);
+    auto [iter, inserted] = tables->emplace(table_id, std::move(vtable));
     CHECK(inserted);
-    auto& table = *iter->second;
-    table.fragment_size = options.fragment_size;
-    table.schema = schema;
+    std::atomic_store(&tables_, std::shared_ptr<const TableMap>(std::move(tables)));
   }
 
   return res;
@@ -389,8 +1168,14 @@ TableInfoPtr ArrowStorage::importArrowTable(std::shared_ptr<arrow::Table> at,
 TableInfoPtr ArrowStorage::importArrowTable(std::shared_ptr<arrow::Table> at,
                                             const std::string& table_name,
                                             const TableOptions& options) {
+  auto columns = getColumnDescriptions(at->schema());
+  return importArrowTable(at, table_name, columns, options);
+}
+
+std::vector<ArrowStorage::ColumnDescription> ArrowStorage::getColumnDescriptions(
+    std::shared_ptr<arrow::Schema> schema) const {
   std::vector<ColumnDescription> columns;
-  for (auto& field : at->schema()->fields()) {
+  for (auto& field : schema->fields()) {
     ColumnDescription desc{field->name(), getOmnisciType(*field->type())};
     // getOmnisciType sets comp_param for dictionaries to 32 because Catalog
     // uses it to compute type size and then replaces it with dictionary id.
@@ -401,7 +1186,7 @@ TableInfoPtr ArrowStorage::importArrowTable(std::shared_ptr<arrow::Table> at,
     }
     columns.emplace_back(std::move(desc));
   }
-  return importArrowTable(at, table_name, columns, options);
+  return columns;
 }
 
 void ArrowStorage::appendArrowTable(std::shared_ptr<arrow::Table> at,
@@ -414,39 +1199,31 @@ void ArrowStorage::appendArrowTable(std::shared_ptr<arrow::Table> at,
 }
 
 void ArrowStorage::appendArrowTable(std::shared_ptr<arrow::Table> at, int table_id) {
-  if (!tables_.count(table_id)) {
+  appendArrowTableImpl(at, table_id, false);
+}
+
+void ArrowStorage::appendArrowTableImpl(std::shared_ptr<arrow::Table> at,
+                                        int table_id,
+                                        bool reuse_input_buffers,
+                                        const std::vector<int64_t>* replaced_row_ids) {
+  appendConvertedColumns(convertArrowTable(at, table_id, reuse_input_buffers),
+                         static_cast<size_t>(at->num_rows()),
+                         table_id,
+                         replaced_row_ids);
+}
+
+std::vector<std::shared_ptr<arrow::ChunkedArray>> ArrowStorage::convertArrowTable(
+    std::shared_ptr<arrow::Table> at,
+    int table_id,
+    bool reuse_input_buffers) {
+  auto vtable = getTable(table_id);
+  if (!vtable) {
     throw std::runtime_error("Invalid table id: "s + std::to_string(table_id));
   }
+  compareSchemas(vtable->getData()->schema, at->schema());
 
-  auto& table = *tables_.at(table_id);
-  compareSchemas(table.schema, at->schema());
-
-  mapd_unique_lock<mapd_shared_mutex> lock(table.mutex);
   std::vector<std::shared_ptr<arrow::ChunkedArray>> col_data;
   col_data.resize(at->columns().size());
-
-  std::vector<DataFragment> fragments;
-  // Compute size of the fragment. If the last existing fragment is not full, then it will
-  // be merged with the first new fragment.
-  size_t first_frag_size =
-      std::min(table.fragment_size, static_cast<size_t>(at->num_rows()));
-  if (!table.fragments.empty()) {
-    auto& last_frag = table.fragments.back();
-    if (last_frag.row_count < table.fragment_size) {
-      first_frag_size =
-          std::min(first_frag_size, table.fragment_size - last_frag.row_count);
-    }
-  }
-  // Now we can compute number of fragments to create.
-  size_t frag_count =
-      (static_cast<size_t>(at->num_rows()) + table.fragment_size - 1 - first_frag_size) /
-          table.fragment_size +
-      1;
-  fragments.resize(frag_count);
-  for (auto& frag : fragments) {
-    frag.metadata.resize(at->columns().size());
-  }
-
   threading::parallel_for(
       threading::blocked_range(0, (int)at->columns().size()), [&](auto range) {
         for (auto col_idx = range.begin(); col_idx != range.end(); col_idx++) {
@@ -458,7 +1235,7 @@ void ArrowStorage::appendArrowTable(std::shared_ptr<arrow::Table> at, int table_
           }
 
           if (col_type.get_type() == kDECIMAL || col_type.get_type() == kNUMERIC) {
-            col_arr = convertDecimalToInteger(col_arr, col_type);
+            col_arr = convertDecimalToInteger(col_arr, col_type, reuse_input_buffers);
           } else if (col_type.is_string()) {
             if (col_type.is_dict_encoded_string()) {
               switch (col_arr->type()->id()) {
@@ -473,74 +1250,85 @@ void ArrowStorage::appendArrowTable(std::shared_ptr<arrow::Table> at, int table_
               }
             }
           } else {
-            col_arr = replaceNullValues(col_arr, col_type, dict);
+            col_arr = replaceNullValues(col_arr, col_type, dict, reuse_input_buffers);
           }
-
           col_data[col_idx] = col_arr;
+        }
+      });  // each column
+  return col_data;
+}
 
-          bool compute_stats =
-              col_type.get_type() != kTEXT || col_type.is_dict_encoded_string();
-          if (compute_stats) {
-            size_t elems_count = 1;
-            if (col_type.is_fixlen_array()) {
-              elems_count = col_type.get_size() / col_type.get_elem_type().get_size();
-            }
-            // Compute stats for each fragment.
-            threading::parallel_for(
-                threading::blocked_range(size_t(0), frag_count), [&](auto frag_range) {
-                  for (size_t frag_idx = frag_range.begin(); frag_idx != frag_range.end();
-                       ++frag_idx) {
-                    auto& frag = fragments[frag_idx];
-
-                    frag.offset =
-                        frag_idx
-                            ? ((frag_idx - 1) * table.fragment_size + first_frag_size)
-                            : 0;
-                    frag.row_count =
-                        frag_idx
-                            ? std::min(table.fragment_size,
-                                       static_cast<size_t>(at->num_rows()) - frag.offset)
-                            : first_frag_size;
-
-                    auto meta = std::make_shared<ChunkMetadata>();
-                    meta->sqlType = col_type;
-                    meta->numElements = frag.row_count;
-                    if (col_type.is_fixlen_array()) {
-                      meta->numBytes = frag.row_count * col_type.get_size();
-                    } else if (col_type.is_varlen_array()) {
-                      meta->numBytes =
-                          computeTotalStringsLength(col_arr, frag.offset, frag.row_count);
-                    } else {
-                      meta->numBytes = frag.row_count * col_type.get_size();
-                    }
-
-                    computeStats(
-                        col_arr->Slice(frag.offset, frag.row_count * elems_count),
-                        col_type,
-                        meta->chunkStats);
-                    frag.metadata[col_idx] = meta;
-                  }
-                });  // each fragment
-          } else {
-            for (size_t frag_idx = 0; frag_idx < frag_count; ++frag_idx) {
-              auto& frag = fragments[frag_idx];
-              frag.offset =
-                  frag_idx ? ((frag_idx - 1) * table.fragment_size + first_frag_size) : 0;
-              frag.row_count =
-                  frag_idx ? std::min(table.fragment_size,
-                                      static_cast<size_t>(at->num_rows()) - frag.offset)
-                           : first_frag_size;
-              auto meta = std::make_shared<ChunkMetadata>();
-              meta->sqlType = col_type;
-              meta->numElements = frag.row_count;
-              CHECK_EQ(col_type.get_type(), kTEXT);
-              meta->numBytes =
-                  computeTotalStringsLength(col_arr, frag.offset, frag.row_count);
-              meta->chunkStats.has_nulls =
-                  col_arr->Slice(frag.offset, frag.row_count)->null_count();
-              frag.metadata[col_idx] = meta;
-            }
+void ArrowStorage::appendConvertedColumns(
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> col_data,
+    size_t row_count,
+    int table_id,
+    const std::vector<int64_t>* replaced_row_ids) {
+  auto vtable = getTable(table_id);
+  if (!vtable) {
+    throw std::runtime_error("Invalid table id: "s + std::to_string(table_id));
+  }
+
+  std::unique_lock<std::mutex> lock(vtable->mutex);
+  if (replaced_row_ids) {
+    checkRowIds(*vtable->getData(), *replaced_row_ids);
+  }
+  // Running queries keep using the current version.
+  auto data = std::make_shared<TableData>(*vtable->getData());
+  auto& table = *data;
+
+  std::vector<DataFragment> fragments;
+  // Compute size of the fragment. If the last existing fragment is not full, then it will
+  // be merged with the first new fragment.
+  size_t first_frag_size = std::min(table.fragment_size, row_count);
+  if (!table.fragments.empty()) {
+    auto& last_frag = table.fragments.back();
+    if (last_frag.row_count < table.fragment_size) {
+      first_frag_size =
+          std::min(first_frag_size, table.fragment_size - last_frag.row_count);
+    }
+  }
+  // Now we can compute number of fragments to create.
+  size_t frag_count =
+      (row_count + table.fragment_size - 1 - first_frag_size) / table.fragment_size + 1;
+  fragments.resize(frag_count);
+  for (size_t frag_idx = 0; frag_idx < frag_count; ++frag_idx) {
+    auto& frag = fragments[frag_idx];
+    frag.offset =
+        frag_idx ? ((frag_idx - 1) * table.fragment_size + first_frag_size) : 0;
+    frag.row_count = frag_idx ? std::min(table.fragment_size, row_count - frag.offset)
+                              : first_frag_size;
+    frag.metadata.resize(col_data.size());
+  }
+  // The first new fragment is merged with the last existing one when the
+  // latter is not full.
+  bool merge_first_fragment =
+      !table.fragments.empty() && table.fragments.back().row_count < table.fragment_size;
+
+  threading::parallel_for(
+      threading::blocked_range(0, (int)col_data.size()), [&](auto range) {
+        for (auto col_idx = range.begin(); col_idx != range.end(); col_idx++) {
+          auto& col_type = getColumnInfo(db_id_, table_id, col_idx + 1)->type;
+          auto col_arr = col_data[col_idx];
+
+          size_t elems_count = 1;
+          if (col_type.is_fixlen_array()) {
+            elems_count = col_type.get_size() / col_type.get_elem_type().get_size();
           }
+
+          col_arr = coalesceFragmentChunks(
+              col_arr, fragments, elems_count, merge_first_fragment);
+          col_data[col_idx] = col_arr;
+
+          // Compute metadata for each fragment.
+          threading::parallel_for(
+              threading::blocked_range(size_t(0), frag_count), [&](auto frag_range) {
+                for (size_t frag_idx = frag_range.begin(); frag_idx != frag_range.end();
+                     ++frag_idx) {
+                  auto& frag = fragments[frag_idx];
+                  frag.metadata[col_idx] =
+                      computeChunkMetadata(col_arr, col_type, frag, elems_count);
+                }
+              });  // each fragment
         }
       });  // each column
 
@@ -562,6 +1350,9 @@ void ArrowStorage::appendArrowTable(std::shared_ptr<arrow::Table> at, int table_
       last_frag.row_count += first_frag.row_count;
       for (size_t col_idx = 0; col_idx < last_frag.metadata.size(); ++col_idx) {
         auto col_type = getColumnInfo(db_id_, table_id, col_idx + 1)->type;
+        // Metadata is shared with the previous versions of the table.
+        last_frag.metadata[col_idx] =
+            std::make_shared<ChunkMetadata>(*last_frag.metadata[col_idx]);
         last_frag.metadata[col_idx]->numElements +=
             first_frag.metadata[col_idx]->numElements;
         last_frag.metadata[col_idx]->numBytes += first_frag.metadata[col_idx]->numBytes;
@@ -573,22 +1364,133 @@ void ArrowStorage::appendArrowTable(std::shared_ptr<arrow::Table> at, int table_
     }
 
     // Copy the rest of fragments adjusting offset.
+    size_t first_new_frag = table.fragments.size();
     table.fragments.reserve(table.fragments.size() + fragments.size() - start_frag);
     for (size_t frag_idx = start_frag; frag_idx < fragments.size(); ++frag_idx) {
       table.fragments.emplace_back(std::move(fragments[frag_idx]));
       table.fragments.back().offset += table.row_count;
     }
+    indexFragments(table, first_new_frag);
 
-    table.row_count += at->num_rows();
+    table.row_count += row_count;
   } else {
     CHECK_EQ(table.row_count, (size_t)0);
+    // Empty fragments of the table are replaced with new ones. Their ids
+    // are reused because cached chunks of empty fragments have no data.
+    for (size_t frag_idx = 0; frag_idx < fragments.size(); ++frag_idx) {
+      if (frag_idx < table.fragments.size()) {
+        fragments[frag_idx].id = table.fragments[frag_idx].id;
+      }
+    }
     table.col_data = std::move(col_data);
     table.fragments = std::move(fragments);
-    table.row_count = at->num_rows();
+    table.row_count = row_count;
+    table.fragment_index.clear();
+    indexFragments(table, 0);
   }
 
-  getTableInfo(db_id_, table_id)->fragments = table.fragments.size();
-}
+  if (table.compression) {
+    compressFragments(table, table_id);
+  }
+
+  if (replaced_row_ids) {
+    table.delete_col_id = getTableInfo(db_id_, table_id)->delete_column->column_id;
+    markRowsDeleted(table, *replaced_row_ids);
+  }
+
+  trackFragmentVersions(table, vtable->getData());
+  vtable->setData(data);
+  if (replaced_row_ids) {
+    scheduleCompaction(*vtable, table, table_id);
+  }
+  lock.unlock();
+  updateFragmentCount(*vtable, table_id);
+}
+
+void ArrowStorage::appendBatches(
+    std::function<std::shared_ptr<arrow::Table>()> read_batch,
+    int table_id) {
+  auto vtable = getTable(table_id);
+  if (!vtable) {
+    throw std::runtime_error("Invalid table id: "s + std::to_string(table_id));
+  }
+  const auto fragment_size = vtable->getData()->fragment_size;
+
+  struct ConvertedBatch {
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> col_data;
+    size_t row_count = 0;
+  };
+  // Each stage works on one batch while at most one more waits in its queue.
+  BoundedQueue<std::shared_ptr<arrow::Table>> parsed(1);
+  BoundedQueue<ConvertedBatch> converted(1);
+  auto cancel_all = [&]() {
+    parsed.cancel();
+    converted.cancel();
+  };
+
+  auto read_stage = std::async(std::launch::async, [&]() {
+    try {
+      while (auto batch = read_batch()) {
+        if (!parsed.push(std::move(batch))) {
+          break;
+        }
+      }
+      parsed.close();
+    } catch (...) {
+      cancel_all();
+      throw;
+    }
+  });
+
+  // Parsed batches are grouped into at least fragment_size rows, so that every
+  // append fills whole fragments.
+  auto convert_stage = std::async(std::launch::async, [&]() {
+    try {
+      std::vector<std::shared_ptr<arrow::Table>> group;
+      size_t group_rows = 0;
+      auto flush = [&]() {
+        if (group.empty()) {
+          return true;
+        }
+        auto table_res = arrow::ConcatenateTables(group);
+        ARROW_THROW_NOT_OK(table_res.status());
+        auto at = table_res.ValueOrDie();
+        group.clear();
+        group_rows = 0;
+        return converted.push(
+            {convertArrowTable(at, table_id, true), static_cast<size_t>(at->num_rows())});
+      };
+      std::shared_ptr<arrow::Table> batch;
+      bool done = false;
+      while (!done && parsed.pop(batch)) {
+        group_rows += batch->num_rows();
+        group.emplace_back(std::move(batch));
+        done = group_rows >= fragment_size && !flush();
+      }
+      if (!done) {
+        flush();
+      }
+      converted.close();
+    } catch (...) {
+      cancel_all();
+      throw;
+    }
+  });
+
+  try {
+    ConvertedBatch batch;
+    while (converted.pop(batch)) {
+      appendConvertedColumns(std::move(batch.col_data), batch.row_count, table_id);
+    }
+  } catch (...) {
+    cancel_all();
+    read_stage.wait();
+    convert_stage.wait();
+    throw;
+  }
+  read_stage.get();
+  convert_stage.get();
+}
 
 TableInfoPtr ArrowStorage::importCsvFile(const std::string& file_name,
                                          const std::string& table_name,
@@ -604,8 +1506,23 @@ TableInfoPtr ArrowStorage::importCsvFile(const std::string& file_name,
                                          const std::string& table_name,
                                          const TableOptions& options,
                                          const CsvParseOptions parse_options) {
+  if (parse_options.max_batch_bytes) {
+    auto read_batch = makeCsvBatchReader(file_name, parse_options);
+    auto first_batch = read_batch();
+    auto res =
+        createTable(table_name, getColumnDescriptions(first_batch->schema()), options);
+    appendBatches(
+        [first_batch, read_batch]() mutable {
+          return first_batch ? std::exchange(first_batch, nullptr) : read_batch();
+        },
+        res->table_id);
+    return res;
+  }
+
   auto at = parseCsvFile(file_name, parse_options);
-  return importArrowTable(at, table_name, options);
+  auto res = createTable(table_name, getColumnDescriptions(at->schema()), options);
+  appendArrowTableImpl(at, res->table_id, true);
+  return res;
 }
 
 void ArrowStorage::appendCsvFile(const std::string& file_name,
@@ -621,13 +1538,18 @@ void ArrowStorage::appendCsvFile(const std::string& file_name,
 void ArrowStorage::appendCsvFile(const std::string& file_name,
                                  int table_id,
                                  const CsvParseOptions parse_options) {
-  if (!tables_.count(table_id)) {
+  if (!getTable(table_id)) {
     throw std::runtime_error("Invalid table id: "s + std::to_string(table_id));
   }
 
   auto col_infos = listColumns(db_id_, table_id);
+  if (parse_options.max_batch_bytes) {
+    appendBatches(makeCsvBatchReader(file_name, parse_options, col_infos), table_id);
+    return;
+  }
+
   auto at = parseCsvFile(file_name, parse_options, col_infos);
-  appendArrowTable(at, table_id);
+  appendArrowTableImpl(at, table_id, true);
 }
 
 void ArrowStorage::appendCsvData(const std::string& csv_data,
@@ -643,13 +1565,13 @@ void ArrowStorage::appendCsvData(const std::string& csv_data,
 void ArrowStorage::appendCsvData(const std::string& csv_data,
                                  int table_id,
                                  const CsvParseOptions parse_options) {
-  if (!tables_.count(table_id)) {
+  if (!getTable(table_id)) {
     throw std::runtime_error("Invalid table id: "s + std::to_string(table_id));
   }
 
   auto col_infos = listColumns(db_id_, table_id);
   auto at = parseCsvData(csv_data, parse_options, col_infos);
-  appendArrowTable(at, table_id);
+  appendArrowTableImpl(at, table_id, true);
 }
 
 void ArrowStorage::appendJsonData(const std::string& json_data,
@@ -665,38 +1587,144 @@ void ArrowStorage::appendJsonData(const std::string& json_data,
 void ArrowStorage::appendJsonData(const std::string& json_data,
                                   int table_id,
                                   const JsonParseOptions parse_options) {
-  if (!tables_.count(table_id)) {
+  if (!getTable(table_id)) {
     throw std::runtime_error("Invalid table id: "s + std::to_string(table_id));
   }
 
   auto col_infos = listColumns(db_id_, table_id);
   auto at = parseJsonData(json_data, parse_options, col_infos);
-  appendArrowTable(at, table_id);
+  appendArrowTableImpl(at, table_id, true);
 }
 
 TableInfoPtr ArrowStorage::importParquetFile(const std::string& file_name,
                                              const std::string& table_name,
-                                             const TableOptions& options) {
+                                             const TableOptions& options,
+                                             const ParquetParseOptions parse_options) {
+  if (parse_options.max_batch_bytes) {
+    auto read_batch = makeParquetBatchReader(file_name, parse_options.max_batch_bytes);
+    auto first_batch = read_batch();
+    auto res =
+        createTable(table_name, getColumnDescriptions(first_batch->schema()), options);
+    appendBatches(
+        [first_batch, read_batch]() mutable {
+          return first_batch ? std::exchange(first_batch, nullptr) : read_batch();
+        },
+        res->table_id);
+    return res;
+  }
+
   auto at = parseParquetFile(file_name);
-  return importArrowTable(at, table_name, options);
+  auto res = createTable(table_name, getColumnDescriptions(at->schema()), options);
+  appendArrowTableImpl(at, res->table_id, true);
+  return res;
 }
 
 void ArrowStorage::appendParquetFile(const std::string& file_name,
-                                     const std::string& table_name) {
+                                     const std::string& table_name,
+                                     const ParquetParseOptions parse_options) {
   auto tinfo = getTableInfo(db_id_, table_name);
   if (!tinfo) {
     throw std::runtime_error("Unknown table: "s + table_name);
   }
-  appendParquetFile(file_name, tinfo->table_id);
+  appendParquetFile(file_name, tinfo->table_id, parse_options);
 }
 
-void ArrowStorage::appendParquetFile(const std::string& file_name, int table_id) {
-  if (!tables_.count(table_id)) {
+void ArrowStorage::appendParquetFile(const std::string& file_name,
+                                     int table_id,
+                                     const ParquetParseOptions parse_options) {
+  if (!getTable(table_id)) {
     throw std::runtime_error("Invalid table id: "s + std::to_string(table_id));
   }
 
+  if (parse_options.max_batch_bytes) {
+    appendBatches(makeParquetBatchReader(file_name, parse_options.max_batch_bytes),
+                  table_id);
+    return;
+  }
+
   auto at = parseParquetFile(file_name);
-  appendArrowTable(at, table_id);
+  appendArrowTableImpl(at, table_id, true);
+}
+
+void ArrowStorage::deleteRows(const std::string& table_name,
+                              const std::vector<int64_t>& row_ids) {
+  auto tinfo = getTableInfo(db_id_, table_name);
+  if (!tinfo) {
+    throw std::runtime_error("Unknown table: "s + table_name);
+  }
+  deleteRows(tinfo->table_id, row_ids);
+}
+
+void ArrowStorage::deleteRows(int table_id, const std::vector<int64_t>& row_ids) {
+  auto vtable = getTable(table_id);
+  if (!vtable) {
+    throw std::runtime_error("Invalid table id: "s + std::to_string(table_id));
+  }
+
+  int delete_col_id = ensureDeleteColumn(table_id);
+  std::lock_guard<std::mutex> lock(vtable->mutex);
+  checkRowIds(*vtable->getData(), row_ids);
+  auto data = std::make_shared<TableData>(*vtable->getData());
+  data->delete_col_id = delete_col_id;
+  markRowsDeleted(*data, row_ids);
+  trackFragmentVersions(*data, vtable->getData());
+  vtable->setData(data);
+  scheduleCompaction(*vtable, *data, table_id);
+}
+
+void ArrowStorage::updateRows(const std::string& table_name,
+                              const std::vector<int64_t>& row_ids,
+                              std::shared_ptr<arrow::Table> at) {
+  auto tinfo = getTableInfo(db_id_, table_name);
+  if (!tinfo) {
+    throw std::runtime_error("Unknown table: "s + table_name);
+  }
+  updateRows(tinfo->table_id, row_ids, at);
+}
+
+void ArrowStorage::updateRows(int table_id,
+                              const std::vector<int64_t>& row_ids,
+                              std::shared_ptr<arrow::Table> at) {
+  if (!getTable(table_id)) {
+    throw std::runtime_error("Invalid table id: "s + std::to_string(table_id));
+  }
+  if (static_cast<size_t>(at->num_rows()) != row_ids.size()) {
+    throw std::runtime_error("Cannot update "s + std::to_string(row_ids.size()) +
+                             " row(s) with " + std::to_string(at->num_rows()) +
+                             " new row(s)");
+  }
+
+  ensureDeleteColumn(table_id);
+  // New row versions are appended to the tail fragments, so row ids of the old
+  // versions are not affected by the append.
+  appendArrowTableImpl(at, table_id, false, &row_ids);
+}
+
+void ArrowStorage::compactTable(const std::string& table_name) {
+  auto tinfo = getTableInfo(db_id_, table_name);
+  if (!tinfo) {
+    throw std::runtime_error("Unknown table: "s + table_name);
+  }
+  compactTable(tinfo->table_id);
+}
+
+void ArrowStorage::compactTable(int table_id) {
+  auto vtable = getTable(table_id);
+  if (!vtable) {
+    throw std::runtime_error("Invalid table id: "s + std::to_string(table_id));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(vtable->mutex);
+    if (!vtable->getData()->deleted_count) {
+      return;
+    }
+    auto data = std::make_shared<TableData>(*vtable->getData());
+    compactTableImpl(*data, table_id);
+    trackFragmentVersions(*data, vtable->getData());
+    vtable->setData(data);
+  }
+  updateFragmentCount(*vtable, table_id);
 }
 
 void ArrowStorage::dropTable(const std::string& table_name, bool throw_if_not_exist) {
@@ -711,18 +1739,25 @@ void ArrowStorage::dropTable(const std::string& table_name, bool throw_if_not_ex
 }
 
 void ArrowStorage::dropTable(int table_id, bool throw_if_not_exist) {
-  if (!tables_.count(table_id)) {
+  auto vtable = getTable(table_id);
+  if (!vtable) {
     if (throw_if_not_exist) {
       throw std::runtime_error("Cannot drop table with invalid id: "s +
                                std::to_string(table_id));
     }
+    return;
+  }
+
+  if (vtable->compaction.valid()) {
+    vtable->compaction.wait();
   }
 
   mapd_unique_lock<mapd_shared_mutex> lock1(data_mutex_);
   mapd_unique_lock<mapd_shared_mutex> lock2(schema_mutex_);
-  std::unique_ptr<TableData> table = std::move(tables_.at(table_id));
-  mapd_unique_lock<mapd_shared_mutex> lock3(table->mutex);
-  tables_.erase(table_id);
+  std::lock_guard<std::mutex> lock3(vtable->mutex);
+  auto tables = std::make_shared<TableMap>(*tables_);
+  tables->erase(table_id);
+  std::atomic_store(&tables_, std::shared_ptr<const TableMap>(std::move(tables)));
 
   std::unordered_set<int> dicts_to_remove;
   auto col_infos = listColumns(db_id_, table_id);
@@ -828,6 +1863,433 @@ void ArrowStorage::checkNewTableParams(const std::string& table_name,
   }
 }
 
+std::shared_ptr<arrow::ChunkedArray> ArrowStorage::coalesceFragmentChunks(
+    std::shared_ptr<arrow::ChunkedArray> arr,
+    const std::vector<DataFragment>& fragments,
+    size_t elems_count,
+    bool skip_first_fragment) const {
+  const bool is_varlen = arr->type()->id() == arrow::Type::STRING ||
+                         arr->type()->id() == arrow::Type::LIST;
+  if ((arr->num_chunks() <= 1 && !is_varlen) || !arr->length()) {
+    return arr;
+  }
+
+  // Re-chunk data so that each fragment is backed by a single Arrow array.
+  // It costs a copy on import but allows zero-copy fetch for all fragments
+  // except the one merged with the last fragment of the previous append.
+  // Offsets of varlen fragments are rebased to start at zero, otherwise they
+  // would be rebased on every fetch.
+  arrow::ArrayVector chunks;
+  chunks.reserve(fragments.size());
+  for (size_t frag_idx = 0; frag_idx < fragments.size(); ++frag_idx) {
+    auto& frag = fragments[frag_idx];
+    auto frag_data =
+        arr->Slice(static_cast<int64_t>(frag.offset * elems_count),
+                   static_cast<int64_t>(frag.row_count * elems_count));
+    if (frag_idx == 0 && skip_first_fragment) {
+      chunks.insert(chunks.end(), frag_data->chunks().begin(), frag_data->chunks().end());
+    } else if (frag_data->num_chunks() <= 1) {
+      for (auto& chunk : frag_data->chunks()) {
+        chunks.push_back(is_varlen ? rebase_varlen_offsets(chunk) : chunk);
+      }
+    } else {
+      auto res = arrow::Concatenate(frag_data->chunks());
+      ARROW_THROW_NOT_OK(res.status());
+      chunks.push_back(res.ValueOrDie());
+    }
+  }
+
+  auto res = arrow::ChunkedArray::Make(std::move(chunks), arr->type());
+  ARROW_THROW_NOT_OK(res.status());
+  return res.ValueOrDie();
+}
+
+std::shared_ptr<ArrowStorage::VersionedTable> ArrowStorage::getTable(int table_id) const {
+  auto tables = std::atomic_load(&tables_);
+  auto it = tables->find(table_id);
+  return it == tables->end() ? nullptr : it->second;
+}
+
+void ArrowStorage::indexFragments(TableData& table, size_t first_frag_idx) const {
+  for (size_t frag_idx = first_frag_idx; frag_idx < table.fragments.size(); ++frag_idx) {
+    auto& frag = table.fragments[frag_idx];
+    if (!frag.id) {
+      frag.id = table.next_fragment_id++;
+    }
+    table.fragment_index[frag.id] = frag_idx;
+  }
+}
+
+std::pair<std::shared_ptr<const ArrowStorage::TableData>, size_t>
+ArrowStorage::getFragment(const VersionedTable& vtable, int table_id, int frag_id) const {
+  auto data = vtable.getData();
+  auto it = data->fragment_index.find(frag_id);
+  if (it != data->fragment_index.end() && data->fragments[it->second].id == frag_id) {
+    return {std::move(data), it->second};
+  }
+  // Ids of replaced and removed fragments are resolved with the latest previous
+  // version still referenced by queries. Fragments only grow while keeping
+  // their ids, so it has all rows the query got metadata for.
+  auto versions_it = data->fragment_versions.find(frag_id);
+  if (versions_it != data->fragment_versions.end()) {
+    for (auto rit = versions_it->second.rbegin(); rit != versions_it->second.rend();
+         ++rit) {
+      if (auto version = rit->lock()) {
+        return {version, version->fragment_index.at(frag_id)};
+      }
+    }
+  }
+  // Ids replaced on rows deletion still refer to the same rows.
+  if (it != data->fragment_index.end()) {
+    return {std::move(data), it->second};
+  }
+  throw std::runtime_error("Fragment "s + std::to_string(frag_id) + " of table " +
+                           std::to_string(table_id) +
+                           " is not available anymore, it was removed by the "
+                           "table compaction.");
+}
+
+void ArrowStorage::trackFragmentVersions(TableData& table,
+                                         std::shared_ptr<const TableData> prev) const {
+  for (auto& frag : prev->fragments) {
+    table.fragment_versions[frag.id].push_back(prev);
+  }
+  // Versions not referenced by queries are released.
+  for (auto it = table.fragment_versions.begin(); it != table.fragment_versions.end();) {
+    auto& versions = it->second;
+    versions.erase(std::remove_if(versions.begin(),
+                                  versions.end(),
+                                  [](auto& version) { return version.expired(); }),
+                   versions.end());
+    if (versions.empty()) {
+      it = table.fragment_versions.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+std::shared_ptr<ChunkMetadata> ArrowStorage::getDeleteColumnMetadata(
+    const DataFragment& frag) const {
+  auto meta = std::make_shared<ChunkMetadata>();
+  meta->sqlType = SQLTypeInfo(kTINYINT, true);
+  meta->numElements = frag.row_count;
+  meta->numBytes = frag.row_count;
+  meta->chunkStats.has_nulls = false;
+  meta->chunkStats.min.tinyintval =
+      frag.row_count && frag.deleted_count == frag.row_count;
+  meta->chunkStats.max.tinyintval = frag.deleted_count ? 1 : 0;
+  return meta;
+}
+
+int ArrowStorage::ensureDeleteColumn(int table_id) {
+  mapd_unique_lock<mapd_shared_mutex> schema_lock(schema_mutex_);
+  auto tinfo = getTableInfo(db_id_, table_id);
+  CHECK(tinfo);
+  if (!tinfo->delete_column) {
+    addDeleteColumn(db_id_, table_id);
+  }
+  return tinfo->delete_column->column_id;
+}
+
+void ArrowStorage::updateFragmentCount(const VersionedTable& vtable, int table_id) {
+  // Table info is shared with schema readers and is updated by writers and
+  // by the compaction thread. It is called with no table lock held to keep
+  // the lock order used by dropTable. The latest published version is used,
+  // so the last update never sets an outdated count.
+  mapd_unique_lock<mapd_shared_mutex> schema_lock(schema_mutex_);
+  auto tinfo = getTableInfo(db_id_, table_id);
+  if (tinfo) {
+    tinfo->fragments = vtable.getData()->fragments.size();
+  }
+}
+
+void ArrowStorage::checkRowIds(const TableData& table,
+                               const std::vector<int64_t>& row_ids) const {
+  for (auto row_id : row_ids) {
+    if (row_id < 0 || static_cast<size_t>(row_id) >= table.row_count) {
+      throw std::runtime_error("Invalid row id: "s + std::to_string(row_id));
+    }
+  }
+}
+
+void ArrowStorage::markRowsDeleted(TableData& table,
+                                   const std::vector<int64_t>& row_ids) const {
+  std::unordered_set<size_t> modified_frags;
+  for (auto row_id : row_ids) {
+    auto frag_it = std::upper_bound(table.fragments.begin(),
+                                    table.fragments.end(),
+                                    static_cast<size_t>(row_id),
+                                    [](size_t row, const DataFragment& frag) {
+                                      return row < frag.offset;
+                                    });
+    CHECK(frag_it != table.fragments.begin());
+    --frag_it;
+    auto& frag = *frag_it;
+    size_t pos = static_cast<size_t>(row_id) - frag.offset;
+    CHECK_LT(pos, frag.row_count);
+    // The last fragment grows on append, so the bitmap is extended on demand.
+    frag.deleted.resize(std::max(frag.deleted.size(), (frag.row_count + 63) / 64), 0);
+    uint64_t mask = uint64_t(1) << (pos & 63);
+    if (!(frag.deleted[pos >> 6] & mask)) {
+      frag.deleted[pos >> 6] |= mask;
+      ++frag.deleted_count;
+      ++table.deleted_count;
+      modified_frags.insert(static_cast<size_t>(frag_it - table.fragments.begin()));
+    }
+  }
+
+  // Modified fragments get new ids, so that outdated chunks cached by the
+  // buffer manager are not used. Old ids are still valid for running queries.
+  for (auto frag_idx : modified_frags) {
+    auto& frag = table.fragments[frag_idx];
+    frag.id = table.next_fragment_id++;
+    table.fragment_index[frag.id] = frag_idx;
+  }
+}
+
+void ArrowStorage::scheduleCompaction(VersionedTable& vtable,
+                                      const TableData& table,
+                                      int table_id) {
+  if (table.compaction_threshold <= 0 || !table.deleted_count ||
+      table.deleted_count < table.compaction_threshold * table.row_count) {
+    return;
+  }
+  // Running compaction might miss the latest deletions. They are going to be
+  // handled by a compaction scheduled on one of the next deletions.
+  if (vtable.compaction.valid() &&
+      vtable.compaction.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return;
+  }
+  vtable.compaction = std::async(std::launch::async, [this, table_id]() {
+    try {
+      compactTable(table_id);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Compaction of table " << table_id << " failed: " << e.what();
+    }
+  });
+}
+
+void ArrowStorage::compactTableImpl(TableData& table, int table_id) {
+  if (!table.deleted_count) {
+    return;
+  }
+
+  size_t row_count = table.row_count - table.deleted_count;
+  size_t frag_count =
+      std::max((row_count + table.fragment_size - 1) / table.fragment_size, size_t(1));
+  std::vector<DataFragment> fragments(frag_count);
+  for (size_t frag_idx = 0; frag_idx < frag_count; ++frag_idx) {
+    auto& frag = fragments[frag_idx];
+    frag.offset = frag_idx * table.fragment_size;
+    frag.row_count = std::min(table.fragment_size, row_count - frag.offset);
+    frag.metadata.resize(table.col_data.size());
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> col_data(table.col_data.size());
+  threading::parallel_for(
+      threading::blocked_range(size_t(0), table.col_data.size()), [&](auto range) {
+        for (size_t col_idx = range.begin(); col_idx != range.end(); ++col_idx) {
+          auto& col_type = getColumnInfo(db_id_, table_id, col_idx + 1)->type;
+          size_t elems_count = 1;
+          if (col_type.is_fixlen_array()) {
+            elems_count = col_type.get_size() / col_type.get_elem_type().get_size();
+          }
+
+          arrow::ArrayVector chunks;
+          for (size_t frag_idx = 0; frag_idx < table.fragments.size(); ++frag_idx) {
+            auto& frag = table.fragments[frag_idx];
+            auto frag_data = getFragmentData(table, frag_idx, col_idx, elems_count);
+            if (frag.deleted_count) {
+              frag_data = removeDeletedRows(frag_data, frag, col_type, elems_count);
+            }
+            chunks.insert(
+                chunks.end(), frag_data->chunks().begin(), frag_data->chunks().end());
+          }
+          auto res = arrow::ChunkedArray::Make(std::move(chunks),
+                                               table.col_data[col_idx]->type());
+          ARROW_THROW_NOT_OK(res.status());
+          auto col_arr =
+              coalesceFragmentChunks(res.ValueOrDie(), fragments, elems_count, false);
+          col_data[col_idx] = col_arr;
+
+          for (auto& frag : fragments) {
+            frag.metadata[col_idx] =
+                computeChunkMetadata(col_arr, col_type, frag, elems_count);
+          }
+        }
+      });  // each column
+
+  table.col_data = std::move(col_data);
+  table.fragments = std::move(fragments);
+  table.row_count = row_count;
+  table.deleted_count = 0;
+  // All fragments get new ids, rows of old ones are not valid anymore.
+  table.fragment_index.clear();
+  indexFragments(table, 0);
+
+  if (table.compression) {
+    compressFragments(table, table_id);
+  }
+}
+
+std::shared_ptr<arrow::ChunkedArray> ArrowStorage::removeDeletedRows(
+    std::shared_ptr<arrow::ChunkedArray> arr,
+    const DataFragment& frag,
+    const SQLTypeInfo& col_type,
+    size_t elems_count) const {
+  auto is_deleted = [&frag](size_t row) {
+    return (row >> 6) < frag.deleted.size() &&
+           ((frag.deleted[row >> 6] >> (row & 63)) & 1);
+  };
+
+  if (col_type.is_varlen_array()) {
+    // Varlen arrays have offsets in bytes with negative values marking
+    // nulls. Such arrays cannot be filtered by Arrow.
+    arrow::TypedBufferBuilder<int32_t> offsets_builder;
+    arrow::BufferBuilder values_builder;
+    ARROW_THROW_NOT_OK(offsets_builder.Append(0));
+    int32_t values_size = 0;
+    int64_t row_count = 0;
+    size_t row = 0;
+    for (auto& chunk : arr->chunks()) {
+      auto chunk_list = std::dynamic_pointer_cast<arrow::ListArray>(chunk);
+      CHECK(chunk_list);
+      const int32_t* offsets = chunk->data()->GetValues<int32_t>(1);
+      const int8_t* values = chunk_list->values()->data()->GetValues<int8_t>(1, 0);
+      for (int64_t i = 0; i < chunk->length(); ++i, ++row) {
+        if (is_deleted(row)) {
+          continue;
+        }
+        int32_t start = std::abs(offsets[i]);
+        int32_t end = std::abs(offsets[i + 1]);
+        if (end > start) {
+          ARROW_THROW_NOT_OK(values_builder.Append(values + start, end - start));
+        }
+        values_size += end - start;
+        ARROW_THROW_NOT_OK(
+            offsets_builder.Append(offsets[i + 1] < 0 ? -values_size : values_size));
+        ++row_count;
+      }
+    }
+
+    std::shared_ptr<arrow::Buffer> offsets_buf;
+    std::shared_ptr<arrow::Buffer> values_buf;
+    ARROW_THROW_NOT_OK(offsets_builder.Finish(&offsets_buf));
+    ARROW_THROW_NOT_OK(values_builder.Finish(&values_buf));
+    auto list_type = std::dynamic_pointer_cast<arrow::ListType>(arr->type());
+    CHECK(list_type);
+    auto values_arr = arrow::MakeArray(
+        arrow::ArrayData::Make(list_type->value_type(),
+                               values_size / col_type.get_elem_type().get_size(),
+                               {nullptr, values_buf},
+                               0));
+    return std::make_shared<arrow::ChunkedArray>(std::make_shared<arrow::ListArray>(
+        arr->type(), row_count, offsets_buf, values_arr));
+  }
+
+  // Fixed length arrays are stored as flat arrays of their elements.
+  arrow::BooleanBuilder filter_builder;
+  ARROW_THROW_NOT_OK(filter_builder.Reserve(frag.row_count * elems_count));
+  for (size_t row = 0; row < frag.row_count; ++row) {
+    bool keep = !is_deleted(row);
+    for (size_t i = 0; i < elems_count; ++i) {
+      filter_builder.UnsafeAppend(keep);
+    }
+  }
+  std::shared_ptr<arrow::Array> filter;
+  ARROW_THROW_NOT_OK(filter_builder.Finish(&filter));
+  auto res = arrow::compute::Filter(arr, filter);
+  ARROW_THROW_NOT_OK(res.status());
+  return res.ValueOrDie().chunked_array();
+}
+
+void ArrowStorage::compressFragments(TableData& table, int table_id) {
+  // The last fragment can be merged with appended data, so only full
+  // fragments are compressed.
+  std::vector<size_t> frag_ids;
+  for (size_t frag_idx = 0; frag_idx < table.fragments.size(); ++frag_idx) {
+    auto& frag = table.fragments[frag_idx];
+    if (frag.row_count == table.fragment_size && frag.compressed.empty()) {
+      frag.compressed.resize(table.col_data.size());
+      frag_ids.push_back(frag_idx);
+    }
+  }
+  if (frag_ids.empty()) {
+    return;
+  }
+
+  threading::parallel_for(
+      threading::blocked_range(size_t(0), table.col_data.size()), [&](auto range) {
+        for (size_t col_idx = range.begin(); col_idx != range.end(); ++col_idx) {
+          auto& col_type = getColumnInfo(db_id_, table_id, col_idx + 1)->type;
+          if (!isCompressibleType(col_type)) {
+            continue;
+          }
+          bool compressed = false;
+          for (auto frag_idx : frag_ids) {
+            auto& frag = table.fragments[frag_idx];
+            auto chunk = compressChunk(
+                table.col_data[col_idx]->Slice(frag.offset, frag.row_count),
+                col_type,
+                frag.metadata[col_idx]->chunkStats.has_nulls);
+            if (chunk) {
+              frag.compressed[col_idx] = std::move(chunk);
+              compressed = true;
+            }
+          }
+          if (compressed) {
+            table.col_data[col_idx] = releaseCompressedData(
+                table.col_data[col_idx], table.fragments, col_idx);
+          }
+        }
+      });
+}
+
+std::shared_ptr<arrow::ChunkedArray> ArrowStorage::releaseCompressedData(
+    std::shared_ptr<arrow::ChunkedArray> arr,
+    const std::vector<DataFragment>& fragments,
+    size_t col_idx) const {
+  // Data of compressed fragments is replaced with arrays having no buffers.
+  // It keeps fragment offsets valid and allows to free the original buffers
+  // once they are not referenced by uncompressed fragments. Fixed length
+  // readers check DataFragment::getCompressed before touching col_data,
+  // variable length columns are never compressed.
+  arrow::ArrayVector chunks;
+  for (auto& frag : fragments) {
+    if (frag.getCompressed(col_idx)) {
+      chunks.push_back(arrow::MakeArray(arrow::ArrayData::Make(
+          arr->type(), static_cast<int64_t>(frag.row_count), {nullptr, nullptr}, 0)));
+    } else {
+      auto frag_data = arr->Slice(static_cast<int64_t>(frag.offset),
+                                  static_cast<int64_t>(frag.row_count));
+      chunks.insert(chunks.end(), frag_data->chunks().begin(), frag_data->chunks().end());
+    }
+  }
+
+  auto res = arrow::ChunkedArray::Make(std::move(chunks), arr->type());
+  ARROW_THROW_NOT_OK(res.status());
+  return res.ValueOrDie();
+}
+
+std::shared_ptr<arrow::ChunkedArray> ArrowStorage::getFragmentData(
+    const TableData& table,
+    size_t frag_idx,
+    size_t col_idx,
+    size_t elems_count) const {
+  auto& frag = table.fragments[frag_idx];
+  if (auto compressed = frag.getCompressed(col_idx)) {
+    auto arr_data = arrow::ArrayData::Make(table.col_data[col_idx]->type(),
+                                           static_cast<int64_t>(frag.row_count),
+                                           {nullptr, getDecodedChunk(*compressed)},
+                                           0);
+    return std::make_shared<arrow::ChunkedArray>(arrow::MakeArray(arr_data));
+  }
+  return table.col_data[col_idx]->Slice(
+      static_cast<int64_t>(frag.offset * elems_count),
+      static_cast<int64_t>(frag.row_count * elems_count));
+}
+
 void ArrowStorage::compareSchemas(std::shared_ptr<arrow::Schema> lhs,
                                   std::shared_ptr<arrow::Schema> rhs) {
   auto& lhs_fields = lhs->fields();
@@ -846,6 +2308,30 @@ void ArrowStorage::compareSchemas(std::shared_ptr<arrow::Schema> lhs,
   }
 }
 
+std::shared_ptr<ChunkMetadata> ArrowStorage::computeChunkMetadata(
+    std::shared_ptr<arrow::ChunkedArray> arr,
+    const SQLTypeInfo& col_type,
+    const DataFragment& frag,
+    size_t elems_count) {
+  auto meta = std::make_shared<ChunkMetadata>();
+  meta->sqlType = col_type;
+  meta->numElements = frag.row_count;
+  if (col_type.get_type() == kTEXT && !col_type.is_dict_encoded_string()) {
+    meta->numBytes = computeTotalStringsLength(arr, frag.offset, frag.row_count);
+    meta->chunkStats.has_nulls = arr->Slice(frag.offset, frag.row_count)->null_count();
+    return meta;
+  }
+
+  if (col_type.is_varlen_array()) {
+    meta->numBytes = computeTotalStringsLength(arr, frag.offset, frag.row_count);
+  } else {
+    meta->numBytes = frag.row_count * col_type.get_size();
+  }
+  computeStats(
+      arr->Slice(frag.offset, frag.row_count * elems_count), col_type, meta->chunkStats);
+  return meta;
+}
+
 void ArrowStorage::computeStats(std::shared_ptr<arrow::ChunkedArray> arr,
                                 SQLTypeInfo type,
                                 ChunkStats& stats) {
@@ -878,6 +2364,257 @@ void ArrowStorage::computeStats(std::shared_ptr<arrow::ChunkedArray> arr,
   encoder->fillChunkStats(stats, elem_type);
 }
 
+void ArrowStorage::persistTable(const std::string& table_name,
+                                const std::string& dir_name) {
+  auto tinfo = getTableInfo(db_id_, table_name);
+  if (!tinfo) {
+    throw std::runtime_error("Unknown table: "s + table_name);
+  }
+  persistTable(tinfo->table_id, dir_name);
+}
+
+void ArrowStorage::persistTable(int table_id, const std::string& dir_name) {
+  if (!getTable(table_id)) {
+    throw std::runtime_error("Invalid table id: "s + std::to_string(table_id));
+  }
+  compactTable(table_id);
+
+  std::filesystem::path dir(dir_name);
+  std::filesystem::create_directories(dir);
+  int generation = getPersistedGeneration(dir) + 1;
+
+  // Modifications made after the compaction are not persisted.
+  auto data = getTable(table_id)->getData();
+  auto& table = *data;
+
+  rapidjson::Document doc(rapidjson::kObjectType);
+  auto& alloc = doc.GetAllocator();
+  doc.AddMember("version", kPersistedTableVersion, alloc);
+  doc.AddMember("generation", generation, alloc);
+  doc.AddMember("fragment_size", static_cast<uint64_t>(table.fragment_size), alloc);
+
+  std::vector<SQLTypeInfo> col_types;
+  std::unordered_set<int> dict_ids;
+  rapidjson::Value columns(rapidjson::kArrayType);
+  for (auto& col_info : listColumns(db_id_, table_id)) {
+    if (col_info->is_rowid || col_info->is_delete) {
+      continue;
+    }
+    rapidjson::Value column(rapidjson::kObjectType);
+    column.AddMember(
+        "name", rapidjson::Value().SetString(col_info->name.c_str(), alloc), alloc);
+    column.AddMember("type", typeToJson(col_info->type, alloc), alloc);
+    columns.PushBack(column, alloc);
+    col_types.push_back(col_info->type);
+    if (col_info->type.is_dict_encoded_type()) {
+      dict_ids.insert(col_info->type.get_comp_param());
+    }
+  }
+  doc.AddMember("columns", columns, alloc);
+
+  for (auto dict_id : dict_ids) {
+    auto strings = dicts_.at(dict_id)->stringDict->copyStrings();
+    arrow::StringBuilder builder;
+    ARROW_THROW_NOT_OK(builder.AppendValues(strings));
+    std::shared_ptr<arrow::Array> strings_arr;
+    ARROW_THROW_NOT_OK(builder.Finish(&strings_arr));
+    auto schema = arrow::schema({arrow::field("strings", arrow::utf8())});
+    writeIpcFile(getDictFilePath(dir, generation, dict_id),
+                 arrow::RecordBatch::Make(schema, strings_arr->length(), {strings_arr}));
+  }
+
+  rapidjson::Value fragments(rapidjson::kArrayType);
+  for (size_t frag_idx = 0; frag_idx < table.fragments.size(); ++frag_idx) {
+    auto& frag = table.fragments[frag_idx];
+    rapidjson::Value frag_meta(rapidjson::kObjectType);
+    frag_meta.AddMember("row_count", static_cast<uint64_t>(frag.row_count), alloc);
+    rapidjson::Value chunks_meta(rapidjson::kArrayType);
+
+    arrow::FieldVector fields;
+    arrow::ArrayVector arrays;
+    for (size_t col_idx = 0; col_idx < col_types.size(); ++col_idx) {
+      auto& col_type = col_types[col_idx];
+      size_t elems_count = 1;
+      if (col_type.is_fixlen_array()) {
+        elems_count = col_type.get_size() / col_type.get_elem_type().get_size();
+      }
+      auto col_slice = getFragmentData(table, frag_idx, col_idx, elems_count);
+      auto arr = toPersistedArray(col_slice, col_type, frag.row_count);
+      fields.push_back(arrow::field("col_"s + std::to_string(col_idx + 1), arr->type()));
+      arrays.push_back(arr);
+
+      auto& meta = frag.metadata[col_idx];
+      rapidjson::Value chunk_meta(rapidjson::kObjectType);
+      chunk_meta.AddMember("num_bytes", static_cast<uint64_t>(meta->numBytes), alloc);
+      chunk_meta.AddMember(
+          "num_elements", static_cast<uint64_t>(meta->numElements), alloc);
+      chunk_meta.AddMember("has_nulls", meta->chunkStats.has_nulls, alloc);
+      chunk_meta.AddMember("min", datumToJson(meta->chunkStats.min, col_type), alloc);
+      chunk_meta.AddMember("max", datumToJson(meta->chunkStats.max, col_type), alloc);
+      chunks_meta.PushBack(chunk_meta, alloc);
+    }
+    frag_meta.AddMember("chunks", chunks_meta, alloc);
+    fragments.PushBack(frag_meta, alloc);
+
+    writeIpcFile(getFragmentFilePath(dir, generation, frag_idx),
+                 arrow::RecordBatch::Make(arrow::schema(fields), frag.row_count, arrays));
+  }
+  doc.AddMember("fragments", fragments, alloc);
+
+  // Metadata is written last and atomically replaces the previous one, so an
+  // interrupted write leaves the previously persisted table loadable.
+  writeJsonFileAtomically(dir / kPersistedTableMetaFile, doc);
+  removeStalePersistedFiles(dir, generation);
+}
+
+TableInfoPtr ArrowStorage::loadPersistedTable(const std::string& dir_name,
+                                              const std::string& table_name) {
+  std::filesystem::path dir(dir_name);
+  auto meta_path = dir / kPersistedTableMetaFile;
+  std::ifstream meta_file(meta_path);
+  if (!meta_file) {
+    throw std::runtime_error("Cannot open table metadata in "s + dir_name);
+  }
+  rapidjson::IStreamWrapper meta_stream(meta_file);
+  rapidjson::Document doc;
+  doc.ParseStream<rapidjson::kParseNanAndInfFlag>(meta_stream);
+  checkPersistedTableMeta(doc, meta_path);
+  int generation = doc["generation"].GetInt();
+
+  // Persisted dictionary ids are used as negative sharing ids to get new
+  // dictionaries with the same sharing among table columns.
+  std::vector<ColumnDescription> columns;
+  std::vector<int> persisted_dict_ids;
+  for (auto& column : doc["columns"].GetArray()) {
+    auto type = jsonToType(column["type"]);
+    int dict_id = 0;
+    if (type.is_dict_encoded_type()) {
+      dict_id = type.get_comp_param();
+      type.set_comp_param(-dict_id);
+    }
+    columns.push_back({column["name"].GetString(), type});
+    persisted_dict_ids.push_back(dict_id);
+  }
+
+  // Data files are opened and checked before the table is created. Their data is
+  // mapped to memory and is not read until used.
+  std::unordered_map<int, std::shared_ptr<arrow::StringArray>> dict_strings;
+  for (auto dict_id : persisted_dict_ids) {
+    if (!dict_id || dict_strings.count(dict_id)) {
+      continue;
+    }
+    auto file_path = getDictFilePath(dir, generation, dict_id);
+    auto batch = readIpcFile(file_path);
+    auto strings_arr =
+        batch->num_columns() == 1
+            ? std::dynamic_pointer_cast<arrow::StringArray>(batch->column(0))
+            : nullptr;
+    if (!strings_arr || strings_arr->null_count()) {
+      throw std::runtime_error("Malformed dictionary data in "s + file_path.string());
+    }
+    dict_strings.emplace(dict_id, strings_arr);
+  }
+
+  auto frags_meta = doc["fragments"].GetArray();
+  std::vector<arrow::ArrayVector> col_chunks(columns.size());
+  for (size_t frag_idx = 0; frag_idx < frags_meta.Size(); ++frag_idx) {
+    auto file_path = getFragmentFilePath(dir, generation, frag_idx);
+    auto batch = readIpcFile(file_path);
+    if (batch->num_columns() != static_cast<int>(columns.size()) ||
+        batch->num_rows() !=
+            static_cast<int64_t>(frags_meta[frag_idx]["row_count"].GetUint64())) {
+      throw std::runtime_error("Malformed fragment data in "s + file_path.string());
+    }
+    for (size_t col_idx = 0; col_idx < columns.size(); ++col_idx) {
+      auto arr = fromPersistedArray(batch->column(col_idx), columns[col_idx].type);
+      if (!arr || (frag_idx && !arr->type()->Equals(col_chunks[col_idx][0]->type()))) {
+        throw std::runtime_error("Malformed fragment data in "s + file_path.string());
+      }
+      col_chunks[col_idx].push_back(arr);
+    }
+  }
+
+  auto res = createTable(
+      table_name, columns, TableOptions(doc["fragment_size"].GetUint64()));
+  bool loaded = false;
+  ScopeGuard drop_on_failure([&]() {
+    if (!loaded) {
+      dropTable(res->table_id);
+    }
+  });
+
+  std::unordered_set<int> loaded_dicts;
+  for (size_t col_idx = 0; col_idx < columns.size(); ++col_idx) {
+    int dict_id = persisted_dict_ids[col_idx];
+    if (!dict_id || loaded_dicts.count(dict_id)) {
+      continue;
+    }
+    loaded_dicts.insert(dict_id);
+
+    auto& strings_arr = dict_strings.at(dict_id);
+    std::vector<std::string_view> strings;
+    strings.reserve(strings_arr->length());
+    for (int64_t i = 0; i < strings_arr->length(); ++i) {
+      auto str = strings_arr->GetView(i);
+      strings.emplace_back(str.data(), str.size());
+    }
+    // Strings are added in the order of their ids and get the same ids.
+    std::vector<int32_t> ids(strings.size());
+    auto& col_type = getColumnInfo(db_id_, res->table_id, col_idx + 1)->type;
+    dicts_.at(col_type.get_comp_param())->stringDict->getOrAddBulk(strings, ids.data());
+    for (size_t i = 0; i < ids.size(); ++i) {
+      if (ids[i] != static_cast<int32_t>(i)) {
+        throw std::runtime_error(
+            "Malformed dictionary data in "s +
+            getDictFilePath(dir, generation, dict_id).string() + ": duplicated strings");
+      }
+    }
+  }
+
+  auto vtable = getTable(res->table_id);
+  std::unique_lock<std::mutex> lock(vtable->mutex);
+  auto data = std::make_shared<TableData>(*vtable->getData());
+  auto& table = *data;
+  for (auto& frag_meta : frags_meta) {
+    auto& frag = table.fragments.emplace_back();
+    frag.offset = table.row_count;
+    frag.row_count = frag_meta["row_count"].GetUint64();
+
+    auto chunks_meta = frag_meta["chunks"].GetArray();
+    for (size_t col_idx = 0; col_idx < columns.size(); ++col_idx) {
+      auto& col_type = getColumnInfo(db_id_, res->table_id, col_idx + 1)->type;
+      auto& chunk_meta = chunks_meta[col_idx];
+      auto meta = std::make_shared<ChunkMetadata>();
+      meta->sqlType = col_type;
+      meta->numBytes = chunk_meta["num_bytes"].GetUint64();
+      meta->numElements = chunk_meta["num_elements"].GetUint64();
+      meta->chunkStats.has_nulls = chunk_meta["has_nulls"].GetBool();
+      try {
+        meta->chunkStats.min = jsonToDatum(chunk_meta["min"], col_type);
+        meta->chunkStats.max = jsonToDatum(chunk_meta["max"], col_type);
+      } catch (const std::runtime_error& e) {
+        throw std::runtime_error("Malformed table metadata in "s + meta_path.string() +
+                                 ": " + e.what());
+      }
+      frag.metadata.push_back(meta);
+    }
+    table.row_count += frag.row_count;
+  }
+  indexFragments(table, 0);
+
+  if (!table.fragments.empty()) {
+    for (auto& chunks : col_chunks) {
+      table.col_data.push_back(arrow::ChunkedArray::Make(chunks).ValueOrDie());
+    }
+  }
+  vtable->setData(data);
+  lock.unlock();
+  updateFragmentCount(*vtable, res->table_id);
+  loaded = true;
+
+  return res;
+}
+
 std::shared_ptr<arrow::Table> ArrowStorage::parseCsvFile(
     const std::string& file_name,
     const CsvParseOptions parse_options,
@@ -901,50 +2638,13 @@ std::shared_ptr<arrow::Table> ArrowStorage::parseCsv(
     const CsvParseOptions parse_options,
     const ColumnInfoList& col_infos) {
   auto io_context = arrow::io::default_io_context();
+  auto csv_options = getArrowCsvOptions(parse_options, col_infos);
 
-  auto arrow_parse_options = arrow::csv::ParseOptions::Defaults();
-  arrow_parse_options.quoting = false;
-  arrow_parse_options.escaping = false;
-  arrow_parse_options.newlines_in_values = false;
-  arrow_parse_options.delimiter = parse_options.delimiter;
-
-  auto arrow_read_options = arrow::csv::ReadOptions::Defaults();
-  arrow_read_options.use_threads = true;
-  arrow_read_options.block_size = parse_options.block_size;
-  arrow_read_options.autogenerate_column_names =
-      !parse_options.header && col_infos.empty();
-  arrow_read_options.skip_rows = parse_options.header && !col_infos.empty()
-                                     ? (parse_options.skip_rows + 1)
-                                     : parse_options.skip_rows;
-
-  auto arrow_convert_options = arrow::csv::ConvertOptions::Defaults();
-  arrow_convert_options.check_utf8 = false;
-  arrow_convert_options.include_columns = arrow_read_options.column_names;
-  arrow_convert_options.strings_can_be_null = true;
-
-  bool need_time_parser = false;
-  for (auto& col_info : col_infos) {
-    if (!col_info->is_rowid) {
-      arrow_read_options.column_names.push_back(col_info->name);
-      arrow_convert_options.column_types.emplace(col_info->name,
-                                                 getArrowImportType(col_info->type));
-      if (col_info->type.get_type() == kTIME) {
-        need_time_parser = true;
-      }
-    }
-  }
-  // There is no built-in converter for TIME types in Arrow 5.0 CSV reader and
-  // therefore we add a parser to parse it as a custom datetime.
-  // We will be able to switch to buil-in converter starting from Arrow 6.0.
-  if (need_time_parser) {
-    arrow_convert_options.timestamp_parsers.push_back(
-        arrow::TimestampParser::MakeISO8601());
-    arrow_convert_options.timestamp_parsers.push_back(
-        arrow::TimestampParser::MakeStrptime("%H:%M:%S"));
-  }
-
-  auto table_reader_result = arrow::csv::TableReader::Make(
-      io_context, input, arrow_read_options, arrow_parse_options, arrow_convert_options);
+  auto table_reader_result = arrow::csv::TableReader::Make(io_context,
+                                                           input,
+                                                           csv_options.read_options,
+                                                           csv_options.parse_options,
+                                                           csv_options.convert_options);
   ARROW_THROW_NOT_OK(table_reader_result.status());
   auto table_reader = table_reader_result.ValueOrDie();
 
@@ -960,6 +2660,65 @@ std::shared_ptr<arrow::Table> ArrowStorage::parseCsv(
   return at;
 }
 
+std::function<std::shared_ptr<arrow::Table>()> ArrowStorage::makeCsvBatchReader(
+    const std::string& file_name,
+    const CsvParseOptions parse_options,
+    const ColumnInfoList& col_infos) {
+  auto file_result = arrow::io::ReadableFile::Open(file_name.c_str());
+  ARROW_THROW_NOT_OK(file_result.status());
+
+  auto io_context = arrow::io::default_io_context();
+  auto csv_options = getArrowCsvOptions(parse_options, col_infos);
+  auto reader_result = arrow::csv::StreamingReader::Make(io_context,
+                                                         file_result.ValueOrDie(),
+                                                         csv_options.read_options,
+                                                         csv_options.parse_options,
+                                                         csv_options.convert_options);
+  ARROW_THROW_NOT_OK(reader_result.status());
+  std::shared_ptr<arrow::RecordBatchReader> reader = reader_result.ValueOrDie();
+
+  auto max_batch_bytes = parse_options.max_batch_bytes;
+  // The streaming reader infers column types from the first block only and
+  // cannot change them later.
+  bool inferred_types = col_infos.empty();
+  auto exhausted = std::make_shared<bool>(false);
+  auto first_call = std::make_shared<bool>(true);
+  return [reader, max_batch_bytes, inferred_types, exhausted, first_call]() {
+    if (*exhausted) {
+      return std::shared_ptr<arrow::Table>();
+    }
+
+    arrow::RecordBatchVector batches;
+    size_t batches_bytes = 0;
+    while (batches_bytes < max_batch_bytes) {
+      std::shared_ptr<arrow::RecordBatch> batch;
+      auto status = reader->ReadNext(&batch);
+      if (status.IsInvalid() && inferred_types) {
+        throw std::runtime_error(
+            "CSV data doesn't match column types inferred from the first block (" +
+            reader->schema()->ToString(false) + "): " + status.ToString() +
+            ". Import with explicit column types or a larger block size.");
+      }
+      ARROW_THROW_NOT_OK(status);
+      if (!batch) {
+        *exhausted = true;
+        break;
+      }
+      batches_bytes += arrow::util::TotalBufferSize(*batch);
+      batches.emplace_back(std::move(batch));
+    }
+
+    if (batches.empty() && !*first_call) {
+      return std::shared_ptr<arrow::Table>();
+    }
+    *first_call = false;
+
+    auto table_result = arrow::Table::FromRecordBatches(reader->schema(), batches);
+    ARROW_THROW_NOT_OK(table_result.status());
+    return table_result.ValueOrDie();
+  };
+}
+
 std::shared_ptr<arrow::Table> ArrowStorage::parseJsonData(
     const std::string& json_data,
     const JsonParseOptions parse_options,
@@ -975,7 +2734,7 @@ std::shared_ptr<arrow::Table> ArrowStorage::parseJson(
   arrow::FieldVector fields;
   fields.reserve(col_infos.size());
   for (auto& col_info : col_infos) {
-    if (!col_info->is_rowid) {
+    if (!col_info->is_rowid && !col_info->is_delete) {
       fields.emplace_back(
           std::make_shared<arrow::Field>(col_info->name,
                                          getArrowImportType(col_info->type),
@@ -1011,27 +2770,53 @@ std::shared_ptr<arrow::Table> ArrowStorage::parseJson(
 
 std::shared_ptr<arrow::Table> ArrowStorage::parseParquetFile(
     const std::string& file_name) {
-  auto file_result = arrow::io::ReadableFile::Open(file_name.c_str());
-  ARROW_THROW_NOT_OK(file_result.status());
-  auto inp = file_result.ValueOrDie();
-
-  auto parquet_reader = parquet::ParquetFileReader::Open(inp);
-
-  std::unique_ptr<parquet::arrow::FileReader> arrow_reader;
-  // Allow multithreding.
-  parquet::ArrowReaderProperties prop(true);
-  auto st = parquet::arrow::FileReader::Make(
-      arrow::default_memory_pool(), std::move(parquet_reader), prop, &arrow_reader);
-  if (!st.ok()) {
-    throw std::runtime_error(st.ToString());
-  }
+  auto arrow_reader = openParquetFile(file_name);
 
   // Read entire file as a single Arrow table
   std::shared_ptr<arrow::Table> table;
-  st = arrow_reader->ReadTable(&table);
+  auto st = arrow_reader->ReadTable(&table);
   if (!st.ok()) {
     throw std::runtime_error(st.ToString());
   }
 
   return table;
 }
+
+std::function<std::shared_ptr<arrow::Table>()> ArrowStorage::makeParquetBatchReader(
+    const std::string& file_name,
+    size_t max_batch_bytes) {
+  std::shared_ptr<parquet::arrow::FileReader> arrow_reader = openParquetFile(file_name);
+  auto metadata = arrow_reader->parquet_reader()->metadata();
+
+  // Group row groups into batches using their uncompressed size so that
+  // we never read more than required for a single batch.
+  auto batches = std::make_shared<std::vector<std::vector<int>>>();
+  size_t batch_bytes = max_batch_bytes;
+  for (int rg_idx = 0; rg_idx < metadata->num_row_groups(); ++rg_idx) {
+    if (batch_bytes >= max_batch_bytes) {
+      batches->emplace_back();
+      batch_bytes = 0;
+    }
+    batches->back().push_back(rg_idx);
+    batch_bytes += static_cast<size_t>(metadata->RowGroup(rg_idx)->total_byte_size());
+  }
+
+  auto next_batch = std::make_shared<size_t>(0);
+  return [arrow_reader, batches, next_batch]() {
+    std::shared_ptr<arrow::Table> table;
+    if (*next_batch < batches->size()) {
+      auto st = arrow_reader->ReadRowGroups((*batches)[*next_batch], &table);
+      if (!st.ok()) {
+        throw std::runtime_error(st.ToString());
+      }
+    } else if (*next_batch == 0) {
+      // No row groups in the file. Return an empty table to provide a schema.
+      auto st = arrow_reader->ReadTable(&table);
+      if (!st.ok()) {
+        throw std::runtime_error(st.ToString());
+      }
+    }
+    ++(*next_batch);
+    return table;
+  };
+}
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "ArrowStorage/ChunkCompression.h"
 #include "DataMgr/AbstractDataProvider.h"
 #include "DataProvider/DictDescriptor.h"
 #include "SchemaMgr/SimpleSchemaProvider.h"
@@ -21,6 +22,10 @@
 
 #include <arrow/api.h>
 
+#include <functional>
+#include <future>
+#include <mutex>
+
 class ArrowStorage : public SimpleSchemaProvider, public AbstractDataProvider {
  public:
   struct ColumnDescription {
@@ -33,6 +38,16 @@ class ArrowStorage : public SimpleSchemaProvider, public AbstractDataProvider {
     TableOptions(size_t fragment_size_) : fragment_size(fragment_size_){};
 
     size_t fragment_size = 32'000'000;
+    // When set, full fragments of integer, decimal, date/time and dictionary
+    // encoded columns are stored compressed and decoded on fetch. This trades
+    // scan speed for memory: decoded data is shared only while some reader
+    // holds it, so every cold fetch decodes the chunk to full width again.
+    // Kernels never read the compressed data, so it is an opt-in for tables
+    // which do not fit in memory otherwise and is never enabled by default.
+    bool compression = false;
+    // Fraction of deleted rows triggering a background compaction of the table.
+    // Zero disables automatic compaction.
+    double compaction_threshold = 0.0;
   };
 
   struct CsvParseOptions {
@@ -42,6 +57,9 @@ class ArrowStorage : public SimpleSchemaProvider, public AbstractDataProvider {
     bool header = true;
     size_t skip_rows = 0;
     size_t block_size = 20 << 20;  // Default block size is 20MB
+    // When non-zero, the file is parsed and appended by batches holding
+    // roughly max_batch_bytes of parsed data instead of a single table.
+    size_t max_batch_bytes = 0;
   };
 
   struct JsonParseOptions {
@@ -51,10 +69,19 @@ class ArrowStorage : public SimpleSchemaProvider, public AbstractDataProvider {
     size_t block_size = 1 << 20;  // Default block size is 1MB
   };
 
+  struct ParquetParseOptions {
+    ParquetParseOptions(){};
+
+    // When non-zero, row groups are read and appended by batches holding
+    // roughly max_batch_bytes of uncompressed data instead of a single table.
+    size_t max_batch_bytes = 0;
+  };
+
   ArrowStorage(int schema_id, const std::string& schema_name, int db_id)
       : SimpleSchemaProvider(schema_id, schema_name)
       , db_id_(db_id)
       , schema_id_(getSchemaId(db_id)) {}
+  ~ArrowStorage() override;
 
   void fetchBuffer(const ChunkKey& key,
                    Data_Namespace::AbstractBuffer* dest,
@@ -114,53 +141,216 @@ class ArrowStorage : public SimpleSchemaProvider, public AbstractDataProvider {
                       int table_id,
                       const JsonParseOptions parse_options = JsonParseOptions());
 
-  TableInfoPtr importParquetFile(const std::string& file_name,
-                                 const std::string& table_name,
-                                 const TableOptions& options = TableOptions());
-
-  void appendParquetFile(const std::string& file_name, const std::string& table_name);
-  void appendParquetFile(const std::string& file_name, int table_id);
+  TableInfoPtr importParquetFile(
+      const std::string& file_name,
+      const std::string& table_name,
+      const TableOptions& options = TableOptions(),
+      const ParquetParseOptions parse_options = ParquetParseOptions());
+
+  void appendParquetFile(const std::string& file_name,
+                         const std::string& table_name,
+                         const ParquetParseOptions parse_options = ParquetParseOptions());
+  void appendParquetFile(const std::string& file_name,
+                         int table_id,
+                         const ParquetParseOptions parse_options = ParquetParseOptions());
+
+  // Mark rows with the specified row ids as deleted. Row id is the row position
+  // in the table as returned by the rowid column. Deleted rows are skipped by
+  // queries and are physically removed by the table compaction.
+  void deleteRows(const std::string& table_name, const std::vector<int64_t>& row_ids);
+  void deleteRows(int table_id, const std::vector<int64_t>& row_ids);
+
+  // Replace rows with the specified row ids with rows of the provided table.
+  // Old row versions are deleted and new ones are appended to the table.
+  void updateRows(const std::string& table_name,
+                  const std::vector<int64_t>& row_ids,
+                  std::shared_ptr<arrow::Table> at);
+  void updateRows(int table_id,
+                  const std::vector<int64_t>& row_ids,
+                  std::shared_ptr<arrow::Table> at);
+
+  // Rewrite table data with deleted rows removed. Row ids of the remaining
+  // rows can change.
+  void compactTable(const std::string& table_name);
+  void compactTable(int table_id);
 
   void dropTable(const std::string& table_name, bool throw_if_not_exist = false);
   void dropTable(int table_id, bool throw_if_not_exist = false);
 
+  // Write table data to the specified directory. Each fragment goes to a separate
+  // Arrow IPC file. Column types, chunk metadata and dictionaries are stored
+  // alongside so that the table can be loaded with no parsing or stats computation.
+  // The table is compacted before writing. A table previously persisted to the
+  // directory stays loadable until the new data is complete and then is removed.
+  void persistTable(const std::string& table_name, const std::string& dir_name);
+  void persistTable(int table_id, const std::string& dir_name);
+
+  // Create a table from data written by persistTable. Fragment files are memory
+  // mapped and their data is served to the buffer manager with no copy when
+  // possible. Dictionaries shared with other tables become table's own. Malformed
+  // files cause std::runtime_error naming the file.
+  TableInfoPtr loadPersistedTable(const std::string& dir_name,
+                                  const std::string& table_name);
+
  private:
   struct DataFragment {
+    // Id used in chunk keys. It is changed on rows deletion to avoid the use
+    // of outdated cached chunks of the fragment.
+    int id = 0;
     size_t offset = 0;
     size_t row_count = 0;
     std::vector<std::shared_ptr<ChunkMetadata>> metadata;
+    // Compressed column data, nullptr for columns stored as is. Empty for
+    // fragments not considered for compression yet.
+    std::vector<std::shared_ptr<CompressedChunk>> compressed;
+    // Bitmap of deleted rows. Rows out of the bitmap range are not deleted.
+    std::vector<uint64_t> deleted;
+    size_t deleted_count = 0;
+
+    // Column data of compressed fragments is a placeholder with no buffers,
+    // so readers have to check this first.
+    const CompressedChunk* getCompressed(size_t col_idx) const {
+      return col_idx < compressed.size() ? compressed[col_idx].get() : nullptr;
+    }
   };
 
+  // Version of table data. Published versions are never modified, so readers
+  // can use them with no locks.
   struct TableData {
-    mapd_shared_mutex mutex;
     size_t fragment_size = 32'000'000;
+    bool compression = false;
+    double compaction_threshold = 0.0;
     std::shared_ptr<arrow::Schema> schema;
     std::vector<std::shared_ptr<arrow::ChunkedArray>> col_data;
     std::vector<DataFragment> fragments;
     size_t row_count = 0;
+    // Maps current and previous ids of fragments to their indexes.
+    std::unordered_map<int, size_t> fragment_index;
+    // Previous versions holding fragments with the given ids, from the oldest.
+    // Chunk metadata returned to queries shares ownership of its version, so
+    // fragments replaced or removed later stay readable while any query can
+    // reference them.
+    std::unordered_map<int, std::vector<std::weak_ptr<const TableData>>>
+        fragment_versions;
+    int next_fragment_id = 1;
+    int delete_col_id = 0;
+    size_t deleted_count = 0;
   };
 
+  // Table modifications are serialized with the mutex. Writers modify a copy of
+  // the current data version and then publish it atomically. Readers never wait
+  // for writers. Queries read fragments of the version they got metadata for,
+  // see getFragment.
+  struct VersionedTable {
+    std::mutex mutex;
+    std::future<void> compaction;
+
+    std::shared_ptr<const TableData> getData() const { return std::atomic_load(&data); }
+    void setData(std::shared_ptr<const TableData> new_data) {
+      std::atomic_store(&data, std::move(new_data));
+    }
+
+   private:
+    std::shared_ptr<const TableData> data;
+  };
+
+  using TableMap = std::unordered_map<int, std::shared_ptr<VersionedTable>>;
+
   class ArrowChunkDataToken : public Data_Namespace::AbstractDataToken {
    public:
     ArrowChunkDataToken(std::shared_ptr<arrow::Array> chunk,
                         const int8_t* ptr,
-                        size_t size)
-        : chunk_(std::move(chunk)), ptr_(ptr), size_(size) {}
+                        size_t size,
+                        std::optional<SQLTypeInfo> encoder_type = std::nullopt)
+        : chunk_(std::move(chunk))
+        , ptr_(ptr)
+        , size_(size)
+        , encoder_type_(std::move(encoder_type)) {}
 
     const int8_t* getMemoryPtr() const override { return ptr_; }
     size_t getSize() const override { return size_; }
+    std::optional<SQLTypeInfo> getEncoderType() const override { return encoder_type_; }
 
    private:
     std::shared_ptr<arrow::Array> chunk_;
     const int8_t* ptr_;
     size_t size_;
+    std::optional<SQLTypeInfo> encoder_type_;
   };
 
+  std::vector<ColumnDescription> getColumnDescriptions(
+      std::shared_ptr<arrow::Schema> schema) const;
+  // Tables produced by our own parsers are exclusively owned by the storage
+  // and their buffers can be reused for the converted data.
+  // Rows with replaced_row_ids are deleted along with the append.
+  void appendArrowTableImpl(std::shared_ptr<arrow::Table> at,
+                            int table_id,
+                            bool reuse_input_buffers,
+                            const std::vector<int64_t>* replaced_row_ids = nullptr);
+  // Converts columns of the table to the storage representation. It doesn't need
+  // the table lock, so it can run ahead of the append of previous data.
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> convertArrowTable(
+      std::shared_ptr<arrow::Table> at,
+      int table_id,
+      bool reuse_input_buffers);
+  void appendConvertedColumns(std::vector<std::shared_ptr<arrow::ChunkedArray>> col_data,
+                              size_t row_count,
+                              int table_id,
+                              const std::vector<int64_t>* replaced_row_ids = nullptr);
+  // Appends tables produced by read_batch until it returns nullptr. Reading,
+  // converting and appending run concurrently and pass data through bounded
+  // queues. Batches are grouped into at least fragment_size rows per append.
+  void appendBatches(std::function<std::shared_ptr<arrow::Table>()> read_batch,
+                     int table_id);
   void checkNewTableParams(const std::string& table_name,
                            const std::vector<ColumnDescription>& columns,
                            const TableOptions& options) const;
+  std::shared_ptr<arrow::ChunkedArray> coalesceFragmentChunks(
+      std::shared_ptr<arrow::ChunkedArray> arr,
+      const std::vector<DataFragment>& fragments,
+      size_t elems_count,
+      bool skip_first_fragment) const;
   void compareSchemas(std::shared_ptr<arrow::Schema> lhs,
                       std::shared_ptr<arrow::Schema> rhs);
+  // Return nullptr for unknown tables.
+  std::shared_ptr<VersionedTable> getTable(int table_id) const;
+  void indexFragments(TableData& table, size_t first_frag_idx) const;
+  // Return the data version the fragment id refers to and the fragment's index
+  // in it. Throws for ids removed by compaction with no query referencing them.
+  std::pair<std::shared_ptr<const TableData>, size_t> getFragment(
+      const VersionedTable& vtable,
+      int table_id,
+      int frag_id) const;
+  // Record prev as a version holding its fragments before table is published.
+  void trackFragmentVersions(TableData& table,
+                             std::shared_ptr<const TableData> prev) const;
+  std::shared_ptr<ChunkMetadata> computeChunkMetadata(
+      std::shared_ptr<arrow::ChunkedArray> arr,
+      const SQLTypeInfo& col_type,
+      const DataFragment& frag,
+      size_t elems_count);
+  std::shared_ptr<ChunkMetadata> getDeleteColumnMetadata(const DataFragment& frag) const;
+  int ensureDeleteColumn(int table_id);
+  void updateFragmentCount(const VersionedTable& vtable, int table_id);
+  void checkRowIds(const TableData& table, const std::vector<int64_t>& row_ids) const;
+  void markRowsDeleted(TableData& table, const std::vector<int64_t>& row_ids) const;
+  void scheduleCompaction(VersionedTable& vtable, const TableData& table, int table_id);
+  void compactTableImpl(TableData& table, int table_id);
+  std::shared_ptr<arrow::ChunkedArray> removeDeletedRows(
+      std::shared_ptr<arrow::ChunkedArray> arr,
+      const DataFragment& frag,
+      const SQLTypeInfo& col_type,
+      size_t elems_count) const;
+  void compressFragments(TableData& table, int table_id);
+  std::shared_ptr<arrow::ChunkedArray> releaseCompressedData(
+      std::shared_ptr<arrow::ChunkedArray> arr,
+      const std::vector<DataFragment>& fragments,
+      size_t col_idx) const;
+  // Get fragment's column data decompressing it if required.
+  std::shared_ptr<arrow::ChunkedArray> getFragmentData(const TableData& table,
+                                                       size_t frag_idx,
+                                                       size_t col_idx,
+                                                       size_t elems_count) const;
   void computeStats(std::shared_ptr<arrow::ChunkedArray> arr,
                     SQLTypeInfo type,
                     ChunkStats& stats);
@@ -173,6 +363,12 @@ class ArrowStorage : public SimpleSchemaProvider, public AbstractDataProvider {
   std::shared_ptr<arrow::Table> parseCsv(std::shared_ptr<arrow::io::InputStream> input,
                                          const CsvParseOptions parse_options,
                                          const ColumnInfoList& col_infos = {});
+  // Batch readers always return a table on the first call (possibly an empty one)
+  // to provide a schema and return nullptr when the input is exhausted.
+  std::function<std::shared_ptr<arrow::Table>()> makeCsvBatchReader(
+      const std::string& file_name,
+      const CsvParseOptions parse_options,
+      const ColumnInfoList& col_infos = {});
   std::shared_ptr<arrow::Table> parseJsonData(const std::string& json_data,
                                               const JsonParseOptions parse_options,
                                               const ColumnInfoList& col_infos = {});
@@ -180,13 +376,25 @@ class ArrowStorage : public SimpleSchemaProvider, public AbstractDataProvider {
                                           const JsonParseOptions parse_options,
                                           const ColumnInfoList& col_infos = {});
   std::shared_ptr<arrow::Table> parseParquetFile(const std::string& file_name);
+  std::function<std::shared_ptr<arrow::Table>()> makeParquetBatchReader(
+      const std::string& file_name,
+      size_t max_batch_bytes);
   TableFragmentsInfo getEmptyTableMetadata(int table_id) const;
+  std::unique_ptr<Data_Namespace::AbstractDataToken> getZeroCopyVarLenBufferMemory(
+      const TableData& table,
+      size_t frag_idx,
+      size_t col_idx,
+      const SQLTypeInfo& col_type,
+      bool is_index_buffer) const;
   void fetchFixedLenData(const TableData& table,
                          size_t frag_idx,
                          size_t col_idx,
                          Data_Namespace::AbstractBuffer* dest,
                          size_t num_bytes,
                          size_t elem_size) const;
+  void fetchDeleteFlags(const DataFragment& frag,
+                        Data_Namespace::AbstractBuffer* dest,
+                        size_t num_bytes) const;
   void fetchVarLenOffsets(const TableData& table,
                           size_t frag_idx,
                           size_t col_idx,
@@ -208,7 +416,9 @@ class ArrowStorage : public SimpleSchemaProvider, public AbstractDataProvider {
   int schema_id_;
   int next_table_id_ = 1;
   int next_dict_id_ = 1;
-  std::unordered_map<int, std::unique_ptr<TableData>> tables_;
+  // The map is replaced on tables creation and removal, so that readers can
+  // access it with no locks. Modifications are serialized with data_mutex_.
+  std::shared_ptr<const TableMap> tables_ = std::make_shared<TableMap>();
   std::unordered_map<int, std::unique_ptr<DictDescriptor>> dicts_;
   mapd_shared_mutex data_mutex_;
   mapd_shared_mutex schema_mutex_;
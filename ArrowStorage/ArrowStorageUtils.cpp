@@ -19,6 +19,7 @@
 #include <tbb/task_group.h>
 
 #include <iostream>
+#include <unordered_set>
 
 using namespace std::string_literals;
 
@@ -167,14 +168,60 @@ void copyArrayDataReplacingNulls(T* dst, std::shared_ptr<arrow::Array> arr) {
   copyArrayDataReplacingNulls(dst, arr, 0, arr->length());
 }
 
+// Check if values buffers of all chunks can be modified in-place. It requires
+// each chunk to exclusively own its mutable values buffer.
+bool canReuseValuesBuffers(std::shared_ptr<arrow::ChunkedArray> arr) {
+  std::unordered_set<const uint8_t*> buffers;
+  for (auto& chunk : arr->chunks()) {
+    if (chunk->offset() != 0 || chunk->data()->buffers.size() < 2) {
+      return false;
+    }
+    auto& values = chunk->data()->buffers[1];
+    if (!values || !values->is_mutable() || !buffers.insert(values->data()).second) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+void replaceNullValuesInplace(std::shared_ptr<arrow::Array> arr) {
+  if (arr->null_count() == 0) {
+    return;
+  }
+  auto data = reinterpret_cast<T*>(arr->data()->buffers[1]->mutable_data());
+  copyArrayDataReplacingNulls<T>(data, arr);
+}
+
 template <typename T>
 std::shared_ptr<arrow::ChunkedArray> replaceNullValuesImpl(
-    std::shared_ptr<arrow::ChunkedArray> arr) {
+    std::shared_ptr<arrow::ChunkedArray> arr,
+    bool reuse_input_buffers) {
   if (!std::is_same_v<T, bool> && arr->null_count() == 0) {
     // for boolean columns we still need to convert bitmaps to array
     return arr;
   }
 
+  if constexpr (!std::is_same_v<T, bool>) {
+    // Write null values right into the input buffers to avoid a copy of the
+    // whole column. Validity bitmaps are dropped as in the copying path.
+    if (reuse_input_buffers && canReuseValuesBuffers(arr)) {
+      arrow::ArrayVector converted_chunks(arr->num_chunks());
+      tbb::parallel_for(
+          tbb::blocked_range<int>(0, arr->num_chunks()),
+          [&](const tbb::blocked_range<int>& r) {
+            for (int c = r.begin(); c != r.end(); ++c) {
+              auto chunk = arr->chunk(c);
+              replaceNullValuesInplace<T>(chunk);
+              converted_chunks[c] = std::make_shared<arrow::PrimitiveArray>(
+                  chunk->type(), chunk->length(), chunk->data()->buffers[1]);
+            }
+          });
+      return std::make_shared<arrow::ChunkedArray>(std::move(converted_chunks),
+                                                   arr->type());
+    }
+  }
+
   auto resultBuf = arrow::AllocateBuffer(sizeof(T) * arr->length()).ValueOrDie();
   auto resultData = reinterpret_cast<T*>(resultBuf->mutable_data());
 
@@ -240,7 +287,27 @@ void copyTimestampToTimeReplacingNulls(int64_t* dst, std::shared_ptr<arrow::Arra
 }
 
 std::shared_ptr<arrow::ChunkedArray> convertTimestampToTimeReplacingNulls(
-    std::shared_ptr<arrow::ChunkedArray> arr) {
+    std::shared_ptr<arrow::ChunkedArray> arr,
+    bool reuse_input_buffers) {
+  if (reuse_input_buffers && canReuseValuesBuffers(arr)) {
+    // Conversion doesn't change values size and can be done in-place.
+    arrow::ArrayVector converted_chunks(arr->num_chunks());
+    tbb::parallel_for(
+        tbb::blocked_range<int>(0, arr->num_chunks()),
+        [&](const tbb::blocked_range<int>& r) {
+          for (int c = r.begin(); c != r.end(); ++c) {
+            auto chunk = arr->chunk(c);
+            auto values = chunk->data()->buffers[1];
+            copyTimestampToTimeReplacingNulls(
+                reinterpret_cast<int64_t*>(values->mutable_data()), chunk);
+            converted_chunks[c] =
+                std::make_shared<arrow::Int64Array>(chunk->length(), values);
+          }
+        });
+    return std::make_shared<arrow::ChunkedArray>(std::move(converted_chunks),
+                                                 arrow::int64());
+  }
+
   auto resultBuf = arrow::AllocateBuffer(sizeof(int64_t) * arr->length()).ValueOrDie();
   auto resultData = reinterpret_cast<int64_t*>(resultBuf->mutable_data());
 
@@ -885,9 +952,47 @@ std::shared_ptr<arrow::ChunkedArray> replaceNullValuesFixedSizeArray(
   return nullptr;
 }
 
+template <typename IntType>
+void convertDecimalToIntegerChunk(IntType* dst,
+                                  std::shared_ptr<arrow::Decimal128Array> arr) {
+  auto all_nulls = arr->null_count() == arr->length();
+  for (int i = 0; i < arr->length(); i++) {
+    if (all_nulls || arr->IsNull(i)) {
+      dst[i] = inline_null_value<IntType>();
+    } else {
+      arrow::Decimal128 val(arr->GetValue(i));
+      dst[i] = static_cast<int64_t>(val);  // arrow can cast only to int64_t
+    }
+  }
+}
+
 template <typename IntType, typename ChunkType>
 std::shared_ptr<arrow::ChunkedArray> convertDecimalToInteger(
-    std::shared_ptr<arrow::ChunkedArray> arr_col_chunked_array) {
+    std::shared_ptr<arrow::ChunkedArray> arr_col_chunked_array,
+    bool reuse_input_buffers) {
+  static_assert(sizeof(IntType) <= sizeof(arrow::Decimal128));
+  if (reuse_input_buffers && canReuseValuesBuffers(arr_col_chunked_array)) {
+    // Integers are narrower than decimals and therefore can be written into
+    // the input buffer: i-th integer never overlaps with decimals that are
+    // not yet converted.
+    arrow::ArrayVector converted_chunks(arr_col_chunked_array->num_chunks());
+    tbb::parallel_for(
+        tbb::blocked_range(0, arr_col_chunked_array->num_chunks()), [&](auto& range) {
+          for (int chunk_idx = range.begin(); chunk_idx < range.end(); chunk_idx++) {
+            auto decimal_array = std::static_pointer_cast<arrow::Decimal128Array>(
+                arr_col_chunked_array->chunk(chunk_idx));
+            auto values = decimal_array->data()->buffers[1];
+            convertDecimalToIntegerChunk<IntType>(
+                reinterpret_cast<IntType*>(values->mutable_data()), decimal_array);
+            converted_chunks[chunk_idx] =
+                std::make_shared<ChunkType>(decimal_array->length(), values);
+          }
+        });
+    using IntArrowType = typename arrow::CTypeTraits<IntType>::ArrowType;
+    return std::make_shared<arrow::ChunkedArray>(
+        std::move(converted_chunks), arrow::TypeTraits<IntArrowType>::type_singleton());
+  }
+
   size_t column_size = 0;
   std::vector<int> offsets(arr_col_chunked_array->num_chunks());
   for (int i = 0; i < arr_col_chunked_array->num_chunks(); i++) {
@@ -906,22 +1011,9 @@ std::shared_ptr<arrow::ChunkedArray> convertDecimalToInteger(
       [buffer_data, &offsets, arr_col_chunked_array](auto& range) {
         for (int chunk_idx = range.begin(); chunk_idx < range.end(); chunk_idx++) {
           auto offset = offsets[chunk_idx];
-          IntType* chunk_buffer = buffer_data + offset;
-
-          auto decimalArray = std::static_pointer_cast<arrow::Decimal128Array>(
+          auto decimal_array = std::static_pointer_cast<arrow::Decimal128Array>(
               arr_col_chunked_array->chunk(chunk_idx));
-          auto empty =
-              arr_col_chunked_array->null_count() == arr_col_chunked_array->length();
-          for (int i = 0; i < decimalArray->length(); i++) {
-            if (empty || decimalArray->null_count() == decimalArray->length() ||
-                decimalArray->IsNull(i)) {
-              chunk_buffer[i] = inline_null_value<IntType>();
-            } else {
-              arrow::Decimal128 val(decimalArray->GetValue(i));
-              chunk_buffer[i] =
-                  static_cast<int64_t>(val);  // arrow can cast only to int64_t
-            }
-          }
+          convertDecimalToIntegerChunk<IntType>(buffer_data + offset, decimal_array);
         }
       });
   auto array = std::make_shared<ChunkType>(column_size, result_buffer);
@@ -1005,13 +1097,14 @@ std::shared_ptr<arrow::DataType> getArrowImportType(const SQLTypeInfo type) {
 std::shared_ptr<arrow::ChunkedArray> replaceNullValues(
     std::shared_ptr<arrow::ChunkedArray> arr,
     const SQLTypeInfo& type,
-    StringDictionary* dict) {
+    StringDictionary* dict,
+    bool reuse_input_buffers) {
   if (type.get_type() == kTIME) {
     if (type.get_size() != 8) {
       throw std::runtime_error("Unsupported time type for Arrow import: "s +
                                type.toString());
     }
-    return convertTimestampToTimeReplacingNulls(arr);
+    return convertTimestampToTimeReplacingNulls(arr, reuse_input_buffers);
   }
   if (type.get_type() == kDATE) {
     if (type.get_compression() != kENCODING_DATE_IN_DAYS) {
@@ -1023,7 +1116,7 @@ std::shared_ptr<arrow::ChunkedArray> replaceNullValues(
       case 2:
         return convertDateReplacingNulls<int32_t, int16_t>(arr);
       case 4:
-        return replaceNullValuesImpl<int32_t>(arr);
+        return replaceNullValuesImpl<int32_t>(arr, reuse_input_buffers);
       case 8:
         return convertDateReplacingNulls<int32_t, int64_t>(arr);
       default:
@@ -1033,13 +1126,13 @@ std::shared_ptr<arrow::ChunkedArray> replaceNullValues(
   } else if (type.is_integer() || is_datetime(type.get_type())) {
     switch (type.get_size()) {
       case 1:
-        return replaceNullValuesImpl<int8_t>(arr);
+        return replaceNullValuesImpl<int8_t>(arr, reuse_input_buffers);
       case 2:
-        return replaceNullValuesImpl<int16_t>(arr);
+        return replaceNullValuesImpl<int16_t>(arr, reuse_input_buffers);
       case 4:
-        return replaceNullValuesImpl<int32_t>(arr);
+        return replaceNullValuesImpl<int32_t>(arr, reuse_input_buffers);
       case 8:
-        return replaceNullValuesImpl<int64_t>(arr);
+        return replaceNullValuesImpl<int64_t>(arr, reuse_input_buffers);
       default:
         throw std::runtime_error("Unsupported integer/datetime type for Arrow import: "s +
                                  type.toString());
@@ -1047,12 +1140,12 @@ std::shared_ptr<arrow::ChunkedArray> replaceNullValues(
   } else if (type.is_fp()) {
     switch (type.get_size()) {
       case 4:
-        return replaceNullValuesImpl<float>(arr);
+        return replaceNullValuesImpl<float>(arr, reuse_input_buffers);
       case 8:
-        return replaceNullValuesImpl<double>(arr);
+        return replaceNullValuesImpl<double>(arr, reuse_input_buffers);
     }
   } else if (type.is_boolean()) {
-    return replaceNullValuesImpl<bool>(arr);
+    return replaceNullValuesImpl<bool>(arr, reuse_input_buffers);
   } else if (type.is_fixlen_array()) {
     return replaceNullValuesFixedSizeArray(arr, type, dict);
   } else if (type.is_varlen_array()) {
@@ -1064,15 +1157,19 @@ std::shared_ptr<arrow::ChunkedArray> replaceNullValues(
 
 std::shared_ptr<arrow::ChunkedArray> convertDecimalToInteger(
     std::shared_ptr<arrow::ChunkedArray> arr,
-    const SQLTypeInfo& type) {
+    const SQLTypeInfo& type,
+    bool reuse_input_buffers) {
   CHECK(type.get_type() == kDECIMAL || type.get_type() == kNUMERIC);
   switch (type.get_size()) {
     case 2:
-      return convertDecimalToInteger<int16_t, arrow::Int16Array>(arr);
+      return convertDecimalToInteger<int16_t, arrow::Int16Array>(arr,
+                                                                 reuse_input_buffers);
     case 4:
-      return convertDecimalToInteger<int32_t, arrow::Int32Array>(arr);
+      return convertDecimalToInteger<int32_t, arrow::Int32Array>(arr,
+                                                                 reuse_input_buffers);
     case 8:
-      return convertDecimalToInteger<int64_t, arrow::Int64Array>(arr);
+      return convertDecimalToInteger<int64_t, arrow::Int64Array>(arr,
+                                                                 reuse_input_buffers);
     default:
       // TODO: throw unsupported decimal type exception
       CHECK(false) << "Unsupported decimal type: " << type.toString();
@@ -23,14 +23,20 @@ std::shared_ptr<arrow::DataType> getArrowImportType(const SQLTypeInfo type);
 
 SQLTypeInfo getOmnisciType(const arrow::DataType& type);
 
+// Nulls are replaced with the inline null values of the type, the resulting
+// arrays have no validity bitmaps. When reuse_input_buffers is set, conversion
+// can write results into the input arrays' buffers instead of allocating new
+// ones. It should be used only for arrays exclusively owned by the caller.
 std::shared_ptr<arrow::ChunkedArray> replaceNullValues(
     std::shared_ptr<arrow::ChunkedArray> arr,
     const SQLTypeInfo& type,
-    StringDictionary* dict = nullptr);
+    StringDictionary* dict = nullptr,
+    bool reuse_input_buffers = false);
 
 std::shared_ptr<arrow::ChunkedArray> convertDecimalToInteger(
     std::shared_ptr<arrow::ChunkedArray> arr,
-    const SQLTypeInfo& type);
+    const SQLTypeInfo& type,
+    bool reuse_input_buffers = false);
 
 std::shared_ptr<arrow::ChunkedArray> createDictionaryEncodedColumn(
     StringDictionary* dict,
@@ -0,0 +1,362 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ChunkCompression.h"
+
+#include "Logger/Logger.h"
+#include "Shared/ArrowUtil.h"
+#include "Shared/InlineNullValues.h"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+namespace {
+
+int bitWidth(uint64_t max_code) {
+  int res = 0;
+  while (max_code) {
+    ++res;
+    max_code >>= 1;
+  }
+  return res;
+}
+
+size_t packedWords(size_t num_codes, int bit_width) {
+  return (num_codes * bit_width + 63) / 64;
+}
+
+class BitPacker {
+ public:
+  BitPacker(std::vector<uint64_t>& words, size_t num_codes, int bit_width)
+      : words_(words), bit_width_(bit_width) {
+    words_.assign(packedWords(num_codes, bit_width), 0);
+  }
+
+  void append(uint64_t code) {
+    if (!bit_width_) {
+      return;
+    }
+    size_t word = bit_pos_ >> 6;
+    size_t offs = bit_pos_ & 63;
+    words_[word] |= code << offs;
+    if (offs + bit_width_ > 64) {
+      words_[word + 1] |= code >> (64 - offs);
+    }
+    bit_pos_ += bit_width_;
+  }
+
+ private:
+  std::vector<uint64_t>& words_;
+  int bit_width_;
+  size_t bit_pos_ = 0;
+};
+
+class BitUnpacker {
+ public:
+  BitUnpacker(const std::vector<uint64_t>& words, int bit_width)
+      : words_(words.data())
+      , bit_width_(bit_width)
+      , mask_(bit_width == 64 ? ~uint64_t(0) : (uint64_t(1) << bit_width) - 1) {}
+
+  uint64_t next() {
+    if (!bit_width_) {
+      return 0;
+    }
+    size_t word = bit_pos_ >> 6;
+    size_t offs = bit_pos_ & 63;
+    uint64_t res = words_[word] >> offs;
+    if (offs + bit_width_ > 64) {
+      res |= words_[word + 1] << (64 - offs);
+    }
+    bit_pos_ += bit_width_;
+    return res & mask_;
+  }
+
+ private:
+  const uint64_t* words_;
+  int bit_width_;
+  uint64_t mask_;
+  size_t bit_pos_ = 0;
+};
+
+template <typename T, typename Fn>
+void forEachValue(std::shared_ptr<arrow::ChunkedArray> data, Fn fn) {
+  for (auto& chunk : data->chunks()) {
+    const T* vals = chunk->data()->GetValues<T>(1);
+    for (int64_t i = 0; i < chunk->length(); ++i) {
+      fn(static_cast<int64_t>(vals[i]));
+    }
+  }
+}
+
+template <typename T>
+std::unique_ptr<CompressedChunk> compressChunkImpl(
+    std::shared_ptr<arrow::ChunkedArray> data,
+    bool has_nulls) {
+  size_t num_elems = static_cast<size_t>(data->length());
+  if (!num_elems) {
+    return nullptr;
+  }
+
+  // Collect range, delta and run statistics in a single pass.
+  const int64_t null_value = inline_null_value<T>();
+  int64_t min_val = std::numeric_limits<int64_t>::max();
+  int64_t max_val = std::numeric_limits<int64_t>::min();
+  int64_t min_delta = std::numeric_limits<int64_t>::max();
+  int64_t max_delta = std::numeric_limits<int64_t>::min();
+  size_t num_runs = 0;
+  bool first = true;
+  int64_t prev = 0;
+  forEachValue<T>(data, [&](int64_t val) {
+    if (!has_nulls || val != null_value) {
+      min_val = std::min(min_val, val);
+      max_val = std::max(max_val, val);
+    }
+    if (first || val != prev) {
+      ++num_runs;
+    }
+    if (!first) {
+      auto delta = static_cast<int64_t>(static_cast<uint64_t>(val) -
+                                        static_cast<uint64_t>(prev));
+      min_delta = std::min(min_delta, delta);
+      max_delta = std::max(max_delta, delta);
+    }
+    first = false;
+    prev = val;
+  });
+  // All values are nulls.
+  if (min_val > max_val) {
+    min_val = max_val = null_value;
+    has_nulls = false;
+  }
+
+  uint64_t max_code =
+      static_cast<uint64_t>(max_val) - static_cast<uint64_t>(min_val) + has_nulls;
+  int for_width = bitWidth(max_code);
+  // Null code overflow means the chunk uses the full value range.
+  bool for_possible = !has_nulls || max_code != 0;
+  size_t for_size = packedWords(num_elems, for_width) * sizeof(uint64_t);
+
+  bool delta_possible = !has_nulls && num_elems > 1;
+  int delta_width = delta_possible ? bitWidth(static_cast<uint64_t>(max_delta) -
+                                              static_cast<uint64_t>(min_delta))
+                                   : 64;
+  size_t delta_size = packedWords(num_elems - 1, delta_width) * sizeof(uint64_t);
+
+  // Run ends are 32-bit.
+  bool rle_possible = num_elems <= std::numeric_limits<uint32_t>::max();
+  size_t rle_size = num_runs * (sizeof(int64_t) + sizeof(uint32_t));
+
+  size_t raw_size = num_elems * sizeof(T);
+  size_t best_size = raw_size - raw_size / 4;
+  std::optional<ChunkCodec> codec;
+  if (for_possible && for_size < best_size) {
+    codec = ChunkCodec::kFrameOfReference;
+    best_size = for_size;
+  }
+  if (delta_possible && delta_size < best_size) {
+    codec = ChunkCodec::kDelta;
+    best_size = delta_size;
+  }
+  if (rle_possible && rle_size < best_size) {
+    codec = ChunkCodec::kRunLength;
+    best_size = rle_size;
+  }
+  if (!codec) {
+    return nullptr;
+  }
+
+  auto res = std::make_unique<CompressedChunk>();
+  res->codec = *codec;
+  res->elem_size = sizeof(T);
+  res->num_elems = num_elems;
+  switch (*codec) {
+    case ChunkCodec::kFrameOfReference: {
+      res->base = min_val;
+      res->bit_width = for_width;
+      res->has_null_code = has_nulls;
+      res->null_code = max_code;
+      res->null_value = null_value;
+      BitPacker packer(res->packed, num_elems, for_width);
+      forEachValue<T>(data, [&](int64_t val) {
+        packer.append(has_nulls && val == null_value
+                          ? max_code
+                          : static_cast<uint64_t>(val) - static_cast<uint64_t>(min_val));
+      });
+      break;
+    }
+    case ChunkCodec::kDelta: {
+      res->delta_base = min_delta;
+      res->bit_width = delta_width;
+      BitPacker packer(res->packed, num_elems - 1, delta_width);
+      bool first = true;
+      int64_t prev = 0;
+      forEachValue<T>(data, [&](int64_t val) {
+        if (first) {
+          res->base = val;
+          first = false;
+        } else {
+          packer.append(static_cast<uint64_t>(val) - static_cast<uint64_t>(prev) -
+                        static_cast<uint64_t>(min_delta));
+        }
+        prev = val;
+      });
+      break;
+    }
+    case ChunkCodec::kRunLength: {
+      res->run_values.reserve(num_runs);
+      res->run_ends.reserve(num_runs);
+      uint32_t pos = 0;
+      forEachValue<T>(data, [&](int64_t val) {
+        if (!pos || val != res->run_values.back()) {
+          res->run_values.push_back(val);
+          res->run_ends.push_back(pos);
+        }
+        res->run_ends.back() = ++pos;
+      });
+      CHECK_EQ(res->run_values.size(), num_runs);
+      break;
+    }
+  }
+
+  return res;
+}
+
+template <typename T>
+void decompressChunkImpl(const CompressedChunk& chunk, size_t num_elems, T* dst) {
+  switch (chunk.codec) {
+    case ChunkCodec::kFrameOfReference: {
+      BitUnpacker unpacker(chunk.packed, chunk.bit_width);
+      const uint64_t base = static_cast<uint64_t>(chunk.base);
+      if (chunk.has_null_code) {
+        const uint64_t null_code = chunk.null_code;
+        const T null_value = static_cast<T>(chunk.null_value);
+        for (size_t i = 0; i < num_elems; ++i) {
+          auto code = unpacker.next();
+          dst[i] = code == null_code ? null_value : static_cast<T>(base + code);
+        }
+      } else {
+        for (size_t i = 0; i < num_elems; ++i) {
+          dst[i] = static_cast<T>(base + unpacker.next());
+        }
+      }
+      break;
+    }
+    case ChunkCodec::kDelta: {
+      if (!num_elems) {
+        return;
+      }
+      BitUnpacker unpacker(chunk.packed, chunk.bit_width);
+      const uint64_t delta_base = static_cast<uint64_t>(chunk.delta_base);
+      uint64_t val = static_cast<uint64_t>(chunk.base);
+      dst[0] = static_cast<T>(val);
+      for (size_t i = 1; i < num_elems; ++i) {
+        val += delta_base + unpacker.next();
+        dst[i] = static_cast<T>(val);
+      }
+      break;
+    }
+    case ChunkCodec::kRunLength: {
+      size_t pos = 0;
+      for (size_t run = 0; pos < num_elems; ++run) {
+        CHECK_LT(run, chunk.run_values.size());
+        size_t end = std::min(static_cast<size_t>(chunk.run_ends[run]), num_elems);
+        std::fill(dst + pos, dst + end, static_cast<T>(chunk.run_values[run]));
+        pos = end;
+      }
+      break;
+    }
+  }
+}
+
+}  // anonymous namespace
+
+size_t CompressedChunk::memoryUsage() const {
+  return packed.size() * sizeof(uint64_t) + run_values.size() * sizeof(int64_t) +
+         run_ends.size() * sizeof(uint32_t);
+}
+
+std::string toString(ChunkCodec codec) {
+  switch (codec) {
+    case ChunkCodec::kFrameOfReference:
+      return "FOR";
+    case ChunkCodec::kDelta:
+      return "DELTA";
+    case ChunkCodec::kRunLength:
+      return "RLE";
+  }
+  return "UNKNOWN";
+}
+
+bool isCompressibleType(const SQLTypeInfo& type) {
+  if (type.is_array() || type.is_varlen()) {
+    return false;
+  }
+  return type.is_integer() || type.is_decimal() || type.is_time() ||
+         type.is_dict_encoded_string();
+}
+
+std::unique_ptr<CompressedChunk> compressChunk(std::shared_ptr<arrow::ChunkedArray> data,
+                                               const SQLTypeInfo& type,
+                                               bool has_nulls) {
+  CHECK(isCompressibleType(type));
+  switch (type.get_size()) {
+    case 1:
+      return compressChunkImpl<int8_t>(data, has_nulls);
+    case 2:
+      return compressChunkImpl<int16_t>(data, has_nulls);
+    case 4:
+      return compressChunkImpl<int32_t>(data, has_nulls);
+    case 8:
+      return compressChunkImpl<int64_t>(data, has_nulls);
+    default:
+      CHECK(false) << "Unexpected element size: " << type.get_size();
+  }
+  return nullptr;
+}
+
+void decompressChunk(const CompressedChunk& chunk, size_t num_elems, int8_t* dst) {
+  CHECK_LE(num_elems, chunk.num_elems);
+  switch (chunk.elem_size) {
+    case 1:
+      decompressChunkImpl(chunk, num_elems, dst);
+      break;
+    case 2:
+      decompressChunkImpl(chunk, num_elems, reinterpret_cast<int16_t*>(dst));
+      break;
+    case 4:
+      decompressChunkImpl(chunk, num_elems, reinterpret_cast<int32_t*>(dst));
+      break;
+    case 8:
+      decompressChunkImpl(chunk, num_elems, reinterpret_cast<int64_t*>(dst));
+      break;
+    default:
+      CHECK(false) << "Unexpected element size: " << chunk.elem_size;
+  }
+}
+
+std::shared_ptr<arrow::Buffer> getDecodedChunk(const CompressedChunk& chunk) {
+  std::lock_guard<std::mutex> lock(chunk.decoded_mutex);
+  auto res = chunk.decoded.lock();
+  if (!res) {
+    auto buf_res = arrow::AllocateBuffer(chunk.num_elems * chunk.elem_size);
+    ARROW_THROW_NOT_OK(buf_res.status());
+    res = std::move(buf_res).ValueOrDie();
+    decompressChunk(
+        chunk, chunk.num_elems, reinterpret_cast<int8_t*>(res->mutable_data()));
+    chunk.decoded = res;
+  }
+  return res;
+}
@@ -0,0 +1,76 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Shared/sqltypes.h"
+
+#include <arrow/api.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Lightweight codecs for fixed-width integer chunks stored in ArrowStorage.
+ *
+ *  - kFrameOfReference: values are stored as bit-packed offsets from the chunk's
+ *    min value. The max code is reserved for nulls when the chunk has them.
+ *  - kDelta: values are stored as bit-packed differences between consecutive
+ *    values, shifted by the min difference. Used for chunks with no nulls.
+ *  - kRunLength: runs of equal values are stored as (value, run end) pairs.
+ *
+ * All arithmetic is done modulo 2^64, so any input is encoded losslessly.
+ */
+enum class ChunkCodec { kFrameOfReference, kDelta, kRunLength };
+
+struct CompressedChunk {
+  ChunkCodec codec;
+  size_t elem_size;
+  size_t num_elems;
+  // Min value for kFrameOfReference, first value for kDelta.
+  int64_t base = 0;
+  // Min difference between consecutive values for kDelta.
+  int64_t delta_base = 0;
+  int bit_width = 0;
+  bool has_null_code = false;
+  uint64_t null_code = 0;
+  int64_t null_value = 0;
+  std::vector<uint64_t> packed;
+  std::vector<int64_t> run_values;
+  std::vector<uint32_t> run_ends;
+  // Decoded data shared by all readers of the chunk. It is kept only while
+  // referenced, so cold chunks hold nothing but the compressed data.
+  mutable std::mutex decoded_mutex;
+  mutable std::weak_ptr<arrow::Buffer> decoded;
+
+  size_t memoryUsage() const;
+};
+
+std::string toString(ChunkCodec codec);
+
+bool isCompressibleType(const SQLTypeInfo& type);
+
+// Choose the most compact codec for the chunk. Return nullptr when no codec
+// saves at least a quarter of the raw chunk size.
+std::unique_ptr<CompressedChunk> compressChunk(std::shared_ptr<arrow::ChunkedArray> data,
+                                               const SQLTypeInfo& type,
+                                               bool has_nulls);
+
+// Decode the first num_elems values of the chunk into dst.
+void decompressChunk(const CompressedChunk& chunk, size_t num_elems, int8_t* dst);
+
+// Return decoded data of the whole chunk. The chunk is decoded only when no
+// previously decoded buffer is alive.
+std::shared_ptr<arrow::Buffer> getDecodedChunk(const CompressedChunk& chunk);
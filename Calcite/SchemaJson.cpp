@@ -62,14 +62,16 @@ std::string schema_to_json(SchemaProviderPtr schema_provider) {
       column.AddMember("is_notnull",
                        rapidjson::Value().SetBool(col_info->type.get_notnull()),
                        doc.GetAllocator());
-      column.AddMember("is_systemcol",
-                       rapidjson::Value().SetBool(col_info->is_rowid),
-                       doc.GetAllocator());
+      column.AddMember(
+          "is_systemcol",
+          rapidjson::Value().SetBool(col_info->is_rowid || col_info->is_delete),
+          doc.GetAllocator());
       column.AddMember("is_virtualcol",
                        rapidjson::Value().SetBool(col_info->is_rowid),
                        doc.GetAllocator());
-      column.AddMember(
-          "is_deletedcol", rapidjson::Value().SetBool(false), doc.GetAllocator());
+      column.AddMember("is_deletedcol",
+                       rapidjson::Value().SetBool(col_info->is_delete),
+                       doc.GetAllocator());
       table["columns"].PushBack(column, doc.GetAllocator());
     }
     doc.AddMember(rapidjson::StringRef(tinfo->name), table, doc.GetAllocator());
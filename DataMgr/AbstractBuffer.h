@@ -22,6 +22,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #ifdef BUFFER_MUTEX
 #include <boost/thread/locks.hpp>
@@ -50,6 +51,9 @@ class AbstractDataToken {
 
   virtual const int8_t* getMemoryPtr() const = 0;
   virtual size_t getSize() const = 0;
+  // Varlen data buffers require an encoder. Tokens for such buffers
+  // provide a type to initialize it with.
+  virtual std::optional<SQLTypeInfo> getEncoderType() const { return std::nullopt; }
 };
 
 class AbstractBuffer {
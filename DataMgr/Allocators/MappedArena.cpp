@@ -0,0 +1,126 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/Allocators/MappedArena.h"
+
+#include "Logger/Logger.h"
+#include "Shared/numa_utils.h"
+
+#include <sys/mman.h>
+
+#include <new>
+#include <stdexcept>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+namespace {
+
+size_t hugePageSize(HugePages huge_pages) {
+  switch (huge_pages) {
+    case HugePages::k2MB:
+      return 1ULL << 21;
+    case HugePages::k1GB:
+      return 1ULL << 30;
+    default:
+      return 0;
+  }
+}
+
+int hugePageShift(HugePages huge_pages) {
+  return huge_pages == HugePages::k1GB ? 30 : 21;
+}
+
+void adviseHugePages(void* ptr, size_t size) {
+#ifdef MADV_HUGEPAGE
+  if (madvise(ptr, size, MADV_HUGEPAGE)) {
+    VLOG(1) << "Transparent huge pages are not available for " << size << " bytes";
+  }
+#endif
+}
+
+}  // namespace
+
+HugePages parseHugePages(const std::string& mode) {
+  if (mode == "none") {
+    return HugePages::kNone;
+  }
+  if (mode == "thp") {
+    return HugePages::kTransparent;
+  }
+  if (mode == "2mb") {
+    return HugePages::k2MB;
+  }
+  if (mode == "1gb") {
+    return HugePages::k1GB;
+  }
+  throw std::runtime_error("Unknown huge pages mode: '" + mode +
+                           "'. Expected one of: none, thp, 2mb, 1gb.");
+}
+
+MappedArena::MappedArena(HugePages huge_pages) : huge_pages_(huge_pages) {}
+
+MappedArena::~MappedArena() {
+  for (auto [ptr, size] : mappings_) {
+    munmap(ptr, size);
+  }
+}
+
+void* MappedArena::allocate(size_t num_bytes) {
+  return allocateOnNode(num_bytes, -1);
+}
+
+void* MappedArena::allocateOnNode(size_t num_bytes, int node) {
+  void* ptr = MAP_FAILED;
+  size_t mapped_size = num_bytes;
+  auto page_size = hugePageSize(huge_pages_);
+#ifdef MAP_HUGETLB
+  if (page_size) {
+    mapped_size = (num_bytes + page_size - 1) / page_size * page_size;
+    ptr = mmap(nullptr,
+               mapped_size,
+               PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                   (hugePageShift(huge_pages_) << MAP_HUGE_SHIFT),
+               -1,
+               0);
+    if (ptr == MAP_FAILED) {
+      LOG(WARNING) << "Cannot map " << mapped_size << " bytes with " << page_size
+                   << " bytes huge pages, falling back to transparent huge pages.";
+    }
+  }
+#endif
+  if (ptr == MAP_FAILED) {
+    mapped_size = num_bytes;
+    ptr = mmap(nullptr,
+               mapped_size,
+               PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS,
+               -1,
+               0);
+    if (ptr == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    if (huge_pages_ != HugePages::kNone) {
+      adviseHugePages(ptr, mapped_size);
+    }
+  }
+  if (node >= 0 && !numa::bindMemory(ptr, mapped_size, node)) {
+    VLOG(1) << "Cannot bind " << mapped_size << " bytes to NUMA node " << node;
+  }
+  mappings_.emplace_back(ptr, mapped_size);
+  size_ += mapped_size;
+  return ptr;
+}
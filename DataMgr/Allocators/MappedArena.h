@@ -0,0 +1,50 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "DataMgr/Allocators/ArenaAllocator.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class HugePages { kNone, kTransparent, k2MB, k1GB };
+
+// Parse huge pages mode from one of "none", "thp", "2mb" or "1gb".
+HugePages parseHugePages(const std::string& mode);
+
+/**
+ * Arena mapping each allocation directly from the OS. Mappings can be backed by
+ * explicit (hugetlbfs) or transparent huge pages to reduce TLB misses on scans
+ * over large slabs, and can be bound to a NUMA node. When explicit huge pages
+ * are not reserved in the system, transparent huge pages are requested instead.
+ */
+class MappedArena : public Arena {
+ public:
+  explicit MappedArena(HugePages huge_pages);
+  ~MappedArena() override;
+
+  void* allocate(size_t num_bytes) override;
+  // Allocate memory with physical pages placed on the node. Negative node means
+  // the default OS placement.
+  void* allocateOnNode(size_t num_bytes, int node);
+
+  size_t bytesUsed() const override { return size_; }
+
+ private:
+  HugePages huge_pages_;
+  size_t size_ = 0;
+  std::vector<std::pair<void*, size_t>> mappings_;
+};
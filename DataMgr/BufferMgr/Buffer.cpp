@@ -60,6 +60,9 @@ Buffer::Buffer(BufferMgr* bm,
   pin();
   seg_it_->buffer = this;
   setSize(token_->getSize());
+  if (auto encoder_type = token_->getEncoderType()) {
+    initEncoder(*encoder_type);
+  }
 }
 
 Buffer::~Buffer() {}
@@ -31,6 +31,8 @@
 
 using namespace std;
 
+extern std::string g_buffer_eviction_policy;
+
 namespace Buffer_Namespace {
 
 std::string BufferMgr::keyToString(const ChunkKey& key) {
@@ -59,7 +61,11 @@ BufferMgr::BufferMgr(const int device_id,
     , allocations_capped_(false)
     , parent_mgr_(parent_mgr)
     , max_buffer_id_(0)
-    , buffer_epoch_(0) {
+    , buffer_epoch_(0)
+    , eviction_policy_(makeEvictionPolicy(g_buffer_eviction_policy))
+    , num_hits_(0)
+    , num_misses_(0)
+    , num_evictions_(0) {
   CHECK(max_buffer_pool_size_ > 0);
   CHECK(page_size_ > 0);
   // TODO change checks on run-time configurable slab size variables to exceptions
@@ -103,6 +109,7 @@ void BufferMgr::clear() {
   slabs_.clear();
   slab_segments_.clear();
   unsized_segs_.clear();
+  eviction_index_.clear();
   buffer_epoch_ = 0;
 }
 
@@ -178,6 +185,10 @@ BufferList::iterator BufferMgr::evict(BufferList::iterator& evict_start,
       CHECK(evict_it->buffer->getPinCount() < 1);
     }
     num_pages += evict_it->num_pages;
+    if (evict_it->mem_status == USED) {
+      removeFromEvictionIndex(evict_it);
+      ++num_evictions_;
+    }
     if (evict_it->mem_status == USED && evict_it->chunk_key.size() > 0) {
       chunk_index_.erase(evict_it->chunk_key);
     }
@@ -190,12 +201,13 @@ BufferList::iterator BufferMgr::evict(BufferList::iterator& evict_start,
         evict_it);  // erase operations returns next iterator - safe if we ever move
                     // to a vector (as opposed to erase(evict_it++)
   }
-  BufferSeg data_seg(
-      start_page, num_pages_requested, USED, buffer_epoch_++);  // until we can
+  BufferSeg data_seg(start_page, num_pages_requested, USED);
+  eviction_policy_->init(data_seg, buffer_epoch_++);
   // data_seg.pinCount++;
   data_seg.slab_num = slab_num;
   auto data_seg_it =
       slab_segments_[slab_num].insert(evict_it, data_seg);  // Will insert before evict_it
+  addToEvictionIndex(data_seg_it);
   if (num_pages_requested < num_pages) {
     size_t excess_pages = num_pages - num_pages_requested;
     if (evict_it != slab_segments_[slab_num].end() &&
@@ -275,8 +287,9 @@ BufferList::iterator BufferMgr::findFreeBufferInSlab(const size_t slab_num,
       size_t excess_pages = buffer_it->num_pages - num_pages_requested;
       buffer_it->num_pages = num_pages_requested;
       buffer_it->mem_status = USED;
-      buffer_it->last_touched = buffer_epoch_++;
+      eviction_policy_->init(*buffer_it, buffer_epoch_++);
       buffer_it->slab_num = slab_num;
+      addToEvictionIndex(buffer_it);
       if (excess_pages > 0) {
         BufferSeg free_seg(
             buffer_it->start_page + num_pages_requested, excess_pages, FREE);
@@ -302,6 +315,9 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
   size_t num_slabs = slab_segments_.size();
 
   for (size_t slab_num = 0; slab_num != num_slabs; ++slab_num) {
+    if (!isPreferredSlab(slab_num)) {
+      continue;
+    }
     auto seg_it = findFreeBufferInSlab(slab_num, num_pages_requested);
     if (seg_it != slab_segments_[slab_num].end()) {
       return seg_it;
@@ -363,69 +379,20 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
     throw FailedToCreateFirstSlab(num_bytes);
   }
 
-  // If here then we can't add a slab - so we need to evict
-
-  size_t min_score = std::numeric_limits<size_t>::max();
-  // We're going for lowest score here, like golf
-  // This is because score is the sum of the lastTouched score for all pages evicted.
-  // Evicting fewer pages and older pages will lower the score
-  BufferList::iterator best_eviction_start = slab_segments_[0].end();
-  int best_eviction_start_slab = -1;
-  int slab_num = 0;
-
-  for (auto slab_it = slab_segments_.begin(); slab_it != slab_segments_.end();
-       ++slab_it, ++slab_num) {
-    for (auto buffer_it = slab_it->begin(); buffer_it != slab_it->end(); ++buffer_it) {
-      // Note there are some shortcuts we could take here - like we should never consider
-      // a USED buffer coming after a free buffer as we would have used the FREE buffer,
-      // but we won't worry about this for now
-
-      // We can't evict pinned buffers - only normal usedbuffers
-
-      // if (buffer_it->mem_status == FREE || buffer_it->buffer->getPinCount() == 0) {
-      size_t page_count = 0;
-      size_t score = 0;
-      bool solution_found = false;
-      auto evict_it = buffer_it;
-      for (; evict_it != slab_segments_[slab_num].end(); ++evict_it) {
-        // pinCount should never go up - only down because we have
-        // global lock on buffer pool and pin count only increments
-        // on getChunk
-        if (evict_it->mem_status == USED && evict_it->buffer->getPinCount() > 0) {
-          break;
-        }
-        page_count += evict_it->num_pages;
-        if (evict_it->mem_status == USED) {
-          // MAT changed from
-          // score += evictIt->lastTouched;
-          // Issue was thrashing when going from 8M fragment size chunks back to 64M
-          // basically the large chunks were being evicted prior to small as many small
-          // chunk score was larger than one large chunk so it always would evict a large
-          // chunk so under memory pressure a query would evict its own current chunks and
-          // cause reloads rather than evict several smaller unused older chunks.
-          score = std::max(score, static_cast<size_t>(evict_it->last_touched));
-        }
-        if (page_count >= num_pages_requested) {
-          solution_found = true;
-          break;
-        }
-      }
-      if (solution_found && score < min_score) {
-        min_score = score;
-        best_eviction_start = buffer_it;
-        best_eviction_start_slab = slab_num;
-      } else if (evict_it == slab_segments_[slab_num].end()) {
-        // this means that every segment after this will fail as well, so our search has
-        // proven futile
-        // throw std::runtime_error ("Couldn't evict chunks to get free space");
-        break;
-        // in reality we should try to rearrange the buffer to get more contiguous free
-        // space
-      }
-      // other possibility is ending at PINNED - do nothing in this case
-      //}
+  // Free space in other slabs is still better than eviction.
+  for (size_t slab_num = 0; slab_num != num_slabs; ++slab_num) {
+    if (isPreferredSlab(slab_num)) {
+      continue;
+    }
+    auto seg_it = findFreeBufferInSlab(slab_num, num_pages_requested);
+    if (seg_it != slab_segments_[slab_num].end()) {
+      return seg_it;
     }
   }
+
+  // If here then we can't add a slab - so we need to evict
+  auto [best_eviction_start, best_eviction_start_slab] =
+      findEvictionRange(num_pages_requested);
   if (best_eviction_start == slab_segments_[0].end()) {
     LOG(ERROR) << "ALLOCATION failed to find " << num_bytes << "B throwing out of memory "
                << getStringMgrType() << ":" << device_id_;
@@ -442,6 +409,62 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
   return best_eviction_start;
 }
 
+std::pair<BufferList::iterator, int> BufferMgr::findEvictionRange(
+    size_t num_pages_requested) {
+  for (auto& [key, seg_it] : eviction_index_) {
+    // pinCount should never go up - only down because we have
+    // global lock on buffer pool and pin count only increments
+    // on getChunk
+    if (seg_it->buffer->getPinCount() > 0) {
+      continue;
+    }
+
+    auto max_score = key.first;
+    auto can_evict = [this, max_score](BufferList::iterator it) {
+      return it->mem_status == FREE || (it->buffer->getPinCount() == 0 &&
+                                        eviction_policy_->getScore(*it) <= max_score);
+    };
+
+    auto& segs = slab_segments_[seg_it->slab_num];
+    size_t page_count = seg_it->num_pages;
+    auto start_it = seg_it;
+    while (page_count < num_pages_requested && start_it != segs.begin() &&
+           can_evict(std::prev(start_it))) {
+      --start_it;
+      page_count += start_it->num_pages;
+    }
+    for (auto end_it = std::next(seg_it);
+         page_count < num_pages_requested && end_it != segs.end() && can_evict(end_it);
+         ++end_it) {
+      page_count += end_it->num_pages;
+    }
+
+    if (page_count >= num_pages_requested) {
+      return {start_it, seg_it->slab_num};
+    }
+  }
+  return {slab_segments_[0].end(), -1};
+}
+
+void BufferMgr::addToEvictionIndex(BufferList::iterator seg_it) {
+  if (seg_it->slab_num >= 0 && seg_it->mem_status == USED) {
+    eviction_index_.emplace(std::make_pair(eviction_policy_->getScore(*seg_it), &*seg_it),
+                            seg_it);
+  }
+}
+
+void BufferMgr::removeFromEvictionIndex(BufferList::iterator seg_it) {
+  if (seg_it->slab_num >= 0 && seg_it->mem_status == USED) {
+    eviction_index_.erase(std::make_pair(eviction_policy_->getScore(*seg_it), &*seg_it));
+  }
+}
+
+void BufferMgr::touchSegment(BufferList::iterator seg_it) {
+  removeFromEvictionIndex(seg_it);
+  eviction_policy_->touch(*seg_it, buffer_epoch_++);
+  addToEvictionIndex(seg_it);
+}
+
 std::string BufferMgr::printSlab(size_t slab_num) {
   std::ostringstream tss;
   // size_t lastEnd = 0;
@@ -670,6 +693,7 @@ void BufferMgr::removeSegment(BufferList::iterator& seg_it) {
     std::lock_guard<std::mutex> unsized_segs_lock(unsized_segs_mutex_);
     unsized_segs_.erase(seg_it);
   } else {
+    removeFromEvictionIndex(seg_it);
     if (seg_it != slab_segments_[slab_num].begin()) {
       auto prev_it = std::prev(seg_it);
       // LOG(INFO) << "PrevIt: " << " " << getStringMgrType() << ":" << device_id_;
@@ -749,9 +773,9 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes
   if (found_buffer) {
     CHECK(buffer_it->second->buffer);
     buffer_it->second->buffer->pin();
+    touchSegment(buffer_it->second);
     sized_segs_lock.unlock();
-
-    buffer_it->second->last_touched = buffer_epoch_++;  // race
+    ++num_hits_;
 
     if (buffer_it->second->buffer->size() < num_bytes) {
       // need to fetch part of buffer we don't have - up to numBytes
@@ -760,6 +784,7 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes
     return buffer_it->second->buffer;
   } else {  // If wasn't in pool then we need to fetch it
     sized_segs_lock.unlock();
+    ++num_misses_;
     // Check if we can zero-copy fetch requested chunk.
     if (auto token = getZeroCopyBufferMemory(key, num_bytes)) {
       return createZeroCopyBuffer(key, std::move(token));
@@ -790,6 +815,7 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
   AbstractBuffer* buffer;
   if (!found_buffer) {
     sized_segs_lock.unlock();
+    ++num_misses_;
     CHECK(parent_mgr_ != 0);
     buffer = createBuffer(key, page_size_, num_bytes);  // will pin buffer
     try {
@@ -800,6 +826,8 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
   } else {
     buffer = buffer_it->second->buffer;
     buffer->pin();
+    touchSegment(buffer_it->second);
+    ++num_hits_;
     if (num_bytes > buffer->size()) {
       try {
         parent_mgr_->fetchBuffer(key, buffer, num_bytes);
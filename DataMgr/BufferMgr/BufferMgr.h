@@ -26,6 +26,7 @@
 
 #define BOOST_STACKTRACE_GNU_SOURCE_NOT_REQUIRED 1
 
+#include <atomic>
 #include <iostream>
 #include <list>
 #include <map>
@@ -34,6 +35,7 @@
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/AbstractBufferMgr.h"
 #include "DataMgr/BufferMgr/BufferSeg.h"
+#include "DataMgr/BufferMgr/EvictionPolicy.h"
 #include "Shared/boost_stacktrace.hpp"
 #include "Shared/types.h"
 
@@ -125,6 +127,11 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   bool isAllocationCapped() override;
   const std::vector<BufferList>& getSlabSegments();
 
+  std::string getEvictionPolicyName() const { return eviction_policy_->getName(); }
+  size_t getNumHits() const { return num_hits_; }
+  size_t getNumMisses() const { return num_misses_; }
+  size_t getNumEvictions() const { return num_evictions_; }
+
   /// Creates a chunk with the specified key and page size.
   AbstractBuffer* createBuffer(const ChunkKey& key,
                                const size_t page_size = 0,
@@ -204,6 +211,9 @@ class BufferMgr : public AbstractBufferMgr {  // implements
                                             const size_t num_pages_requested);
   int getBufferId();
   virtual void addSlab(const size_t slab_size) = 0;
+  // Slabs which are not preferred are used for new buffers only when no new
+  // slab can be added.
+  virtual bool isPreferredSlab(size_t slab_num) const { return true; }
   virtual void freeAllMem() = 0;
   virtual void allocateBuffer(BufferList::iterator seg_it,
                               const size_t page_size,
@@ -236,6 +246,34 @@ class BufferMgr : public AbstractBufferMgr {  // implements
 
   BufferList unsized_segs_;
 
+  std::unique_ptr<EvictionPolicy> eviction_policy_;
+  // Used slab segments ordered by their eviction scores. Protected by the same
+  // locks as slab_segments_.
+  std::map<std::pair<uint64_t, const BufferSeg*>, BufferList::iterator> eviction_index_;
+
+  std::atomic<size_t> num_hits_;
+  std::atomic<size_t> num_misses_;
+  std::atomic<size_t> num_evictions_;
+
+  void addToEvictionIndex(BufferList::iterator seg_it);
+  void removeFromEvictionIndex(BufferList::iterator seg_it);
+  void touchSegment(BufferList::iterator seg_it);
+  /**
+   * @brief Finds a contiguous range of segments to evict
+   *
+   * Candidates are checked in the order of their scores. A range is built
+   * around a candidate from free and unpinned segments with scores not greater
+   * than the candidate's one. Thus, the first found range has the minimal max
+   * score of evicted segments. Usually, only a few candidates are checked.
+   *
+   * Max score is used instead of a sum of scores to avoid evicting a large chunk
+   * in favor of several smaller but older chunks.
+   *
+   * @return Start of the found range and its slab number or slab_segments_[0].end()
+   * if there is no suitable range.
+   */
+  std::pair<BufferList::iterator, int> findEvictionRange(size_t num_pages_requested);
+
   BufferList::iterator evict(BufferList::iterator& evict_start,
                              const size_t num_pages_requested,
                              const int slab_num);
@@ -18,23 +18,46 @@
 
 #include "DataMgr/Allocators/ArenaAllocator.h"
 #include "DataMgr/BufferMgr/CpuBufferMgr/CpuBuffer.h"
+#include "Shared/numa_utils.h"
+
+extern std::string g_cpu_buffer_huge_pages;
+extern bool g_enable_numa_aware_buffers;
 
 namespace Buffer_Namespace {
 
 void CpuBufferMgr::addSlab(const size_t slab_size) {
   CHECK(allocator_);
+  // Place the slab on the node of the requesting thread. Without a preference
+  // spread slabs over nodes to balance memory bandwidth.
+  int node = -1;
+  int node_count = numa::getNodeCount();
+  if (mapped_allocator_ && g_enable_numa_aware_buffers && node_count > 1) {
+    node = numa::getPreferredNode();
+    node = node >= 0 ? node % node_count : static_cast<int>(slabs_.size() % node_count);
+  }
   slabs_.resize(slabs_.size() + 1);
   try {
-    slabs_.back() = reinterpret_cast<int8_t*>(allocator_->allocate(slab_size));
+    slabs_.back() = reinterpret_cast<int8_t*>(
+        mapped_allocator_ ? mapped_allocator_->allocateOnNode(slab_size, node)
+                          : allocator_->allocate(slab_size));
   } catch (std::bad_alloc&) {
     slabs_.resize(slabs_.size() - 1);
     throw FailedToCreateSlab(slab_size);
   }
+  slab_nodes_.push_back(node);
   slab_segments_.resize(slab_segments_.size() + 1);
   slab_segments_[slab_segments_.size() - 1].push_back(
       BufferSeg(0, slab_size / page_size_));
 }
 
+bool CpuBufferMgr::isPreferredSlab(size_t slab_num) const {
+  int node = numa::getPreferredNode();
+  if (node < 0 || slab_num >= slab_nodes_.size() || slab_nodes_[slab_num] < 0) {
+    return true;
+  }
+  return slab_nodes_[slab_num] == node % numa::getNodeCount();
+}
+
 void CpuBufferMgr::freeAllMem() {
   CHECK(allocator_);
   initializeMem();
@@ -62,7 +85,16 @@ AbstractBuffer* CpuBufferMgr::allocateZeroCopyBuffer(
 }
 
 void CpuBufferMgr::initializeMem() {
-  allocator_.reset(new Arena(max_slab_size_ + kArenaBlockOverhead));
+  auto huge_pages = parseHugePages(g_cpu_buffer_huge_pages);
+  slab_nodes_.clear();
+  if (huge_pages != HugePages::kNone || g_enable_numa_aware_buffers) {
+    auto arena = std::make_unique<MappedArena>(huge_pages);
+    mapped_allocator_ = arena.get();
+    allocator_ = std::move(arena);
+  } else {
+    mapped_allocator_ = nullptr;
+    allocator_.reset(new Arena(max_slab_size_ + kArenaBlockOverhead));
+  }
 }
 
 }  // namespace Buffer_Namespace
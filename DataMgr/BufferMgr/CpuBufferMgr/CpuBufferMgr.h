@@ -19,6 +19,7 @@
 #include "DataMgr/BufferMgr/BufferMgr.h"
 
 #include "DataMgr/Allocators/ArenaAllocator.h"
+#include "DataMgr/Allocators/MappedArena.h"
 
 namespace Buffer_Namespace {
 
@@ -55,6 +56,7 @@ class CpuBufferMgr : public BufferMgr {
 
  protected:
   void addSlab(const size_t slab_size) override;
+  bool isPreferredSlab(size_t slab_num) const override;
   void freeAllMem() override;
   void allocateBuffer(BufferList::iterator segment_iter,
                       const size_t page_size,
@@ -65,6 +67,11 @@ class CpuBufferMgr : public BufferMgr {
 
  private:
   std::unique_ptr<Arena> allocator_;
+  // Set when slabs are mapped directly from the OS and can be placed on NUMA
+  // nodes. Points to allocator_.
+  MappedArena* mapped_allocator_ = nullptr;
+  // NUMA node of each slab or -1 for the default placement.
+  std::vector<int> slab_nodes_;
 };
 
 }  // namespace Buffer_Namespace
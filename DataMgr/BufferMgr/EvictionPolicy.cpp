@@ -0,0 +1,59 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/BufferMgr/EvictionPolicy.h"
+
+#include <stdexcept>
+
+namespace Buffer_Namespace {
+
+void EvictionPolicy::init(BufferSeg& seg, unsigned int epoch) const {
+  seg.last_touched = epoch;
+}
+
+void EvictionPolicy::touch(BufferSeg& seg, unsigned int epoch) const {
+  seg.last_touched = epoch;
+}
+
+uint64_t LruEvictionPolicy::getScore(const BufferSeg& seg) const {
+  return seg.last_touched;
+}
+
+void Lru2EvictionPolicy::init(BufferSeg& seg, unsigned int epoch) const {
+  EvictionPolicy::init(seg, epoch);
+  seg.prev_touched = 0;
+}
+
+void Lru2EvictionPolicy::touch(BufferSeg& seg, unsigned int epoch) const {
+  seg.prev_touched = seg.last_touched + 1;
+  EvictionPolicy::touch(seg, epoch);
+}
+
+uint64_t Lru2EvictionPolicy::getScore(const BufferSeg& seg) const {
+  // Zero prev_touched means a single access. Such segments go first and
+  // are ordered by the last access.
+  return (static_cast<uint64_t>(seg.prev_touched) << 32) | seg.last_touched;
+}
+
+std::unique_ptr<EvictionPolicy> makeEvictionPolicy(const std::string& name) {
+  if (name == "lru") {
+    return std::make_unique<LruEvictionPolicy>();
+  }
+  if (name == "lru2") {
+    return std::make_unique<Lru2EvictionPolicy>();
+  }
+  throw std::runtime_error("Unknown buffer eviction policy: " + name);
+}
+
+}  // namespace Buffer_Namespace
@@ -0,0 +1,69 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    EvictionPolicy.h
+ * @brief   Policies used by BufferMgr to choose buffers for eviction.
+ */
+#pragma once
+
+#include "DataMgr/BufferMgr/BufferSeg.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Buffer_Namespace {
+
+/**
+ * @class   EvictionPolicy
+ * @brief   Maintains access history of used buffer segments and scores them.
+ *
+ * Every segment records its last access, policies which score by a longer
+ * history record it as well. Segments with lower scores are evicted first. The
+ * score of a segment can change only when the segment is touched.
+ */
+class EvictionPolicy {
+ public:
+  virtual ~EvictionPolicy() = default;
+
+  virtual std::string getName() const = 0;
+  /// Resets access history of a newly allocated segment.
+  virtual void init(BufferSeg& seg, unsigned int epoch) const;
+  /// Records an access to an already allocated segment.
+  virtual void touch(BufferSeg& seg, unsigned int epoch) const;
+  virtual uint64_t getScore(const BufferSeg& seg) const = 0;
+};
+
+/// Evicts least recently used segments first.
+class LruEvictionPolicy : public EvictionPolicy {
+ public:
+  std::string getName() const override { return "lru"; }
+  uint64_t getScore(const BufferSeg& seg) const override;
+};
+
+/// LRU-2 policy. Segments are ordered by their penultimate access, so chunks
+/// touched once by a large scan are evicted before repeatedly used ones.
+class Lru2EvictionPolicy : public EvictionPolicy {
+ public:
+  std::string getName() const override { return "lru2"; }
+  void init(BufferSeg& seg, unsigned int epoch) const override;
+  void touch(BufferSeg& seg, unsigned int epoch) const override;
+  uint64_t getScore(const BufferSeg& seg) const override;
+};
+
+/// Throws std::runtime_error for unknown policy names.
+std::unique_ptr<EvictionPolicy> makeEvictionPolicy(const std::string& name);
+
+}  // namespace Buffer_Namespace
@@ -38,6 +38,9 @@
 
 bool g_enable_tiered_cpu_mem{false};
 size_t g_pmem_size{0};
+std::string g_buffer_eviction_policy{"lru"};
+std::string g_cpu_buffer_huge_pages{"none"};
+bool g_enable_numa_aware_buffers{false};
 
 namespace Data_Namespace {
 
@@ -327,6 +330,10 @@ std::vector<MemoryInfo> DataMgr::getMemoryInfo(const MemoryLevel memLevel) {
     mi.maxNumPages = cpu_buffer->getMaxSize() / mi.pageSize;
     mi.isAllocationCapped = cpu_buffer->isAllocationCapped();
     mi.numPageAllocated = cpu_buffer->getAllocated() / mi.pageSize;
+    mi.evictionPolicy = cpu_buffer->getEvictionPolicyName();
+    mi.numHits = cpu_buffer->getNumHits();
+    mi.numMisses = cpu_buffer->getNumMisses();
+    mi.numEvictions = cpu_buffer->getNumEvictions();
 
     const auto& slab_segments = cpu_buffer->getSlabSegments();
     for (size_t slab_num = 0; slab_num < slab_segments.size(); ++slab_num) {
@@ -356,6 +363,10 @@ std::vector<MemoryInfo> DataMgr::getMemoryInfo(const MemoryLevel memLevel) {
       mi.maxNumPages = gpu_buffer->getMaxSize() / mi.pageSize;
       mi.isAllocationCapped = gpu_buffer->isAllocationCapped();
       mi.numPageAllocated = gpu_buffer->getAllocated() / mi.pageSize;
+      mi.evictionPolicy = gpu_buffer->getEvictionPolicyName();
+      mi.numHits = gpu_buffer->getNumHits();
+      mi.numMisses = gpu_buffer->getNumMisses();
+      mi.numEvictions = gpu_buffer->getNumEvictions();
 
       const auto& slab_segments = gpu_buffer->getSlabSegments();
       for (size_t slab_num = 0; slab_num < slab_segments.size(); ++slab_num) {
@@ -598,6 +609,12 @@ PersistentStorageMgr* DataMgr::getPersistentStorageMgr() const {
   return dynamic_cast<PersistentStorageMgr*>(bufferMgrs_[0][0]);
 }
 
+size_t DataMgr::getBufferPoolSize(const MemoryLevel memLevel, const int deviceId) const {
+  CHECK_LT(static_cast<size_t>(memLevel), bufferMgrs_.size());
+  CHECK_LT(static_cast<size_t>(deviceId), bufferMgrs_[memLevel].size());
+  return bufferMgrs_[memLevel][deviceId]->getMaxSize();
+}
+
 Buffer_Namespace::CpuBufferMgr* DataMgr::getCpuBufferMgr() const {
   return dynamic_cast<Buffer_Namespace::CpuBufferMgr*>(bufferMgrs_[1][0]);
 }
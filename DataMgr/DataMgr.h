@@ -71,6 +71,10 @@ struct MemoryInfo {
   size_t maxNumPages;
   size_t numPageAllocated;
   bool isAllocationCapped;
+  std::string evictionPolicy;
+  size_t numHits;
+  size_t numMisses;
+  size_t numEvictions;
   std::vector<MemoryData> nodeMemoryData;
 };
 
@@ -197,6 +201,8 @@ class DataMgr {
                         const MemoryLevel memLevel,
                         const int deviceId);
   std::vector<MemoryInfo> getMemoryInfo(const MemoryLevel memLevel);
+  // Max size of the buffer pool of a device.
+  size_t getBufferPoolSize(const MemoryLevel memLevel, const int deviceId) const;
   std::string dumpLevel(const MemoryLevel memLevel);
   void clearMemory(const MemoryLevel memLevel);
 
@@ -0,0 +1,99 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/BackgroundCompiler.h"
+#include "Logger/Logger.h"
+
+#include <algorithm>
+
+bool g_enable_tiered_compilation{false};
+size_t g_background_compilation_threads{1};
+
+BackgroundCompiler::BackgroundCompiler(size_t num_threads, size_t max_pending_tasks)
+    : max_pending_tasks_(max_pending_tasks) {
+  num_threads = std::max(num_threads, size_t(1));
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back([this]() { worker(); });
+  }
+}
+
+BackgroundCompiler::~BackgroundCompiler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    // Pending tasks are dropped, running ones are finished.
+    for (const auto& task : tasks_) {
+      active_keys_.erase(task.first);
+    }
+    tasks_.clear();
+  }
+  task_cv_.notify_all();
+  done_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+BackgroundCompiler& BackgroundCompiler::get() {
+  static BackgroundCompiler compiler(g_background_compilation_threads, 64);
+  return compiler;
+}
+
+bool BackgroundCompiler::submit(const Key& key, Task task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_ || tasks_.size() >= max_pending_tasks_ || active_keys_.count(key)) {
+      return false;
+    }
+    active_keys_.insert(key);
+    tasks_.emplace_back(key, std::move(task));
+  }
+  task_cv_.notify_one();
+  return true;
+}
+
+void BackgroundCompiler::waitAll() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this]() { return active_keys_.empty(); });
+}
+
+size_t BackgroundCompiler::getPendingCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return tasks_.size();
+}
+
+void BackgroundCompiler::worker() {
+  while (true) {
+    std::pair<Key, Task> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    try {
+      task.second();
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Background compilation failed: " << e.what();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      active_keys_.erase(task.first);
+    }
+    done_cv_.notify_all();
+  }
+}
@@ -0,0 +1,72 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <boost/functional/hash.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+extern bool g_enable_tiered_compilation;
+extern size_t g_background_compilation_threads;
+
+/**
+ * Thread pool running compilation tasks off the query threads. Tasks are
+ * identified by the code cache key of the code they produce, a task is not
+ * scheduled while another one with the same key is pending or running. Tasks
+ * submitted when the queue is full are dropped, the code is compiled again on
+ * a later run of the query then.
+ */
+class BackgroundCompiler {
+ public:
+  using Key = std::vector<std::string>;
+  using Task = std::function<void()>;
+
+  BackgroundCompiler(size_t num_threads, size_t max_pending_tasks);
+  ~BackgroundCompiler();
+
+  BackgroundCompiler(const BackgroundCompiler&) = delete;
+  BackgroundCompiler& operator=(const BackgroundCompiler&) = delete;
+
+  // Compiler configured by --background-compilation-threads.
+  static BackgroundCompiler& get();
+
+  // Return false if the task was not scheduled.
+  bool submit(const Key& key, Task task);
+
+  // Wait until all the submitted tasks are finished.
+  void waitAll();
+
+  size_t getPendingCount() const;
+
+ private:
+  void worker();
+
+  const size_t max_pending_tasks_;
+  mutable std::mutex mutex_;
+  std::condition_variable task_cv_;
+  std::condition_variable done_cv_;
+  std::deque<std::pair<Key, Task>> tasks_;
+  // Keys of the pending and running tasks.
+  std::unordered_set<Key, boost::hash<Key>> active_keys_;
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+};
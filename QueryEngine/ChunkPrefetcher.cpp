@@ -0,0 +1,217 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/ChunkPrefetcher.h"
+#include "QueryEngine/Execute.h"
+#include "Shared/numa_utils.h"
+
+#include <limits>
+#include <optional>
+#include <set>
+#include <tuple>
+
+ChunkPrefetcher::ChunkPrefetcher(
+    Executor* executor,
+    const std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+    const std::vector<InputTableInfo>& query_infos,
+    size_t max_kernels_ahead,
+    size_t max_bytes)
+    : kernels_(kernels.size())
+    , max_kernels_ahead_(max_kernels_ahead)
+    , max_bytes_(max_bytes) {
+  auto schema_provider = executor->getSchemaProvider();
+  const auto& plan_state = *executor->plan_state_;
+  // By default, prefetched chunks may take a small share of the smallest buffer
+  // pool used by the kernels.
+  const bool auto_max_bytes = !max_bytes_;
+  if (auto_max_bytes) {
+    max_bytes_ = std::numeric_limits<size_t>::max();
+  }
+  // Chunks of inner tables are usually required by all kernels. Request each
+  // chunk for the first kernel using it only.
+  std::set<std::tuple<ChunkKey, Data_Namespace::MemoryLevel, int>> requested_chunks;
+  for (size_t kernel_idx = 0; kernel_idx < kernels.size(); ++kernel_idx) {
+    const auto& kernel = kernels[kernel_idx];
+    const auto& ra_exe_unit = kernel->ra_exe_unit_;
+    auto& kernel_chunks = kernels_[kernel_idx];
+    kernel_chunks.column_fetcher = &kernel->getColumnFetcher();
+    kernel_chunks.numa_node = kernel->getPreferredNumaNode();
+    kernel_chunks.device_id = kernel->getDeviceId();
+    const auto memory_level = kernel->getDeviceType() == ExecutorDeviceType::GPU
+                                  ? Data_Namespace::GPU_LEVEL
+                                  : Data_Namespace::CPU_LEVEL;
+    if (auto_max_bytes) {
+      max_bytes_ = std::min(
+          max_bytes_,
+          executor->getDataMgr()->getBufferPoolSize(memory_level,
+                                                    kernel_chunks.device_id) /
+              kDefaultBufferPoolShare);
+    }
+
+    std::map<int, const TableFragments*> all_tables_fragments;
+    QueryFragmentDescriptor::computeAllTablesFragments(
+        all_tables_fragments, ra_exe_unit, query_infos);
+
+    for (const auto& frags_per_table : kernel->getFragmentsList()) {
+      if (frags_per_table.table_id <= 0) {
+        continue;
+      }
+      // Fragments of streaming tables are re-fetched by kernels.
+      auto table_info =
+          schema_provider->getTableInfo(frags_per_table.db_id, frags_per_table.table_id);
+      if (!table_info || table_info->is_stream) {
+        continue;
+      }
+      auto fragments_it = all_tables_fragments.find(frags_per_table.table_id);
+      if (fragments_it == all_tables_fragments.end()) {
+        continue;
+      }
+      const auto& fragments = *fragments_it->second;
+      for (const auto& col_desc : ra_exe_unit.input_col_descs) {
+        if (col_desc->isVirtual() || col_desc->getTableId() != frags_per_table.table_id) {
+          continue;
+        }
+        // Lazily fetched columns are read for the output rows only.
+        if (plan_state.columns_to_not_fetch_.count(*col_desc)) {
+          continue;
+        }
+        // Kernels fetch columns which are not used by the generated code to CPU.
+        const auto col_memory_level = plan_state.columns_to_fetch_.count(*col_desc)
+                                          ? memory_level
+                                          : Data_Namespace::CPU_LEVEL;
+        auto col_info = col_desc->getColInfo();
+        for (auto frag_idx : frags_per_table.fragment_ids) {
+          CHECK_LT(frag_idx, fragments.size());
+          const auto& fragment = fragments[frag_idx];
+          if (fragment.isEmptyPhysicalFragment()) {
+            continue;
+          }
+          auto meta_it = fragment.getChunkMetadataMap().find(col_info->column_id);
+          if (meta_it == fragment.getChunkMetadataMap().end()) {
+            continue;
+          }
+          ChunkKey key{col_info->db_id,
+                       fragment.physicalTableId,
+                       col_info->column_id,
+                       fragment.fragmentId};
+          if (!requested_chunks
+                   .emplace(key,
+                            col_memory_level,
+                            col_memory_level == Data_Namespace::GPU_LEVEL
+                                ? kernel_chunks.device_id
+                                : 0)
+                   .second) {
+            continue;
+          }
+          kernel_chunks.requests.push_back({col_info, &fragment, col_memory_level});
+          kernel_chunks.num_bytes += meta_it->second->numBytes;
+        }
+      }
+    }
+  }
+
+  thread_ = std::thread([this]() { run(); });
+}
+
+ChunkPrefetcher::~ChunkPrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void ChunkPrefetcher::kernelStarted(size_t kernel_idx) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_LT(kernel_idx, kernels_.size());
+    kernels_[kernel_idx].state = KernelState::kStarted;
+    ++num_started_;
+  }
+  cv_.notify_all();
+}
+
+void ChunkPrefetcher::kernelFinished(size_t kernel_idx) {
+  std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_LT(kernel_idx, kernels_.size());
+    auto& kernel_chunks = kernels_[kernel_idx];
+    kernel_chunks.state = KernelState::kFinished;
+    if (!kernel_chunks.chunks.empty()) {
+      CHECK_GE(pinned_bytes_, kernel_chunks.num_bytes);
+      pinned_bytes_ -= kernel_chunks.num_bytes;
+      chunks.swap(kernel_chunks.chunks);
+    }
+  }
+  cv_.notify_all();
+  // Unpin chunks out of the lock.
+  chunks.clear();
+}
+
+void ChunkPrefetcher::run() {
+  for (size_t kernel_idx = 0; kernel_idx < kernels_.size(); ++kernel_idx) {
+    auto& kernel_chunks = kernels_[kernel_idx];
+    if (kernel_chunks.requests.empty() || kernel_chunks.num_bytes > max_bytes_) {
+      continue;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&]() {
+        return stop_ || kernel_chunks.state != KernelState::kPending ||
+               (kernel_idx < num_started_ + max_kernels_ahead_ &&
+                pinned_bytes_ + kernel_chunks.num_bytes <= max_bytes_);
+      });
+      if (stop_) {
+        return;
+      }
+      // Kernel is already fetching its data, no reason to prefetch it.
+      if (kernel_chunks.state != KernelState::kPending) {
+        continue;
+      }
+      pinned_bytes_ += kernel_chunks.num_bytes;
+    }
+
+    std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks;
+    // Fetch chunks into slabs local to the node which runs the kernel.
+    std::optional<numa::ScopedNodeBinding> numa_binding;
+    if (kernel_chunks.numa_node >= 0) {
+      numa_binding.emplace(kernel_chunks.numa_node);
+    }
+    try {
+      for (auto& req : kernel_chunks.requests) {
+        auto chunk = kernel_chunks.column_fetcher->prefetchOneTableColumnFragment(
+            req.col_info, *req.fragment, req.memory_level, kernel_chunks.device_id);
+        if (chunk) {
+          chunks.push_back(std::move(chunk));
+        }
+      }
+    } catch (const std::exception& e) {
+      // Prefetch is an optimization only, let kernels handle fetch errors.
+      LOG(WARNING) << "Chunk prefetch stopped: " << e.what();
+      std::lock_guard<std::mutex> lock(mutex_);
+      pinned_bytes_ -= kernel_chunks.num_bytes;
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (kernel_chunks.state == KernelState::kFinished) {
+      pinned_bytes_ -= kernel_chunks.num_bytes;
+    } else {
+      kernel_chunks.chunks = std::move(chunks);
+    }
+  }
+}
@@ -0,0 +1,78 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "QueryEngine/ExecutionKernel.h"
+
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+
+/**
+ * Loads chunks required by execution kernels into the buffer pools the kernels
+ * read them from ahead of kernels execution. Chunks are fetched by a background
+ * thread in the kernels launch order and are kept pinned until the corresponding
+ * kernel and all its sub-tasks are finished. The prefetch distance (in kernels)
+ * and the total size of pinned prefetched chunks are bounded. Zero max_bytes
+ * limits pinned chunks to 1/kDefaultBufferPoolShare of the smallest buffer pool
+ * used by the kernels. Lazily fetched columns are not prefetched.
+ */
+class ChunkPrefetcher {
+ public:
+  ChunkPrefetcher(Executor* executor,
+                  const std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+                  const std::vector<InputTableInfo>& query_infos,
+                  size_t max_kernels_ahead,
+                  size_t max_bytes);
+  ~ChunkPrefetcher();
+
+  static constexpr size_t kDefaultBufferPoolShare = 16;
+
+  void kernelStarted(size_t kernel_idx);
+  void kernelFinished(size_t kernel_idx);
+
+ private:
+  struct ChunkRequest {
+    ColumnInfoPtr col_info;
+    const FragmentInfo* fragment;
+    Data_Namespace::MemoryLevel memory_level;
+  };
+
+  enum class KernelState { kPending, kStarted, kFinished };
+
+  struct KernelChunks {
+    const ColumnFetcher* column_fetcher;
+    int numa_node = -1;
+    int device_id = 0;
+    std::vector<ChunkRequest> requests;
+    size_t num_bytes = 0;
+    KernelState state = KernelState::kPending;
+    std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks;
+  };
+
+  void run();
+
+  std::vector<KernelChunks> kernels_;
+  size_t max_kernels_ahead_;
+  size_t max_bytes_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  size_t num_started_ = 0;
+  size_t pinned_bytes_ = 0;
+  bool stop_ = false;
+  std::thread thread_;
+};
@@ -104,6 +104,19 @@ class CodeCacheAccessor {
     compilation_cv_.notify_all();
   }
 
+  // Replace the code cached for key, e.g. with better optimized code.
+  void overwrite(const CodeCacheKey& key, CodeCacheVal<CompilationContext>& value) {
+    std::lock_guard<std::mutex> lock(code_cache_mutex_);
+    put_count_++;
+    overwrite_count_++;
+    code_cache_.put(key, value);
+  }
+
+  int64_t getOverwriteCount() {
+    std::lock_guard<std::mutex> lock(code_cache_mutex_);
+    return overwrite_count_;
+  }
+
   void clear() {
     std::lock_guard<std::mutex> lock(code_cache_mutex_);
     code_cache_.clear();
@@ -70,10 +70,14 @@ class CodeGenerator {
       const std::vector<llvm::Function*>& roots,
       const std::vector<llvm::Function*>& leaves);
 
+  // The object cache supplies and receives the machine code of the module. The IR
+  // optimizations are skipped if it is known to have the object already.
   static ExecutionEngineWrapper generateNativeCPUCode(
       llvm::Function* func,
       const std::unordered_set<llvm::Function*>& live_funcs,
-      const CompilationOptions& co);
+      const CompilationOptions& co,
+      std::unique_ptr<llvm::ObjectCache> object_cache = nullptr,
+      const bool has_cached_object = false);
 
   static std::string generatePTX(const std::string& cuda_llir,
                                  llvm::TargetMachine* nvptx_target_machine,
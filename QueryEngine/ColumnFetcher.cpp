@@ -289,6 +289,37 @@ const int8_t* ColumnFetcher::getOneTableColumnFragment(
   }
 }
 
+std::shared_ptr<Chunk_NS::Chunk> ColumnFetcher::prefetchOneTableColumnFragment(
+    ColumnInfoPtr col_info,
+    const FragmentInfo& fragment,
+    const Data_Namespace::MemoryLevel memory_level,
+    const int device_id) const {
+  CHECK_GT(col_info->table_id, 0);
+  if (fragment.isEmptyPhysicalFragment()) {
+    return nullptr;
+  }
+  auto chunk_meta_it = fragment.getChunkMetadataMap().find(col_info->column_id);
+  CHECK(chunk_meta_it != fragment.getChunkMetadataMap().end());
+  const auto& col_type = col_info->type;
+  const bool is_varlen =
+      (col_type.is_string() && col_type.get_compression() == kENCODING_NONE) ||
+      col_type.is_array();
+  ChunkKey chunk_key{col_info->db_id,
+                     fragment.physicalTableId,
+                     col_info->column_id,
+                     fragment.fragmentId};
+  std::unique_ptr<std::lock_guard<std::mutex>> varlen_chunk_lock;
+  if (is_varlen) {
+    varlen_chunk_lock.reset(new std::lock_guard<std::mutex>(varlen_chunk_fetch_mutex_));
+  }
+  return data_provider_->getChunk(col_info,
+                                  chunk_key,
+                                  memory_level,
+                                  device_id,
+                                  chunk_meta_it->second->numBytes,
+                                  chunk_meta_it->second->numElements);
+}
+
 const int8_t* ColumnFetcher::getAllTableColumnFragments(
     ColumnInfoPtr col_info,
     const std::map<int, const TableFragments*>& all_tables_fragments,
@@ -74,6 +74,14 @@ class ColumnFetcher {
       const int device_id,
       DeviceAllocator* device_allocator) const;
 
+  //! Loads a chunk into a buffer pool ahead of its use by a kernel. The returned
+  //! chunk keeps the buffer pinned. Returns nullptr for empty fragments.
+  std::shared_ptr<Chunk_NS::Chunk> prefetchOneTableColumnFragment(
+      ColumnInfoPtr col_info,
+      const FragmentInfo& fragment,
+      const Data_Namespace::MemoryLevel memory_level,
+      const int device_id) const;
+
   const int8_t* getAllTableColumnFragments(
       ColumnInfoPtr col_info,
       const std::map<int, const TableFragments*>& all_tables_fragments,
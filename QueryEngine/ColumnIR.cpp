@@ -200,6 +200,9 @@ llvm::Value* CodeGenerator::codegenWindowPosition(
 
 // Generate code for fixed length column types (number, timestamp or date,
 // dictionary-encoded string)
+// TODO: nulls are expected to be inline null values, storage replaces them on
+// import. Reading Arrow validity bitmaps here would allow zero-copy import of
+// nullable columns but requires bitmap support in all consumers of the values.
 llvm::Value* CodeGenerator::codegenFixedLengthColVar(const Analyzer::ColumnVar* col_var,
                                                      llvm::Value* col_byte_stream,
                                                      llvm::Value* pos_arg) {
@@ -517,7 +520,10 @@ const Analyzer::Expr* remove_cast_to_int(const Analyzer::Expr* expr) {
 std::shared_ptr<const Analyzer::Expr> CodeGenerator::hashJoinLhs(
     const Analyzer::ColumnVar* rhs) const {
   for (const auto& tautological_eq : plan_state_->join_info_.equi_join_tautologies_) {
-    CHECK(IS_EQUIVALENCE(tautological_eq->get_optype()));
+    // Range joins only narrow down the inner rows, their quals are no tautologies.
+    if (!IS_EQUIVALENCE(tautological_eq->get_optype())) {
+      continue;
+    }
     if (dynamic_cast<const Analyzer::ExpressionTuple*>(
             tautological_eq->get_left_operand())) {
       auto lhs_col = hashJoinLhsTuple(rhs, tautological_eq.get());
@@ -33,7 +33,9 @@ inline std::ostream& operator<<(std::ostream& os, ExecutorDeviceType const dt) {
 }
 #endif
 
-enum class ExecutorOptLevel { Default, ReductionJIT };
+// FirstTier code is compiled quickly and replaced with Default level code
+// compiled in background.
+enum class ExecutorOptLevel { Default, ReductionJIT, FirstTier };
 
 enum class ExecutorExplainType { Default, Optimized };
 
@@ -101,6 +103,8 @@ struct ExecutionOptions {
   std::vector<size_t> outer_fragment_indices{};
   bool multifrag_result = false;
   bool preserve_order = false;
+  // Kernels of queries with higher priority get CPU threads first.
+  int kernel_priority = 0;
 
   static ExecutionOptions defaults() {
     return ExecutionOptions{false,
@@ -38,6 +38,7 @@ enum CacheItemType {
   BASELINE_HT,              // Baseline hashtable
   HT_HASHING_SCHEME,        // Hashtable layout
   BASELINE_HT_APPROX_CARD,  // Approximated cardinality for baseline hashtable
+  RANGE_HT,                 // Sorted keys for range joins
   // TODO (yoonmin): support the following items for recycling
   // ROW_RS,             Row-wise resultset
   // COUNTALL_CARD_EST,  Cardinality of query result
@@ -119,7 +120,8 @@ class DataRecyclerUtil {
       shared::string_view_array("Perfect Join Hashtable",
                                 "Baseline Join Hashtable",
                                 "Hashing Scheme for Join Hashtable",
-                                "Baseline Join Hashtable's Approximated Cardinality");
+                                "Baseline Join Hashtable's Approximated Cardinality",
+                                "Range Join Hashtable");
   static std::string_view toStringCacheItemType(CacheItemType item_type) {
     static_assert(cache_item_type_str.size() == NUM_CACHE_ITEM_TYPE);
     return cache_item_type_str[item_type];
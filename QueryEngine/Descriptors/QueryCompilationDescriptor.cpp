@@ -17,6 +17,7 @@
 #include "QueryCompilationDescriptor.h"
 
 #include "QueryEngine/Execute.h"
+#include "QueryEngine/VectorizedInterpreter.h"
 
 extern bool g_enable_lazy_fetch;
 
@@ -72,3 +73,27 @@ std::unique_ptr<QueryMemoryDescriptor> QueryCompilationDescriptor::compile(
                crt_min_byte_width);
   return query_mem_desc;
 }
+
+std::unique_ptr<QueryMemoryDescriptor> QueryCompilationDescriptor::prepareInterpreted(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& table_infos,
+    Executor* executor) {
+  CHECK(executor);
+  executor->plan_state_.reset(new PlanState(false, table_infos, executor));
+  executor->plan_state_->allocateLocalColumnIds(ra_exe_unit.input_col_descs);
+  GroupByAndAggregate group_by_and_aggregate(executor,
+                                             ExecutorDeviceType::CPU,
+                                             ra_exe_unit,
+                                             table_infos,
+                                             executor->row_set_mem_owner_,
+                                             std::nullopt);
+  auto query_mem_desc =
+      group_by_and_aggregate.initQueryMemoryDescriptor(false, 0, 8, false);
+  if (!VectorizedInterpreter::isSupportedLayout(*query_mem_desc)) {
+    return nullptr;
+  }
+  compilation_device_type_ = ExecutorDeviceType::CPU;
+  hoist_literals_ = false;
+  interpreted_ = true;
+  return query_mem_desc;
+}
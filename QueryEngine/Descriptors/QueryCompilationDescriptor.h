@@ -67,6 +67,14 @@ class QueryCompilationDescriptor {
       const ExecutionOptions& eo,
       Executor* executor);
 
+  // Prepare the execution unit for the vectorized interpreter instead of the
+  // code generation. Return nullptr if the interpreter cannot produce the
+  // output layout of the unit.
+  std::unique_ptr<QueryMemoryDescriptor> prepareInterpreted(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const std::vector<InputTableInfo>& table_infos,
+      Executor* executor);
+
   auto getCompilationResult() const { return compilation_result_; }
 
   std::string getIR() const {
@@ -86,6 +94,7 @@ class QueryCompilationDescriptor {
 
   ExecutorDeviceType getDeviceType() const { return compilation_device_type_; }
   bool hoistLiterals() const { return hoist_literals_; }
+  bool isInterpreted() const { return interpreted_; }
   int8_t getMinByteWidth() const { return actual_min_byte_width_; }
   bool useGroupByBufferDesc() const { return use_groupby_buffer_desc_; }
   void setUseGroupByBufferDesc(bool val) { use_groupby_buffer_desc_ = val; }
@@ -106,4 +115,5 @@ class QueryCompilationDescriptor {
   bool hoist_literals_;
   int8_t actual_min_byte_width_;
   bool use_groupby_buffer_desc_;
+  bool interpreted_{false};
 };
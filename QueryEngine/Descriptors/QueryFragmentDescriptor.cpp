@@ -134,7 +134,9 @@ void QueryFragmentDescriptor::buildFragmentPerKernelForTable(
     const auto& fragment = (*fragments)[i];
     const auto skip_frag = executor->skipFragment(
         table_desc, fragment, ra_exe_unit.simple_quals, frag_offsets, i);
-    if (skip_frag.first) {
+    if (skip_frag.first ||
+        (!table_desc_offset &&
+         executor->skipFragmentByJoinKeyFilters(table_desc, fragment))) {
       continue;
     }
     rowid_lookup_key_ = std::max(rowid_lookup_key_, skip_frag.second);
@@ -344,7 +346,8 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
       skip_frag = executor->skipFragmentInnerJoins(
           outer_table_desc, ra_exe_unit, fragment, frag_offsets, outer_frag_id);
     }
-    if (skip_frag.first) {
+    if (skip_frag.first ||
+        executor->skipFragmentByJoinKeyFilters(outer_table_desc, fragment)) {
       continue;
     }
     auto [device_type, device_id] =
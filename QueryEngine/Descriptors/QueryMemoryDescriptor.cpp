@@ -339,8 +339,12 @@ std::unique_ptr<QueryMemoryDescriptor> QueryMemoryDescriptor::init(
           output_columnar ? 8
                           : pick_baseline_key_width(ra_exe_unit, query_infos, executor);
 
-      actual_col_range_info =
-          ColRangeInfo{QueryDescriptionType::GroupByBaselineHash, 0, 0, 0, false};
+      actual_col_range_info = ColRangeInfo{QueryDescriptionType::GroupByBaselineHash,
+                                           0,
+                                           0,
+                                           0,
+                                           false,
+                                           col_range_info.radix_partitions};
       break;
     }
     case QueryDescriptionType::Projection: {
@@ -434,6 +438,7 @@ QueryMemoryDescriptor::QueryMemoryDescriptor(
     , max_val_(col_range_info.max)
     , bucket_(col_range_info.bucket)
     , has_nulls_(col_range_info.has_nulls)
+    , radix_partition_count_(col_range_info.radix_partitions)
     , count_distinct_descriptors_(count_distinct_descriptors)
     , output_columnar_(false)
     , must_use_baseline_sort_(must_use_baseline_sort)
@@ -502,6 +507,7 @@ QueryMemoryDescriptor::QueryMemoryDescriptor()
     , max_val_(0)
     , bucket_(0)
     , has_nulls_(false)
+    , radix_partition_count_(0)
     , sort_on_gpu_(false)
     , output_columnar_(false)
     , must_use_baseline_sort_(false)
@@ -525,6 +531,7 @@ QueryMemoryDescriptor::QueryMemoryDescriptor(const Executor* executor,
     , max_val_(0)
     , bucket_(0)
     , has_nulls_(false)
+    , radix_partition_count_(0)
     , sort_on_gpu_(false)
     , output_columnar_(false)
     , must_use_baseline_sort_(false)
@@ -550,6 +557,7 @@ QueryMemoryDescriptor::QueryMemoryDescriptor(const QueryDescriptionType query_de
     , max_val_(max_val)
     , bucket_(0)
     , has_nulls_(false)
+    , radix_partition_count_(0)
     , sort_on_gpu_(false)
     , output_columnar_(false)
     , must_use_baseline_sort_(false)
@@ -1165,6 +1173,9 @@ std::string QueryMemoryDescriptor::toString() const {
   str += "\tMin Val (perfect hash only): " + std::to_string(min_val_) + "\n";
   str += "\tMax Val (perfect hash only): " + std::to_string(max_val_) + "\n";
   str += "\tBucket Val (perfect hash only): " + std::to_string(bucket_) + "\n";
+  str += "\tRadix Partitions (baseline hash only): " +
+         std::to_string(radix_partition_count_) + "\n";
+  str += "\tRadix Partitioned Layout: " + ::toString(radix_partitioned_layout_) + "\n";
   str += "\tSort on GPU: " + ::toString(sort_on_gpu_) + "\n";
   str += "\tUse Streaming Top N: " + ::toString(use_streaming_top_n_) + "\n";
   str += "\tOutput Columnar: " + ::toString(output_columnar_) + "\n";
@@ -244,6 +244,13 @@ class QueryMemoryDescriptor {
 
   bool hasNulls() const { return has_nulls_; }
 
+  size_t getRadixPartitionCount() const { return radix_partition_count_; }
+  void setRadixPartitionCount(const size_t val) { radix_partition_count_ = val; }
+  // Whether kernels write groups of every radix partition into its own range of
+  // entries, see get_group_value_radix_partitioned.
+  bool hasRadixPartitionedLayout() const { return radix_partitioned_layout_; }
+  void setRadixPartitionedLayout(const bool val) { radix_partitioned_layout_ = val; }
+
   const CountDistinctDescriptor& getCountDistinctDescriptor(const size_t idx) const {
     CHECK_LT(idx, count_distinct_descriptors_.size());
     return count_distinct_descriptors_[idx];
@@ -360,6 +367,8 @@ class QueryMemoryDescriptor {
   int64_t max_val_;
   int64_t bucket_;
   bool has_nulls_;
+  size_t radix_partition_count_;  // meaningful for GroupByBaselineHash only
+  bool radix_partitioned_layout_{false};
   CountDistinctDescriptors count_distinct_descriptors_;
   bool sort_on_gpu_;
   bool output_columnar_;
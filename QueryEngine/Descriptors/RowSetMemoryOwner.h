@@ -17,7 +17,10 @@
 #pragma once
 
 #include <boost/noncopyable.hpp>
+#include <algorithm>
+#include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -30,6 +33,7 @@
 #include "DataProvider/DataProvider.h"
 #include "Logger/Logger.h"
 #include "QueryEngine/StringDictionaryGenerations.h"
+#include "Shared/checked_alloc.h"
 #include "Shared/quantile.h"
 #include "StringDictionary/StringDictionaryProxy.h"
 #include "ThirdParty/robin_hood.h"
@@ -87,6 +91,67 @@ class RowSetMemoryOwner final : public SimpleAllocator, boost::noncopyable {
     group_by_buffers_.push_back(group_by_buffer);
   }
 
+  // Called with the size of a releasable group by buffer before it is allocated and
+  // once again with failed set if the allocation fails. It may free memory, e.g. by
+  // spilling results held by the query.
+  using GroupByBufferReserve = std::function<void(size_t num_bytes, bool failed)>;
+
+  // Group by buffers are allocated out of the arenas when they may be released
+  // before the query ends, see releaseGroupByBuffer.
+  int8_t* allocateGroupByBuffer(const size_t num_bytes, const size_t thread_idx = 0) {
+    if (!releasable_group_by_buffers_) {
+      return allocate(num_bytes, thread_idx);
+    }
+    if (reserve_group_by_buffer_) {
+      reserve_group_by_buffer_(num_bytes, /*failed=*/false);
+    }
+    auto buffer = reinterpret_cast<int64_t*>(malloc(num_bytes));
+    if (!buffer && reserve_group_by_buffer_) {
+      reserve_group_by_buffer_(num_bytes, /*failed=*/true);
+      buffer = reinterpret_cast<int64_t*>(malloc(num_bytes));
+    }
+    if (!buffer) {
+      throw OutOfHostMemory(num_bytes);
+    }
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    group_by_buffers_.push_back(buffer);
+    releasable_buffer_sizes_.emplace(reinterpret_cast<int8_t*>(buffer), num_bytes);
+    return reinterpret_cast<int8_t*>(buffer);
+  }
+
+  void setReleasableGroupByBuffers(const bool releasable,
+                                   GroupByBufferReserve reserve = nullptr) {
+    releasable_group_by_buffers_ = releasable;
+    reserve_group_by_buffer_ = std::move(reserve);
+  }
+
+  // Free a group by buffer whose content is not needed anymore, e.g. spilled to
+  // disk. The pointer may point into the buffer, e.g. past its index buffer.
+  // Returns the number of freed bytes.
+  size_t releaseGroupByBuffer(const int8_t* buffer) {
+    int8_t* released{nullptr};
+    size_t released_bytes{0};
+    {
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      auto it = releasable_buffer_sizes_.upper_bound(buffer);
+      CHECK(it != releasable_buffer_sizes_.begin())
+          << "Group by buffer is not releasable, it was allocated from an arena.";
+      --it;
+      released = const_cast<int8_t*>(it->first);
+      released_bytes = it->second;
+      CHECK_LT(buffer, released + released_bytes)
+          << "Group by buffer is not releasable, it was allocated from an arena.";
+      releasable_buffer_sizes_.erase(it);
+      auto buffer_it = std::find(group_by_buffers_.begin(),
+                                 group_by_buffers_.end(),
+                                 reinterpret_cast<int64_t*>(released));
+      CHECK(buffer_it != group_by_buffers_.end());
+      group_by_buffers_.erase(buffer_it);
+    }
+    free(released);
+    return released_bytes;
+  }
+
   void addVarlenBuffer(void* varlen_buffer) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     varlen_buffers_.push_back(varlen_buffer);
@@ -262,6 +327,10 @@ class RowSetMemoryOwner final : public SimpleAllocator, boost::noncopyable {
   DataProvider* data_provider_;  // for metadata lookups
   size_t arena_block_size_;      // for cloning
   std::vector<std::unique_ptr<Arena>> allocators_;
+  bool releasable_group_by_buffers_{false};
+  GroupByBufferReserve reserve_group_by_buffer_;
+  // Releasable group by buffers by their start address.
+  std::map<const int8_t*, size_t> releasable_buffer_sizes_;
 
   mutable std::mutex state_mutex_;
 
@@ -30,6 +30,7 @@
 #include <memory>
 #include <mutex>
 #include <numeric>
+#include <optional>
 #include <thread>
 
 #include "CudaMgr/CudaMgr.h"
@@ -38,6 +39,7 @@
 #include "OSDependent/omnisci_path.h"
 #include "QueryEngine/AggregateUtils.h"
 #include "QueryEngine/AggregatedColRange.h"
+#include "QueryEngine/ChunkPrefetcher.h"
 #include "QueryEngine/CodeGenerator.h"
 #include "QueryEngine/ColumnFetcher.h"
 #include "QueryEngine/Descriptors/QueryCompilationDescriptor.h"
@@ -56,6 +58,7 @@
 #include "QueryEngine/JoinHashTable/BaselineJoinHashTable.h"
 #include "QueryEngine/JsonAccessors.h"
 #include "QueryEngine/OutputBufferInitialization.h"
+#include "QueryEngine/KernelScheduler.h"
 #include "QueryEngine/QueryDispatchQueue.h"
 #include "QueryEngine/QueryRewrite.h"
 #include "QueryEngine/QueryTemplateGenerator.h"
@@ -65,6 +68,7 @@
 #include "QueryEngine/StringDictionaryGenerations.h"
 #include "QueryEngine/TableFunctions/TableFunctionCompilationContext.h"
 #include "QueryEngine/TableFunctions/TableFunctionExecutionContext.h"
+#include "QueryEngine/VectorizedInterpreter.h"
 #include "QueryEngine/Visitors/TransientStringLiteralsVisitor.h"
 #include "Shared/SystemParameters.h"
 #include "Shared/TypedDataAccessors.h"
@@ -77,7 +81,12 @@
 
 bool g_enable_dynamic_watchdog{false};
 bool g_enable_cpu_sub_tasks{false};
+bool g_enable_morsel_execution{false};
 size_t g_cpu_sub_task_size{500'000};
+bool g_enable_chunk_prefetch{false};
+size_t g_chunk_prefetch_kernels{4};
+size_t g_chunk_prefetch_max_bytes{0};  // 0 - a share of the buffer pool
+size_t g_max_kernels_per_query{0};  // 0 = no limit
 bool g_enable_filter_function{true};
 unsigned g_dynamic_watchdog_time_limit{10000};
 bool g_allow_cpu_retry{true};
@@ -98,6 +107,9 @@ bool g_enable_columnar_output{false};
 bool g_enable_left_join_filter_hoisting{true};
 bool g_optimize_row_initialization{true};
 bool g_strip_join_covered_quals{false};
+bool g_enable_radix_partitioned_join_build{true};
+size_t g_radix_join_partition_bytes{256 * 1024};  // per core L2 size
+bool g_enable_partitioned_one_to_many_build{true};
 size_t g_constrained_by_in_threshold{10};
 size_t g_default_max_groups_buffer_entry_guess{16384};
 size_t g_big_group_threshold{g_default_max_groups_buffer_entry_guess};
@@ -185,6 +197,8 @@ CodeCacheAccessor<CpuCompilationContext> Executor::cpu_code_accessor(
 CodeCacheAccessor<GpuCompilationContext> Executor::gpu_code_accessor(
     Executor::code_cache_size,
     "gpu_code_cache");
+CodeCacheAccessor<CompiledPlan> Executor::plan_code_accessor(Executor::code_cache_size,
+                                                             "plan_code_cache");
 
 Executor::Executor(const ExecutorId executor_id,
                    Data_Namespace::DataMgr* data_mgr,
@@ -240,6 +254,7 @@ void Executor::reset(bool discard_runtime_modules_only) {
   s_stubs_accessor.clear();
   cpu_code_accessor.clear();
   gpu_code_accessor.clear();
+  plan_code_accessor.clear();
 
   if (discard_runtime_modules_only) {
     extension_modules_.erase(Executor::ExtModuleKinds::rt_udf_cpu_module);
@@ -1178,7 +1193,8 @@ ResultSetPtr Executor::reduceMultiDeviceResults(
     const RelAlgExecutionUnit& ra_exe_unit,
     std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>& results_per_device,
     std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
-    const QueryMemoryDescriptor& query_mem_desc) const {
+    const QueryMemoryDescriptor& query_mem_desc,
+    const SpilledRadixPartitions* spilled_partitions) const {
   auto timer = DEBUG_TIMER(__func__);
   if (ra_exe_unit.estimator) {
     return reduce_estimator_results(ra_exe_unit, results_per_device);
@@ -1202,7 +1218,8 @@ ResultSetPtr Executor::reduceMultiDeviceResults(
   return reduceMultiDeviceResultSets(
       results_per_device,
       row_set_mem_owner,
-      ResultSet::fixupQueryMemoryDescriptor(query_mem_desc));
+      ResultSet::fixupQueryMemoryDescriptor(query_mem_desc),
+      spilled_partitions);
 }
 
 namespace {
@@ -1240,26 +1257,46 @@ bool couldUseParallelReduce(const QueryMemoryDescriptor& desc) {
 ResultSetPtr Executor::reduceMultiDeviceResultSets(
     std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>& results_per_device,
     std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
-    const QueryMemoryDescriptor& query_mem_desc) const {
+    const QueryMemoryDescriptor& query_mem_desc,
+    const SpilledRadixPartitions* spilled_partitions) const {
   auto timer = DEBUG_TIMER(__func__);
+  if (spilled_partitions && spilled_partitions->getResultCount()) {
+    return reduceSpilledResultSets(
+        results_per_device, row_set_mem_owner, *spilled_partitions);
+  }
   std::shared_ptr<ResultSet> reduced_results;
 
   const auto& first = results_per_device.front().first;
 
+  std::vector<const ResultSetStorage*> partitioned_storages;
+  std::optional<RadixPartitionedEntries> radix_partitions;
   if (query_mem_desc.getQueryDescriptionType() ==
           QueryDescriptionType::GroupByBaselineHash &&
       results_per_device.size() > 1) {
-    const auto total_entry_count = std::accumulate(
-        results_per_device.begin(),
-        results_per_device.end(),
-        size_t(0),
-        [](const size_t init, const std::pair<ResultSetPtr, std::vector<size_t>>& rs) {
-          const auto& r = rs.first;
-          return init + r->getQueryMemDesc().getEntryCount();
-        });
+    if (result_set::use_radix_partitioned_reduction(first->getQueryMemDesc(),
+                                                    results_per_device.size())) {
+      for (const auto& rs : results_per_device) {
+        partitioned_storages.push_back(rs.first->getStorage());
+      }
+      radix_partitions = ResultSetStorage::radixPartitionEntries(
+          partitioned_storages, first->getQueryMemDesc().getRadixPartitionCount());
+    }
+    const auto total_entry_count =
+        radix_partitions
+            ? radix_partitions->getOutputEntryCount()
+            : std::accumulate(results_per_device.begin(),
+                              results_per_device.end(),
+                              size_t(0),
+                              [](const size_t init,
+                                 const std::pair<ResultSetPtr, std::vector<size_t>>& rs) {
+                                const auto& r = rs.first;
+                                return init + r->getQueryMemDesc().getEntryCount();
+                              });
     CHECK(total_entry_count);
     auto query_mem_desc = first->getQueryMemDesc();
     query_mem_desc.setEntryCount(total_entry_count);
+    // The output is hashed globally, kernel partition ranges are not kept.
+    query_mem_desc.setRadixPartitionedLayout(false);
     reduced_results = std::make_shared<ResultSet>(first->getTargetInfos(),
                                                   ExecutorDeviceType::CPU,
                                                   query_mem_desc,
@@ -1270,17 +1307,19 @@ ResultSetPtr Executor::reduceMultiDeviceResultSets(
                                                   gridSize());
     auto result_storage = reduced_results->allocateStorage(plan_state_->init_agg_vals_);
     reduced_results->initializeStorage();
-    switch (query_mem_desc.getEffectiveKeyWidth()) {
-      case 4:
-        first->getStorage()->moveEntriesToBuffer<int32_t>(
-            result_storage->getUnderlyingBuffer(), query_mem_desc.getEntryCount());
-        break;
-      case 8:
-        first->getStorage()->moveEntriesToBuffer<int64_t>(
-            result_storage->getUnderlyingBuffer(), query_mem_desc.getEntryCount());
-        break;
-      default:
-        CHECK(false);
+    if (!radix_partitions) {
+      switch (query_mem_desc.getEffectiveKeyWidth()) {
+        case 4:
+          first->getStorage()->moveEntriesToBuffer<int32_t>(
+              result_storage->getUnderlyingBuffer(), query_mem_desc.getEntryCount());
+          break;
+        case 8:
+          first->getStorage()->moveEntriesToBuffer<int64_t>(
+              result_storage->getUnderlyingBuffer(), query_mem_desc.getEntryCount());
+          break;
+        default:
+          CHECK(false);
+      }
     }
   } else {
     reduced_results = first;
@@ -1290,7 +1329,10 @@ ResultSetPtr Executor::reduceMultiDeviceResultSets(
   const auto reduction_code =
       get_reduction_code(executor_id_, results_per_device, &compilation_queue_time);
 
-  if (couldUseParallelReduce(query_mem_desc)) {
+  if (radix_partitions) {
+    reduced_results->getStorage()->reduceRadixPartitions(
+        partitioned_storages, *radix_partitions, reduction_code, executor_id_);
+  } else if (couldUseParallelReduce(query_mem_desc)) {
     std::vector<ResultSetStorage*> storages;
     for (auto& rs : results_per_device) {
       storages.push_back(const_cast<ResultSetStorage*>(rs.first->getStorage()));
@@ -1328,6 +1370,69 @@ ResultSetPtr Executor::reduceMultiDeviceResultSets(
   return reduced_results;
 }
 
+ResultSetPtr Executor::reduceSpilledResultSets(
+    std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>& results_per_device,
+    std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+    const SpilledRadixPartitions& spilled_partitions) const {
+  auto timer = DEBUG_TIMER(__func__);
+  const auto& first = results_per_device.front().first;
+  CHECK(first->getQueryMemDesc().getQueryDescriptionType() ==
+        QueryDescriptionType::GroupByBaselineHash);
+  std::vector<const ResultSetStorage*> storages;
+  for (const auto& rs : results_per_device) {
+    storages.push_back(rs.first->getStorage());
+  }
+  const auto radix_partitions = ResultSetStorage::radixPartitionEntries(
+      storages, spilled_partitions.getPartitionCount(), &spilled_partitions);
+  int64_t compilation_queue_time = 0;
+  const auto reduction_code =
+      get_reduction_code(executor_id_, results_per_device, &compilation_queue_time);
+
+  // Partitions are reduced one at a time per thread, and their groups are written
+  // back to disk. The output is allocated only after the kernel results are freed,
+  // and it is sized for the actual number of groups.
+  SpilledRadixPartitions reduced_partitions(SpillManager::get(),
+                                            spilled_partitions.getPartitionCount(),
+                                            spilled_partitions.row_bytes);
+  first->getStorage()->spillReducedRadixPartitions(storages,
+                                                   radix_partitions,
+                                                   reduction_code,
+                                                   executor_id_,
+                                                   &spilled_partitions,
+                                                   reduced_partitions);
+  const auto target_infos = first->getTargetInfos();
+  auto query_mem_desc = first->getQueryMemDesc();
+  for (auto& rs : results_per_device) {
+    const auto buffer = rs.first->getStorage()->getUnderlyingBuffer();
+    auto result_row_set_mem_owner = rs.first->getRowSetMemOwner();
+    rs.first.reset();
+    result_row_set_mem_owner->releaseGroupByBuffer(buffer);
+  }
+  results_per_device.clear();
+
+  size_t group_count = 0;
+  for (size_t partition = 0; partition < reduced_partitions.getPartitionCount();
+       ++partition) {
+    group_count += reduced_partitions.getRowCount(partition);
+  }
+  query_mem_desc.setEntryCount(group_count + group_count / 2 + 1);
+  query_mem_desc.setRadixPartitionedLayout(false);
+  auto reduced_results = std::make_shared<ResultSet>(target_infos,
+                                                     ExecutorDeviceType::CPU,
+                                                     query_mem_desc,
+                                                     row_set_mem_owner,
+                                                     data_mgr_,
+                                                     buffer_provider_,
+                                                     blockSize(),
+                                                     gridSize());
+  reduced_results->allocateStorage(plan_state_->init_agg_vals_);
+  reduced_results->initializeStorage();
+  reduced_results->getStorage()->reduceSpilledRadixPartitions(
+      reduced_partitions, reduction_code, executor_id_);
+  reduced_results->addCompilationQueueTime(compilation_queue_time);
+  return reduced_results;
+}
+
 ResultSetPtr Executor::reduceSpeculativeTopN(
     const RelAlgExecutionUnit& ra_exe_unit,
     std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>& results_per_device,
@@ -1660,8 +1765,104 @@ RelAlgExecutionUnit replace_scan_limit(const RelAlgExecutionUnit& ra_exe_unit_in
           ra_exe_unit_in.union_all};
 }
 
+ColumnInfoPtr get_deleted_column_if_rows_deleted(const SchemaProvider& schema_provider,
+                                                const InputDescriptor& input_desc,
+                                                const InputTableInfo& table_info) {
+  auto tinfo =
+      schema_provider.getTableInfo(input_desc.getDatabaseId(), input_desc.getTableId());
+  if (!tinfo || !tinfo->delete_column) {
+    return nullptr;
+  }
+  for (const auto& fragment : table_info.info.fragments) {
+    auto meta_it = fragment.getChunkMetadataMap().find(tinfo->delete_column->column_id);
+    if (meta_it != fragment.getChunkMetadataMap().end() &&
+        meta_it->second->chunkStats.max.tinyintval) {
+      return tinfo->delete_column;
+    }
+  }
+  return nullptr;
+}
+
 }  // namespace
 
+RelAlgExecutionUnit Executor::addDeletedColumn(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const CompilationOptions& co) {
+  if (!co.filter_on_deleted_column) {
+    return ra_exe_unit;
+  }
+  CHECK_EQ(ra_exe_unit.input_descs.size(), query_infos.size());
+
+  auto input_col_descs = ra_exe_unit.input_col_descs;
+  auto simple_quals = ra_exe_unit.simple_quals;
+  auto quals = ra_exe_unit.quals;
+  auto join_quals = ra_exe_unit.join_quals;
+  bool has_deleted_rows = false;
+  for (size_t i = 0; i < ra_exe_unit.input_descs.size(); ++i) {
+    const auto& input_desc = ra_exe_unit.input_descs[i];
+    if (input_desc.getSourceType() != InputSourceType::TABLE) {
+      continue;
+    }
+    auto deleted_col = get_deleted_column_if_rows_deleted(
+        *schema_provider_, input_desc, query_infos[i]);
+    if (!deleted_col) {
+      continue;
+    }
+    has_deleted_rows = true;
+
+    // Keep input columns ordered by nest level.
+    const int nest_level = input_desc.getNestLevel();
+    auto pos = std::find_if(input_col_descs.begin(),
+                            input_col_descs.end(),
+                            [nest_level](const auto& col_desc) {
+                              return col_desc->getNestLevel() > nest_level;
+                            });
+    input_col_descs.insert(
+        pos, std::make_shared<const InputColDescriptor>(deleted_col, nest_level));
+
+    // Non-zero delete flag marks a deleted row. The filter on the outer table
+    // is a simple qual, so fragments with all rows deleted are skipped using
+    // the delete column metadata.
+    Datum zero;
+    zero.tinyintval = 0;
+    auto qual = std::make_shared<Analyzer::BinOper>(
+        SQLTypeInfo(kBOOLEAN, true),
+        false,
+        kEQ,
+        kONE,
+        std::make_shared<Analyzer::ColumnVar>(deleted_col, nest_level),
+        std::make_shared<Analyzer::Constant>(deleted_col->type, false, zero));
+    if (nest_level == 0) {
+      simple_quals.push_front(qual);
+    } else if (static_cast<size_t>(nest_level) <= join_quals.size()) {
+      join_quals[nest_level - 1].quals.push_back(qual);
+    } else {
+      quals.push_back(qual);
+    }
+  }
+  if (!has_deleted_rows) {
+    return ra_exe_unit;
+  }
+
+  return {ra_exe_unit.input_descs,
+          input_col_descs,
+          simple_quals,
+          quals,
+          join_quals,
+          ra_exe_unit.groupby_exprs,
+          ra_exe_unit.target_exprs,
+          ra_exe_unit.estimator,
+          ra_exe_unit.sort_info,
+          ra_exe_unit.scan_limit,
+          ra_exe_unit.query_hint,
+          ra_exe_unit.query_plan_dag,
+          ra_exe_unit.hash_table_build_plan_dag,
+          ra_exe_unit.table_id_to_node_map,
+          ra_exe_unit.use_bump_allocator,
+          ra_exe_unit.union_all};
+}
+
 TemporaryTable Executor::executeWorkUnit(size_t& max_groups_buffer_entry_guess,
                                          const bool is_agg,
                                          const std::vector<InputTableInfo>& query_infos,
@@ -1672,6 +1873,7 @@ TemporaryTable Executor::executeWorkUnit(size_t& max_groups_buffer_entry_guess,
                                          DataProvider* data_provider,
                                          ColumnCacheMap& column_cache) {
   VLOG(1) << "Executor " << executor_id_ << " is executing work unit:" << ra_exe_unit_in;
+  const auto ra_exe_unit = addDeletedColumn(ra_exe_unit_in, query_infos, co);
 
   ScopeGuard cleanup_post_execution = [this] {
     // cleanup/unpin GPU buffer allocations
@@ -1687,7 +1889,7 @@ TemporaryTable Executor::executeWorkUnit(size_t& max_groups_buffer_entry_guess,
                                       is_agg,
                                       true,
                                       query_infos,
-                                      ra_exe_unit_in,
+                                      ra_exe_unit,
                                       co,
                                       eo,
                                       row_set_mem_owner_,
@@ -1706,7 +1908,7 @@ TemporaryTable Executor::executeWorkUnit(size_t& max_groups_buffer_entry_guess,
                             is_agg,
                             false,
                             query_infos,
-                            replace_scan_limit(ra_exe_unit_in, e.new_scan_limit_),
+                            replace_scan_limit(ra_exe_unit, e.new_scan_limit_),
                             co,
                             eo,
                             row_set_mem_owner_,
@@ -1853,6 +2055,42 @@ ResultSetPtr Executor::finishStreamExecution(
   return table[0];
 }
 
+namespace {
+
+// Results of high-cardinality baseline hash group by on CPU can be spilled to disk
+// by radix partition, see SharedKernelContext::enableGroupBySpill.
+bool use_group_by_spill(const RelAlgExecutionUnit& ra_exe_unit,
+                        const QueryMemoryDescriptor& query_mem_desc,
+                        const ExecutorDeviceType device_type,
+                        const size_t kernel_count) {
+  return g_enable_spill && device_type == ExecutorDeviceType::CPU &&
+         !ra_exe_unit.estimator &&
+         result_set::use_radix_partitioned_reduction(query_mem_desc, kernel_count) &&
+         !query_mem_desc.hasVarlenOutput() &&
+         !use_speculative_top_n(ra_exe_unit, query_mem_desc);
+}
+
+void enable_group_by_spill(SharedKernelContext& shared_context,
+                           const QueryMemoryDescriptor& query_mem_desc,
+                           RowSetMemoryOwner& row_set_mem_owner) {
+  const auto memory_threshold =
+      g_spill_memory_threshold ? g_spill_memory_threshold
+                               : Data_Namespace::DataMgr::getTotalSystemMemory() / 2;
+  shared_context.enableGroupBySpill(
+      std::make_unique<SpilledRadixPartitions>(SpillManager::get(),
+                                               query_mem_desc.getRadixPartitionCount(),
+                                               get_row_bytes(query_mem_desc)),
+      memory_threshold);
+  // Kernel buffers are freed once spilled. Held results are spilled before a new
+  // buffer is allocated, so that the allocation doesn't fail.
+  row_set_mem_owner.setReleasableGroupByBuffers(
+      true, [&shared_context](size_t num_bytes, bool failed) {
+        shared_context.reserveGroupByBuffer(num_bytes, failed);
+      });
+}
+
+}  // namespace
+
 TemporaryTable Executor::executeWorkUnitImpl(
     size_t& max_groups_buffer_entry_guess,
     const bool is_agg,
@@ -1894,6 +2132,13 @@ TemporaryTable Executor::executeWorkUnitImpl(
     }
   }
 
+  // Short queries over small inputs skip the code generation.
+  const bool use_interpreter =
+      g_enable_vectorized_interpreter && eo.executor_type == ExecutorType::Native &&
+      !eo.just_explain && device_type == ExecutorDeviceType::CPU &&
+      !g_enable_heterogeneous_execution &&
+      VectorizedInterpreter::canInterpret(ra_exe_unit, query_infos);
+
   int8_t crt_min_byte_width{MAX_BYTE_WIDTH_SUPPORTED};
   do {
     SharedKernelContext shared_context(query_infos);
@@ -1911,7 +2156,13 @@ TemporaryTable Executor::executeWorkUnitImpl(
       auto query_comp_desc_owned = std::make_unique<QueryCompilationDescriptor>();
       query_comp_desc_owned->setUseGroupByBufferDesc(co.use_groupby_buffer_desc);
       std::unique_ptr<QueryMemoryDescriptor> query_mem_desc_owned;
-      if (eo.executor_type == ExecutorType::Native) {
+      if (use_interpreter) {
+        query_mem_desc_owned =
+            query_comp_desc_owned->prepareInterpreted(ra_exe_unit, query_infos, this);
+      }
+      if (query_mem_desc_owned) {
+        VLOG(1) << "Executing the work unit with the vectorized interpreter";
+      } else if (eo.executor_type == ExecutorType::Native) {
         try {
           INJECT_TIMER(query_step_compilation);
           query_mem_desc_owned =
@@ -1991,7 +2242,19 @@ TemporaryTable Executor::executeWorkUnitImpl(
                                   available_gpus,
                                   available_cpus);
         }
-        launchKernels(shared_context, std::move(kernels), device_type);
+        if (!g_enable_heterogeneous_execution &&
+            use_group_by_spill(ra_exe_unit,
+                               *query_mem_descs_owned[device_type],
+                               device_type,
+                               kernels.size())) {
+          enable_group_by_spill(
+              shared_context, *query_mem_descs_owned[device_type], *row_set_mem_owner);
+        }
+        ScopeGuard releasable_buffers_guard = [&row_set_mem_owner] {
+          row_set_mem_owner->setReleasableGroupByBuffers(false);
+        };
+        launchKernels(
+            shared_context, std::move(kernels), device_type, eo.kernel_priority);
       } catch (QueryExecutionError& e) {
         if (eo.with_dynamic_watchdog && interrupted_.load() &&
             e.getErrorCode() == ERR_OUT_OF_TIME) {
@@ -2098,9 +2361,10 @@ void Executor::executeWorkUnitPerFragment(
   }
 
   {
-    auto clock_begin = timer_start();
-    std::lock_guard<std::mutex> kernel_lock(kernel_mutex_);
-    kernel_queue_time_ms_ += timer_stop(clock_begin);
+    KernelScheduler::Query scheduled_query(KernelScheduler::instance(),
+                                           eo.kernel_priority,
+                                           g_max_kernels_per_query,
+                                           &interrupted_);
 
     for (auto fragment_index : fragment_indexes) {
       // We may want to consider in the future allowing this to execute on devices other
@@ -2116,6 +2380,12 @@ void Executor::executeWorkUnitPerFragment(
                              fragments_list,
                              ExecutorDispatchMode::KernelPerFragment,
                              /*rowid_lookup_key=*/-1);
+      auto wait_ms = scheduled_query.acquireSlot();
+      if (!wait_ms) {
+        throw QueryExecutionError(ERR_INTERRUPTED);
+      }
+      kernel_queue_time_ms_ += *wait_ms;
+      ScopeGuard slot_guard([&scheduled_query]() { scheduled_query.releaseSlot(); });
       kernel.run(this, 0, kernel_context);
     }
   }
@@ -2366,8 +2636,11 @@ ResultSetPtr Executor::collectAllDeviceResults(
   if (shard_count && !result_per_device.empty()) {
     return collectAllDeviceShardedTopResults(shared_context, ra_exe_unit);
   }
-  return reduceMultiDeviceResults(
-      ra_exe_unit, result_per_device, row_set_mem_owner, query_mem_desc);
+  return reduceMultiDeviceResults(ra_exe_unit,
+                                  result_per_device,
+                                  row_set_mem_owner,
+                                  query_mem_desc,
+                                  shared_context.getSpilledPartitions());
 }
 
 namespace {
@@ -2752,10 +3025,50 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createHeterogeneousKerne
 // TODO(Petr): remove device_type from function signature
 void Executor::launchKernels(SharedKernelContext& shared_context,
                              std::vector<std::unique_ptr<ExecutionKernel>>&& kernels,
-                             const ExecutorDeviceType device_type) {
-  auto clock_begin = timer_start();
-  std::lock_guard<std::mutex> kernel_lock(kernel_mutex_);
-  kernel_queue_time_ms_ += timer_stop(clock_begin);
+                             const ExecutorDeviceType device_type,
+                             const int priority) {
+  // CPU kernels of concurrent queries share CPU threads through the kernel
+  // scheduler. Queries using GPUs still have exclusive access to devices.
+  std::unique_lock<std::mutex> kernel_lock(kernel_mutex_, std::defer_lock);
+  if (std::any_of(kernels.begin(), kernels.end(), [](const auto& kernel) {
+        return kernel->getDeviceType() == ExecutorDeviceType::GPU;
+      })) {
+    auto clock_begin = timer_start();
+    kernel_lock.lock();
+    kernel_queue_time_ms_ += timer_stop(clock_begin);
+  }
+  KernelScheduler::Query scheduled_query(
+      KernelScheduler::instance(), priority, g_max_kernels_per_query, &interrupted_);
+  // Slots are acquired by the launching thread and handed over to kernels when
+  // they start. Kernels skipped by a cancelled task group leave their slots to
+  // be released here, after all tasks are done.
+  std::atomic<size_t> unstarted_slots{0};
+  ScopeGuard unstarted_slots_guard([&scheduled_query, &unstarted_slots]() {
+    for (size_t i = unstarted_slots.load(); i; --i) {
+      scheduled_query.releaseSlot();
+    }
+  });
+
+  VLOG(1) << "Launching " << kernels.size() << " kernels for query on "
+          << (device_type == ExecutorDeviceType::CPU ? "CPU"s : "GPU"s) << ".";
+  // Kernel tasks use the prefetcher, so it has to outlive the task group.
+  std::unique_ptr<ChunkPrefetcher> prefetcher;
+  if (g_enable_chunk_prefetch && kernels.size() > 1) {
+    prefetcher = std::make_unique<ChunkPrefetcher>(this,
+                                                   kernels,
+                                                   shared_context.getQueryInfos(),
+                                                   g_chunk_prefetch_kernels,
+                                                   g_chunk_prefetch_max_bytes);
+  }
+
+#ifdef HAVE_TBB
+  // Morsel sources left unfinished by a failure keep done guards of their
+  // kernels. They are released once all tasks are done, while the scheduler
+  // slots and the prefetcher are still alive.
+  ScopeGuard morsel_sources_guard([&shared_context]() {
+    shared_context.getMorselDispenser().releaseSources();
+  });
+#endif  // HAVE_TBB
 
   threading::task_group tg;
   // A hack to have unused unit for results collection.
@@ -2769,23 +3082,64 @@ void Executor::launchKernels(SharedKernelContext& shared_context,
   ScopeGuard pool_guard([&shared_context]() { shared_context.setThreadPool(nullptr); });
 #endif  // HAVE_TBB
 
-  VLOG(1) << "Launching " << kernels.size() << " kernels for query on "
-          << (device_type == ExecutorDeviceType::CPU ? "CPU"s : "GPU"s) << ".";
   size_t kernel_idx = 1;
   for (auto& kernel : kernels) {
     CHECK(kernel.get());
+    const bool use_slot = kernel->getDeviceType() == ExecutorDeviceType::CPU;
+    if (use_slot) {
+      auto wait_ms = scheduled_query.acquireSlot();
+      if (!wait_ms) {
+        // Let already started kernels finish before reporting the interrupt.
+        tg.wait();
+        throw QueryExecutionError(ERR_INTERRUPTED);
+      }
+      kernel_queue_time_ms_ += *wait_ms;
+      ++unstarted_slots;
+    }
     tg.run([this,
             &kernel,
             &shared_context,
+            &scheduled_query,
+            &unstarted_slots,
+            use_slot,
+            prefetcher = prefetcher.get(),
             parent_thread_id = logger::thread_id(),
             crt_kernel_idx = kernel_idx++] {
+      if (use_slot) {
+        --unstarted_slots;
+      }
+      // Sub-tasks of the kernel run on the same thread pool and read chunks
+      // prefetched for the kernel, so the slot and the pinned chunks are held
+      // until they are done too.
+      auto done_guard = std::make_shared<ScopeGuard>(
+          [&scheduled_query, use_slot, prefetcher, crt_kernel_idx]() {
+            if (prefetcher) {
+              prefetcher->kernelFinished(crt_kernel_idx - 1);
+            }
+            if (use_slot) {
+              scheduled_query.releaseSlot();
+            }
+          });
       DEBUG_TIMER_NEW_THREAD(parent_thread_id);
       const size_t thread_i = crt_kernel_idx % cpu_threads();
+      if (prefetcher) {
+        prefetcher->kernelStarted(crt_kernel_idx - 1);
+      }
+      kernel->setDoneGuard(std::move(done_guard));
       kernel->run(this, thread_i, shared_context);
     });
   }
   tg.wait();
 
+#ifdef HAVE_TBB
+  for (const auto& [thread_id, stats] :
+       shared_context.getMorselDispenser().getThreadStats()) {
+    VLOG(1) << "Morsel worker thread " << thread_id << " processed " << stats.morsels
+            << " morsels (" << stats.stolen_morsels << " stolen), busy for "
+            << stats.busy_us / 1000 << " ms.";
+  }
+#endif  // HAVE_TBB
+
   for (auto& exec_ctx : shared_context.getTlsExecutionContext()) {
     // The first arg is used for GPU only, it's not our case.
     // TODO: add QueryExecutionContext::getRowSet() interface
@@ -4211,6 +4565,59 @@ std::pair<bool, int64_t> Executor::skipFragmentInnerJoins(
   return skip_frag;
 }
 
+bool Executor::skipFragmentByJoinKeyFilters(const InputDescriptor& table_desc,
+                                            const FragmentInfo& fragment) const {
+  if (!g_enable_join_key_filter || table_desc.getNestLevel() != 0) {
+    return false;
+  }
+  const auto& join_info = plan_state_->join_info_;
+  CHECK_EQ(join_info.join_types_.size(), join_info.join_hash_tables_.size());
+  for (size_t i = 0; i < join_info.join_hash_tables_.size(); ++i) {
+    // Outer rows without a match are kept by the other join types.
+    const auto join_type = join_info.join_types_[i];
+    if (join_type != JoinType::INNER && join_type != JoinType::SEMI) {
+      continue;
+    }
+    const auto hash_table = join_info.join_hash_tables_[i]->getHashTableForDevice(0);
+    if (!hash_table || hash_table->getKeyFilters().empty()) {
+      continue;
+    }
+    const auto& key_filters = hash_table->getKeyFilters();
+    const auto inner_outer_pairs =
+        HashJoin::normalizeColumnPairs(join_info.equi_join_tautologies_[i].get(),
+                                       schema_provider_,
+                                       getTemporaryTables());
+    CHECK_EQ(inner_outer_pairs.size(), key_filters.size());
+    for (size_t j = 0; j < key_filters.size(); ++j) {
+      const auto& key_filter = key_filters[j];
+      const auto outer_col =
+          dynamic_cast<const Analyzer::ColumnVar*>(inner_outer_pairs[j].second);
+      if (!key_filter || !outer_col || outer_col->get_rte_idx() != 0 ||
+          outer_col->get_table_id() != table_desc.getTableId() ||
+          !outer_col->get_type_info().is_integer()) {
+        continue;
+      }
+      if (key_filter->empty()) {
+        return true;
+      }
+      const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+      auto chunk_meta_it = chunk_metadata_map.find(outer_col->get_column_id());
+      if (chunk_meta_it == chunk_metadata_map.end()) {
+        continue;
+      }
+      const auto& outer_ti = outer_col->get_type_info();
+      const auto chunk_min =
+          extract_min_stat_int_type(chunk_meta_it->second->chunkStats, outer_ti);
+      const auto chunk_max =
+          extract_max_stat_int_type(chunk_meta_it->second->chunkStats, outer_ti);
+      if (chunk_min <= chunk_max && !key_filter->mayContain(chunk_min, chunk_max)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 AggregatedColRange Executor::computeColRangesCache(
     const std::unordered_set<InputColDescriptor>& col_descs) {
   AggregatedColRange agg_col_range_cache;
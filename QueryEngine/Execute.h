@@ -55,6 +55,7 @@
 #include "QueryEngine/JoinHashTable/HashJoin.h"
 #include "QueryEngine/LoopControlFlow/JoinLoop.h"
 #include "QueryEngine/NvidiaKernel.h"
+#include "QueryEngine/PlanFingerprint.h"
 #include "QueryEngine/PlanState.h"
 #include "QueryEngine/QueryPlanDagCache.h"
 #include "QueryEngine/RelAlgExecutionUnit.h"
@@ -681,7 +682,8 @@ class Executor {
    */
   void launchKernels(SharedKernelContext& shared_context,
                      std::vector<std::unique_ptr<ExecutionKernel>>&& kernels,
-                     const ExecutorDeviceType device_type);
+                     const ExecutorDeviceType device_type,
+                     const int priority);
 
   std::vector<size_t> getTableFragmentIndices(
       const RelAlgExecutionUnit& ra_exe_unit,
@@ -810,17 +812,30 @@ class Executor {
       const RelAlgExecutionUnit&,
       std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>& all_fragment_results,
       std::shared_ptr<RowSetMemoryOwner>,
-      const QueryMemoryDescriptor&) const;
+      const QueryMemoryDescriptor&,
+      const SpilledRadixPartitions* spilled_partitions = nullptr) const;
   ResultSetPtr reduceMultiDeviceResultSets(
       std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>& all_fragment_results,
       std::shared_ptr<RowSetMemoryOwner>,
-      const QueryMemoryDescriptor&) const;
+      const QueryMemoryDescriptor&,
+      const SpilledRadixPartitions* spilled_partitions = nullptr) const;
+  // Reduce kernel results and spilled rows partition by partition through a spill
+  // file. Kernel results are released before the output is allocated.
+  ResultSetPtr reduceSpilledResultSets(
+      std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>& all_fragment_results,
+      std::shared_ptr<RowSetMemoryOwner>,
+      const SpilledRadixPartitions& spilled_partitions) const;
   ResultSetPtr reduceSpeculativeTopN(
       const RelAlgExecutionUnit&,
       std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>& all_fragment_results,
       std::shared_ptr<RowSetMemoryOwner>,
       const QueryMemoryDescriptor&) const;
 
+  // Add filters on delete columns of input tables having deleted rows.
+  RelAlgExecutionUnit addDeletedColumn(const RelAlgExecutionUnit& ra_exe_unit,
+                                       const std::vector<InputTableInfo>& query_infos,
+                                       const CompilationOptions& co);
+
   TemporaryTable executeWorkUnitImpl(size_t& max_groups_buffer_entry_guess,
                                      const bool is_agg,
                                      const bool allow_single_frag_table_opt,
@@ -949,7 +964,10 @@ class Executor {
                     const std::vector<InputTableInfo>& query_infos,
                     const RelAlgExecutionUnit* ra_exe_unit);
 
+  // Key of the generated CPU code in the code cache.
+  CodeCacheKey getCpuCodeCacheKey(llvm::Function* query_func) const;
   std::shared_ptr<CompilationContext> optimizeAndCodegenCPU(
+      const CodeCacheKey& key,
       llvm::Function*,
       llvm::Function*,
       const std::unordered_set<llvm::Function*>&,
@@ -1005,6 +1023,11 @@ class Executor {
       const std::vector<uint64_t>& frag_offsets,
       const size_t frag_idx);
 
+  // Returns true if the keys of an outer table fragment, per its chunk stats, have
+  // no matches in the inner join hash tables.
+  bool skipFragmentByJoinKeyFilters(const InputDescriptor& table_desc,
+                                    const FragmentInfo& fragment) const;
+
   AggregatedColRange computeColRangesCache(
       const std::unordered_set<InputColDescriptor>& col_descs);
   StringDictionaryGenerations computeStringDictionaryGenerations(
@@ -1197,6 +1220,8 @@ class Executor {
   static CodeCacheAccessor<CpuCompilationContext> s_code_accessor;
   static CodeCacheAccessor<CpuCompilationContext> cpu_code_accessor;
   static CodeCacheAccessor<GpuCompilationContext> gpu_code_accessor;
+  // Compiled plans by the fingerprint of the execution unit.
+  static CodeCacheAccessor<CompiledPlan> plan_code_accessor;
 
  private:
   static const size_t baseline_threshold{
@@ -1296,9 +1321,10 @@ class Executor {
   // until the update is complete.
   static std::shared_mutex register_runtime_extension_functions_mutex_;
 
-  static std::mutex kernel_mutex_;  // TODO: should this be executor-local mutex?
+  static std::mutex kernel_mutex_;  // serializes queries using GPU devices
 
   friend class BaselineJoinHashTable;
+  friend class ChunkPrefetcher;  // plan_state_
   friend class CodeGenerator;
   friend class ColumnFetcher;
   friend struct DiamondCodegen;  // cgen_state_
@@ -1319,6 +1345,7 @@ class Executor {
   friend class QueryRewriter;
   friend class PendingExecutionClosure;
   friend class RelAlgExecutor;
+  friend class RangeJoinHashTable;
   friend class TableFunctionCompilationContext;
   friend class TableFunctionExecutionContext;
   friend struct TargetExprCodegenBuilder;
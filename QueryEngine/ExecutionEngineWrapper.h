@@ -21,6 +21,7 @@
 
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/JITEventListener.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
 #include <llvm/IR/Module.h>
 
 struct CompilationOptions;
@@ -68,8 +69,10 @@ class ORCJITExecutionEngineWrapper {
   ORCJITExecutionEngineWrapper(
       std::unique_ptr<llvm::orc::ExecutionSession> execution_session,
       llvm::orc::JITTargetMachineBuilder target_machine_builder,
-      std::unique_ptr<llvm::DataLayout> data_layout)
-      : execution_session_(std::move(execution_session))
+      std::unique_ptr<llvm::DataLayout> data_layout,
+      std::unique_ptr<llvm::ObjectCache> object_cache = nullptr)
+      : object_cache_(std::move(object_cache))
+      , execution_session_(std::move(execution_session))
       , data_layout_(std::move(data_layout))
       , mangle_(std::make_unique<llvm::orc::MangleAndInterner>(*this->execution_session_,
                                                                *data_layout_))
@@ -80,7 +83,8 @@ class ORCJITExecutionEngineWrapper {
             *execution_session_,
             *object_layer_,
             std::make_unique<llvm::orc::ConcurrentIRCompiler>(
-                std::move(target_machine_builder)))) {
+                std::move(target_machine_builder),
+                object_cache_.get()))) {
     auto dylib_or_error = execution_session_->createJITDylib("<main>");
     if (!dylib_or_error) {
       LOG(FATAL) << "Failed to initialize JITTargetMachineBuilder: "
@@ -127,6 +131,8 @@ class ORCJITExecutionEngineWrapper {
   ORCJITExecutionEngineWrapper& operator=(ORCJITExecutionEngineWrapper&& other) = default;
 
  private:
+  // Must outlive the compile layer using it.
+  std::unique_ptr<llvm::ObjectCache> object_cache_;
   std::unique_ptr<llvm::orc::ExecutionSession> execution_session_;
   std::unique_ptr<llvm::DataLayout> data_layout_;
   std::unique_ptr<llvm::orc::MangleAndInterner> mangle_;
@@ -159,6 +165,13 @@ class MCJITExecutionEngineWrapper {
 
   bool exists() const { return !(execution_engine_ == nullptr); }
 
+  // Must be set before the object is finalized.
+  void setObjectCache(std::unique_ptr<llvm::ObjectCache> object_cache) {
+    CHECK(execution_engine_);
+    object_cache_ = std::move(object_cache);
+    execution_engine_->setObjectCache(object_cache_.get());
+  }
+
   void removeModule(llvm::Module* module) { execution_engine_->removeModule(module); }
 
   llvm::ExecutionEngine* operator->() { return execution_engine_.get(); }
@@ -171,6 +184,8 @@ class MCJITExecutionEngineWrapper {
   MCJITExecutionEngineWrapper& operator=(llvm::ExecutionEngine* execution_engine);
 
  private:
+  // Must outlive the execution engine using it.
+  std::unique_ptr<llvm::ObjectCache> object_cache_;
   std::unique_ptr<llvm::ExecutionEngine> execution_engine_;
   std::unique_ptr<llvm::JITEventListener> intel_jit_listener_;
 };
@@ -25,8 +25,13 @@
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ExternalExecutor.h"
 #include "QueryEngine/SerializeToSql.h"
+#include "QueryEngine/VectorizedInterpreter.h"
+#include "Shared/numa_utils.h"
 
 extern size_t g_cpu_sub_task_size;
+extern bool g_enable_morsel_execution;
+extern bool g_enable_numa_aware_buffers;
+
 namespace {
 
 bool needs_skip_result(const ResultSetPtr& res) {
@@ -108,12 +113,75 @@ const std::vector<uint64_t>& SharedKernelContext::getFragOffsets() {
 void SharedKernelContext::addDeviceResults(ResultSetPtr&& device_results,
                                            int outer_table_id,
                                            std::vector<size_t> outer_table_fragment_ids) {
+  if (needs_skip_result(device_results)) {
+    return;
+  }
+  if (spilled_partitions_ && spillDeviceResults(device_results)) {
+    return;
+  }
   std::lock_guard<std::mutex> lock(reduce_mutex_);
-  if (!needs_skip_result(device_results)) {
-    device_results->setOuterTableId(outer_table_id);
-    all_fragment_results_.emplace_back(std::move(device_results),
-                                       outer_table_fragment_ids);
+  device_results->setOuterTableId(outer_table_id);
+  all_fragment_results_.emplace_back(std::move(device_results),
+                                     outer_table_fragment_ids);
+}
+
+void SharedKernelContext::enableGroupBySpill(
+    std::unique_ptr<SpilledRadixPartitions> spilled_partitions,
+    const size_t memory_threshold) {
+  spilled_partitions_ = std::move(spilled_partitions);
+  spill_memory_threshold_ = memory_threshold;
+}
+
+void SharedKernelContext::reserveGroupByBuffer(const size_t num_bytes,
+                                               const bool allocation_failed) {
+  CHECK(spilled_partitions_);
+  while (true) {
+    ResultSetPtr spilled_results;
+    {
+      std::lock_guard<std::mutex> lock(reduce_mutex_);
+      // The first result stays in memory, the reduction uses it as a template.
+      if (all_fragment_results_.size() < 2 ||
+          (!allocation_failed &&
+           allocated_result_bytes_ + num_bytes <= spill_memory_threshold_)) {
+        if (!allocation_failed) {
+          allocated_result_bytes_ += num_bytes;
+        }
+        return;
+      }
+      spilled_results = std::move(all_fragment_results_.back().first);
+      all_fragment_results_.pop_back();
+    }
+    spillResults(spilled_results);
+  }
+}
+
+bool SharedKernelContext::spillDeviceResults(ResultSetPtr& device_results) {
+  {
+    std::lock_guard<std::mutex> lock(reduce_mutex_);
+    // The first result stays in memory, the reduction uses it as a template.
+    if (all_fragment_results_.empty() ||
+        allocated_result_bytes_ <= spill_memory_threshold_) {
+      return false;
+    }
   }
+  spillResults(device_results);
+  return true;
+}
+
+void SharedKernelContext::spillResults(ResultSetPtr& results) {
+  const auto storage = results->getStorage();
+  CHECK(storage);
+  VLOG(1) << "Spilling "
+          << results->getQueryMemDesc().getBufferSizeBytes(ExecutorDeviceType::CPU)
+          << " bytes of group by results.";
+  storage->spillRadixPartitions(*spilled_partitions_);
+  const auto buffer = storage->getUnderlyingBuffer();
+  auto row_set_mem_owner = results->getRowSetMemOwner();
+  results.reset();
+  const auto released_bytes = row_set_mem_owner->releaseGroupByBuffer(buffer);
+  std::lock_guard<std::mutex> lock(reduce_mutex_);
+  CHECK_GE(allocated_result_bytes_, released_bytes);
+  allocated_result_bytes_ -= released_bytes;
 }
 
 std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>&
@@ -121,18 +189,40 @@ SharedKernelContext::getFragmentResults() {
   return all_fragment_results_;
 }
 
+int ExecutionKernel::getPreferredNumaNode() const {
+  if (!g_enable_numa_aware_buffers || chosen_device_type != ExecutorDeviceType::CPU ||
+      frag_list.empty() || frag_list.front().fragment_ids.empty()) {
+    return -1;
+  }
+  int node_count = numa::getNodeCount();
+  if (node_count < 2) {
+    return -1;
+  }
+  // Kernels processing the same outer fragment always run on the same node, so
+  // its chunks are fetched into slabs of that node and stay local on re-runs.
+  return static_cast<int>(frag_list.front().fragment_ids.front() % node_count);
+}
+
 void ExecutionKernel::run(Executor* executor,
                           const size_t thread_idx,
                           SharedKernelContext& shared_context) {
   DEBUG_TIMER("ExecutionKernel::run");
   INJECT_TIMER(kernel_run);
+  ScopeGuard release_done_guard([this]() { done_guard_.reset(); });
   std::optional<logger::QidScopeGuard> qid_scope_guard;
+  std::optional<numa::ScopedNodeBinding> numa_binding;
+  auto numa_node = getPreferredNumaNode();
+  if (numa_node >= 0) {
+    numa_binding.emplace(numa_node);
+  }
   try {
     runImpl(executor, thread_idx, shared_context);
   } catch (const OutOfHostMemory& e) {
     throw QueryExecutionError(Executor::ERR_OUT_OF_CPU_MEM, e.what());
   } catch (const std::bad_alloc& e) {
     throw QueryExecutionError(Executor::ERR_OUT_OF_CPU_MEM, e.what());
+  } catch (const SpillBudgetExceeded& e) {
+    throw QueryExecutionError(Executor::ERR_OUT_OF_CPU_MEM, e.what());
   } catch (const OutOfMemory& e) {
     throw QueryExecutionError(
         Executor::ERR_OUT_OF_GPU_MEM,
@@ -269,6 +359,14 @@ void ExecutionKernel::runImpl(Executor* executor,
         std::move(device_results_), outer_table_id, outer_tab_frag_ids);
     return;
   }
+  if (query_comp_desc.isInterpreted()) {
+    VectorizedInterpreter interpreter(
+        ra_exe_unit_, executor->plan_state_.get(), executor, eo);
+    device_results_ = interpreter.run(*fetch_result, query_mem_desc);
+    shared_context.addDeviceResults(
+        std::move(device_results_), outer_table_id, outer_tab_frag_ids);
+    return;
+  }
   const CompilationResult& compilation_result = query_comp_desc.getCompilationResult();
   std::unique_ptr<QueryExecutionContext> query_exe_context_owned;
 
@@ -329,6 +427,40 @@ void ExecutionKernel::runImpl(Executor* executor,
 
   // TODO: check for literals? We serialize literals before execution and hold them in
   // result sets. Can we simply do it once and holdin an outer structure?
+  if (can_run_subkernels && g_enable_morsel_execution) {
+    size_t total_rows = fetch_result->num_rows[0][0];
+    auto& dispenser = shared_context.getMorselDispenser();
+    auto source_idx = dispenser.addSource(
+        start_rowid,
+        total_rows,
+        g_cpu_sub_task_size,
+        getPreferredNumaNode(),
+        [this,
+         &shared_context,
+         executor,
+         fetch_result,
+         chunk_iterators_ptr,
+         total_num_input_rows,
+         thread_idx,
+         done_guard = done_guard_](size_t start_row, size_t num_rows) {
+          KernelSubtask subtask(*this,
+                                shared_context,
+                                fetch_result,
+                                chunk_iterators_ptr,
+                                total_num_input_rows,
+                                start_row,
+                                num_rows,
+                                thread_idx);
+          subtask.run(executor);
+        });
+    auto num_workers = dispenser.workersToLaunch(source_idx, cpu_threads());
+    for (size_t i = 0; i < num_workers; ++i) {
+      shared_context.getThreadPool()->run(
+          [&dispenser, source_idx] { dispenser.runWorker(source_idx); });
+    }
+    return;
+  }
+
   if (can_run_subkernels) {
     size_t total_rows = fetch_result->num_rows[0][0];
     size_t sub_size = g_cpu_sub_task_size;
@@ -343,7 +475,7 @@ void ExecutionKernel::runImpl(Executor* executor,
                                                      sub_size,
                                                      thread_idx);
       shared_context.getThreadPool()->run(
-          [subtask, executor] { subtask->run(executor); });
+          [subtask, executor, done_guard = done_guard_] { subtask->run(executor); });
     }
 
     return;
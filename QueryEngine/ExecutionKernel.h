@@ -19,7 +19,9 @@
 #include "Logger/Logger.h"
 #include "QueryEngine/ColumnFetcher.h"
 #include "QueryEngine/Descriptors/QueryCompilationDescriptor.h"
+#include "QueryEngine/MorselDispenser.h"
 
+#include "Shared/scope.h"
 #include "Shared/threading.h"
 
 #ifdef HAVE_TBB
@@ -46,18 +48,40 @@ class SharedKernelContext {
 
   const std::vector<InputTableInfo>& getQueryInfos() const { return query_infos_; }
 
+  // Spill baseline hash results into the partitions instead of holding them in
+  // memory once group by buffers of the query take more than memory_threshold bytes.
+  void enableGroupBySpill(std::unique_ptr<SpilledRadixPartitions> spilled_partitions,
+                          const size_t memory_threshold);
+  // Called before a kernel group by buffer is allocated, see
+  // RowSetMemoryOwner::GroupByBufferReserve. Held results are spilled until the new
+  // buffer fits under the memory threshold, or all of them if the allocation failed.
+  void reserveGroupByBuffer(const size_t num_bytes, const bool allocation_failed);
+  const SpilledRadixPartitions* getSpilledPartitions() const {
+    return spilled_partitions_.get();
+  }
+
   std::atomic_flag dynamic_watchdog_set = ATOMIC_FLAG_INIT;
 
 #ifdef HAVE_TBB
   auto getThreadPool() { return task_group_; }
   void setThreadPool(threading::task_group* tg) { task_group_ = tg; }
   auto& getTlsExecutionContext() { return tls_execution_context_; }
+  MorselDispenser& getMorselDispenser() { return morsel_dispenser_; }
 #endif  // HAVE_TBB
 
  private:
   std::mutex reduce_mutex_;
   std::vector<std::pair<ResultSetPtr, std::vector<size_t>>> all_fragment_results_;
 
+  bool spillDeviceResults(ResultSetPtr& device_results);
+  void spillResults(ResultSetPtr& results);
+
+  std::unique_ptr<SpilledRadixPartitions> spilled_partitions_;
+  size_t spill_memory_threshold_{0};
+  // Group by buffers allocated by kernels and not released yet, including the
+  // buffers of running kernels.
+  size_t allocated_result_bytes_{0};
+
   std::vector<uint64_t> all_frag_row_offsets_;
   std::mutex all_frag_row_offsets_mutex_;
   std::vector<InputTableInfo> query_infos_;
@@ -67,6 +91,7 @@ class SharedKernelContext {
   threading::task_group* task_group_;
   tbb::enumerable_thread_specific<std::unique_ptr<QueryExecutionContext>>
       tls_execution_context_;
+  MorselDispenser morsel_dispenser_;
 #endif  // HAVE_TBB
 };
 
@@ -97,6 +122,17 @@ class ExecutionKernel {
            const size_t thread_idx,
            SharedKernelContext& shared_context);
 
+  // Sub-tasks keep running after run() returns. The guard is shared with them
+  // and is destroyed when the kernel and all its sub-tasks are done.
+  void setDoneGuard(std::shared_ptr<ScopeGuard> guard) { done_guard_ = std::move(guard); }
+
+  const FragmentsList& getFragmentsList() const { return frag_list; }
+  const ColumnFetcher& getColumnFetcher() const { return column_fetcher; }
+  ExecutorDeviceType getDeviceType() const { return chosen_device_type; }
+  int getDeviceId() const { return chosen_device_id; }
+  // NUMA node to run the kernel on or -1 when there is no preference.
+  int getPreferredNumaNode() const;
+
   const RelAlgExecutionUnit& ra_exe_unit_;
 
  private:
@@ -111,6 +147,7 @@ class ExecutionKernel {
   const int64_t rowid_lookup_key;
 
   ResultSetPtr device_results_;
+  std::shared_ptr<ScopeGuard> done_guard_;
 
   void runImpl(Executor* executor,
                const size_t thread_idx,
@@ -26,10 +26,11 @@
 // Classes that are involved in needing a cache invalidated
 #include "JoinHashTable/BaselineJoinHashTable.h"
 #include "JoinHashTable/PerfectJoinHashTable.h"
+#include "JoinHashTable/RangeJoinHashTable.h"
 
 // Note that this is functionally the same as the above two invalidators. The
 // JoinHashTableCacheInvalidator is a generic invalidator used during `clear_cpu` calls.
 // The above cache invalidators are specific invalidators called during update/delete and
 // will likely be extended in the future.
 using JoinHashTableCacheInvalidator =
-    CacheInvalidator<BaselineJoinHashTable, PerfectJoinHashTable>;
+    CacheInvalidator<BaselineJoinHashTable, PerfectJoinHashTable, RangeJoinHashTable>;
@@ -16,6 +16,7 @@
 
 #include "DynamicWatchdog.h"
 #include "Execute.h"
+#include "KernelScheduler.h"
 
 extern bool g_enable_runtime_query_interrupt;
 extern bool g_enable_non_kernel_time_query_interrupt;
@@ -86,6 +87,8 @@ void Executor::interrupt(const std::string& query_session,
     }
     // mark the interrupted status of this executor
     interrupted_.store(true);
+    // wake up kernels of the query waiting for a slot in the kernel scheduler
+    KernelScheduler::instance().notifyInterrupted();
   }
 
   // for both GPU and CPU kernel execution, interrupt flag that running kernel accesses
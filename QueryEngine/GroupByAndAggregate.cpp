@@ -53,6 +53,8 @@
 bool g_bigint_count{false};
 int g_hll_precision_bits{11};
 size_t g_watchdog_baseline_max_groups{120000000};
+bool g_enable_radix_partitioned_group_by{true};
+size_t g_radix_partitioned_group_by_threshold{1000000};
 
 extern bool g_enable_watchdog;
 namespace {
@@ -166,6 +168,12 @@ ColRangeInfo get_expr_range_info(const RelAlgExecutionUnit& ra_exe_unit,
 }  // namespace
 
 ColRangeInfo GroupByAndAggregate::getColRangeInfo() {
+  auto col_range_info = getColRangeInfoImpl();
+  col_range_info.radix_partitions = getRadixPartitionCount(col_range_info);
+  return col_range_info;
+}
+
+ColRangeInfo GroupByAndAggregate::getColRangeInfoImpl() {
   // Use baseline layout more eagerly on the GPU if the query uses count distinct,
   // because our HyperLogLog implementation is 4x less memory efficient on GPU.
   // Technically, this only applies to APPROX_COUNT_DISTINCT, but in practice we
@@ -287,6 +295,33 @@ ColRangeInfo GroupByAndAggregate::getColRangeInfo() {
   return col_range_info;
 }
 
+// High-cardinality baseline hash results are reduced through radix partitioning on
+// CPU. Every partition is aggregated into its own hash table which should fit into
+// the L2 cache, so the number of partitions is chosen from the estimated number of
+// groups.
+size_t GroupByAndAggregate::getRadixPartitionCount(
+    const ColRangeInfo& col_range_info) const {
+  if (!g_enable_radix_partitioned_group_by ||
+      col_range_info.hash_type_ != QueryDescriptionType::GroupByBaselineHash ||
+      device_type_ != ExecutorDeviceType::CPU || !group_cardinality_estimation_ ||
+      *group_cardinality_estimation_ <
+          static_cast<int64_t>(g_radix_partitioned_group_by_threshold)) {
+    return 0;
+  }
+  constexpr size_t kPartitionBytes = 512 * 1024;
+  constexpr size_t kMaxPartitions = 1 << 12;
+  const size_t row_bytes =
+      (ra_exe_unit_.groupby_exprs.size() + ra_exe_unit_.target_exprs.size()) *
+      sizeof(int64_t);
+  // Partition tables are sized for 2/3 load factor.
+  const size_t total_bytes = *group_cardinality_estimation_ * row_bytes * 3 / 2;
+  size_t partitions = 2;
+  while (partitions < kMaxPartitions && total_bytes / partitions > kPartitionBytes) {
+    partitions *= 2;
+  }
+  return partitions;
+}
+
 int64_t GroupByAndAggregate::getBucketedCardinality(const ColRangeInfo& col_range_info) {
   checked_int64_t crt_col_cardinality =
       checked_int64_t(col_range_info.max) - checked_int64_t(col_range_info.min);
@@ -683,6 +718,16 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
       break;
     }
   }
+  // Groups are written right into their radix partitions, so that the reduction
+  // reads every partition from a contiguous range of each kernel buffer.
+  if (device_type_ == ExecutorDeviceType::CPU &&
+      query_mem_desc->getQueryDescriptionType() ==
+          QueryDescriptionType::GroupByBaselineHash &&
+      query_mem_desc->getRadixPartitionCount() > 1 &&
+      !query_mem_desc->didOutputColumnar() &&
+      query_mem_desc->getEntryCount() >= query_mem_desc->getRadixPartitionCount()) {
+    query_mem_desc->setRadixPartitionedLayout(true);
+  }
   return query_mem_desc;
 }
 
@@ -715,7 +760,8 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
                    col_range_info_nosharding.min,
                    col_range_info_nosharding.max,
                    getShardedTopBucket(col_range_info_nosharding, shard_count),
-                   col_range_info_nosharding.has_nulls};
+                   col_range_info_nosharding.has_nulls,
+                   shard_count ? 0 : col_range_info_nosharding.radix_partitions};
 
   // Non-grouped aggregates do not support accessing aggregated ranges
   // Keyless hash is currently only supported with single-column perfect hash
@@ -1308,6 +1354,13 @@ GroupByAndAggregate::codegenMultiColumnBaselineHash(
     func_name += "_columnar_slot";
   } else {
     func_args.push_back(LL_INT(row_size_quad));
+    if (query_mem_desc.hasRadixPartitionedLayout()) {
+      CHECK(co.device_type == ExecutorDeviceType::CPU);
+      const auto partition_count = query_mem_desc.getRadixPartitionCount();
+      CHECK_EQ(partition_count & (partition_count - 1), size_t(0));
+      func_name += "_radix_partitioned";
+      func_args.push_back(LL_INT(static_cast<int32_t>(__builtin_ctzll(partition_count))));
+    }
   }
   if (co.with_dynamic_watchdog) {
     func_name += "_with_watchdog";
@@ -43,6 +43,8 @@
 
 extern bool g_enable_smem_group_by;
 extern bool g_bigint_count;
+extern bool g_enable_radix_partitioned_group_by;
+extern size_t g_radix_partitioned_group_by_threshold;
 
 struct ColRangeInfo {
   QueryDescriptionType hash_type_;
@@ -50,6 +52,9 @@ struct ColRangeInfo {
   int64_t max;
   int64_t bucket;
   bool has_nulls;
+  // Number of radix partitions used to reduce baseline hash results on CPU,
+  // zero when the results are reduced into a single hash table.
+  size_t radix_partitions{0};
   bool isEmpty() { return min == 0 && max == -1; }
 };
 
@@ -137,6 +142,10 @@ class GroupByAndAggregate {
 
   ColRangeInfo getColRangeInfo();
 
+  ColRangeInfo getColRangeInfoImpl();
+
+  size_t getRadixPartitionCount(const ColRangeInfo& col_range_info) const;
+
   static int64_t getBucketedCardinality(const ColRangeInfo& col_range_info);
 
   llvm::Value* convertNullIfAny(const SQLTypeInfo& arg_type,
@@ -213,6 +222,7 @@ class GroupByAndAggregate {
   friend class QueryMemoryDescriptor;
   friend class CodeGenerator;
   friend class ExecutionKernel;
+  friend class QueryCompilationDescriptor;
   friend struct TargetExprCodegen;
   friend struct TargetExprCodegenBuilder;
 };
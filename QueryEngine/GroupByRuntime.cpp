@@ -81,6 +81,70 @@ extern "C" RUNTIME_EXPORT NEVER_INLINE DEVICE int64_t* get_group_value_with_watc
   return NULL;
 }
 
+// The buffer is split into equal ranges of entries, one per radix partition, and
+// every group is written into the range of its partition. Partitions are taken from
+// the high bits of a hash which differs from the one used to find a slot, it must
+// match get_radix_partition used by the reduction.
+extern "C" RUNTIME_EXPORT ALWAYS_INLINE DEVICE int64_t* get_radix_partition_buffer(
+    int64_t* groups_buffer,
+    const uint32_t partition_entry_count,
+    const int64_t* key,
+    const uint32_t key_count,
+    const uint32_t key_width,
+    const uint32_t row_size_quad,
+    const uint32_t partition_bits) {
+  const uint32_t partition =
+      MurmurHash3(key, key_width * key_count, 0x9e3779b9) >> (32 - partition_bits);
+  return groups_buffer +
+         static_cast<int64_t>(partition) * partition_entry_count * row_size_quad;
+}
+
+extern "C" RUNTIME_EXPORT NEVER_INLINE DEVICE int64_t* get_group_value_radix_partitioned(
+    int64_t* groups_buffer,
+    const uint32_t groups_buffer_entry_count,
+    const int64_t* key,
+    const uint32_t key_count,
+    const uint32_t key_width,
+    const uint32_t row_size_quad,
+    const uint32_t partition_bits) {
+  const uint32_t partition_entry_count = groups_buffer_entry_count >> partition_bits;
+  return get_group_value(get_radix_partition_buffer(groups_buffer,
+                                                    partition_entry_count,
+                                                    key,
+                                                    key_count,
+                                                    key_width,
+                                                    row_size_quad,
+                                                    partition_bits),
+                         partition_entry_count,
+                         key,
+                         key_count,
+                         key_width,
+                         row_size_quad);
+}
+
+extern "C" RUNTIME_EXPORT NEVER_INLINE DEVICE int64_t*
+get_group_value_radix_partitioned_with_watchdog(int64_t* groups_buffer,
+                                                const uint32_t groups_buffer_entry_count,
+                                                const int64_t* key,
+                                                const uint32_t key_count,
+                                                const uint32_t key_width,
+                                                const uint32_t row_size_quad,
+                                                const uint32_t partition_bits) {
+  const uint32_t partition_entry_count = groups_buffer_entry_count >> partition_bits;
+  return get_group_value_with_watchdog(get_radix_partition_buffer(groups_buffer,
+                                                                  partition_entry_count,
+                                                                  key,
+                                                                  key_count,
+                                                                  key_width,
+                                                                  row_size_quad,
+                                                                  partition_bits),
+                                       partition_entry_count,
+                                       key,
+                                       key_count,
+                                       key_width,
+                                       row_size_quad);
+}
+
 extern "C" RUNTIME_EXPORT NEVER_INLINE DEVICE int32_t
 get_group_value_columnar_slot(int64_t* groups_buffer,
                               const uint32_t groups_buffer_entry_count,
@@ -17,6 +17,7 @@
 #include "CodeGenerator.h"
 #include "Execute.h"
 #include "ExternalExecutor.h"
+#include "JoinHashTable/RangeJoinHashTable.h"
 #include "MaxwellCodegenPatch.h"
 #include "RelAlgTranslator.h"
 
@@ -886,6 +887,7 @@ std::shared_ptr<HashJoin> Executor::buildCurrentLevelHashTable(
     if (hash_table_or_error.hash_table) {
       plan_state_->join_info_.join_hash_tables_.push_back(hash_table_or_error.hash_table);
       plan_state_->join_info_.equi_join_tautologies_.push_back(qual_bin_oper);
+      plan_state_->join_info_.join_types_.push_back(current_level_join_conditions.type);
     } else {
       fail_reasons.push_back(hash_table_or_error.fail_reason);
       if (!current_level_hash_table) {
@@ -895,6 +897,30 @@ std::shared_ptr<HashJoin> Executor::buildCurrentLevelHashTable(
       handleNonHashtableQual(current_level_join_conditions.type, qual_bin_oper);
     }
   }
+  // Without an equijoin, try to narrow down the inner rows by inequalities. All the
+  // quals are already handled as non-hashtable quals and are evaluated for the rows
+  // found in the range hash table.
+  if (!current_level_hash_table && g_enable_range_join &&
+      co.device_type == ExecutorDeviceType::CPU) {
+    try {
+      auto range_hash_table =
+          RangeJoinHashTable::getInstance(current_level_join_conditions.quals,
+                                          query_infos,
+                                          MemoryLevel::CPU_LEVEL,
+                                          current_level_join_conditions.type,
+                                          data_provider,
+                                          column_cache,
+                                          this,
+                                          ra_exe_unit.table_id_to_node_map);
+      plan_state_->join_info_.join_hash_tables_.push_back(range_hash_table);
+      plan_state_->join_info_.equi_join_tautologies_.push_back(
+          range_hash_table->getKeyQual());
+      plan_state_->join_info_.join_types_.push_back(current_level_join_conditions.type);
+      current_level_hash_table = range_hash_table;
+    } catch (const HashJoinFail& e) {
+      fail_reasons.emplace_back(e.what());
+    }
+  }
   return current_level_hash_table;
 }
 
@@ -75,7 +75,9 @@ std::shared_ptr<BaselineJoinHashTable> BaselineJoinHashTable::getInstance(
                                 executor,
                                 inner_outer_pairs,
                                 device_count,
-                                hashtable_cache_key.first,
+                                addTableDataVersion(hashtable_cache_key.first,
+                                                    getInnerTableId(inner_outer_pairs),
+                                                    query_infos),
                                 hashtable_cache_key.second,
                                 table_id_to_node_map));
   try {
@@ -275,7 +277,8 @@ void BaselineJoinHashTable::reifyWithLayout(const HashType layout) {
         columns_per_device.front().join_columns.front().num_elems,
         condition_->get_optype(),
         join_type_};
-    hashtable_cache_key_ = getAlternativeCacheKey(cache_key);
+    hashtable_cache_key_ = addTableDataVersion(
+        getAlternativeCacheKey(cache_key), getInnerTableId(), query_infos_);
     VLOG(2) << "Use alternative hashtable cache key due to unavailable query plan dag "
                "extraction";
   }
@@ -640,6 +643,10 @@ int BaselineJoinHashTable::initHashTableForDevice(
                                          getKeyComponentWidth(),
                                          getKeyComponentCount());
         hash_tables_for_device_[device_id] = builder.getHashTable();
+        if (!err && hash_tables_for_device_[device_id]) {
+          hash_tables_for_device_[device_id]->setKeyFilters(
+              buildKeyFilters(inner_outer_pairs_, join_columns, join_column_types));
+        }
         ts2 = std::chrono::steady_clock::now();
         auto hashtable_build_time =
             std::chrono::duration_cast<std::chrono::milliseconds>(ts2 - ts1).count();
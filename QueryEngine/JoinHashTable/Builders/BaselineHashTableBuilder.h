@@ -23,6 +23,22 @@
 #include "QueryEngine/JoinHashTable/Runtime/JoinHashTableGpuUtils.h"
 #include "Shared/thread_count.h"
 
+extern bool g_enable_radix_partitioned_join_build;
+extern size_t g_radix_join_partition_bytes;
+
+// Number of partitions to fill a CPU hash table of the given size in, so that
+// each partition fits the cache. 1 if the whole table fits.
+inline size_t get_radix_join_partition_count(const size_t hash_table_size) {
+  if (!g_enable_radix_partitioned_join_build || !g_radix_join_partition_bytes ||
+      hash_table_size <= g_radix_join_partition_bytes) {
+    return 1;
+  }
+  constexpr size_t max_partition_count{4096};
+  return std::min(
+      (hash_table_size + g_radix_join_partition_bytes - 1) / g_radix_join_partition_bytes,
+      max_partition_count);
+}
+
 template <typename SIZE,
           class KEY_HANDLER,
           typename std::enable_if<sizeof(SIZE) == 4, SIZE>::type* = nullptr>
@@ -283,58 +299,93 @@ class BaselineJoinHashTableBuilder {
       }
 #endif  // !HAVE_TBB
     }
-    std::vector<std::future<int>> fill_cpu_buff_threads;
-    for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
-      fill_cpu_buff_threads.emplace_back(std::async(
-          std::launch::async,
-          [key_handler,
-           keyspace_entry_count,
-           &join_columns,
-           key_component_count,
-           key_component_width,
-           layout,
-           thread_idx,
-           cpu_hash_table_ptr,
-           thread_count,
-           for_semi_join] {
-            switch (key_component_width) {
-              case 4: {
-                return fill_baseline_hash_join_buff<int32_t>(cpu_hash_table_ptr,
-                                                             keyspace_entry_count,
-                                                             -1,
-                                                             for_semi_join,
-                                                             key_component_count,
-                                                             layout == HashType::OneToOne,
-                                                             key_handler,
-                                                             join_columns[0].num_elems,
-                                                             thread_idx,
-                                                             thread_count);
-                break;
-              }
-              case 8: {
-                return fill_baseline_hash_join_buff<int64_t>(cpu_hash_table_ptr,
-                                                             keyspace_entry_count,
-                                                             -1,
-                                                             for_semi_join,
-                                                             key_component_count,
-                                                             layout == HashType::OneToOne,
-                                                             key_handler,
-                                                             join_columns[0].num_elems,
-                                                             thread_idx,
-                                                             thread_count);
-                break;
-              }
-              default:
-                CHECK(false);
-            }
-            return -1;
-          }));
-    }
     int err = 0;
-    for (auto& child : fill_cpu_buff_threads) {
-      int partial_err = child.get();
-      if (partial_err) {
-        err = partial_err;
+    const size_t partition_count =
+        get_radix_join_partition_count(entry_size * keyspace_entry_count);
+    if (partition_count > 1) {
+      VLOG(1) << "Filling CPU Join Hash Table in " << partition_count << " partitions";
+      auto timer_fill = DEBUG_TIMER("CPU Baseline-Hash: partitioned fill");
+      switch (key_component_width) {
+        case 4:
+          err = fill_baseline_hash_join_buff_partitioned_32(cpu_hash_table_ptr,
+                                                            keyspace_entry_count,
+                                                            -1,
+                                                            for_semi_join,
+                                                            key_component_count,
+                                                            layout == HashType::OneToOne,
+                                                            key_handler,
+                                                            partition_count,
+                                                            thread_count);
+          break;
+        case 8:
+          err = fill_baseline_hash_join_buff_partitioned_64(cpu_hash_table_ptr,
+                                                            keyspace_entry_count,
+                                                            -1,
+                                                            for_semi_join,
+                                                            key_component_count,
+                                                            layout == HashType::OneToOne,
+                                                            key_handler,
+                                                            partition_count,
+                                                            thread_count);
+          break;
+        default:
+          CHECK(false);
+      }
+    } else {
+      std::vector<std::future<int>> fill_cpu_buff_threads;
+      for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+        fill_cpu_buff_threads.emplace_back(std::async(
+            std::launch::async,
+            [key_handler,
+             keyspace_entry_count,
+             &join_columns,
+             key_component_count,
+             key_component_width,
+             layout,
+             thread_idx,
+             cpu_hash_table_ptr,
+             thread_count,
+             for_semi_join] {
+              switch (key_component_width) {
+                case 4: {
+                  return fill_baseline_hash_join_buff<int32_t>(
+                      cpu_hash_table_ptr,
+                      keyspace_entry_count,
+                      -1,
+                      for_semi_join,
+                      key_component_count,
+                      layout == HashType::OneToOne,
+                      key_handler,
+                      join_columns[0].num_elems,
+                      thread_idx,
+                      thread_count);
+                  break;
+                }
+                case 8: {
+                  return fill_baseline_hash_join_buff<int64_t>(
+                      cpu_hash_table_ptr,
+                      keyspace_entry_count,
+                      -1,
+                      for_semi_join,
+                      key_component_count,
+                      layout == HashType::OneToOne,
+                      key_handler,
+                      join_columns[0].num_elems,
+                      thread_idx,
+                      thread_count);
+                  break;
+                }
+                default:
+                  CHECK(false);
+              }
+              return -1;
+            }));
+      }
+      for (auto& child : fill_cpu_buff_threads) {
+        int partial_err = child.get();
+        if (partial_err) {
+          err = partial_err;
+        }
       }
     }
     if (err) {
@@ -20,6 +20,8 @@
 
 #include "Shared/scope.h"
 
+extern bool g_enable_partitioned_one_to_many_build;
+
 class PerfectJoinHashTableBuilder {
  public:
   PerfectJoinHashTableBuilder() {}
@@ -310,7 +312,10 @@ class PerfectJoinHashTableBuilder {
       auto timer_fill = DEBUG_TIMER(
           "CPU One-To-Many Perfect Hash Table Builder: fill_hash_join_buff_bucketized");
       if (ti.get_type() == kDATE) {
-        fill_one_to_many_hash_table_bucketized(
+        auto fill_func = g_enable_partitioned_one_to_many_build
+                             ? fill_one_to_many_hash_table_partitioned_bucketized
+                             : fill_one_to_many_hash_table_bucketized;
+        fill_func(
             cpu_hash_table_buff,
             hash_entry_info,
             hash_join_invalid_val,
@@ -327,7 +332,10 @@ class PerfectJoinHashTableBuilder {
                                       : 0 /*dummy*/,
             thread_count);
       } else {
-        fill_one_to_many_hash_table(
+        auto fill_func = g_enable_partitioned_one_to_many_build
+                             ? fill_one_to_many_hash_table_partitioned
+                             : fill_one_to_many_hash_table;
+        fill_func(
             cpu_hash_table_buff,
             hash_entry_info,
             hash_join_invalid_val,
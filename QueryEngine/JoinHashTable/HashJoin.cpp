@@ -21,10 +21,13 @@
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/JoinHashTable/BaselineJoinHashTable.h"
 #include "QueryEngine/JoinHashTable/PerfectJoinHashTable.h"
+#include "QueryEngine/JoinHashTable/RangeJoinHashTable.h"
 #include "QueryEngine/RangeTableIndexVisitor.h"
 #include "QueryEngine/RuntimeFunctions.h"
 #include "QueryEngine/ScalarExprVisitor.h"
 
+#include <boost/functional/hash.hpp>
+
 //! fetchJoinColumn() calls ColumnFetcher::makeJoinColumn(), then copies the
 //! JoinColumn's col_chunks_buff memory onto the GPU if required by the
 //! effective_memory_level parameter. The dev_buff_owner parameter will
@@ -259,22 +262,43 @@ std::shared_ptr<HashJoin> HashJoin::getInstance(
                                                           hashtable_build_dag_map,
                                                           table_id_to_node_map);
     } catch (TooManyHashEntries&) {
-      const auto join_quals = coalesce_singleton_equi_join(qual_bin_oper);
-      CHECK_EQ(join_quals.size(), size_t(1));
-      const auto join_qual =
-          std::dynamic_pointer_cast<Analyzer::BinOper>(join_quals.front());
-      VLOG(1) << "Trying to build keyed hash table after perfect hash table:";
-      join_hash_table = BaselineJoinHashTable::getInstance(join_qual,
-                                                           query_infos,
-                                                           memory_level,
-                                                           join_type,
-                                                           preferred_hash_type,
-                                                           device_count,
-                                                           data_provider,
-                                                           column_cache,
-                                                           executor,
-                                                           hashtable_build_dag_map,
-                                                           table_id_to_node_map);
+      // Sparse keys of an inner column already sorted, e.g. timestamps, are
+      // probed by a binary search over the sorted column instead of a keyed hash
+      // table.
+      if (g_enable_sorted_index_join && memory_level == Data_Namespace::CPU_LEVEL) {
+        try {
+          VLOG(1) << "Trying to build sorted index table after perfect hash table:";
+          join_hash_table =
+              RangeJoinHashTable::getSortedIndexInstance(qual_bin_oper,
+                                                         query_infos,
+                                                         memory_level,
+                                                         join_type,
+                                                         data_provider,
+                                                         column_cache,
+                                                         executor,
+                                                         table_id_to_node_map);
+        } catch (const HashJoinFail& e) {
+          VLOG(1) << "Could not build sorted index table: " << e.what();
+        }
+      }
+      if (!join_hash_table) {
+        const auto join_quals = coalesce_singleton_equi_join(qual_bin_oper);
+        CHECK_EQ(join_quals.size(), size_t(1));
+        const auto join_qual =
+            std::dynamic_pointer_cast<Analyzer::BinOper>(join_quals.front());
+        VLOG(1) << "Trying to build keyed hash table after perfect hash table:";
+        join_hash_table = BaselineJoinHashTable::getInstance(join_qual,
+                                                             query_infos,
+                                                             memory_level,
+                                                             join_type,
+                                                             preferred_hash_type,
+                                                             device_count,
+                                                             data_provider,
+                                                             column_cache,
+                                                             executor,
+                                                             hashtable_build_dag_map,
+                                                             table_id_to_node_map);
+      }
     }
   }
   CHECK(join_hash_table);
@@ -342,6 +366,29 @@ const StringDictionaryProxy::IdMap* HashJoin::translateInnerToOuterStrDictProxie
   return nullptr;
 }
 
+std::vector<std::shared_ptr<const JoinKeyFilter>> HashJoin::buildKeyFilters(
+    const std::vector<InnerOuter>& inner_outer_pairs,
+    const std::vector<JoinColumn>& join_columns,
+    const std::vector<JoinColumnTypeInfo>& join_column_types) {
+  auto timer = DEBUG_TIMER(__func__);
+  CHECK_EQ(inner_outer_pairs.size(), join_columns.size());
+  CHECK_EQ(inner_outer_pairs.size(), join_column_types.size());
+  std::vector<std::shared_ptr<const JoinKeyFilter>> key_filters;
+  if (!g_enable_join_key_filter) {
+    return key_filters;
+  }
+  for (size_t i = 0; i < inner_outer_pairs.size(); ++i) {
+    // Nulls are not in the filter, so it cannot be used if nulls match.
+    const auto& inner_ti = inner_outer_pairs[i].first->get_type_info();
+    if (inner_ti.is_integer() && !join_column_types[i].uses_bw_eq) {
+      key_filters.push_back(JoinKeyFilter::build(join_columns[i], join_column_types[i]));
+    } else {
+      key_filters.push_back(nullptr);
+    }
+  }
+  return key_filters;
+}
+
 CompositeKeyInfo HashJoin::getCompositeKeyInfo(
     const std::vector<InnerOuter>& inner_outer_pairs,
     const Executor* executor) {
@@ -721,6 +768,25 @@ InnerOuter HashJoin::normalizeColumnPair(const Analyzer::Expr* lhs,
   return {normalized_inner_col, normalized_outer_col};
 }
 
+QueryPlanHash HashJoin::addTableDataVersion(
+    QueryPlanHash cache_key,
+    int table_id,
+    const std::vector<InputTableInfo>& query_infos) {
+  if (cache_key == EMPTY_HASHED_PLAN_DAG_KEY) {
+    return cache_key;
+  }
+  for (auto& query_info : query_infos) {
+    if (query_info.table_id != table_id) {
+      continue;
+    }
+    for (auto& frag : query_info.info.fragments) {
+      boost::hash_combine(cache_key, frag.fragmentId);
+      boost::hash_combine(cache_key, frag.getPhysicalNumTuples());
+    }
+  }
+  return cache_key;
+}
+
 std::vector<InnerOuter> HashJoin::normalizeColumnPairs(
     const Analyzer::BinOper* condition,
     SchemaProviderPtr schema_provider,
@@ -133,7 +133,7 @@ class HashJoin {
   }
 
   static std::string getHashTypeString(HashType ht) noexcept {
-    const char* HashTypeStrings[3] = {"OneToOne", "OneToMany", "ManyToMany"};
+    const char* HashTypeStrings[4] = {"OneToOne", "OneToMany", "ManyToMany", "Range"};
     return HashTypeStrings[static_cast<int>(ht)];
   };
 
@@ -225,6 +225,14 @@ class HashJoin {
     return first_inner_col->get_table_id();
   }
 
+  // Mix ids and sizes of the table's fragments into the hash table cache key.
+  // Storages give new ids to modified fragments, so hash tables built over an
+  // outdated version of the table are not reused.
+  static QueryPlanHash addTableDataVersion(
+      QueryPlanHash cache_key,
+      int table_id,
+      const std::vector<InputTableInfo>& query_infos);
+
   // Swap the columns if needed and make the inner column the first component.
   static InnerOuter normalizeColumnPair(const Analyzer::Expr* lhs,
                                         const Analyzer::Expr* rhs,
@@ -285,6 +293,13 @@ class HashJoin {
     hash_tables_for_device_.swap(empty_hash_tables);
   }
 
+  // Key filters of a hash table built on CPU from the given inner columns, used to
+  // skip the outer fragments without matches.
+  static std::vector<std::shared_ptr<const JoinKeyFilter>> buildKeyFilters(
+      const std::vector<InnerOuter>& inner_outer_pairs,
+      const std::vector<JoinColumn>& join_columns,
+      const std::vector<JoinColumnTypeInfo>& join_column_types);
+
   static CompositeKeyInfo getCompositeKeyInfo(
       const std::vector<InnerOuter>& inner_outer_pairs,
       const Executor* executor);
@@ -16,13 +16,15 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
 #include <tuple>
 #include <vector>
 
 #include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/JoinHashTable/JoinKeyFilter.h"
 
-enum class HashType : int { OneToOne, OneToMany, ManyToMany };
+enum class HashType : int { OneToOne, OneToMany, ManyToMany, Range };
 
 struct DecodedJoinHashBufferEntry {
   std::vector<int64_t> key;
@@ -52,6 +54,16 @@ class HashTable {
   virtual size_t getEntryCount() const = 0;
   virtual size_t getEmittedKeysCount() const = 0;
 
+  // Filters of the keys per key component, set for tables built on CPU. Null for
+  // the components without a filter.
+  const std::vector<std::shared_ptr<const JoinKeyFilter>>& getKeyFilters() const {
+    return key_filters_;
+  }
+
+  void setKeyFilters(std::vector<std::shared_ptr<const JoinKeyFilter>> key_filters) {
+    key_filters_ = std::move(key_filters);
+  }
+
   //! Decode hash table into a std::set for easy inspection and validation.
   static DecodedJoinHashBufferSet toSet(
       size_t key_component_count,  // number of key parts
@@ -76,4 +88,7 @@ class HashTable {
       const int8_t* ptr4,              // payloads (rowids)
       size_t buffer_size,
       bool raw = false);
+
+ private:
+  std::vector<std::shared_ptr<const JoinKeyFilter>> key_filters_;
 };
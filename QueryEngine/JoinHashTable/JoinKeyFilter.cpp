@@ -0,0 +1,84 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/JoinHashTable/JoinKeyFilter.h"
+#include "QueryEngine/JoinHashTable/Runtime/HashJoinRuntime.h"
+#include "QueryEngine/JoinHashTable/Runtime/JoinColumnIterator.h"
+#include "Logger/Logger.h"
+
+#include <algorithm>
+#include <limits>
+
+bool g_enable_join_key_filter{true};
+
+JoinKeyFilter::JoinKeyFilter(const int64_t min, const int64_t max)
+    : empty_(false), min_(min), max_(max) {
+  CHECK_LE(min, max);
+  const uint64_t range_minus_one =
+      static_cast<uint64_t>(max_) - static_cast<uint64_t>(min_);
+  bucket_width_ = range_minus_one / kMaxBucketCount + 1;
+  bitmap_.resize(getBucket(max_) / 64 + 1, 0);
+}
+
+std::shared_ptr<JoinKeyFilter> JoinKeyFilter::build(
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info) {
+  CHECK(type_info.column_type == Signed || type_info.column_type == Unsigned);
+  JoinColumnTyped col{&join_column, &type_info};
+  bool has_keys = false;
+  int64_t min = std::numeric_limits<int64_t>::max();
+  int64_t max = std::numeric_limits<int64_t>::min();
+  for (auto item : col.slice(0, 1)) {
+    const auto key = item.element;
+    if (key != type_info.null_val) {
+      has_keys = true;
+      min = std::min(min, key);
+      max = std::max(max, key);
+    }
+  }
+  if (!has_keys) {
+    return std::make_shared<JoinKeyFilter>();
+  }
+  auto filter = std::make_shared<JoinKeyFilter>(min, max);
+  for (auto item : col.slice(0, 1)) {
+    const auto key = item.element;
+    if (key != type_info.null_val) {
+      filter->add(key);
+    }
+  }
+  return filter;
+}
+
+bool JoinKeyFilter::mayContain(const int64_t min, const int64_t max) const {
+  const auto lo = std::max(min, min_);
+  const auto hi = std::min(max, max_);
+  if (empty_ || lo > hi) {
+    return false;
+  }
+  const auto lo_bucket = getBucket(lo);
+  const auto hi_bucket = getBucket(hi);
+  for (size_t word_idx = lo_bucket / 64; word_idx <= hi_bucket / 64; ++word_idx) {
+    auto word = bitmap_[word_idx];
+    if (word_idx == lo_bucket / 64) {
+      word &= ~uint64_t(0) << (lo_bucket % 64);
+    }
+    if (word_idx == hi_bucket / 64 && hi_bucket % 64 != 63) {
+      word &= (uint64_t(1) << (hi_bucket % 64 + 1)) - 1;
+    }
+    if (word) {
+      return true;
+    }
+  }
+  return false;
+}
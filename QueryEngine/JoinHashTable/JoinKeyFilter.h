@@ -0,0 +1,69 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+extern bool g_enable_join_key_filter;
+
+struct JoinColumn;
+struct JoinColumnTypeInfo;
+
+/**
+ * Summary of the integer keys of a join hash table component: the range of the
+ * keys and a bitmap of the sub-ranges containing at least one key. It answers
+ * whether a range of values, e.g. the chunk stats of an outer table fragment,
+ * may contain a key, so outer fragments without matches can be skipped. Nulls
+ * are never added to the filter.
+ */
+class JoinKeyFilter {
+ public:
+  static constexpr size_t kMaxBucketCount{size_t(1) << 16};
+
+  // Filter without keys.
+  JoinKeyFilter() = default;
+  // Filter for keys in [min, max], initially without keys.
+  JoinKeyFilter(const int64_t min, const int64_t max);
+
+  // Filter of the non-null keys of an integer column.
+  static std::shared_ptr<JoinKeyFilter> build(const JoinColumn& join_column,
+                                              const JoinColumnTypeInfo& type_info);
+
+  void add(const int64_t key) {
+    const auto bucket = getBucket(key);
+    bitmap_[bucket / 64] |= uint64_t(1) << (bucket % 64);
+  }
+
+  // False if none of the keys is in [min, max].
+  bool mayContain(const int64_t min, const int64_t max) const;
+
+  bool empty() const { return empty_; }
+  int64_t getMin() const { return min_; }
+  int64_t getMax() const { return max_; }
+
+ private:
+  size_t getBucket(const int64_t key) const {
+    return (static_cast<uint64_t>(key) - static_cast<uint64_t>(min_)) / bucket_width_;
+  }
+
+  bool empty_{true};
+  int64_t min_{0};
+  int64_t max_{0};
+  uint64_t bucket_width_{1};
+  std::vector<uint64_t> bitmap_;
+};
@@ -168,7 +168,8 @@ std::shared_ptr<PerfectJoinHashTable> PerfectJoinHashTable::getInstance(
                                               join_type,
                                               hashtable_build_dag_map,
                                               executor);
-  auto hash_key = hashtable_cache_key.first;
+  auto hash_key = addTableDataVersion(
+      hashtable_cache_key.first, inner_col->get_table_id(), query_infos);
   decltype(std::chrono::steady_clock::now()) ts1, ts2;
   if (VLOGGING(1)) {
     ts1 = std::chrono::steady_clock::now();
@@ -354,7 +355,8 @@ void PerfectJoinHashTable::reify() {
             columns_per_device[device_id].join_columns.front().num_elems,
             qual_bin_oper_->get_optype(),
             join_type_};
-        hashtable_cache_key_ = getAlternativeCacheKey(cache_key);
+        hashtable_cache_key_ = addTableDataVersion(
+            getAlternativeCacheKey(cache_key), getInnerTableId(), query_infos_);
         VLOG(2) << "Use alternative hashtable cache key due to unavailable query plan "
                    "dag extraction";
       }
@@ -588,6 +590,18 @@ int PerfectJoinHashTable::initHashTableForDevice(
                                                 executor_);
             hash_table = builder.getHashTable();
           }
+          if (hash_table) {
+            const auto& ti = inner_col->get_type_info();
+            const JoinColumnTypeInfo type_info{static_cast<size_t>(ti.get_size()),
+                                               0,
+                                               0,
+                                               inline_fixed_encoding_null_val(ti),
+                                               isBitwiseEq(),
+                                               0,
+                                               get_join_column_type_kind(ti)};
+            hash_table->setKeyFilters(
+                buildKeyFilters({cols}, {join_column}, {type_info}));
+          }
           ts2 = std::chrono::steady_clock::now();
           auto build_time =
               std::chrono::duration_cast<std::chrono::milliseconds>(ts2 - ts1).count();
@@ -0,0 +1,74 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <memory>
+
+#include "Logger/Logger.h"
+#include "QueryEngine/JoinHashTable/HashTable.h"
+
+/**
+ * Inner rows of a range join or of a sorted index sorted by a key column. The buffer
+ * holds the sorted keys (int64) followed by the row ids (int32) in the same order. The
+ * max width is the largest distance between the key and the opposite bound of the
+ * band of an inner row, -1 if the join has no opposite bound.
+ */
+class RangeHashTable : public HashTable {
+ public:
+  RangeHashTable(const size_t entry_count, const int64_t max_width)
+      : entry_count_(entry_count)
+      , max_width_(max_width)
+      , cpu_hash_table_buff_(new int64_t[entry_count + (entry_count + 1) / 2]) {}
+
+  size_t getHashTableBufferSize(const ExecutorDeviceType device_type) const override {
+    CHECK(device_type == ExecutorDeviceType::CPU);
+    return entry_count_ * (sizeof(int64_t) + sizeof(int32_t));
+  }
+
+  int8_t* getCpuBuffer() override {
+    return reinterpret_cast<int8_t*>(cpu_hash_table_buff_.get());
+  }
+
+  int8_t* getGpuBuffer() const override { return nullptr; }
+
+  HashType getLayout() const override { return HashType::Range; }
+
+  size_t getEntryCount() const override { return entry_count_; }
+
+  size_t getEmittedKeysCount() const override { return entry_count_; }
+
+  int64_t* getKeys() const { return cpu_hash_table_buff_.get(); }
+
+  int32_t* getRowIds() const {
+    return reinterpret_cast<int32_t*>(cpu_hash_table_buff_.get() + entry_count_);
+  }
+
+  int64_t getMaxWidth() const { return max_width_; }
+
+  void setMaxWidth(const int64_t max_width) { max_width_ = max_width; }
+
+  // Drops the entries past entry_count, e.g. the inner rows skipped by the build.
+  void shrink(const size_t entry_count) {
+    CHECK_LE(entry_count, entry_count_);
+    std::memmove(getKeys() + entry_count, getRowIds(), entry_count * sizeof(int32_t));
+    entry_count_ = entry_count;
+  }
+
+ private:
+  size_t entry_count_;
+  int64_t max_width_;
+  std::unique_ptr<int64_t[]> cpu_hash_table_buff_;
+};
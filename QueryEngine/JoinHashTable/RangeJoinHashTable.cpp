@@ -0,0 +1,531 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/JoinHashTable/RangeJoinHashTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <sstream>
+
+#include "Logger/Logger.h"
+#include "QueryEngine/CodeGenerator.h"
+#include "QueryEngine/ColumnFetcher.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/JoinHashTable/PerfectJoinHashTable.h"
+#include "QueryEngine/JoinHashTable/Runtime/HashJoinRuntime.h"
+#include "QueryEngine/JoinHashTable/Runtime/JoinColumnIterator.h"
+#include "Shared/parallel_sort.h"
+
+bool g_enable_range_join{true};
+bool g_enable_sorted_index_join{false};
+
+std::unique_ptr<HashtableRecycler> RangeJoinHashTable::hash_table_cache_ =
+    std::make_unique<HashtableRecycler>(CacheItemType::RANGE_HT,
+                                        DataRecyclerUtil::CPU_DEVICE_IDENTIFIER);
+
+namespace {
+
+// A join qual normalized to `inner optype outer`.
+struct RangeJoinQual {
+  std::shared_ptr<Analyzer::BinOper> qual;
+  InnerOuter cols;
+  SQLOps optype;
+};
+
+bool is_lower_inequality(const SQLOps optype) {
+  return optype == kLT || optype == kLE;
+}
+
+const Analyzer::Expr* remove_cast(const Analyzer::Expr* expr) {
+  const auto uoper = dynamic_cast<const Analyzer::UOper*>(expr);
+  return uoper && uoper->get_optype() == kCAST ? uoper->get_operand() : expr;
+}
+
+// The keys are compared as the integers read from the inner column, the outer
+// values must have the same scale.
+bool is_range_join_supported(const SQLTypeInfo& inner_ti, const SQLTypeInfo& outer_ti) {
+  if (inner_ti.is_integer() && outer_ti.is_integer()) {
+    return true;
+  }
+  if (inner_ti.is_decimal() && outer_ti.is_decimal()) {
+    return inner_ti.get_scale() == outer_ti.get_scale();
+  }
+  if (inner_ti.is_time() && outer_ti.is_time()) {
+    // The dates encoded in days are not read as the seconds the outer values are.
+    return !inner_ti.is_date_in_days() && inner_ti.get_type() == outer_ti.get_type() &&
+           inner_ti.get_dimension() == outer_ti.get_dimension();
+  }
+  return false;
+}
+
+// Normalizes an equality or an inequality supported by the range hash table.
+std::optional<RangeJoinQual> normalize_range_join_qual(
+    const std::shared_ptr<Analyzer::Expr>& qual,
+    const bool equality,
+    Executor* executor) {
+  auto bin_oper = std::dynamic_pointer_cast<Analyzer::BinOper>(qual);
+  if (!bin_oper || bin_oper->get_qualifier() != kONE) {
+    return std::nullopt;
+  }
+  const auto optype = bin_oper->get_optype();
+  if (equality ? optype != kEQ
+               : optype != kLT && optype != kLE && optype != kGT && optype != kGE) {
+    return std::nullopt;
+  }
+  const auto lhs = bin_oper->get_left_operand();
+  const auto rhs = bin_oper->get_right_operand();
+  if (dynamic_cast<const Analyzer::ExpressionTuple*>(lhs)) {
+    return std::nullopt;
+  }
+  InnerOuter cols;
+  try {
+    cols = HashJoin::normalizeColumnPair(
+        lhs, rhs, executor->getSchemaProvider(), executor->getTemporaryTables());
+  } catch (const HashJoinFail& e) {
+    VLOG(2) << "Cannot use range join for " << bin_oper->toString() << ": " << e.what();
+    return std::nullopt;
+  }
+  if (cols.first->is_virtual() ||
+      !is_range_join_supported(cols.first->get_type_info(),
+                               cols.second->get_type_info())) {
+    return std::nullopt;
+  }
+  const bool inner_is_lhs = remove_cast(lhs) == cols.first;
+  return RangeJoinQual{
+      bin_oper, cols, inner_is_lhs ? optype : COMMUTE_COMPARISON(optype)};
+}
+
+// The column is ordered across the fragments if the value ranges of the consecutive
+// fragments don't overlap. The order inside of the fragments is checked by the build.
+bool is_sorted_by_chunk_stats(const Analyzer::ColumnVar* inner_col,
+                              const std::vector<FragmentInfo>& fragments) {
+  const auto& ti = inner_col->get_type_info();
+  std::optional<int64_t> prev_max;
+  for (const auto& fragment : fragments) {
+    if (!fragment.getNumTuples()) {
+      continue;
+    }
+    const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+    const auto chunk_meta_it = chunk_metadata_map.find(inner_col->get_column_id());
+    if (chunk_meta_it == chunk_metadata_map.end()) {
+      return false;
+    }
+    const auto& chunk_stats = chunk_meta_it->second->chunkStats;
+    const auto chunk_min = extract_min_stat_int_type(chunk_stats, ti);
+    const auto chunk_max = extract_max_stat_int_type(chunk_stats, ti);
+    // Fragments of nulls only.
+    if (chunk_min > chunk_max) {
+      continue;
+    }
+    if (prev_max && *prev_max > chunk_min) {
+      return false;
+    }
+    prev_max = chunk_max;
+  }
+  return true;
+}
+
+JoinColumnTypeInfo get_join_column_type_info(const Analyzer::ColumnVar* inner_col) {
+  const auto& ti = inner_col->get_type_info();
+  return JoinColumnTypeInfo{static_cast<size_t>(ti.get_size()),
+                            0,
+                            0,
+                            inline_fixed_encoding_null_val(ti),
+                            false,
+                            0,
+                            get_join_column_type_kind(ti)};
+}
+
+}  // namespace
+
+std::shared_ptr<RangeJoinHashTable> RangeJoinHashTable::getInstance(
+    const std::list<std::shared_ptr<Analyzer::Expr>>& join_quals,
+    const std::vector<InputTableInfo>& query_infos,
+    const Data_Namespace::MemoryLevel memory_level,
+    const JoinType join_type,
+    DataProvider* data_provider,
+    ColumnCacheMap& column_cache,
+    Executor* executor,
+    const TableIdToNodeMap& table_id_to_node_map) {
+  if (memory_level != Data_Namespace::CPU_LEVEL) {
+    throw HashJoinFail("Range join is only supported on CPU");
+  }
+  // Semi and anti joins stop at the first match, the range table only narrows
+  // down the candidates and the remaining quals must be checked for all of them.
+  if (join_type != JoinType::INNER && join_type != JoinType::LEFT) {
+    throw HashJoinFail("Range join supports only inner and left joins");
+  }
+  std::vector<RangeJoinQual> inequalities;
+  for (const auto& qual : join_quals) {
+    if (auto inequality = normalize_range_join_qual(qual, false, executor)) {
+      inequalities.push_back(*inequality);
+    }
+  }
+  if (inequalities.empty()) {
+    throw HashJoinFail("No inequality supported by range join found");
+  }
+  const auto& key = inequalities.front();
+  std::optional<RangeJoinQual> bound;
+  for (size_t i = 1; i < inequalities.size(); ++i) {
+    const auto& candidate = inequalities[i];
+    if (is_lower_inequality(candidate.optype) != is_lower_inequality(key.optype) &&
+        candidate.cols.first->get_table_id() == key.cols.first->get_table_id() &&
+        candidate.cols.first->get_rte_idx() == key.cols.first->get_rte_idx() &&
+        *candidate.cols.second == *key.cols.second) {
+      bound = candidate;
+      break;
+    }
+  }
+
+  return reifyInstance(std::shared_ptr<RangeJoinHashTable>(
+      new RangeJoinHashTable(key.qual,
+                             key.cols,
+                             key.optype,
+                             bound ? bound->qual : nullptr,
+                             bound ? std::make_optional(bound->cols) : std::nullopt,
+                             query_infos,
+                             join_type,
+                             data_provider,
+                             column_cache,
+                             executor,
+                             table_id_to_node_map)));
+}
+
+std::shared_ptr<RangeJoinHashTable> RangeJoinHashTable::getSortedIndexInstance(
+    const std::shared_ptr<Analyzer::BinOper> qual_bin_oper,
+    const std::vector<InputTableInfo>& query_infos,
+    const Data_Namespace::MemoryLevel memory_level,
+    const JoinType join_type,
+    DataProvider* data_provider,
+    ColumnCacheMap& column_cache,
+    Executor* executor,
+    const TableIdToNodeMap& table_id_to_node_map) {
+  if (memory_level != Data_Namespace::CPU_LEVEL) {
+    throw HashJoinFail("Sorted index join is only supported on CPU");
+  }
+  if (join_type != JoinType::INNER && join_type != JoinType::LEFT) {
+    throw HashJoinFail("Sorted index join supports only inner and left joins");
+  }
+  const auto equality = normalize_range_join_qual(qual_bin_oper, true, executor);
+  if (!equality) {
+    throw HashJoinFail("Equijoin not supported by sorted index join: " +
+                       qual_bin_oper->toString());
+  }
+  const auto inner_col = equality->cols.first;
+  const auto& query_info =
+      get_inner_query_info(inner_col->get_table_id(), query_infos).info;
+  if (!is_sorted_by_chunk_stats(inner_col, query_info.fragments)) {
+    throw HashJoinFail(
+        "Inner column of sorted index join is not ordered across fragments");
+  }
+  return reifyInstance(std::shared_ptr<RangeJoinHashTable>(
+      new RangeJoinHashTable(equality->qual,
+                             equality->cols,
+                             equality->optype,
+                             nullptr,
+                             std::nullopt,
+                             query_infos,
+                             join_type,
+                             data_provider,
+                             column_cache,
+                             executor,
+                             table_id_to_node_map)));
+}
+
+std::shared_ptr<RangeJoinHashTable> RangeJoinHashTable::reifyInstance(
+    std::shared_ptr<RangeJoinHashTable> join_hash_table) {
+  decltype(std::chrono::steady_clock::now()) ts1, ts2;
+  if (VLOGGING(1)) {
+    ts1 = std::chrono::steady_clock::now();
+  }
+  try {
+    join_hash_table->reify();
+  } catch (const HashJoinFail& e) {
+    join_hash_table->freeHashBufferMemory();
+    throw HashJoinFail(std::string("Could not build range join hash table | ") +
+                       e.what());
+  } catch (const ColumnarConversionNotSupported& e) {
+    throw HashJoinFail(std::string("Could not build range join hash table | ") +
+                       e.what());
+  } catch (const TooManyHashEntries& e) {
+    throw HashJoinFail(std::string("Could not build range join hash table | ") +
+                       e.what());
+  } catch (const OutOfMemory& e) {
+    throw HashJoinFail(
+        std::string("Ran out of memory while building range join hash table | ") +
+        e.what());
+  } catch (const std::exception& e) {
+    throw std::runtime_error(
+        std::string("Fatal error while attempting to build hash tables for join: ") +
+        e.what());
+  }
+  if (VLOGGING(1)) {
+    ts2 = std::chrono::steady_clock::now();
+    const auto& bound_qual = join_hash_table->bound_qual_;
+    VLOG(1) << "Built range hash table for " << join_hash_table->key_qual_->toString()
+            << (bound_qual ? " bounded by " + bound_qual->toString() : std::string())
+            << " in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(ts2 - ts1).count()
+            << " ms";
+  }
+  return join_hash_table;
+}
+
+void RangeJoinHashTable::reify() {
+  auto timer = DEBUG_TIMER(__func__);
+  const auto& query_info = get_inner_query_info(getInnerTableId(), query_infos_).info;
+  if (query_info.getNumTuplesUpperBound() >
+      static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+    throw TooManyHashEntries();
+  }
+  if (query_info.fragments.empty()) {
+    hash_tables_for_device_[0] = std::make_shared<RangeHashTable>(0, -1);
+    return;
+  }
+  // Tables of temporary results are not cached, their ids are not stable.
+  const auto cache_key = getInnerTableId() > 0 ? getCacheKey(query_info.getNumTuples())
+                                               : EMPTY_HASHED_PLAN_DAG_KEY;
+  std::shared_ptr<RangeHashTable> hash_table;
+  if (cache_key != EMPTY_HASHED_PLAN_DAG_KEY) {
+    hash_table = std::dynamic_pointer_cast<RangeHashTable>(
+        hash_table_cache_->getItemFromCache(
+            cache_key, CacheItemType::RANGE_HT, DataRecyclerUtil::CPU_DEVICE_IDENTIFIER));
+  }
+  if (!hash_table) {
+    const auto ts1 = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
+    std::vector<std::shared_ptr<void>> malloc_owner;
+    const auto fetch_column = [&](const Analyzer::ColumnVar* inner_col) {
+      return fetchJoinColumn(inner_col,
+                             query_info.fragments,
+                             Data_Namespace::CPU_LEVEL,
+                             0,
+                             chunks_owner,
+                             nullptr,
+                             malloc_owner,
+                             executor_,
+                             &column_cache_);
+    };
+    const auto key_column = fetch_column(key_cols_.first);
+    std::optional<JoinColumn> bound_column;
+    if (bound_cols_) {
+      bound_column = fetch_column(bound_cols_->first);
+    }
+    hash_table =
+        initHashTableOnCpu(key_column, bound_column ? &*bound_column : nullptr);
+    const auto build_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                std::chrono::steady_clock::now() - ts1)
+                                .count();
+    if (cache_key != EMPTY_HASHED_PLAN_DAG_KEY) {
+      hash_table_cache_->putItemToCache(
+          cache_key,
+          hash_table,
+          CacheItemType::RANGE_HT,
+          DataRecyclerUtil::CPU_DEVICE_IDENTIFIER,
+          hash_table->getHashTableBufferSize(ExecutorDeviceType::CPU),
+          build_time);
+    }
+  }
+  hash_tables_for_device_[0] = hash_table;
+}
+
+std::shared_ptr<RangeHashTable> RangeJoinHashTable::initHashTableOnCpu(
+    const JoinColumn& key_column,
+    const JoinColumn* bound_column) {
+  auto timer = DEBUG_TIMER(__func__);
+  const auto key_type_info = get_join_column_type_info(key_cols_.first);
+  // Opposite bounds of the bands by row id.
+  std::vector<int64_t> bounds;
+  int64_t bound_null_val{0};
+  if (bound_column) {
+    CHECK(bound_cols_);
+    CHECK_EQ(bound_column->num_elems, key_column.num_elems);
+    const auto bound_type_info = get_join_column_type_info(bound_cols_->first);
+    bound_null_val = bound_type_info.null_val;
+    bounds.resize(bound_column->num_elems);
+    JoinColumnTyped bound_col{bound_column, &bound_type_info};
+    for (auto item : bound_col.slice(0, 1)) {
+      bounds[item.index] = item.element;
+    }
+  }
+
+  const bool key_is_lower = is_lower_inequality(key_optype_);
+  auto hash_table = std::make_shared<RangeHashTable>(key_column.num_elems, -1);
+  const auto keys = hash_table->getKeys();
+  const auto row_ids = hash_table->getRowIds();
+  size_t entry_count{0};
+  bool sorted{true};
+  int64_t max_width = bound_column ? 0 : -1;
+  JoinColumnTyped key_col{&key_column, &key_type_info};
+  for (auto item : key_col.slice(0, 1)) {
+    const auto key = item.element;
+    // Nulls never match.
+    if (key == key_type_info.null_val) {
+      continue;
+    }
+    if (bound_column) {
+      const auto bound = bounds[item.index];
+      const auto band_start = key_is_lower ? key : bound;
+      const auto band_end = key_is_lower ? bound : key;
+      if (bound == bound_null_val || band_end < band_start) {
+        continue;
+      }
+      const auto width =
+          std::min(static_cast<uint64_t>(band_end) - static_cast<uint64_t>(band_start),
+                   static_cast<uint64_t>(std::numeric_limits<int64_t>::max()));
+      max_width = std::max(max_width, static_cast<int64_t>(width));
+    }
+    sorted = sorted && (!entry_count || keys[entry_count - 1] <= key);
+    keys[entry_count] = key;
+    row_ids[entry_count] = static_cast<int32_t>(item.index);
+    ++entry_count;
+  }
+  hash_table->shrink(entry_count);
+  hash_table->setMaxWidth(max_width);
+
+  // Inputs already ordered by the key, e.g. time series, are used as is.
+  if (!sorted) {
+    if (key_optype_ == kEQ) {
+      throw HashJoinFail("Inner column of sorted index join is not sorted");
+    }
+    parallel_sort_by_key(hash_table->getKeys(),
+                         hash_table->getRowIds(),
+                         entry_count,
+                         std::less<int64_t>());
+  }
+  return hash_table;
+}
+
+QueryPlanHash RangeJoinHashTable::getCacheKey(const size_t num_elements) const {
+  const auto get_chunk_key = [](const Analyzer::ColumnVar* inner_col) {
+    return ChunkKey{
+        inner_col->get_db_id(), inner_col->get_table_id(), inner_col->get_column_id()};
+  };
+  auto hash = boost::hash_value(::toString(get_chunk_key(key_cols_.first)));
+  boost::hash_combine(hash, ::toString(key_optype_));
+  if (bound_cols_) {
+    boost::hash_combine(hash, ::toString(get_chunk_key(bound_cols_->first)));
+  }
+  boost::hash_combine(hash, num_elements);
+  return addTableDataVersion(hash, getInnerTableId(), query_infos_);
+}
+
+RangeHashTable* RangeJoinHashTable::getRangeHashTable() const {
+  return dynamic_cast<RangeHashTable*>(getHashTableForDevice(0));
+}
+
+size_t RangeJoinHashTable::getComponentBufferSize() const noexcept {
+  const auto hash_table = getRangeHashTable();
+  return hash_table ? hash_table->getEntryCount() * sizeof(int64_t) : 0;
+}
+
+llvm::Value* RangeJoinHashTable::codegenSlot(const CompilationOptions&, const size_t) {
+  UNREACHABLE() << "Range hash tables have no one-to-one layout";
+  return nullptr;
+}
+
+HashJoinMatchingSet RangeJoinHashTable::codegenMatchingSet(const CompilationOptions& co,
+                                                           const size_t index) {
+  AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
+  auto cgen_state = executor_->cgen_state_.get();
+  auto& ir_builder = cgen_state->ir_builder_;
+  const auto outer_expr = key_cols_.second;
+  CodeGenerator code_generator(executor_);
+  const auto value_lvs = code_generator.codegen(outer_expr, true, co);
+  CHECK_EQ(size_t(1), value_lvs.size());
+  const auto value_lv = cgen_state->castToTypeIn(value_lvs.front(), 64);
+
+  const auto hash_table = getRangeHashTable();
+  const int64_t entry_count = hash_table ? hash_table->getEntryCount() : 0;
+  const int64_t max_width = hash_table ? hash_table->getMaxWidth() : -1;
+  auto hash_ptr = HashJoin::codegenHashTableLoad(index, executor_);
+  if (!hash_ptr->getType()->isIntegerTy(64)) {
+    CHECK(hash_ptr->getType()->isPointerTy());
+    hash_ptr = ir_builder.CreatePtrToInt(
+        hash_ptr, llvm::Type::getInt64Ty(cgen_state->context_));
+  }
+  const auto keys_lv = ir_builder.CreateIntToPtr(
+      hash_ptr, llvm::Type::getInt64PtrTy(cgen_state->context_));
+  const auto row_ids_lv = ir_builder.CreateIntToPtr(
+      ir_builder.CreateAdd(hash_ptr, cgen_state->llInt(getComponentBufferSize())),
+      llvm::Type::getInt32PtrTy(cgen_state->context_));
+  const auto entry_count_lv = cgen_state->llInt(entry_count);
+  const auto codegen_bound = [&](const bool upper_bound, const int64_t offset) {
+    return cgen_state->emitCall(
+        upper_bound ? "range_join_upper_bound" : "range_join_lower_bound",
+        {keys_lv, entry_count_lv, value_lv, cgen_state->llInt(offset)});
+  };
+
+  // The keys matching the inequality are a prefix (inner <= outer) or a suffix
+  // (inner >= outer) of the sorted keys. The band width bounds the other side.
+  llvm::Value* begin_lv{nullptr};
+  llvm::Value* end_lv{nullptr};
+  if (key_optype_ == kEQ) {
+    begin_lv = codegen_bound(false, 0);
+    end_lv = codegen_bound(true, 0);
+  } else if (is_lower_inequality(key_optype_)) {
+    begin_lv =
+        max_width >= 0 ? codegen_bound(false, -max_width) : cgen_state->llInt(int64_t(0));
+    end_lv = codegen_bound(key_optype_ == kLE, 0);
+  } else {
+    begin_lv = codegen_bound(key_optype_ == kGT, 0);
+    end_lv = max_width >= 0 ? codegen_bound(true, max_width) : entry_count_lv;
+  }
+  llvm::Value* count_lv = ir_builder.CreateSub(end_lv, begin_lv);
+  const auto& outer_ti = outer_expr->get_type_info();
+  if (!outer_ti.get_notnull()) {
+    const auto null_lv = cgen_state->llInt(
+        inline_fixed_encoding_null_val(get_logical_type_info(outer_ti)));
+    count_lv = ir_builder.CreateSelect(ir_builder.CreateICmpEQ(value_lv, null_lv),
+                                       cgen_state->llInt(int64_t(0)),
+                                       count_lv);
+  }
+  const auto elements_lv = ir_builder.CreateGEP(
+      row_ids_lv->getType()->getScalarType()->getPointerElementType(),
+      row_ids_lv,
+      begin_lv);
+  return {elements_lv, count_lv, begin_lv};
+}
+
+DecodedJoinHashBufferSet RangeJoinHashTable::toSet(const ExecutorDeviceType device_type,
+                                                   const int device_id) const {
+  CHECK(device_type == ExecutorDeviceType::CPU);
+  DecodedJoinHashBufferSet s;
+  const auto hash_table = getRangeHashTable();
+  if (!hash_table) {
+    return s;
+  }
+  const auto keys = hash_table->getKeys();
+  const auto row_ids = hash_table->getRowIds();
+  for (size_t i = 0; i < hash_table->getEntryCount();) {
+    DecodedJoinHashBufferEntry entry{{keys[i]}, {}};
+    for (; i < hash_table->getEntryCount() && keys[i] == entry.key.front(); ++i) {
+      entry.payload.insert(row_ids[i]);
+    }
+    s.insert(std::move(entry));
+  }
+  return s;
+}
+
+std::string RangeJoinHashTable::toString(const ExecutorDeviceType device_type,
+                                         const int device_id,
+                                         bool raw) const {
+  const auto hash_table = getRangeHashTable();
+  std::ostringstream os;
+  os << "| range " << ::toString(key_optype_) << " | max width "
+     << (hash_table ? hash_table->getMaxWidth() : -1) << " | "
+     << toSet(device_type, device_id);
+  return os.str();
+}
@@ -0,0 +1,182 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Analyzer/Analyzer.h"
+#include "QueryEngine/DataRecycler/HashtableRecycler.h"
+#include "QueryEngine/JoinHashTable/HashJoin.h"
+#include "QueryEngine/JoinHashTable/RangeHashTable.h"
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+extern bool g_enable_range_join;
+extern bool g_enable_sorted_index_join;
+
+/**
+ * Join on inequalities between an inner column and an outer expression, e.g.
+ * `a.ts BETWEEN b.start AND b.end`. The inner rows are sorted by the column of
+ * one of the inequalities and the rows matching it are found by a binary search.
+ * When the join also has the opposite inequality on another inner column, the
+ * largest band width of the inner rows bounds the search from the other side.
+ *
+ * The probe only narrows the inner rows down to a superset of the matches, all the
+ * join quals are still evaluated for the candidates.
+ *
+ * The same table serves as a sorted index for equijoins on inner columns which are
+ * already sorted, it replaces a keyed hash table when the keys are too sparse for a
+ * perfect one. The whole inner column is kept in memory and every outer row is
+ * probed by a binary search, this is not a streaming merge of both inputs.
+ */
+class RangeJoinHashTable : public HashJoin {
+ public:
+  //! Make range hash table from the quals of a join level, throws HashJoinFail when
+  //! none of the quals is an inequality supported by the table.
+  static std::shared_ptr<RangeJoinHashTable> getInstance(
+      const std::list<std::shared_ptr<Analyzer::Expr>>& join_quals,
+      const std::vector<InputTableInfo>& query_infos,
+      const Data_Namespace::MemoryLevel memory_level,
+      const JoinType join_type,
+      DataProvider* data_provider,
+      ColumnCacheMap& column_cache,
+      Executor* executor,
+      const TableIdToNodeMap& table_id_to_node_map);
+
+  //! Make sorted index table for an equijoin, throws HashJoinFail when the inner
+  //! column is not sorted.
+  static std::shared_ptr<RangeJoinHashTable> getSortedIndexInstance(
+      const std::shared_ptr<Analyzer::BinOper> qual_bin_oper,
+      const std::vector<InputTableInfo>& query_infos,
+      const Data_Namespace::MemoryLevel memory_level,
+      const JoinType join_type,
+      DataProvider* data_provider,
+      ColumnCacheMap& column_cache,
+      Executor* executor,
+      const TableIdToNodeMap& table_id_to_node_map);
+
+  std::string toString(const ExecutorDeviceType device_type,
+                       const int device_id = 0,
+                       bool raw = false) const override;
+
+  DecodedJoinHashBufferSet toSet(const ExecutorDeviceType device_type,
+                                 const int device_id) const override;
+
+  llvm::Value* codegenSlot(const CompilationOptions&, const size_t) override;
+
+  HashJoinMatchingSet codegenMatchingSet(const CompilationOptions&,
+                                         const size_t) override;
+
+  int getInnerTableId() const noexcept override {
+    return key_cols_.first->get_table_id();
+  }
+
+  int getInnerTableRteIdx() const noexcept override {
+    return key_cols_.first->get_rte_idx();
+  }
+
+  HashType getHashType() const noexcept override { return HashType::Range; }
+
+  Data_Namespace::MemoryLevel getMemoryLevel() const noexcept override {
+    return Data_Namespace::CPU_LEVEL;
+  }
+
+  int getDeviceCount() const noexcept override { return 1; }
+
+  size_t offsetBufferOff() const noexcept override { return 0; }
+
+  size_t countBufferOff() const noexcept override { return 0; }
+
+  size_t payloadBufferOff() const noexcept override { return getComponentBufferSize(); }
+
+  std::string getHashJoinType() const final {
+    return key_optype_ == kEQ ? "Merge" : "Range";
+  }
+
+  bool isBitwiseEq() const override { return false; }
+
+  // The qual the inner rows are sorted by.
+  std::shared_ptr<Analyzer::BinOper> getKeyQual() const { return key_qual_; }
+
+  static HashtableRecycler* getHashTableCache() {
+    CHECK(hash_table_cache_);
+    return hash_table_cache_.get();
+  }
+
+  static auto getCacheInvalidator() -> std::function<void()> {
+    CHECK(hash_table_cache_);
+    return hash_table_cache_->getCacheInvalidator();
+  }
+
+  virtual ~RangeJoinHashTable() {}
+
+ private:
+  RangeJoinHashTable(std::shared_ptr<Analyzer::BinOper> key_qual,
+                     const InnerOuter& key_cols,
+                     const SQLOps key_optype,
+                     std::shared_ptr<Analyzer::BinOper> bound_qual,
+                     const std::optional<InnerOuter>& bound_cols,
+                     const std::vector<InputTableInfo>& query_infos,
+                     const JoinType join_type,
+                     DataProvider* data_provider,
+                     ColumnCacheMap& column_cache,
+                     Executor* executor,
+                     const TableIdToNodeMap& table_id_to_node_map)
+      : HashJoin(data_provider)
+      , key_qual_(key_qual)
+      , key_cols_(key_cols)
+      , key_optype_(key_optype)
+      , bound_qual_(bound_qual)
+      , bound_cols_(bound_cols)
+      , query_infos_(query_infos)
+      , join_type_(join_type)
+      , executor_(executor)
+      , column_cache_(column_cache)
+      , table_id_to_node_map_(table_id_to_node_map) {
+    hash_tables_for_device_.resize(1);
+  }
+
+  static std::shared_ptr<RangeJoinHashTable> reifyInstance(
+      std::shared_ptr<RangeJoinHashTable> join_hash_table);
+
+  void reify();
+
+  std::shared_ptr<RangeHashTable> initHashTableOnCpu(const JoinColumn& key_column,
+                                                     const JoinColumn* bound_column);
+
+  QueryPlanHash getCacheKey(const size_t num_elements) const;
+
+  RangeHashTable* getRangeHashTable() const;
+
+  size_t getComponentBufferSize() const noexcept override;
+
+  // The equality or the inequality the inner rows are sorted by, normalized to
+  // `inner key_optype_ outer`.
+  std::shared_ptr<Analyzer::BinOper> key_qual_;
+  InnerOuter key_cols_;
+  SQLOps key_optype_;
+  // The opposite inequality with the same outer expression, if any.
+  std::shared_ptr<Analyzer::BinOper> bound_qual_;
+  std::optional<InnerOuter> bound_cols_;
+  const std::vector<InputTableInfo>& query_infos_;
+  const JoinType join_type_;
+  Executor* executor_;
+  ColumnCacheMap& column_cache_;
+  const TableIdToNodeMap table_id_to_node_map_;
+
+  static std::unique_ptr<HashtableRecycler> hash_table_cache_;
+};
@@ -39,6 +39,7 @@
 #include <tbb/parallel_for.h>
 #endif
 
+#include <atomic>
 #include <future>
 #endif
 
@@ -216,6 +217,40 @@ void SUFFIX(init_hash_join_buff_tbb)(int32_t* groups_buffer,
 #define mapd_cas(address, compare, val) __sync_val_compare_and_swap(address, compare, val)
 #endif
 
+// Maps an inner value to the value its slot is selected by: nulls go to the translated
+// null slot for bitwise equality joins and dictionary ids are translated to the outer
+// dictionary. Returns false for the values which don't have a slot.
+FORCE_INLINE DEVICE bool get_slot_elem(int64_t& elem,
+                                       const JoinColumnTypeInfo& type_info
+#ifndef __CUDACC__
+                                       ,
+                                       const int32_t* sd_inner_to_outer_translation_map,
+                                       const int32_t min_inner_elem
+#endif
+) {
+  if (elem == type_info.null_val) {
+    if (!type_info.uses_bw_eq) {
+      return false;
+    }
+    elem = type_info.translated_null_val;
+  }
+#ifndef __CUDACC__
+  if (sd_inner_to_outer_translation_map &&
+      (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
+    const auto outer_id = map_str_id_to_outer_dict(elem,
+                                                   min_inner_elem,
+                                                   type_info.min_val,
+                                                   type_info.max_val,
+                                                   sd_inner_to_outer_translation_map);
+    if (outer_id == StringDictionary::INVALID_STR_ID) {
+      return false;
+    }
+    elem = outer_id;
+  }
+#endif
+  return true;
+}
+
 template <typename HASHTABLE_FILLING_FUNC>
 DEVICE auto fill_hash_join_buff_impl(int32_t* buff,
                                      const int32_t invalid_slot_val,
@@ -237,27 +272,16 @@ DEVICE auto fill_hash_join_buff_impl(int32_t* buff,
   for (auto item : col.slice(start, step)) {
     const size_t index = item.index;
     int64_t elem = item.element;
-    if (elem == type_info.null_val) {
-      if (type_info.uses_bw_eq) {
-        elem = type_info.translated_null_val;
-      } else {
-        continue;
-      }
-    }
+    if (!get_slot_elem(elem,
+                       type_info
 #ifndef __CUDACC__
-    if (sd_inner_to_outer_translation_map &&
-        (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      const auto outer_id = map_str_id_to_outer_dict(elem,
-                                                     min_inner_elem,
-                                                     type_info.min_val,
-                                                     type_info.max_val,
-                                                     sd_inner_to_outer_translation_map);
-      if (outer_id == StringDictionary::INVALID_STR_ID) {
-        continue;
-      }
-      elem = outer_id;
-    }
+                       ,
+                       sd_inner_to_outer_translation_map,
+                       min_inner_elem
 #endif
+                       )) {
+      continue;
+    }
     if (filling_func(elem, index)) {
       return -1;
     }
@@ -655,27 +679,16 @@ DEVICE void count_matches_impl(int32_t* count_buff,
   JoinColumnTyped col{&join_column, &type_info};
   for (auto item : col.slice(start, step)) {
     int64_t elem = item.element;
-    if (elem == type_info.null_val) {
-      if (type_info.uses_bw_eq) {
-        elem = type_info.translated_null_val;
-      } else {
-        continue;
-      }
-    }
+    if (!get_slot_elem(elem,
+                       type_info
 #ifndef __CUDACC__
-    if (sd_inner_to_outer_translation_map &&
-        (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      const auto outer_id = map_str_id_to_outer_dict(elem,
-                                                     min_inner_elem,
-                                                     type_info.min_val,
-                                                     type_info.max_val,
-                                                     sd_inner_to_outer_translation_map);
-      if (outer_id == StringDictionary::INVALID_STR_ID) {
-        continue;
-      }
-      elem = outer_id;
-    }
+                       ,
+                       sd_inner_to_outer_translation_map,
+                       min_inner_elem
 #endif
+                       )) {
+      continue;
+    }
     auto* entry_ptr = slot_selector(count_buff, elem);
     mapd_add(entry_ptr, int32_t(1));
   }
@@ -850,27 +863,16 @@ DEVICE void fill_row_ids_impl(int32_t* buff,
   for (auto item : col.slice(start, step)) {
     const size_t index = item.index;
     int64_t elem = item.element;
-    if (elem == type_info.null_val) {
-      if (type_info.uses_bw_eq) {
-        elem = type_info.translated_null_val;
-      } else {
-        continue;
-      }
-    }
+    if (!get_slot_elem(elem,
+                       type_info
 #ifndef __CUDACC__
-    if (sd_inner_to_outer_translation_map &&
-        (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      const auto outer_id = map_str_id_to_outer_dict(elem,
-                                                     min_inner_elem,
-                                                     type_info.min_val,
-                                                     type_info.max_val,
-                                                     sd_inner_to_outer_translation_map);
-      if (outer_id == StringDictionary::INVALID_STR_ID) {
-        continue;
-      }
-      elem = outer_id;
-    }
+                       ,
+                       sd_inner_to_outer_translation_map,
+                       min_inner_elem
 #endif
+                       )) {
+      continue;
+    }
     auto pos_ptr = slot_selector(pos_buff, elem);
     const auto bin_idx = pos_ptr - pos_buff;
     const auto id_buff_idx = mapd_add(count_buff + bin_idx, 1) + *pos_ptr;
@@ -1378,6 +1380,241 @@ void fill_one_to_many_hash_table_bucketized(
                                    launch_fill_row_ids);
 }
 
+template <typename SLOT_SELECTOR>
+void fill_one_to_many_hash_table_partitioned_impl(
+    int32_t* buff,
+    const int64_t hash_entry_count,
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const unsigned cpu_thread_count,
+    SLOT_SELECTOR slot_selector) {
+  auto timer = DEBUG_TIMER(__func__);
+  CHECK_GT(hash_entry_count, int64_t(0));
+  CHECK_GT(cpu_thread_count, 0u);
+  int32_t* pos_buff = buff;
+  int32_t* count_buff = buff + hash_entry_count;
+  int32_t* id_buff = count_buff + hash_entry_count;
+  const size_t row_count = join_column.num_elems;
+  const size_t rows_per_thread = (row_count + cpu_thread_count - 1) / cpu_thread_count;
+  // A partition is a range of slots. There are a few partitions per thread to even
+  // out the skew of the keys.
+  const int64_t partition_count =
+      std::min(static_cast<int64_t>(cpu_thread_count) * 8, hash_entry_count);
+  const int64_t partition_size =
+      (hash_entry_count + partition_count - 1) / partition_count;
+  const auto run_tasks = [cpu_thread_count](const int64_t task_count,
+                                            const auto& task) {
+    std::vector<std::future<void>> threads;
+    for (unsigned cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count;
+         ++cpu_thread_idx) {
+      threads.push_back(std::async(std::launch::async, [&, cpu_thread_idx] {
+        for (int64_t task_idx = cpu_thread_idx; task_idx < task_count;
+             task_idx += cpu_thread_count) {
+          task(task_idx);
+        }
+      }));
+    }
+    for (auto& child : threads) {
+      child.get();
+    }
+  };
+
+  // Count pass: every thread finds the slots of a contiguous range of the rows and
+  // counts the rows per partition in its own histogram.
+  std::vector<int32_t> row_slots(row_count);
+  std::vector<std::vector<int64_t>> partition_offsets_per_thread(
+      cpu_thread_count, std::vector<int64_t>(partition_count, 0));
+  run_tasks(cpu_thread_count, [&](const int64_t thread_idx) {
+    const size_t start = thread_idx * rows_per_thread;
+    const size_t end = std::min(start + rows_per_thread, row_count);
+    if (start >= end) {
+      return;
+    }
+    auto& histogram = partition_offsets_per_thread[thread_idx];
+    for (JoinColumnIterator it(&join_column, &type_info, start, 1); it && it.index < end;
+         ++it) {
+      const auto item = *it;
+      int64_t elem = item.element;
+      if (!get_slot_elem(
+              elem, type_info, sd_inner_to_outer_translation_map, min_inner_elem)) {
+        row_slots[item.index] = -1;
+        continue;
+      }
+      const auto slot = static_cast<int32_t>(slot_selector(pos_buff, elem) - pos_buff);
+      row_slots[item.index] = slot;
+      ++histogram[slot / partition_size];
+    }
+  });
+
+  // The histograms turn into the offsets of the rows of a thread in the partitions,
+  // the partitions are stored in the order of the slots.
+  std::vector<int64_t> partition_offsets(partition_count + 1);
+  int64_t offset{0};
+  for (int64_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+    partition_offsets[partition_idx] = offset;
+    for (auto& thread_offsets : partition_offsets_per_thread) {
+      const auto partition_row_count = thread_offsets[partition_idx];
+      thread_offsets[partition_idx] = offset;
+      offset += partition_row_count;
+    }
+  }
+  partition_offsets[partition_count] = offset;
+
+  // Scatter pass: the threads write the row ids to their own ranges of the
+  // partitions, the rows of a partition stay in ascending order.
+  std::vector<int32_t> partitioned_rows(offset);
+  run_tasks(cpu_thread_count, [&](const int64_t thread_idx) {
+    const size_t start = thread_idx * rows_per_thread;
+    const size_t end = std::min(start + rows_per_thread, row_count);
+    auto& thread_offsets = partition_offsets_per_thread[thread_idx];
+    for (size_t row_idx = start; row_idx < end; ++row_idx) {
+      const auto slot = row_slots[row_idx];
+      if (slot >= 0) {
+        partitioned_rows[thread_offsets[slot / partition_size]++] =
+            static_cast<int32_t>(row_idx);
+      }
+    }
+  });
+
+  // A partition with a lot more rows than the average one, e.g. the partition of a
+  // frequent key, is split into chunks of rows which are filled by different threads.
+  const int64_t partitioned_row_count = offset;
+  const int64_t max_chunk_row_count = std::max(
+      int64_t(1), 2 * ((partitioned_row_count + partition_count - 1) / partition_count));
+  std::vector<int64_t> partition_chunks(partition_count + 1);
+  int64_t chunk_count{0};
+  for (int64_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+    partition_chunks[partition_idx] = chunk_count;
+    const auto partition_row_count =
+        partition_offsets[partition_idx + 1] - partition_offsets[partition_idx];
+    chunk_count +=
+        std::max(int64_t(1),
+                 (partition_row_count + max_chunk_row_count - 1) / max_chunk_row_count);
+  }
+  partition_chunks[partition_count] = chunk_count;
+  const auto get_slot_range = [&](const int64_t partition_idx) {
+    const int64_t slot_start = std::min(partition_idx * partition_size, hash_entry_count);
+    return std::make_pair(slot_start,
+                          std::min(slot_start + partition_size, hash_entry_count));
+  };
+  const auto get_chunk_rows = [&](const int64_t partition_idx, const int64_t chunk_idx) {
+    const auto partition_start = partition_offsets[partition_idx];
+    const auto partition_end = partition_offsets[partition_idx + 1];
+    const auto chunk_start = std::min(
+        partition_start +
+            (chunk_idx - partition_chunks[partition_idx]) * max_chunk_row_count,
+        partition_end);
+    return std::make_pair(partitioned_rows.begin() + chunk_start,
+                          partitioned_rows.begin() +
+                              std::min(chunk_start + max_chunk_row_count, partition_end));
+  };
+  std::vector<int64_t> chunk_partitions(chunk_count);
+  for (int64_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+    std::fill(chunk_partitions.begin() + partition_chunks[partition_idx],
+              chunk_partitions.begin() + partition_chunks[partition_idx + 1],
+              partition_idx);
+  }
+
+  // Fill count pass: every chunk counts its rows per slot of its partition.
+  std::vector<std::vector<int32_t>> chunk_slot_counts(chunk_count);
+  run_tasks(chunk_count, [&](const int64_t chunk_idx) {
+    const auto partition_idx = chunk_partitions[chunk_idx];
+    const auto [slot_start, slot_end] = get_slot_range(partition_idx);
+    auto& slot_counts = chunk_slot_counts[chunk_idx];
+    slot_counts.resize(slot_end - slot_start, 0);
+    const auto [rows_start, rows_end] = get_chunk_rows(partition_idx, chunk_idx);
+    for (auto row_it = rows_start; row_it != rows_end; ++row_it) {
+      ++slot_counts[row_slots[*row_it] - slot_start];
+    }
+  });
+
+  // Fill position pass: a partition owns its slots, their counts and positions are
+  // written without atomics. The counts of a chunk turn into the positions of its rows.
+  run_tasks(partition_count, [&](const int64_t partition_idx) {
+    const auto [slot_start, slot_end] = get_slot_range(partition_idx);
+    int64_t pos = partition_offsets[partition_idx];
+    for (int64_t slot = slot_start; slot < slot_end; ++slot) {
+      int32_t slot_count{0};
+      for (auto chunk_idx = partition_chunks[partition_idx];
+           chunk_idx < partition_chunks[partition_idx + 1];
+           ++chunk_idx) {
+        auto& chunk_slot_count = chunk_slot_counts[chunk_idx][slot - slot_start];
+        const auto chunk_slot_rows = chunk_slot_count;
+        chunk_slot_count = pos + slot_count;
+        slot_count += chunk_slot_rows;
+      }
+      count_buff[slot] = slot_count;
+      if (slot_count) {
+        pos_buff[slot] = pos;
+        pos += slot_count;
+      }
+    }
+  });
+
+  // Fill row id pass: the chunks of a partition write the row ids to their own ranges
+  // of the slots, the rows of a slot stay in ascending order.
+  run_tasks(chunk_count, [&](const int64_t chunk_idx) {
+    const auto partition_idx = chunk_partitions[chunk_idx];
+    const auto slot_start = get_slot_range(partition_idx).first;
+    auto& slot_positions = chunk_slot_counts[chunk_idx];
+    const auto [rows_start, rows_end] = get_chunk_rows(partition_idx, chunk_idx);
+    for (auto row_it = rows_start; row_it != rows_end; ++row_it) {
+      id_buff[slot_positions[row_slots[*row_it] - slot_start]++] = *row_it;
+    }
+  });
+}
+
+void fill_one_to_many_hash_table_partitioned(
+    int32_t* buff,
+    const HashEntryInfo hash_entry_info,
+    const int32_t invalid_slot_val,
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const unsigned cpu_thread_count) {
+  auto timer = DEBUG_TIMER(__func__);
+  auto slot_sel = [&type_info](auto pos_buff, auto elem) {
+    return SUFFIX(get_hash_slot)(pos_buff, elem, type_info.min_val);
+  };
+  fill_one_to_many_hash_table_partitioned_impl(buff,
+                                               hash_entry_info.hash_entry_count,
+                                               join_column,
+                                               type_info,
+                                               sd_inner_to_outer_translation_map,
+                                               min_inner_elem,
+                                               cpu_thread_count,
+                                               slot_sel);
+}
+
+void fill_one_to_many_hash_table_partitioned_bucketized(
+    int32_t* buff,
+    const HashEntryInfo hash_entry_info,
+    const int32_t invalid_slot_val,
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const unsigned cpu_thread_count) {
+  auto timer = DEBUG_TIMER(__func__);
+  const auto bucket_normalization = hash_entry_info.bucket_normalization;
+  auto slot_sel = [&type_info, bucket_normalization](auto pos_buff, auto elem) {
+    return SUFFIX(get_bucketized_hash_slot)(
+        pos_buff, elem, type_info.min_val, bucket_normalization);
+  };
+  fill_one_to_many_hash_table_partitioned_impl(
+      buff,
+      hash_entry_info.getNormalizedHashEntryCount(),
+      join_column,
+      type_info,
+      sd_inner_to_outer_translation_map,
+      min_inner_elem,
+      cpu_thread_count,
+      slot_sel);
+}
+
 void init_baseline_hash_join_buff_32(int8_t* hash_join_buff,
                                      const int64_t entry_count,
                                      const size_t key_component_count,
@@ -1478,6 +1715,172 @@ int fill_baseline_hash_join_buff_64(int8_t* hash_buff,
                                                cpu_thread_count);
 }
 
+template <typename T>
+int fill_baseline_hash_join_buff_partitioned(int8_t* hash_buff,
+                                             const int64_t entry_count,
+                                             const int32_t invalid_slot_val,
+                                             const bool for_semi_join,
+                                             const size_t key_component_count,
+                                             const bool with_val_slot,
+                                             const GenericKeyHandler* key_handler,
+                                             const size_t partition_count,
+                                             const int32_t cpu_thread_count) {
+  CHECK_GT(entry_count, int64_t(0));
+  CHECK_GT(partition_count, size_t(0));
+  const size_t key_size_in_bytes = key_component_count * sizeof(T);
+  const size_t hash_entry_size =
+      (key_component_count + (with_val_slot ? 1 : 0)) * sizeof(T);
+  // Each partitioned entry is the key followed by the row id.
+  const size_t partition_entry_size = key_component_count + 1;
+
+  // The partition of a key is the range of slots containing its home slot.
+  std::vector<std::vector<std::vector<T>>> partitions_per_thread(
+      cpu_thread_count, std::vector<std::vector<T>>(partition_count));
+  std::vector<std::future<int>> partition_threads;
+  for (int32_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count;
+       ++cpu_thread_idx) {
+    partition_threads.push_back(std::async(
+        std::launch::async,
+        [key_handler,
+         entry_count,
+         key_size_in_bytes,
+         partition_count,
+         cpu_thread_idx,
+         cpu_thread_count,
+         &partitions = partitions_per_thread[cpu_thread_idx]] {
+          T key_scratch_buff[g_maximum_conditions_to_coalesce];
+          auto key_buff_handler =
+              [entry_count, key_size_in_bytes, partition_count, &partitions](
+                  const int64_t entry_idx,
+                  const T* key_scratch_buffer,
+                  const size_t key_component_count) {
+                const uint64_t h =
+                    MurmurHash1Impl(key_scratch_buffer, key_size_in_bytes, 0) %
+                    entry_count;
+                auto& partition = partitions[h * partition_count / entry_count];
+                partition.insert(partition.end(),
+                                 key_scratch_buffer,
+                                 key_scratch_buffer + key_component_count);
+                partition.push_back(static_cast<T>(entry_idx));
+                return 0;
+              };
+          JoinColumnTuple cols(key_handler->get_number_of_columns(),
+                               key_handler->get_join_columns(),
+                               key_handler->get_join_column_type_infos());
+          for (auto& it : cols.slice(cpu_thread_idx, cpu_thread_count)) {
+            const auto err = (*key_handler)(
+                it.join_column_iterators, key_scratch_buff, key_buff_handler);
+            if (err) {
+              return err;
+            }
+          }
+          return 0;
+        }));
+  }
+  int err = 0;
+  for (auto& child : partition_threads) {
+    const auto partial_err = child.get();
+    if (partial_err) {
+      err = partial_err;
+    }
+  }
+  if (err) {
+    return err;
+  }
+
+  // Threads take whole partitions, so the slots written by a thread at a time
+  // are a cache resident range. Keys probing past the end of their range are
+  // still handled by the atomic slot writes.
+  std::atomic<size_t> next_partition{0};
+  std::vector<std::future<int>> fill_threads;
+  for (int32_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count;
+       ++cpu_thread_idx) {
+    fill_threads.push_back(std::async(std::launch::async, [&] {
+      for (size_t partition_idx = next_partition++; partition_idx < partition_count;
+           partition_idx = next_partition++) {
+        for (const auto& partitions : partitions_per_thread) {
+          const auto& partition = partitions[partition_idx];
+          for (size_t i = 0; i < partition.size(); i += partition_entry_size) {
+            const T* key = &partition[i];
+            const auto val = static_cast<int32_t>(key[key_component_count]);
+            const auto err =
+                for_semi_join
+                    ? write_baseline_hash_slot_for_semi_join<T>(val,
+                                                                hash_buff,
+                                                                entry_count,
+                                                                key,
+                                                                key_component_count,
+                                                                with_val_slot,
+                                                                invalid_slot_val,
+                                                                key_size_in_bytes,
+                                                                hash_entry_size)
+                    : write_baseline_hash_slot<T>(val,
+                                                  hash_buff,
+                                                  entry_count,
+                                                  key,
+                                                  key_component_count,
+                                                  with_val_slot,
+                                                  invalid_slot_val,
+                                                  key_size_in_bytes,
+                                                  hash_entry_size);
+            if (err) {
+              return err;
+            }
+          }
+        }
+      }
+      return 0;
+    }));
+  }
+  for (auto& child : fill_threads) {
+    const auto partial_err = child.get();
+    if (partial_err) {
+      err = partial_err;
+    }
+  }
+  return err;
+}
+
+int fill_baseline_hash_join_buff_partitioned_32(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const bool for_semi_join,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                const int32_t cpu_thread_count) {
+  return fill_baseline_hash_join_buff_partitioned<int32_t>(hash_buff,
+                                                           entry_count,
+                                                           invalid_slot_val,
+                                                           for_semi_join,
+                                                           key_component_count,
+                                                           with_val_slot,
+                                                           key_handler,
+                                                           partition_count,
+                                                           cpu_thread_count);
+}
+
+int fill_baseline_hash_join_buff_partitioned_64(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const bool for_semi_join,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                const int32_t cpu_thread_count) {
+  return fill_baseline_hash_join_buff_partitioned<int64_t>(hash_buff,
+                                                           entry_count,
+                                                           invalid_slot_val,
+                                                           for_semi_join,
+                                                           key_component_count,
+                                                           with_val_slot,
+                                                           key_handler,
+                                                           partition_count,
+                                                           cpu_thread_count);
+}
+
 template <typename T>
 void fill_one_to_many_baseline_hash_table(
     int32_t* buff,
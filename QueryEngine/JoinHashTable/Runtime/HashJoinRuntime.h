@@ -214,6 +214,30 @@ void fill_one_to_many_hash_table_bucketized(
     const int32_t min_inner_elem,
     const unsigned cpu_thread_count);
 
+// Fills the one-to-many table without atomics: the threads count the rows of
+// contiguous row ranges per slot partition in their own histograms, scatter the
+// row ids to their own ranges of the partitions and then fill whole partitions.
+// The row ids of a slot end up in ascending order.
+void fill_one_to_many_hash_table_partitioned(
+    int32_t* buff,
+    const HashEntryInfo hash_entry_info,
+    const int32_t invalid_slot_val,
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const unsigned cpu_thread_count);
+
+void fill_one_to_many_hash_table_partitioned_bucketized(
+    int32_t* buff,
+    const HashEntryInfo hash_entry_info,
+    const int32_t invalid_slot_val,
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info,
+    const int32_t* sd_inner_to_outer_translation_map,
+    const int32_t min_inner_elem,
+    const unsigned cpu_thread_count);
+
 void fill_one_to_many_hash_table_on_device(int32_t* buff,
                                            const HashEntryInfo hash_entry_info,
                                            const int32_t invalid_slot_val,
@@ -249,6 +273,33 @@ int fill_baseline_hash_join_buff_64(int8_t* hash_buff,
                                     const int32_t cpu_thread_idx,
                                     const int32_t cpu_thread_count);
 
+// Fills the baseline hash table in two passes: the keys are partitioned by the
+// range of their home slots first, then the threads fill whole partitions. Each
+// partition covers a cache sized range of the table, unlike the strided fill
+// which writes to random slots of the whole table. Only the build is partitioned:
+// the probe is generated inline in the row loop of the query kernel and looks up
+// one outer row at a time, so outer rows cannot be grouped by partition without
+// materializing them ahead of the join.
+int fill_baseline_hash_join_buff_partitioned_32(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const bool for_semi_join,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                const int32_t cpu_thread_count);
+
+int fill_baseline_hash_join_buff_partitioned_64(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const bool for_semi_join,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                const int32_t cpu_thread_count);
+
 void fill_baseline_hash_join_buff_on_device_32(int8_t* hash_buff,
                                                const int64_t entry_count,
                                                const int32_t invalid_slot_val,
@@ -190,6 +190,49 @@ extern "C" RUNTIME_EXPORT NEVER_INLINE DEVICE int32_t insert_sorted(int32_t* arr
   return 1;
 }
 
+// Position of the first of the keys sorted in ascending order which is greater than
+// value + offset (upper bound) or not less than value + offset (lower bound). The
+// sum saturates, the offset only widens the range of candidates.
+template <bool upper_bound>
+FORCE_INLINE DEVICE int64_t range_join_bound_impl(const int64_t* keys,
+                                                  const int64_t key_count,
+                                                  const int64_t value,
+                                                  const int64_t offset) {
+  int64_t bound = value;
+  if (offset > 0) {
+    bound = value > INT64_MAX - offset ? INT64_MAX : value + offset;
+  } else if (offset < 0) {
+    bound = value < INT64_MIN - offset ? INT64_MIN : value + offset;
+  }
+  int64_t lo = 0;
+  int64_t hi = key_count;
+  while (lo < hi) {
+    const int64_t mid = lo + (hi - lo) / 2;
+    if (upper_bound ? keys[mid] <= bound : keys[mid] < bound) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+extern "C" RUNTIME_EXPORT NEVER_INLINE DEVICE int64_t
+range_join_lower_bound(const int64_t* keys,
+                       const int64_t key_count,
+                       const int64_t value,
+                       const int64_t offset) {
+  return range_join_bound_impl<false>(keys, key_count, value, offset);
+}
+
+extern "C" RUNTIME_EXPORT NEVER_INLINE DEVICE int64_t
+range_join_upper_bound(const int64_t* keys,
+                       const int64_t key_count,
+                       const int64_t value,
+                       const int64_t offset) {
+  return range_join_bound_impl<true>(keys, key_count, value, offset);
+}
+
 extern "C" RUNTIME_EXPORT ALWAYS_INLINE DEVICE int64_t
 overlaps_hash_join_idx(int64_t hash_buff,
                        const int64_t key,
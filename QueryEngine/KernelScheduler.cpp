@@ -0,0 +1,113 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/KernelScheduler.h"
+
+#include "Logger/Logger.h"
+#include "Shared/measure.h"
+#include "Shared/thread_count.h"
+
+#include <algorithm>
+
+std::optional<int64_t> KernelScheduler::Query::acquireSlot() {
+  auto clock_begin = timer_start();
+  auto is_interrupted = [this]() { return interrupted_ && interrupted_->load(); };
+  std::unique_lock<std::mutex> lock(scheduler_.mutex_);
+  auto waiter_it =
+      scheduler_.waiters_.insert(scheduler_.waiters_.end(),
+                                 Waiter{this, scheduler_.next_ticket_++});
+  scheduler_.cv_.wait(
+      lock, [&]() { return is_interrupted() || scheduler_.isNext(*waiter_it); });
+  scheduler_.waiters_.erase(waiter_it);
+  const bool interrupted = is_interrupted();
+  if (!interrupted) {
+    ++running_kernels_;
+    ++scheduler_.running_kernels_;
+  }
+  lock.unlock();
+  // Other waiters might be able to run too, e.g. if this query hit its limit
+  // or gave up its turn.
+  scheduler_.cv_.notify_all();
+  if (interrupted) {
+    return std::nullopt;
+  }
+  return timer_stop(clock_begin);
+}
+
+void KernelScheduler::Query::releaseSlot() {
+  {
+    std::lock_guard<std::mutex> lock(scheduler_.mutex_);
+    CHECK_GT(running_kernels_, size_t(0));
+    CHECK_GT(scheduler_.running_kernels_, size_t(0));
+    --running_kernels_;
+    --scheduler_.running_kernels_;
+  }
+  scheduler_.cv_.notify_all();
+}
+
+KernelScheduler::KernelScheduler(size_t num_slots) : num_slots_(num_slots) {
+  CHECK_GT(num_slots_, size_t(0));
+}
+
+KernelScheduler& KernelScheduler::instance() {
+  static KernelScheduler scheduler(std::max(cpu_threads(), 1));
+  return scheduler;
+}
+
+size_t KernelScheduler::numRunningKernels() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return running_kernels_;
+}
+
+size_t KernelScheduler::numWaitingKernels() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return waiters_.size();
+}
+
+void KernelScheduler::notifyInterrupted() {
+  // Waiters check their flags under the mutex, so taking it here guarantees
+  // that a flag set before the call is not missed.
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+  }
+  cv_.notify_all();
+}
+
+bool KernelScheduler::canRun(const Query& query) const {
+  return !query.max_running_kernels_ ||
+         query.running_kernels_ < query.max_running_kernels_;
+}
+
+bool KernelScheduler::isBefore(const Waiter& lhs, const Waiter& rhs) const {
+  if (lhs.query->priority_ != rhs.query->priority_) {
+    return lhs.query->priority_ > rhs.query->priority_;
+  }
+  if (lhs.query->running_kernels_ != rhs.query->running_kernels_) {
+    return lhs.query->running_kernels_ < rhs.query->running_kernels_;
+  }
+  return lhs.ticket < rhs.ticket;
+}
+
+bool KernelScheduler::isNext(const Waiter& waiter) const {
+  if (running_kernels_ >= num_slots_ || !canRun(*waiter.query)) {
+    return false;
+  }
+  for (const auto& other : waiters_) {
+    if (other.ticket != waiter.ticket && canRun(*other.query) &&
+        isBefore(other, waiter)) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,102 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+
+/**
+ * Admits CPU execution kernels of concurrently running queries into the shared
+ * thread pool. The number of running kernels is bounded by the number of slots
+ * (CPU threads by default), so kernels of different queries interleave instead
+ * of queries running one after another.
+ *
+ * Kernels are dispatched by the query's launching thread, which blocks until a
+ * slot is available. When several queries wait for a slot, it is granted to the
+ * query with the highest priority, then to the query with fewer running
+ * kernels, then in arrival order. A query never runs more kernels than its
+ * concurrency limit. This way a short query launched during a long scan gets
+ * its share of CPU threads right after the next scan kernel finishes.
+ *
+ * A waiting query gives up when its interrupt flag is set. Whoever sets the flag
+ * has to call notifyInterrupted() to wake the waiters.
+ */
+class KernelScheduler {
+ public:
+  class Query {
+   public:
+    // Zero max_running_kernels means no limit other than the number of slots.
+    Query(KernelScheduler& scheduler,
+          int priority,
+          size_t max_running_kernels,
+          const std::atomic<bool>* interrupted = nullptr)
+        : scheduler_(scheduler)
+        , priority_(priority)
+        , max_running_kernels_(max_running_kernels)
+        , interrupted_(interrupted) {}
+
+    Query(const Query&) = delete;
+    Query& operator=(const Query&) = delete;
+
+    // Block until a kernel of the query can start. Return wait time in ms. Each
+    // acquired slot must be released when the kernel and its sub-tasks finish.
+    // Return nullopt with no slot acquired if the query is interrupted while
+    // waiting.
+    std::optional<int64_t> acquireSlot();
+    void releaseSlot();
+
+   private:
+    friend class KernelScheduler;
+
+    KernelScheduler& scheduler_;
+    int priority_;
+    size_t max_running_kernels_;
+    const std::atomic<bool>* interrupted_;
+    size_t running_kernels_ = 0;
+  };
+
+  explicit KernelScheduler(size_t num_slots);
+
+  // Scheduler shared by all executors.
+  static KernelScheduler& instance();
+
+  size_t numSlots() const { return num_slots_; }
+  size_t numRunningKernels() const;
+  size_t numWaitingKernels() const;
+
+  // Wake waiting queries to check their interrupt flags.
+  void notifyInterrupted();
+
+ private:
+  struct Waiter {
+    Query* query;
+    uint64_t ticket;
+  };
+
+  bool canRun(const Query& query) const;
+  bool isBefore(const Waiter& lhs, const Waiter& rhs) const;
+  bool isNext(const Waiter& waiter) const;
+
+  const size_t num_slots_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  size_t running_kernels_ = 0;
+  uint64_t next_ticket_ = 0;
+  std::list<Waiter> waiters_;
+};
@@ -0,0 +1,154 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/MorselDispenser.h"
+
+#include "Logger/Logger.h"
+#include "Shared/numa_utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
+namespace {
+
+size_t remainingRows(size_t next_row, size_t end_row) {
+  return next_row < end_row ? end_row - next_row : 0;
+}
+
+}  // namespace
+
+size_t MorselDispenser::addSource(size_t begin_row,
+                                  size_t end_row,
+                                  size_t morsel_size,
+                                  int numa_node,
+                                  MorselFn fn) {
+  CHECK_GT(morsel_size, size_t(0));
+  auto source = std::make_unique<Source>();
+  source->end_row = end_row;
+  source->morsel_size = morsel_size;
+  source->numa_node = numa_node;
+  source->next_row = begin_row;
+  source->pending_rows = remainingRows(begin_row, end_row);
+  if (source->pending_rows) {
+    source->fn = std::move(fn);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  sources_.push_back(std::move(source));
+  return sources_.size() - 1;
+}
+
+size_t MorselDispenser::workersToLaunch(size_t source_idx, size_t max_workers) const {
+  auto source = getSource(source_idx);
+  auto rows = remainingRows(source->next_row, source->end_row);
+  auto morsels = (rows + source->morsel_size - 1) / source->morsel_size;
+  size_t active = active_workers_;
+  size_t free_workers = max_workers > active ? max_workers - active : 0;
+  return std::min(morsels, std::max(free_workers, size_t(1)));
+}
+
+void MorselDispenser::runWorker(size_t home_source_idx) {
+  ++active_workers_;
+  ThreadStats stats;
+  auto home = getSource(home_source_idx);
+  std::optional<numa::ScopedNodeBinding> numa_binding;
+  if (home->numa_node >= 0) {
+    numa_binding.emplace(home->numa_node);
+  }
+
+  auto source = home;
+  try {
+    while (source && !failed_) {
+      size_t start = source->next_row.fetch_add(source->morsel_size);
+      if (start >= source->end_row) {
+        source = findVictim(home->numa_node);
+        continue;
+      }
+      size_t num_rows = std::min(source->morsel_size, source->end_row - start);
+      auto clock_begin = std::chrono::steady_clock::now();
+      source->fn(start, num_rows);
+      finishRows(source, num_rows);
+      stats.busy_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - clock_begin)
+                           .count();
+      ++stats.morsels;
+      if (source != home) {
+        ++stats.stolen_morsels;
+      }
+    }
+  } catch (...) {
+    failed_ = true;
+    --active_workers_;
+    throw;
+  }
+  --active_workers_;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& thread_stats = thread_stats_[std::this_thread::get_id()];
+  thread_stats.morsels += stats.morsels;
+  thread_stats.stolen_morsels += stats.stolen_morsels;
+  thread_stats.busy_us += stats.busy_us;
+}
+
+std::unordered_map<std::thread::id, MorselDispenser::ThreadStats>
+MorselDispenser::getThreadStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return thread_stats_;
+}
+
+void MorselDispenser::releaseSources() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& source : sources_) {
+    source->fn = nullptr;
+  }
+}
+
+void MorselDispenser::finishRows(Source* source, size_t num_rows) {
+  // All morsels are taken and done, so no worker uses the function anymore.
+  if (source->pending_rows.fetch_sub(num_rows) == num_rows) {
+    source->fn = nullptr;
+  }
+}
+
+MorselDispenser::Source* MorselDispenser::getSource(size_t idx) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CHECK_LT(idx, sources_.size());
+  return sources_[idx].get();
+}
+
+MorselDispenser::Source* MorselDispenser::findVictim(int numa_node) const {
+  // Take the source with the most remaining rows, so stealing workers spread
+  // over the largest pieces of remaining work.
+  Source* local = nullptr;
+  size_t local_rows = 0;
+  Source* remote = nullptr;
+  size_t remote_rows = 0;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& source : sources_) {
+    auto rows = remainingRows(source->next_row, source->end_row);
+    if (!rows) {
+      continue;
+    }
+    if (numa_node < 0 || source->numa_node < 0 || source->numa_node == numa_node) {
+      if (rows > local_rows) {
+        local = source.get();
+        local_rows = rows;
+      }
+    } else if (rows > remote_rows) {
+      remote = source.get();
+      remote_rows = rows;
+    }
+  }
+  return local ? local : remote;
+}
@@ -0,0 +1,88 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Hands out fixed-size row ranges (morsels) of CPU kernels to worker tasks of a
+ * query. Each kernel registers its rows as a source and launches a few workers.
+ * A worker processes morsels of its home source and, when those are exhausted,
+ * steals morsels of other sources, preferring sources on the same NUMA node.
+ * Workers run until no morsels are left in the query, so threads finishing
+ * selective fragments early help with the remaining ones instead of idling.
+ * A source's function, with everything it captures, is released once all of
+ * its morsels are processed.
+ */
+class MorselDispenser {
+ public:
+  using MorselFn = std::function<void(size_t start_row, size_t num_rows)>;
+
+  struct ThreadStats {
+    size_t morsels = 0;
+    size_t stolen_morsels = 0;
+    int64_t busy_us = 0;
+  };
+
+  // Register rows [begin_row, end_row) to be processed by fn. Negative numa_node
+  // means no node preference. Return the source index.
+  size_t addSource(size_t begin_row,
+                   size_t end_row,
+                   size_t morsel_size,
+                   int numa_node,
+                   MorselFn fn);
+
+  // Number of workers to launch for a newly added source to keep the total
+  // number of active workers within max_workers. At least one worker is
+  // launched for non-empty sources.
+  size_t workersToLaunch(size_t source_idx, size_t max_workers) const;
+
+  // Process morsels until none are left. Rethrow exceptions from the morsel
+  // function; all workers stop taking morsels after the first failure.
+  void runWorker(size_t home_source_idx);
+
+  std::unordered_map<std::thread::id, ThreadStats> getThreadStats() const;
+
+  // Release functions of all sources. Called when no workers are running, to
+  // drop sources left unfinished by a failure.
+  void releaseSources();
+
+ private:
+  struct Source {
+    size_t end_row;
+    size_t morsel_size;
+    int numa_node;
+    MorselFn fn;
+    std::atomic<size_t> next_row;
+    std::atomic<size_t> pending_rows;
+  };
+
+  void finishRows(Source* source, size_t num_rows);
+
+  Source* getSource(size_t idx) const;
+  Source* findVictim(int numa_node) const;
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Source>> sources_;
+  std::unordered_map<std::thread::id, ThreadStats> thread_stats_;
+  std::atomic<size_t> active_workers_{0};
+  std::atomic<bool> failed_{false};
+};
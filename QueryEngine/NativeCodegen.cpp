@@ -67,12 +67,15 @@ static_assert(false, "LLVM Version >= 9 is required.");
 #endif
 
 #include "CudaMgr/CudaMgr.h"
+#include "MapDRelease.h"
+#include "QueryEngine/BackgroundCompiler.h"
 #include "QueryEngine/CodeGenerator.h"
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
 #include "QueryEngine/GpuSharedMemoryUtils.h"
 #include "QueryEngine/LLVMFunctionAttributesUtil.h"
 #include "QueryEngine/Optimization/AnnotateInternalFunctionsPass.h"
 #include "QueryEngine/OutputBufferInitialization.h"
+#include "QueryEngine/PersistentCodeCache.h"
 #include "QueryEngine/QueryTemplateGenerator.h"
 #include "Shared/InlineNullValues.h"
 #include "Shared/MathUtils.h"
@@ -290,6 +293,16 @@ void optimize_ir(llvm::Function* query_func,
 
   pass_manager.add(new AnnotateInternalFunctionsPass());
 
+  if (co.opt_level == ExecutorOptLevel::FirstTier) {
+    // Only the passes required to drop unused runtime functions, the code is
+    // recompiled with all the optimizations in background.
+    pass_manager.add(llvm::createPromoteMemoryToRegisterPass());
+    pass_manager.add(llvm::createGlobalOptimizerPass());
+    pass_manager.run(*llvm_module);
+    eliminate_dead_self_recursive_funcs(*llvm_module, live_funcs);
+    return;
+  }
+
   pass_manager.add(llvm::createSROAPass());
   // mem ssa drops unused load and store instructions, e.g. passing variables directly
   // where possible
@@ -356,6 +369,7 @@ MCJITExecutionEngineWrapper& MCJITExecutionEngineWrapper::operator=(
     llvm::ExecutionEngine* execution_engine) {
   execution_engine_.reset(execution_engine);
   intel_jit_listener_ = nullptr;
+  object_cache_ = nullptr;
   return *this;
 }
 #endif
@@ -397,11 +411,99 @@ std::string assemblyForCPU(ExecutionEngineWrapper& execution_engine,
 #endif  // !ENABLE_ORCJIT
 }
 
+bool use_fast_codegen(const CompilationOptions& co) {
+  return co.opt_level == ExecutorOptLevel::ReductionJIT ||
+         co.opt_level == ExecutorOptLevel::FirstTier;
+}
+
+// Supplies the object loaded from the persistent code cache to the JIT and stores
+// the compiled object if there was none.
+class PersistentObjectCache : public llvm::ObjectCache {
+ public:
+  PersistentObjectCache(PersistentCodeCache& cache,
+                        const std::string& key,
+                        std::optional<std::string> object)
+      : cache_(cache), key_(key), object_(std::move(object)) {}
+
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef obj) override {
+    if (!object_) {
+      cache_.store(key_, obj.getBufferStart(), obj.getBufferSize());
+    }
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override {
+    if (!object_) {
+      return nullptr;
+    }
+    return llvm::MemoryBuffer::getMemBufferCopy(*object_);
+  }
+
+ private:
+  PersistentCodeCache& cache_;
+  const std::string key_;
+  const std::optional<std::string> object_;
+};
+
+// Server build and host properties the generated machine code depends on.
+const std::string& get_persistent_code_cache_salt() {
+  static const std::string salt = []() {
+    std::string ret = MAPD_RELEASE + "\n" + llvm::sys::getProcessTriple() + "\n" +
+                      llvm::sys::getHostCPUName().str() + "\n";
+    llvm::StringMap<bool> host_features;
+    if (llvm::sys::getHostCPUFeatures(host_features)) {
+      std::vector<std::string> enabled_features;
+      for (const auto& feature : host_features) {
+        if (feature.getValue()) {
+          enabled_features.push_back(feature.getKey().str());
+        }
+      }
+      std::sort(enabled_features.begin(), enabled_features.end());
+      for (const auto& feature : enabled_features) {
+        ret += "+" + feature;
+      }
+    }
+    return ret;
+  }();
+  return salt;
+}
+
+// The in-memory code cache key only covers the generated functions, the
+// persistent key also covers the runtime and UDF modules they are linked with.
+std::string get_persistent_code_cache_key(const CodeCacheKey& key,
+                                          const llvm::Module& llvm_module) {
+  std::ostringstream oss;
+  oss << get_persistent_code_cache_salt() << "\n";
+  for (const auto& [kind, source] : Executor::extension_module_sources) {
+    oss << static_cast<int>(kind) << ":";
+    if (kind == Executor::ExtModuleKinds::rt_udf_cpu_module ||
+        kind == Executor::ExtModuleKinds::rt_udf_gpu_module) {
+      oss << source << "\n";
+      continue;
+    }
+    // Module files are identified by their path, size and modification time.
+    boost::system::error_code ec;
+    oss << source << ":" << boost::filesystem::file_size(source, ec) << ":"
+        << boost::filesystem::last_write_time(source, ec) << "\n";
+  }
+  for (const auto& global : llvm_module.globals()) {
+    if (!global.isDeclaration()) {
+      oss << serialize_llvm_object(&global);
+    }
+  }
+  for (const auto& str : key) {
+    oss << str << "\n";
+  }
+  return oss.str();
+}
+
 #ifndef ENABLE_ORCJIT
 
-ExecutionEngineWrapper create_execution_engine(llvm::Module* llvm_module,
-                                               llvm::EngineBuilder& eb,
-                                               const CompilationOptions& co) {
+ExecutionEngineWrapper create_execution_engine(
+    llvm::Module* llvm_module,
+    llvm::EngineBuilder& eb,
+    const CompilationOptions& co,
+    std::unique_ptr<llvm::ObjectCache> object_cache) {
   auto timer = DEBUG_TIMER(__func__);
   // Avoids data race in
   // llvm::sys::DynamicLibrary::getPermanentLibrary and
@@ -413,6 +515,9 @@ ExecutionEngineWrapper create_execution_engine(llvm::Module* llvm_module,
   CHECK(execution_engine.exists());
   // Force the module data layout to match the layout for the selected target
   llvm_module->setDataLayout(execution_engine->getDataLayout());
+  if (object_cache) {
+    execution_engine.setObjectCache(std::move(object_cache));
+  }
 
   LOG(ASM) << assemblyForCPU(execution_engine, llvm_module);
 
@@ -427,14 +532,18 @@ ExecutionEngineWrapper create_execution_engine(llvm::Module* llvm_module,
 ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
     llvm::Function* func,
     const std::unordered_set<llvm::Function*>& live_funcs,
-    const CompilationOptions& co) {
+    const CompilationOptions& co,
+    std::unique_ptr<llvm::ObjectCache> object_cache,
+    const bool has_cached_object) {
   auto timer = DEBUG_TIMER(__func__);
   llvm::Module* llvm_module = func->getParent();
   // run optimizations
 #ifndef WITH_JIT_DEBUG
-  llvm::legacy::PassManager pass_manager;
-  optimize_ir(
-      func, llvm_module, pass_manager, live_funcs, /*is_gpu_smem_used=*/false, co);
+  if (!has_cached_object) {
+    llvm::legacy::PassManager pass_manager;
+    optimize_ir(
+        func, llvm_module, pass_manager, live_funcs, /*is_gpu_smem_used=*/false, co);
+  }
 #endif  // WITH_JIT_DEBUG
 
   auto init_err = llvm::InitializeNativeTarget();
@@ -472,7 +581,7 @@ ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
       std::move(*target_machine_builder_or_error);
   target_machine_builder.getOptions().EnableFastISel = true;
 
-  if (co.opt_level == ExecutorOptLevel::ReductionJIT) {
+  if (use_fast_codegen(co)) {
     target_machine_builder.setCodeGenOptLevel(llvm::CodeGenOpt::None);
   }
 
@@ -486,7 +595,8 @@ ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
 
   ExecutionEngineWrapper execution_engine(std::move(execution_session),
                                           std::move(target_machine_builder),
-                                          std::move(data_layout));
+                                          std::move(data_layout),
+                                          std::move(object_cache));
   execution_engine.addModule(std::move(owner));
   return execution_engine;
 #else
@@ -495,19 +605,133 @@ ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
   eb.setErrorStr(&err_str);
   eb.setEngineKind(llvm::EngineKind::JIT);
   eb.setTargetOptions(to);
-  if (co.opt_level == ExecutorOptLevel::ReductionJIT) {
+  if (use_fast_codegen(co)) {
     eb.setOptLevel(llvm::CodeGenOpt::None);
   }
 
-  return create_execution_engine(llvm_module, eb, co);
+  return create_execution_engine(llvm_module, eb, co, std::move(object_cache));
 #endif
 }
 
-std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
+#ifndef ENABLE_ORCJIT
+std::unique_ptr<llvm::Module> read_llvm_module_from_bc_file(
+    const std::string& bc_filename,
+    llvm::LLVMContext& context);
+
+namespace {
+
+// Module snapshot compiled with all the optimizations in background. Only the
+// generated code is copied on the query thread, the runtime functions it calls
+// are linked in by the background task. The module is stored as bitcode and
+// parsed into a private LLVM context, so the compilation doesn't race with the
+// code generation using the executor context.
+struct SecondTierModule {
+  std::string bitcode;
+  std::string runtime_module_path;
+  std::string query_func_name;
+  std::string multifrag_query_func_name;
+  std::vector<std::string> live_func_names;
+};
+
+SecondTierModule make_second_tier_module(
     llvm::Function* query_func,
     llvm::Function* multifrag_query_func,
     const std::unordered_set<llvm::Function*>& live_funcs,
-    const CompilationOptions& co) {
+    const llvm::Module& rt_module,
+    const std::string& rt_module_path) {
+  auto timer = DEBUG_TIMER(__func__);
+  // External runtime functions are cloned from the runtime module unchanged, so
+  // they are left as declarations. Internal functions can't be linked by name
+  // and the always cloned ones are patched by the code generation.
+  auto clone_definition = [&rt_module](const llvm::GlobalValue* gv) {
+    auto func = llvm::dyn_cast<llvm::Function>(gv);
+    if (!func) {
+      return true;
+    }
+    auto rt_func = rt_module.getFunction(func->getName());
+    return !rt_func || rt_func->isDeclaration() || !rt_func->hasExternalLinkage() ||
+           CodeGenerator::alwaysCloneRuntimeFunction(rt_func);
+  };
+  llvm::ValueToValueMapTy vmap;
+  auto query_module =
+      llvm::CloneModule(*query_func->getParent(), vmap, clone_definition);
+  // The linker brings in a definition for every declaration, keep only the
+  // called ones.
+  std::vector<llvm::Function*> unused_decls;
+  for (auto& func : *query_module) {
+    if (func.isDeclaration() && func.use_empty()) {
+      unused_decls.push_back(&func);
+    }
+  }
+  for (auto func : unused_decls) {
+    func->eraseFromParent();
+  }
+
+  SecondTierModule ret;
+  llvm::raw_string_ostream os(ret.bitcode);
+  llvm::WriteBitcodeToFile(*query_module, os);
+  os.flush();
+  ret.runtime_module_path = rt_module_path;
+  ret.query_func_name = query_func->getName().str();
+  ret.multifrag_query_func_name = multifrag_query_func->getName().str();
+  for (const auto func : live_funcs) {
+    ret.live_func_names.push_back(func->getName().str());
+  }
+  return ret;
+}
+
+std::shared_ptr<CpuCompilationContext> compile_second_tier_module(
+    const SecondTierModule& module_snapshot,
+    const CompilationOptions& co,
+    PersistentCodeCache* persistent_cache,
+    const std::string& persistent_key) {
+  auto timer = DEBUG_TIMER(__func__);
+  llvm::LLVMContext context;
+  auto module_or_err = llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef(module_snapshot.bitcode, "second_tier"), context);
+  if (!module_or_err) {
+    std::string err_str;
+    llvm::raw_string_ostream os(err_str);
+    os << module_or_err.takeError();
+    throw std::runtime_error("Cannot parse the query module: " + os.str());
+  }
+  auto rt_module =
+      read_llvm_module_from_bc_file(module_snapshot.runtime_module_path, context);
+  if (llvm::Linker::linkModules(
+          **module_or_err, std::move(rt_module), llvm::Linker::Flags::LinkOnlyNeeded)) {
+    throw std::runtime_error("Cannot link the runtime functions to the query module");
+  }
+  // The execution engine takes the ownership of the module.
+  auto llvm_module = module_or_err->release();
+  auto query_func = llvm_module->getFunction(module_snapshot.query_func_name);
+  auto multifrag_query_func =
+      llvm_module->getFunction(module_snapshot.multifrag_query_func_name);
+  CHECK(query_func);
+  CHECK(multifrag_query_func);
+  std::unordered_set<llvm::Function*> live_funcs;
+  for (const auto& name : module_snapshot.live_func_names) {
+    if (auto func = llvm_module->getFunction(name)) {
+      live_funcs.insert(func);
+    }
+  }
+  std::unique_ptr<llvm::ObjectCache> object_cache;
+  if (persistent_cache) {
+    object_cache = std::make_unique<PersistentObjectCache>(
+        *persistent_cache, persistent_key, std::nullopt);
+  }
+  auto execution_engine = CodeGenerator::generateNativeCPUCode(
+      query_func, live_funcs, co, std::move(object_cache));
+  auto cpu_compilation_context =
+      std::make_shared<CpuCompilationContext>(std::move(execution_engine));
+  // The module is removed from the engine here and deleted with the context.
+  cpu_compilation_context->setFunctionPointer(multifrag_query_func);
+  return cpu_compilation_context;
+}
+
+}  // namespace
+#endif
+
+CodeCacheKey Executor::getCpuCodeCacheKey(llvm::Function* query_func) const {
   CodeCacheKey key{serialize_llvm_object(query_func),
                    serialize_llvm_object(cgen_state_->row_func_)};
   if (cgen_state_->filter_func_) {
@@ -516,13 +740,69 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
   for (const auto helper : cgen_state_->helper_functions_) {
     key.push_back(serialize_llvm_object(helper));
   }
+  return key;
+}
+
+std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
+    const CodeCacheKey& key,
+    llvm::Function* query_func,
+    llvm::Function* multifrag_query_func,
+    const std::unordered_set<llvm::Function*>& live_funcs,
+    const CompilationOptions& co) {
   auto cached_code = cpu_code_accessor.get_value(key);
   if (cached_code) {
     return cached_code;
   }
 
+  // Machine code stored by an earlier server run replaces the IR optimizations
+  // and the code generation. The IR is generated anyway, it is the cache key.
+  auto persistent_cache =
+      co.opt_level == ExecutorOptLevel::Default ? PersistentCodeCache::get() : nullptr;
+  std::string persistent_key;
+  std::optional<std::string> cached_object;
+  if (persistent_cache) {
+    persistent_key = get_persistent_code_cache_key(key, *query_func->getParent());
+    cached_object = persistent_cache->load(persistent_key);
+  }
+
+  auto first_tier_co = co;
+#ifndef ENABLE_ORCJIT
+  // Start the execution with quickly compiled code and replace it in the code
+  // cache once the optimized code is ready, so later runs use the latter.
+  if (g_enable_tiered_compilation && co.opt_level == ExecutorOptLevel::Default &&
+      !cached_object) {
+    const auto& rt_module_path =
+        extension_module_sources.at(ExtModuleKinds::template_module);
+    auto module_snapshot =
+        std::make_shared<SecondTierModule>(make_second_tier_module(query_func,
+                                                                   multifrag_query_func,
+                                                                   live_funcs,
+                                                                   *get_rt_module(),
+                                                                   rt_module_path));
+    auto second_tier_task =
+        [key, module_snapshot, co, persistent_cache, persistent_key]() {
+          auto cpu_compilation_context = compile_second_tier_module(
+              *module_snapshot, co, persistent_cache, persistent_key);
+          cpu_code_accessor.overwrite(key, cpu_compilation_context);
+        };
+    if (BackgroundCompiler::get().submit(key, std::move(second_tier_task))) {
+      first_tier_co.opt_level = ExecutorOptLevel::FirstTier;
+    }
+  }
+#endif
+
+  std::unique_ptr<llvm::ObjectCache> object_cache;
+  // Only the fully optimized code is stored.
+  if (persistent_cache && first_tier_co.opt_level == ExecutorOptLevel::Default) {
+    object_cache = std::make_unique<PersistentObjectCache>(
+        *persistent_cache, persistent_key, cached_object);
+  }
   auto execution_engine =
-      CodeGenerator::generateNativeCPUCode(query_func, live_funcs, co);
+      CodeGenerator::generateNativeCPUCode(query_func,
+                                           live_funcs,
+                                           first_tier_co,
+                                           std::move(object_cache),
+                                           cached_object.has_value());
   auto cpu_compilation_context =
       std::make_shared<CpuCompilationContext>(std::move(execution_engine));
   cpu_compilation_context->setFunctionPointer(multifrag_query_func);
@@ -2643,6 +2923,41 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
     }
   }
 
+  // Identical execution units reuse the compiled code without generating the IR,
+  // which takes most of the compilation time of short queries.
+  std::optional<CodeCacheKey> plan_key;
+  if (g_enable_plan_code_cache) {
+    auto fingerprint = get_plan_fingerprint(
+        ra_exe_unit, query_infos, *query_mem_desc, co, eo, allow_lazy_fetch, this);
+    if (fingerprint) {
+      mapd_shared_lock<mapd_shared_mutex> session_read_lock(executor_session_mutex_);
+      // The interrupt checks are only generated for queries with a session.
+      plan_key = CodeCacheKey{std::move(*fingerprint),
+                              ::toString(current_query_session_.empty())};
+    }
+  }
+  if (plan_key) {
+    auto compiled_plan = plan_code_accessor.get_value(*plan_key);
+    auto cached_code =
+        compiled_plan ? cpu_code_accessor.get_value(compiled_plan->code_key) : nullptr;
+    if (cached_code) {
+      plan_state_->allocateLocalColumnIds(ra_exe_unit.input_col_descs);
+      for (auto& simple_qual : ra_exe_unit.simple_quals) {
+        plan_state_->addSimpleQual(simple_qual);
+      }
+      plan_state_->init_agg_vals_ = compiled_plan->init_agg_vals;
+      plan_state_->columns_to_fetch_ = compiled_plan->columns_to_fetch;
+      plan_state_->columns_to_not_fetch_ = compiled_plan->columns_to_not_fetch;
+      return std::make_tuple(
+          CompilationResult{std::dynamic_pointer_cast<CompilationContext>(cached_code),
+                            compiled_plan->literal_values,
+                            output_columnar,
+                            "",
+                            gpu_smem_context},
+          std::move(query_mem_desc));
+    }
+  }
+
   // Read the module template and target either CPU or GPU
   // by binding the stream position functions to the right implementation:
   // stride access for GPU, contiguous for CPU
@@ -2915,17 +3230,33 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
   }
 
   // Generate final native code from the LLVM IR.
+  std::shared_ptr<CompilationContext> generated_code;
+  if (co.device_type == ExecutorDeviceType::CPU) {
+    auto code_key = getCpuCodeCacheKey(query_func);
+    generated_code =
+        optimizeAndCodegenCPU(code_key, query_func, multifrag_query_func, live_funcs, co);
+    if (plan_key) {
+      auto compiled_plan = std::make_shared<CompiledPlan>(
+          CompiledPlan{std::move(code_key),
+                       cgen_state_->getLiterals(),
+                       plan_state_->init_agg_vals_,
+                       plan_state_->columns_to_fetch_,
+                       plan_state_->columns_to_not_fetch_});
+      plan_code_accessor.overwrite(*plan_key, compiled_plan);
+    }
+  } else {
+    generated_code = optimizeAndCodegenGPU(query_func,
+                                           multifrag_query_func,
+                                           live_funcs,
+                                           is_group_by || ra_exe_unit.estimator,
+                                           cuda_mgr,
+                                           gpu_smem_context.isSharedMemoryUsed(),
+                                           co);
+  }
+
   return std::make_tuple(
       CompilationResult{
-          co.device_type == ExecutorDeviceType::CPU
-              ? optimizeAndCodegenCPU(query_func, multifrag_query_func, live_funcs, co)
-              : optimizeAndCodegenGPU(query_func,
-                                      multifrag_query_func,
-                                      live_funcs,
-                                      is_group_by || ra_exe_unit.estimator,
-                                      cuda_mgr,
-                                      gpu_smem_context.isSharedMemoryUsed(),
-                                      co),
+          generated_code,
           cgen_state_->getLiterals(),
           output_columnar,
           llvm_ir,
@@ -0,0 +1,193 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/PersistentCodeCache.h"
+#include "Logger/Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include <unistd.h>
+
+bool g_enable_persistent_code_cache{false};
+std::string g_persistent_code_cache_dir{};
+size_t g_persistent_code_cache_max_bytes{size_t(1) << 30};
+
+namespace {
+
+constexpr char kMagic[] = "OMNIOBJ1";
+constexpr size_t kMagicSize = sizeof(kMagic) - 1;
+constexpr char kExtension[] = ".obj";
+
+uint64_t fnv1a_hash(const std::string& str) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (auto c : str) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+bool is_cache_entry(const std::filesystem::directory_entry& entry) {
+  std::error_code ec;
+  return entry.is_regular_file(ec) && entry.path().extension() == kExtension;
+}
+
+}  // namespace
+
+PersistentCodeCache::PersistentCodeCache(const std::string& dir, size_t max_bytes)
+    : dir_(dir), max_bytes_(max_bytes) {
+  if (dir_.empty()) {
+    dir_ = (std::filesystem::temp_directory_path() / "omnisci_code_cache").string();
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(dir_, ec);
+  if (ec) {
+    LOG(WARNING) << "Cannot create code cache directory " << dir_ << ": "
+                 << ec.message();
+  }
+}
+
+PersistentCodeCache* PersistentCodeCache::get() {
+  if (!g_enable_persistent_code_cache) {
+    return nullptr;
+  }
+  static PersistentCodeCache cache(g_persistent_code_cache_dir,
+                                   g_persistent_code_cache_max_bytes);
+  return &cache;
+}
+
+std::string PersistentCodeCache::getPath(const std::string& key) const {
+  std::ostringstream name;
+  name << std::hex << std::setw(16) << std::setfill('0') << fnv1a_hash(key)
+       << kExtension;
+  return (std::filesystem::path(dir_) / name.str()).string();
+}
+
+std::optional<std::string> PersistentCodeCache::load(const std::string& key) {
+  const auto path = getPath(key);
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return std::nullopt;
+  }
+  char magic[kMagicSize];
+  uint64_t key_size{0};
+  in.read(magic, kMagicSize);
+  in.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+  if (!in || std::memcmp(magic, kMagic, kMagicSize) || key_size != key.size()) {
+    return std::nullopt;
+  }
+  std::string stored_key(key_size, '\0');
+  in.read(stored_key.data(), key_size);
+  if (!in || stored_key != key) {
+    return std::nullopt;
+  }
+  std::string data((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+  if (in.bad()) {
+    return std::nullopt;
+  }
+  // Modification time orders the entries for eviction.
+  std::error_code ec;
+  std::filesystem::last_write_time(
+      path, std::filesystem::file_time_type::clock::now(), ec);
+  return data;
+}
+
+void PersistentCodeCache::store(const std::string& key, const char* data, size_t size) {
+  const uint64_t key_size = key.size();
+  const size_t entry_size = kMagicSize + sizeof(key_size) + key.size() + size;
+  if (entry_size > max_bytes_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  evict(entry_size);
+
+  static std::atomic<uint64_t> tmp_counter{0};
+  const auto path = getPath(key);
+  const auto tmp_path = path + ".tmp." + std::to_string(getpid()) + "." +
+                        std::to_string(tmp_counter++);
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    out.write(kMagic, kMagicSize);
+    out.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+    out.write(key.data(), key.size());
+    out.write(data, size);
+    if (!out) {
+      LOG(WARNING) << "Cannot write code cache file " << tmp_path;
+      std::error_code ec;
+      std::filesystem::remove(tmp_path, ec);
+      return;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, path, ec);
+  if (ec) {
+    LOG(WARNING) << "Cannot write code cache file " << path << ": " << ec.message();
+    std::filesystem::remove(tmp_path, ec);
+  }
+}
+
+size_t PersistentCodeCache::getUsedBytes() const {
+  size_t used_bytes = 0;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(dir_, ec)) {
+    if (is_cache_entry(entry)) {
+      used_bytes += entry.file_size(ec);
+    }
+  }
+  return used_bytes;
+}
+
+void PersistentCodeCache::evict(size_t size) {
+  struct Entry {
+    std::filesystem::path path;
+    std::filesystem::file_time_type time;
+    size_t size;
+  };
+  std::vector<Entry> entries;
+  size_t used_bytes = 0;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(dir_, ec)) {
+    if (!is_cache_entry(entry)) {
+      continue;
+    }
+    std::error_code entry_ec;
+    Entry e{entry.path(), entry.last_write_time(entry_ec), entry.file_size(entry_ec)};
+    if (!entry_ec) {
+      used_bytes += e.size;
+      entries.push_back(std::move(e));
+    }
+  }
+  if (used_bytes + size <= max_bytes_) {
+    return;
+  }
+  std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+    return lhs.time < rhs.time;
+  });
+  for (const auto& entry : entries) {
+    if (used_bytes + size <= max_bytes_) {
+      break;
+    }
+    if (std::filesystem::remove(entry.path, ec)) {
+      used_bytes -= entry.size;
+    }
+  }
+}
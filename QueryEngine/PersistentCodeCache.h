@@ -0,0 +1,58 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+
+extern bool g_enable_persistent_code_cache;
+extern std::string g_persistent_code_cache_dir;
+extern size_t g_persistent_code_cache_max_bytes;
+
+/**
+ * Directory of compiled query objects kept across server restarts. An entry
+ * is stored in a file named by the hash of its key. The full key is stored in
+ * the file too and is compared on load, so hash collisions are misses. Least
+ * recently used files are removed when the directory exceeds the size limit.
+ *
+ * Files are written to a temporary name and renamed, so a cache directory can
+ * be shared by concurrent processes.
+ */
+class PersistentCodeCache {
+ public:
+  PersistentCodeCache(const std::string& dir, size_t max_bytes);
+
+  // Cache configured by --persistent-code-cache-dir and
+  // --persistent-code-cache-max-bytes, nullptr if the cache is disabled.
+  static PersistentCodeCache* get();
+
+  std::optional<std::string> load(const std::string& key);
+  void store(const std::string& key, const char* data, size_t size);
+
+  // Total size of the cache entries in the directory.
+  size_t getUsedBytes() const;
+  const std::string& getDir() const { return dir_; }
+
+ private:
+  std::string getPath(const std::string& key) const;
+  // Remove least recently used entries until size more bytes fit the limit.
+  void evict(size_t size);
+
+  std::string dir_;
+  const size_t max_bytes_;
+  std::mutex mutex_;
+};
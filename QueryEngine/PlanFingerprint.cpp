@@ -0,0 +1,226 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/PlanFingerprint.h"
+#include "QueryEngine/Descriptors/QueryMemoryDescriptor.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/ExpressionRange.h"
+
+#include <sstream>
+
+extern bool g_bigint_count;
+extern bool g_null_div_by_zero;
+extern bool g_inf_div_by_zero;
+extern bool g_enable_filter_function;
+
+bool g_enable_plan_code_cache{false};
+
+namespace {
+
+const Analyzer::Expr* get_expr_ptr(const std::shared_ptr<Analyzer::Expr>& expr) {
+  return expr.get();
+}
+
+const Analyzer::Expr* get_expr_ptr(const Analyzer::Expr* expr) {
+  return expr;
+}
+
+bool is_supported_type(const SQLTypeInfo& ti) {
+  return !ti.is_string() && !ti.is_array() && !ti.is_varlen();
+}
+
+// Serializes the expressions the code generation result depends on. Only the
+// expressions whose code is fully determined by the operators, the types, the
+// constant values and the input column ranges are supported.
+class FingerprintBuilder {
+ public:
+  FingerprintBuilder(const std::vector<InputTableInfo>& query_infos,
+                     const Executor* executor)
+      : query_infos_(query_infos), executor_(executor) {}
+
+  bool add(const Analyzer::Expr* expr) {
+    if (!expr) {
+      os_ << "()";
+      return true;
+    }
+    if (!is_supported_type(expr->get_type_info())) {
+      return false;
+    }
+    os_ << "(" << expr->get_type_info().to_string();
+    bool supported = false;
+    if (dynamic_cast<const Analyzer::Var*>(expr)) {
+      supported = false;
+    } else if (auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr)) {
+      supported = addColumnVar(col_var);
+    } else if (auto constant = dynamic_cast<const Analyzer::Constant*>(expr)) {
+      supported = addConstant(constant);
+    } else if (auto uoper = dynamic_cast<const Analyzer::UOper*>(expr)) {
+      const auto optype = uoper->get_optype();
+      os_ << " U" << optype;
+      supported = (optype == kNOT || optype == kUMINUS || optype == kISNULL ||
+                   optype == kCAST) &&
+                  add(uoper->get_operand());
+    } else if (auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(expr)) {
+      os_ << " B" << bin_oper->get_optype();
+      supported = bin_oper->get_qualifier() == kONE &&
+                  add(bin_oper->get_left_operand()) &&
+                  add(bin_oper->get_right_operand());
+    } else if (auto case_expr = dynamic_cast<const Analyzer::CaseExpr*>(expr)) {
+      os_ << " CASE";
+      supported = true;
+      for (const auto& [when_expr, then_expr] : case_expr->get_expr_pair_list()) {
+        supported = supported && add(when_expr.get()) && add(then_expr.get());
+      }
+      supported = supported && add(case_expr->get_else_expr());
+    } else if (auto extract = dynamic_cast<const Analyzer::ExtractExpr*>(expr)) {
+      os_ << " EXTRACT" << static_cast<int>(extract->get_field());
+      supported = add(extract->get_from_expr());
+    } else if (auto datetrunc = dynamic_cast<const Analyzer::DatetruncExpr*>(expr)) {
+      os_ << " DATETRUNC" << static_cast<int>(datetrunc->get_field());
+      supported = add(datetrunc->get_from_expr());
+    } else if (auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(expr)) {
+      const auto agg_type = agg_expr->get_aggtype();
+      os_ << " AGG" << agg_type;
+      supported = (agg_type == kCOUNT || agg_type == kSUM || agg_type == kMIN ||
+                   agg_type == kMAX || agg_type == kAVG) &&
+                  !agg_expr->get_is_distinct() && add(agg_expr->get_arg());
+    }
+    os_ << ")";
+    return supported;
+  }
+
+  std::ostringstream& stream() { return os_; }
+
+ private:
+  bool addColumnVar(const Analyzer::ColumnVar* col_var) {
+    if (col_var->get_rte_idx() != 0) {
+      return false;
+    }
+    // The code generation skips overflow checks based on the value ranges.
+    const auto col_range = getLeafColumnRange(
+        col_var, query_infos_, executor_, /*is_outer_join_proj=*/false);
+    os_ << " C" << col_var->get_table_id() << "," << col_var->get_column_id() << ","
+        << col_range.toString();
+    return true;
+  }
+
+  // The exact value is used even for hoisted literals, the cached plan keeps the
+  // literal buffer of the query it was compiled for.
+  bool addConstant(const Analyzer::Constant* constant) {
+    const auto& ti = constant->get_type_info();
+    os_ << " K";
+    if (constant->get_is_null()) {
+      os_ << "NULL";
+      return true;
+    }
+    const auto& datum = constant->get_constval();
+    switch (ti.get_type()) {
+      case kBOOLEAN:
+        os_ << static_cast<int>(datum.boolval);
+        return true;
+      case kTINYINT:
+        os_ << static_cast<int>(datum.tinyintval);
+        return true;
+      case kSMALLINT:
+        os_ << datum.smallintval;
+        return true;
+      case kINT:
+        os_ << datum.intval;
+        return true;
+      case kBIGINT:
+      case kDECIMAL:
+      case kNUMERIC:
+      case kTIME:
+      case kTIMESTAMP:
+      case kDATE:
+      case kINTERVAL_DAY_TIME:
+      case kINTERVAL_YEAR_MONTH:
+        os_ << datum.bigintval;
+        return true;
+      case kFLOAT:
+        os_ << std::hexfloat << datum.floatval << std::defaultfloat;
+        return true;
+      case kDOUBLE:
+        os_ << std::hexfloat << datum.doubleval << std::defaultfloat;
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  const std::vector<InputTableInfo>& query_infos_;
+  const Executor* executor_;
+  std::ostringstream os_;
+};
+
+}  // namespace
+
+std::optional<std::string> get_plan_fingerprint(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const CompilationOptions& co,
+    const ExecutionOptions& eo,
+    const bool allow_lazy_fetch,
+    const Executor* executor) {
+  if (co.device_type != ExecutorDeviceType::CPU || eo.just_explain ||
+      ra_exe_unit.estimator || !ra_exe_unit.join_quals.empty() ||
+      ra_exe_unit.input_descs.size() != 1 ||
+      ra_exe_unit.input_descs.front().getSourceType() != InputSourceType::TABLE ||
+      ra_exe_unit.union_all) {
+    return std::nullopt;
+  }
+  FingerprintBuilder builder(query_infos, executor);
+  auto& os = builder.stream();
+  os << "executor:" << executor->getExecutorId() << "\n";
+  os << "co:" << co.hoist_literals << static_cast<int>(co.opt_level)
+     << co.with_dynamic_watchdog << co.allow_lazy_fetch << co.filter_on_deleted_column
+     << static_cast<int>(co.explain_type) << co.register_intel_jit_listener
+     << co.use_groupby_buffer_desc << "\n";
+  os << "eo:" << eo.allow_multifrag << eo.with_dynamic_watchdog
+     << eo.allow_runtime_query_interrupt << eo.output_columnar_hint << "\n";
+  os << "flags:" << allow_lazy_fetch << g_bigint_count << g_null_div_by_zero
+     << g_inf_div_by_zero << g_enable_filter_function << "\n";
+  for (const auto& input_desc : ra_exe_unit.input_descs) {
+    os << "input:" << input_desc.getTableId() << "\n";
+  }
+  for (const auto& input_col_desc : ra_exe_unit.input_col_descs) {
+    os << "col:" << input_col_desc->getTableId() << "," << input_col_desc->getColId()
+       << "," << input_col_desc->getNestLevel() << "\n";
+  }
+  const auto add_exprs = [&builder, &os](const char* name, const auto& exprs) {
+    os << name << ":";
+    for (const auto& expr : exprs) {
+      if (!builder.add(get_expr_ptr(expr))) {
+        return false;
+      }
+    }
+    os << "\n";
+    return true;
+  };
+  if (!add_exprs("simple_quals", ra_exe_unit.simple_quals) ||
+      !add_exprs("quals", ra_exe_unit.quals) ||
+      !add_exprs("groupby", ra_exe_unit.groupby_exprs) ||
+      !add_exprs("targets", ra_exe_unit.target_exprs)) {
+    return std::nullopt;
+  }
+  os << "sort:" << static_cast<int>(ra_exe_unit.sort_info.algorithm) << ","
+     << ra_exe_unit.sort_info.limit << "," << ra_exe_unit.sort_info.offset;
+  for (const auto& order_entry : ra_exe_unit.sort_info.order_entries) {
+    os << "," << order_entry.toString();
+  }
+  os << "\nscan_limit:" << ra_exe_unit.scan_limit << "\n";
+  os << query_mem_desc.toString();
+  return os.str();
+}
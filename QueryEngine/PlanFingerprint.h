@@ -0,0 +1,65 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "QueryEngine/CgenState.h"
+#include "QueryEngine/CodeCache.h"
+#include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/PlanState.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+extern bool g_enable_plan_code_cache;
+
+class Executor;
+struct InputTableInfo;
+class QueryMemoryDescriptor;
+
+// State produced by the code generation for an execution unit, enough to run the
+// unit again with the code cached under code_key without generating the code.
+struct CompiledPlan {
+  CodeCacheKey code_key;
+  std::unordered_map<int, CgenState::LiteralValues> literal_values;
+  std::vector<int64_t> init_agg_vals;
+  PlanState::InputColDescriptorSet columns_to_fetch;
+  PlanState::InputColDescriptorSet columns_to_not_fetch;
+};
+
+/**
+ * Key of the code generated for the execution unit which can be computed before
+ * the code generation. It covers the expressions, the memory layout, the
+ * compilation options and the value ranges of the input columns. The generated
+ * code also depends on string dictionaries, join hash tables, window contexts
+ * and other runtime state for some expressions, nullopt is returned for units
+ * using them.
+ *
+ * Constant values are part of the key, so units differing only in literals never
+ * share an entry and always generate the IR again. Even with hoisted literals the
+ * cached literal buffer can't be rebuilt for other values: equal literals share a
+ * buffer slot and some code generation depends on the constant values. Such units
+ * still reuse the compiled code through the IR based code cache.
+ */
+std::optional<std::string> get_plan_fingerprint(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const CompilationOptions& co,
+    const ExecutionOptions& eo,
+    const bool allow_lazy_fetch,
+    const Executor* executor);
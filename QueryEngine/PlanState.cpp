@@ -25,15 +25,10 @@ bool PlanState::isLazyFetchColumn(const Analyzer::Expr* target_expr) const {
   if (!do_not_fetch_column || dynamic_cast<const Analyzer::Var*>(do_not_fetch_column)) {
     return false;
   }
-  if (do_not_fetch_column->get_table_id() > 0) {
-    auto col_info = executor_->getSchemaProvider()->getColumnInfo(
-        do_not_fetch_column->get_db_id(),
-        do_not_fetch_column->get_table_id(),
-        do_not_fetch_column->get_column_id());
-    CHECK(col_info);
-    if (col_info->is_rowid) {
-      return false;
-    }
+  // Row id columns are never fetched lazily. Column var holds the column info
+  // registered in the schema, so it is checked with no schema lookup.
+  if (do_not_fetch_column->get_table_id() > 0 && do_not_fetch_column->is_virtual()) {
+    return false;
   }
   InputColDescriptorSet intersect;
   std::set_intersection(columns_to_fetch_.begin(),
@@ -35,6 +35,7 @@ struct JoinInfo {
                                // definition when using a hash join; we'll
                                // fold them to true during code generation
   std::vector<std::shared_ptr<HashJoin>> join_hash_tables_;
+  std::vector<JoinType> join_types_;  // join type of each hash table
   std::unordered_set<size_t> sharded_range_table_indices_;
 };
 
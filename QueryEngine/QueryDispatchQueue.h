@@ -16,21 +16,75 @@
 
 #pragma once
 
+#include "Logger/Logger.h"
+
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <future>
+#include <limits>
 #include <mutex>
-#include <queue>
+#include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 /**
  * QueryDispatchQueue maintains a list of pending queries and dispatches those queries as
- * Executors become available
+ * Executors become available.
+ *
+ * Pending queries are ordered by priority class first. Queries submitted without an
+ * explicit class are classified by the estimated cost given by the submitter (e.g.
+ * number of fragments times number of referenced columns), so cheap interactive
+ * queries bypass expensive reports. Queries with no cost estimate are kNormal.
+ * A query waiting longer than the aging interval is promoted by one class per interval,
+ * so batch queries are never starved. Within a class, sessions share workers fairly in
+ * proportion to their weights, accounting for the estimated cost of their queries;
+ * queries of a single session and class run in submission order.
  */
 class QueryDispatchQueue {
  public:
   using Task = std::packaged_task<void(size_t)>;
+  using Clock = std::chrono::steady_clock;
+
+  // Classes with lower values are dispatched first.
+  enum class Priority { kInteractive = 0, kNormal = 1, kBatch = 2, kAuto = 3 };
+  static constexpr size_t kNumPriorities = 3;
+
+  struct TaskDescriptor {
+    std::string session_id;
+    Priority priority = Priority::kAuto;
+    size_t estimated_cost = 0;
+  };
+
+  struct Config {
+    // Queries with kAuto priority and the estimated cost up to this value are
+    // interactive, queries with the cost of at least batch_cost are batch. Zero
+    // cost means the cost is unknown and such queries are kNormal.
+    size_t interactive_cost = 0;
+    size_t batch_cost = std::numeric_limits<size_t>::max();
+    std::chrono::milliseconds aging_interval{10'000};
+  };
 
-  QueryDispatchQueue(const size_t parallel_executors_max) {
+  struct Stats {
+    size_t queue_depth = 0;
+    size_t queue_depth_per_priority[kNumPriorities] = {};
+    size_t running = 0;
+    size_t dispatched = 0;
+    // Dispatched queries by their class before aging.
+    size_t dispatched_per_priority[kNumPriorities] = {};
+    int64_t total_wait_ms = 0;
+    int64_t max_wait_ms = 0;
+    // Longest wait among currently queued queries.
+    int64_t oldest_pending_wait_ms = 0;
+  };
+
+  QueryDispatchQueue(const size_t parallel_executors_max)
+      : QueryDispatchQueue(parallel_executors_max, Config()) {}
+
+  QueryDispatchQueue(const size_t parallel_executors_max, const Config& config)
+      : config_(config) {
     workers_.resize(parallel_executors_max);
     for (size_t i = 0; i < workers_.size(); i++) {
       // worker IDs are 1-indexed, leaving Executor 0 for non-dispatch queue worker tasks
@@ -46,6 +100,12 @@ class QueryDispatchQueue {
    * once the task runs.
    */
   void submit(std::shared_ptr<Task> task, const bool is_update_delete) {
+    submit(std::move(task), is_update_delete, TaskDescriptor());
+  }
+
+  void submit(std::shared_ptr<Task> task,
+              const bool is_update_delete,
+              const TaskDescriptor& desc) {
     if (workers_.size() == 1 && is_update_delete) {
       std::lock_guard<decltype(update_delete_mutex_)> update_delete_lock(
           update_delete_mutex_);
@@ -60,17 +120,55 @@ class QueryDispatchQueue {
     }
     std::unique_lock<decltype(queue_mutex_)> lock(queue_mutex_);
 
-    LOG(INFO) << "Dispatching query with " << queue_.size() << " queries in the queue.";
-    queue_.push(task);
+    auto priority = classify(desc);
+    auto& session = sessions_[desc.session_id];
+    if (!session.num_queued) {
+      // Idle sessions don't accumulate credit.
+      session.pass = std::max(session.pass, virtual_time_);
+    }
+    session.tasks[static_cast<size_t>(priority)].push_back(
+        {task, priority, std::max(desc.estimated_cost, size_t(1)), Clock::now()});
+    ++session.num_queued;
+    ++queue_depth_[static_cast<size_t>(priority)];
+    ++num_queued_;
+
+    LOG(INFO) << "Dispatching query with " << num_queued_ - 1 << " queries in the queue.";
     lock.unlock();
     cv_.notify_all();
   }
 
+  // Sessions with higher weights get proportionally more workers when queries of
+  // several sessions are queued. The default weight is 1.
+  void setSessionWeight(const std::string& session_id, double weight) {
+    CHECK_GT(weight, 0.0);
+    std::lock_guard<decltype(queue_mutex_)> lock(queue_mutex_);
+    sessions_[session_id].weight = weight;
+  }
+
   bool hasIdleWorker() {
     std::lock_guard<decltype(queue_mutex_)> lock(queue_mutex_);
     return num_running_workers_ < num_workers_;
   }
 
+  Stats getStats() {
+    std::lock_guard<decltype(queue_mutex_)> lock(queue_mutex_);
+    Stats res = stats_;
+    res.queue_depth = num_queued_;
+    std::copy(
+        queue_depth_, queue_depth_ + kNumPriorities, res.queue_depth_per_priority);
+    res.running = num_running_workers_;
+    auto now = Clock::now();
+    for (auto& [session_id, session] : sessions_) {
+      for (auto& tasks : session.tasks) {
+        if (!tasks.empty()) {
+          res.oldest_pending_wait_ms =
+              std::max(res.oldest_pending_wait_ms, waitMs(tasks.front(), now));
+        }
+      }
+    }
+    return res;
+  }
+
   ~QueryDispatchQueue() {
     {
       std::lock_guard<decltype(queue_mutex_)> lock(queue_mutex_);
@@ -83,23 +181,114 @@ class QueryDispatchQueue {
   }
 
  private:
+  struct PendingTask {
+    std::shared_ptr<Task> task;
+    Priority priority;
+    size_t cost;
+    Clock::time_point submit_time;
+  };
+
+  struct Session {
+    std::deque<PendingTask> tasks[kNumPriorities];
+    size_t num_queued = 0;
+    double weight = 1.0;
+    // Weighted cost of dispatched queries, sessions with lower values go first.
+    double pass = 0.0;
+  };
+
+  Priority classify(const TaskDescriptor& desc) const {
+    if (desc.priority != Priority::kAuto) {
+      return desc.priority;
+    }
+    if (!desc.estimated_cost) {
+      return Priority::kNormal;
+    }
+    if (desc.estimated_cost <= config_.interactive_cost) {
+      return Priority::kInteractive;
+    }
+    if (desc.estimated_cost >= config_.batch_cost) {
+      return Priority::kBatch;
+    }
+    return Priority::kNormal;
+  }
+
+  static int64_t waitMs(const PendingTask& task, Clock::time_point now) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now - task.submit_time)
+        .count();
+  }
+
+  size_t effectivePriority(const PendingTask& task, Clock::time_point now) const {
+    size_t priority = static_cast<size_t>(task.priority);
+    if (config_.aging_interval.count() > 0) {
+      auto promotion = static_cast<size_t>(waitMs(task, now) /
+                                           config_.aging_interval.count());
+      priority -= std::min(priority, promotion);
+    }
+    return priority;
+  }
+
+  // Pick the next task to run and update session accounting. Should be called under
+  // queue_mutex_ with a non-empty queue.
+  PendingTask popNextTask() {
+    auto now = Clock::now();
+    auto best_session = sessions_.end();
+    std::deque<PendingTask>* best = nullptr;
+    size_t best_priority = 0;
+    for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
+      auto& session = it->second;
+      for (auto& tasks : session.tasks) {
+        if (tasks.empty()) {
+          continue;
+        }
+        auto priority = effectivePriority(tasks.front(), now);
+        if (!best || priority < best_priority ||
+            (priority == best_priority &&
+             (session.pass < best_session->second.pass ||
+              (session.pass == best_session->second.pass &&
+               tasks.front().submit_time < best->front().submit_time)))) {
+          best_session = it;
+          best = &tasks;
+          best_priority = priority;
+        }
+      }
+    }
+    CHECK(best);
+    auto res = std::move(best->front());
+    best->pop_front();
+    auto& session = best_session->second;
+    virtual_time_ = std::max(virtual_time_, session.pass);
+    session.pass += static_cast<double>(res.cost) / session.weight;
+    // Forget idle sessions with the default weight to keep the map bounded.
+    if (!--session.num_queued && session.weight == 1.0) {
+      sessions_.erase(best_session);
+    }
+
+    --queue_depth_[static_cast<size_t>(res.priority)];
+    --num_queued_;
+    auto wait_ms = waitMs(res, now);
+    ++stats_.dispatched;
+    ++stats_.dispatched_per_priority[static_cast<size_t>(res.priority)];
+    stats_.total_wait_ms += wait_ms;
+    stats_.max_wait_ms = std::max(stats_.max_wait_ms, wait_ms);
+    return res;
+  }
+
   void worker(const size_t worker_idx) {
     std::unique_lock<std::mutex> lock(queue_mutex_);
     while (true) {
-      cv_.wait(lock, [this] { return !queue_.empty() || threads_should_exit_; });
+      cv_.wait(lock, [this] { return num_queued_ || threads_should_exit_; });
 
       if (threads_should_exit_) {
         return;
       }
 
-      if (!queue_.empty()) {
-        auto task = queue_.front();
-        queue_.pop();
+      if (num_queued_) {
+        auto task = popNextTask().task;
         ++num_running_workers_;
 
         LOG(INFO) << "Worker " << worker_idx
                   << " running query and returning control. There are now "
-                  << num_running_workers_ << " workers are running and " << queue_.size()
+                  << num_running_workers_ << " workers are running and " << num_queued_
                   << " queries in the queue.";
         // allow other threads to pick up tasks
         lock.unlock();
@@ -112,13 +301,19 @@ class QueryDispatchQueue {
     }
   }
 
+  const Config config_;
+
   std::mutex queue_mutex_;
   std::condition_variable cv_;
 
   std::mutex update_delete_mutex_;
 
   bool threads_should_exit_{false};
-  std::queue<std::shared_ptr<Task>> queue_;
+  std::unordered_map<std::string, Session> sessions_;
+  size_t num_queued_{0};
+  size_t queue_depth_[kNumPriorities] = {};
+  double virtual_time_{0.0};
+  Stats stats_;
   std::vector<std::thread> workers_;
   int num_running_workers_;  // manipulate this under queue_lock
   int num_workers_;
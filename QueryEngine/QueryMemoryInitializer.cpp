@@ -68,7 +68,8 @@ inline void check_total_bitmap_memory(const QueryMemoryDescriptor& query_mem_des
 int64_t* alloc_group_by_buffer(const size_t numBytes,
                                const size_t thread_idx,
                                RowSetMemoryOwner* mem_owner) {
-  return reinterpret_cast<int64_t*>(mem_owner->allocate(numBytes, thread_idx));
+  return reinterpret_cast<int64_t*>(
+      mem_owner->allocateGroupByBuffer(numBytes, thread_idx));
 }
 
 inline int64_t get_consistent_frag_size(const std::vector<uint64_t>& frag_offsets) {
@@ -24,6 +24,7 @@
 
 #include "DynamicWatchdog.h"
 #include "Execute.h"
+#include "MurmurHash.h"
 #include "ResultSet.h"
 #include "ResultSetReductionInterpreter.h"
 #include "ResultSetReductionJIT.h"
@@ -38,10 +39,13 @@
 #include <algorithm>
 #include <future>
 #include <numeric>
+#include <optional>
 
 extern bool g_enable_dynamic_watchdog;
 extern bool g_enable_non_kernel_time_query_interrupt;
 
+bool g_enable_parallel_reduction{true};
+
 namespace {
 
 bool use_multithreaded_reduction(const size_t entry_count) {
@@ -183,6 +187,16 @@ void run_reduction_code(const size_t executor_id,
 
 }  // namespace
 
+bool result_set::use_radix_partitioned_reduction(
+    const QueryMemoryDescriptor& query_mem_desc,
+    const size_t result_set_count) {
+  return result_set_count > 1 &&
+         query_mem_desc.getQueryDescriptionType() ==
+             QueryDescriptionType::GroupByBaselineHash &&
+         query_mem_desc.getRadixPartitionCount() > 1 &&
+         !query_mem_desc.didOutputColumnar();
+}
+
 void result_set::fill_empty_key(void* key_ptr,
                                 const size_t key_count,
                                 const size_t key_width) {
@@ -352,6 +366,526 @@ void ResultSetStorage::reduce(const ResultSetStorage& that,
   }
 }
 
+void ResultSetStorage::reduceEntries(const std::vector<const ResultSetStorage*>& those,
+                                     const size_t start_entry,
+                                     const size_t end_entry,
+                                     const ReductionCode& reduction_code,
+                                     const size_t executor_id) const {
+  CHECK(query_mem_desc_.getQueryDescriptionType() !=
+        QueryDescriptionType::GroupByBaselineHash);
+  CHECK_LE(end_entry, query_mem_desc_.getEntryCount());
+  auto this_buff = buff_;
+  CHECK(this_buff);
+  std::shared_ptr<Executor> executor;
+  if (query_mem_desc_.didOutputColumnar()) {
+    executor = Executor::getExecutorFromMap(executor_id);
+    CHECK(executor);
+  } else {
+    CHECK(reduction_code.ir_reduce_loop);
+  }
+  for (auto that : those) {
+    CHECK_EQ(query_mem_desc_.getEntryCount(), that->query_mem_desc_.getEntryCount());
+    auto that_buff = that->buff_;
+    CHECK(that_buff);
+    if (query_mem_desc_.didOutputColumnar()) {
+      reduceEntriesNoCollisionsColWise(
+          this_buff, that_buff, *that, start_entry, end_entry, {}, executor.get());
+    } else {
+      run_reduction_code(executor_id,
+                         reduction_code,
+                         this_buff,
+                         that_buff,
+                         start_entry,
+                         end_entry,
+                         that->query_mem_desc_.getEntryCount(),
+                         &query_mem_desc_,
+                         &that->query_mem_desc_,
+                         nullptr);
+    }
+  }
+}
+
+namespace {
+
+constexpr size_t kRadixPartitionChunkSize = 1 << 16;
+
+// Partitions use the high bits of a hash which differs from the one used to find
+// a slot in the hash table, so entries of a partition spread over its table. Kernels
+// use the same partitions, see get_radix_partition_buffer.
+uint32_t get_radix_partition(const int8_t* key,
+                             const size_t key_bytes,
+                             const int partition_bits) {
+  return MurmurHash3(key, key_bytes, 0x9e3779b9) >> (32 - partition_bits);
+}
+
+// Number of entries in every partition range of a buffer written by kernels with
+// the radix partitioned layout, zero for other buffers. Partitions of such buffers
+// are known from entry indexes with no key hashing.
+size_t get_layout_partition_entry_count(const QueryMemoryDescriptor& query_mem_desc,
+                                        const size_t partition_count) {
+  if (!query_mem_desc.hasRadixPartitionedLayout()) {
+    return 0;
+  }
+  CHECK_EQ(query_mem_desc.getRadixPartitionCount(), partition_count);
+  return query_mem_desc.getEntryCount() / partition_count;
+}
+
+int get_radix_partition_bits(const size_t partition_count) {
+  CHECK_GT(partition_count, size_t(1));
+  CHECK_EQ(partition_count & (partition_count - 1), size_t(0));
+  int partition_bits = 0;
+  while ((size_t(1) << partition_bits) < partition_count) {
+    ++partition_bits;
+  }
+  CHECK_LE(partition_bits, 16);
+  return partition_bits;
+}
+
+// Rows read back from a spill file at once.
+constexpr size_t kSpilledRowsBatchSize = 4096;
+
+// Fill every entry of a row-wise buffer with the empty key and initial values.
+void initialize_baseline_rowwise(int8_t* buff,
+                                 const QueryMemoryDescriptor& query_mem_desc,
+                                 const std::vector<int64_t>& target_init_vals) {
+  const auto key_count = query_mem_desc.getGroupbyColCount();
+  const auto row_size = get_row_bytes(query_mem_desc);
+  CHECK_EQ(row_size % 8, 0u);
+  const auto key_bytes_with_padding =
+      align_to_int64(get_key_bytes_rowwise(query_mem_desc));
+  CHECK(!query_mem_desc.hasKeylessHash());
+  switch (query_mem_desc.getEffectiveKeyWidth()) {
+    case 4: {
+      for (size_t i = 0; i < query_mem_desc.getEntryCount(); ++i) {
+        auto row_ptr = buff + i * row_size;
+        fill_empty_key_32(reinterpret_cast<int32_t*>(row_ptr), key_count);
+        auto slot_ptr = reinterpret_cast<int64_t*>(row_ptr + key_bytes_with_padding);
+        for (size_t j = 0; j < target_init_vals.size(); ++j) {
+          slot_ptr[j] = target_init_vals[j];
+        }
+      }
+      break;
+    }
+    case 8: {
+      for (size_t i = 0; i < query_mem_desc.getEntryCount(); ++i) {
+        auto row_ptr = buff + i * row_size;
+        fill_empty_key_64(reinterpret_cast<int64_t*>(row_ptr), key_count);
+        auto slot_ptr = reinterpret_cast<int64_t*>(row_ptr + key_bytes_with_padding);
+        for (size_t j = 0; j < target_init_vals.size(); ++j) {
+          slot_ptr[j] = target_init_vals[j];
+        }
+      }
+      break;
+    }
+    default:
+      CHECK(false);
+  }
+}
+
+// Reduce rows of a spilled segment into a table. Rows are read in batches, every
+// batch is a buffer of non-empty entries.
+void reduce_spilled_segment(const SpilledRadixPartitions& spilled_partitions,
+                            const size_t segment_offset,
+                            const size_t segment_rows,
+                            int8_t* this_buff,
+                            const QueryMemoryDescriptor& this_query_mem_desc,
+                            const ReductionCode& reduction_code,
+                            const size_t executor_id,
+                            std::vector<int64_t>& batch) {
+  const auto row_bytes = spilled_partitions.row_bytes;
+  for (size_t start = 0; start < segment_rows; start += kSpilledRowsBatchSize) {
+    const auto batch_rows = std::min(kSpilledRowsBatchSize, segment_rows - start);
+    batch.resize(batch_rows * row_bytes / sizeof(int64_t));
+    spilled_partitions.file->read(
+        segment_offset + start * row_bytes, batch.data(), batch_rows * row_bytes);
+    auto batch_query_mem_desc = this_query_mem_desc;
+    batch_query_mem_desc.setEntryCount(batch_rows);
+    run_reduction_code(executor_id,
+                       reduction_code,
+                       this_buff,
+                       reinterpret_cast<int8_t*>(batch.data()),
+                       0,
+                       batch_rows,
+                       batch_rows,
+                       &this_query_mem_desc,
+                       &batch_query_mem_desc,
+                       nullptr);
+  }
+}
+
+}  // namespace
+
+SpilledRadixPartitions::SpilledRadixPartitions(SpillManager& spill_manager,
+                                               const size_t partition_count,
+                                               const size_t row_bytes)
+    : file(spill_manager.createFile())
+    , partition_count(partition_count)
+    , row_bytes(row_bytes) {}
+
+size_t SpilledRadixPartitions::getResultCount() const {
+  std::lock_guard<std::mutex> lock(runs_mutex);
+  return runs.size();
+}
+
+size_t SpilledRadixPartitions::getRowCount(const size_t partition) const {
+  CHECK_LT(partition, partition_count);
+  std::lock_guard<std::mutex> lock(runs_mutex);
+  size_t res = 0;
+  for (const auto& run : runs) {
+    res += run.segment_rows[partition];
+  }
+  return res;
+}
+
+void SpilledRadixPartitions::addRun(Run run) {
+  CHECK_EQ(run.segment_offsets.size(), partition_count);
+  CHECK_EQ(run.segment_rows.size(), partition_count);
+  std::lock_guard<std::mutex> lock(runs_mutex);
+  runs.push_back(std::move(run));
+}
+
+RadixPartitionedEntries ResultSetStorage::radixPartitionEntries(
+    const std::vector<const ResultSetStorage*>& storages,
+    const size_t partition_count,
+    const SpilledRadixPartitions* spilled_partitions) {
+  CHECK(!storages.empty());
+  const auto partition_bits = get_radix_partition_bits(partition_count);
+  if (spilled_partitions) {
+    CHECK_EQ(spilled_partitions->getPartitionCount(), partition_count);
+  }
+
+  RadixPartitionedEntries res;
+  std::vector<std::pair<size_t, size_t>> chunk_ranges;
+  for (size_t storage_idx = 0; storage_idx < storages.size(); ++storage_idx) {
+    const auto& query_mem_desc = storages[storage_idx]->query_mem_desc_;
+    CHECK(query_mem_desc.getQueryDescriptionType() ==
+          QueryDescriptionType::GroupByBaselineHash);
+    CHECK(!query_mem_desc.didOutputColumnar());
+    const auto entry_count = query_mem_desc.getEntryCount();
+    for (size_t start = 0; start < entry_count; start += kRadixPartitionChunkSize) {
+      res.chunks.push_back({storage_idx, {}, {}});
+      chunk_ranges.emplace_back(start,
+                                std::min(start + kRadixPartitionChunkSize, entry_count));
+    }
+  }
+
+  // Two passes over each chunk: the histogram of partition sizes and the scatter
+  // of entry indexes into their partitions.
+  threading::parallel_for(
+      threading::blocked_range<size_t>(0, res.chunks.size()),
+      [&storages, &res, &chunk_ranges, partition_count, partition_bits](auto r) {
+        std::vector<uint32_t> non_empty_entries;
+        std::vector<uint32_t> entry_partitions;
+        std::vector<size_t> partition_cursors;
+        for (size_t chunk_idx = r.begin(); chunk_idx < r.end(); ++chunk_idx) {
+          auto& chunk = res.chunks[chunk_idx];
+          const auto storage = storages[chunk.storage_idx];
+          const auto& query_mem_desc = storage->query_mem_desc_;
+          const auto row_bytes = get_row_bytes(query_mem_desc);
+          const auto key_bytes =
+              query_mem_desc.getGroupbyColCount() * query_mem_desc.getEffectiveKeyWidth();
+          const auto layout_partition_entry_count =
+              get_layout_partition_entry_count(query_mem_desc, partition_count);
+          non_empty_entries.clear();
+          entry_partitions.clear();
+          chunk.partition_offsets.assign(partition_count + 1, 0);
+          for (size_t entry_idx = chunk_ranges[chunk_idx].first;
+               entry_idx < chunk_ranges[chunk_idx].second;
+               ++entry_idx) {
+            if (storage->isEmptyEntry(entry_idx, storage->buff_)) {
+              continue;
+            }
+            const auto partition =
+                layout_partition_entry_count
+                    ? entry_idx / layout_partition_entry_count
+                    : get_radix_partition(storage->buff_ + entry_idx * row_bytes,
+                                          key_bytes,
+                                          partition_bits);
+            non_empty_entries.push_back(entry_idx);
+            entry_partitions.push_back(partition);
+            ++chunk.partition_offsets[partition + 1];
+          }
+          std::partial_sum(chunk.partition_offsets.begin(),
+                           chunk.partition_offsets.end(),
+                           chunk.partition_offsets.begin());
+          partition_cursors = chunk.partition_offsets;
+          chunk.entries.resize(non_empty_entries.size());
+          for (size_t i = 0; i < non_empty_entries.size(); ++i) {
+            chunk.entries[partition_cursors[entry_partitions[i]]++] =
+                non_empty_entries[i];
+          }
+        }
+      });
+
+  // The number of partition's input entries is an upper bound for the number of
+  // its groups. Size partition tables and the output for 2/3 load factor.
+  res.partition_entry_counts.assign(partition_count, 0);
+  for (size_t partition = 0; partition < partition_count; ++partition) {
+    size_t input_entry_count = 0;
+    for (const auto& chunk : res.chunks) {
+      input_entry_count += chunk.partition_offsets[partition + 1] -
+                           chunk.partition_offsets[partition];
+    }
+    if (spilled_partitions) {
+      input_entry_count += spilled_partitions->getRowCount(partition);
+    }
+    res.partition_entry_counts[partition] = input_entry_count + input_entry_count / 2 + 1;
+    res.output_entry_count += res.partition_entry_counts[partition];
+  }
+  return res;
+}
+
+void ResultSetStorage::reduceRadixPartitions(
+    const std::vector<const ResultSetStorage*>& storages,
+    const RadixPartitionedEntries& partitions,
+    const ReductionCode& reduction_code,
+    const size_t executor_id,
+    const SpilledRadixPartitions* spilled_partitions) const {
+  CHECK_EQ(query_mem_desc_.getEntryCount(), partitions.getOutputEntryCount());
+  CHECK(buff_);
+  reduceRadixPartitionsImpl(
+      storages,
+      partitions,
+      reduction_code,
+      executor_id,
+      spilled_partitions,
+      [this, &reduction_code, executor_id](
+          const size_t partition,
+          int8_t* partition_buff,
+          const QueryMemoryDescriptor& partition_query_mem_desc) {
+        // Groups are unique within the partition and other partitions have other
+        // keys, so concurrent inserts never reduce the same output entry.
+        const auto partition_entry_count = partition_query_mem_desc.getEntryCount();
+        run_reduction_code(executor_id,
+                           reduction_code,
+                           buff_,
+                           partition_buff,
+                           0,
+                           partition_entry_count,
+                           partition_entry_count,
+                           &query_mem_desc_,
+                           &partition_query_mem_desc,
+                           nullptr);
+      });
+}
+
+void ResultSetStorage::spillReducedRadixPartitions(
+    const std::vector<const ResultSetStorage*>& storages,
+    const RadixPartitionedEntries& partitions,
+    const ReductionCode& reduction_code,
+    const size_t executor_id,
+    const SpilledRadixPartitions* spilled_partitions,
+    SpilledRadixPartitions& reduced_partitions) const {
+  const auto row_bytes = get_row_bytes(query_mem_desc_);
+  CHECK_EQ(reduced_partitions.getPartitionCount(), partitions.getPartitionCount());
+  CHECK_EQ(reduced_partitions.row_bytes, row_bytes);
+  SpilledRadixPartitions::Run run;
+  run.segment_offsets.resize(partitions.getPartitionCount(), 0);
+  run.segment_rows.resize(partitions.getPartitionCount(), 0);
+  reduceRadixPartitionsImpl(
+      storages,
+      partitions,
+      reduction_code,
+      executor_id,
+      spilled_partitions,
+      [this, &run, &reduced_partitions, row_bytes](
+          const size_t partition,
+          int8_t* partition_buff,
+          const QueryMemoryDescriptor& partition_query_mem_desc) {
+        // Non-empty entries are compacted in place, the table isn't used anymore.
+        auto segment = partition_buff;
+        size_t segment_rows = 0;
+        for (size_t entry_idx = 0; entry_idx < partition_query_mem_desc.getEntryCount();
+             ++entry_idx) {
+          if (isEmptyEntry(entry_idx, segment)) {
+            continue;
+          }
+          if (entry_idx != segment_rows) {
+            memcpy(segment + segment_rows * row_bytes,
+                   segment + entry_idx * row_bytes,
+                   row_bytes);
+          }
+          ++segment_rows;
+        }
+        if (segment_rows) {
+          run.segment_offsets[partition] =
+              reduced_partitions.file->append(segment, segment_rows * row_bytes);
+          run.segment_rows[partition] = segment_rows;
+        }
+      });
+  reduced_partitions.addRun(std::move(run));
+}
+
+void ResultSetStorage::reduceSpilledRadixPartitions(
+    const SpilledRadixPartitions& reduced_partitions,
+    const ReductionCode& reduction_code,
+    const size_t executor_id) const {
+  CHECK(query_mem_desc_.getQueryDescriptionType() ==
+        QueryDescriptionType::GroupByBaselineHash);
+  CHECK(!query_mem_desc_.didOutputColumnar());
+  CHECK(reduction_code.ir_reduce_loop);
+  CHECK(buff_);
+  CHECK_EQ(reduced_partitions.row_bytes, get_row_bytes(query_mem_desc_));
+  CHECK_EQ(reduced_partitions.getResultCount(), size_t(1));
+  const auto& run = reduced_partitions.runs.front();
+  // Partitions have no common keys, so they are inserted concurrently.
+  threading::parallel_for(
+      threading::blocked_range<size_t>(0, reduced_partitions.getPartitionCount()),
+      [this, &reduced_partitions, &run, &reduction_code, executor_id](auto r) {
+        std::vector<int64_t> batch;
+        for (size_t partition = r.begin(); partition < r.end(); ++partition) {
+          reduce_spilled_segment(reduced_partitions,
+                                 run.segment_offsets[partition],
+                                 run.segment_rows[partition],
+                                 buff_,
+                                 query_mem_desc_,
+                                 reduction_code,
+                                 executor_id,
+                                 batch);
+        }
+      });
+}
+
+void ResultSetStorage::reduceRadixPartitionsImpl(
+    const std::vector<const ResultSetStorage*>& storages,
+    const RadixPartitionedEntries& partitions,
+    const ReductionCode& reduction_code,
+    const size_t executor_id,
+    const SpilledRadixPartitions* spilled_partitions,
+    const std::function<void(size_t, int8_t*, const QueryMemoryDescriptor&)>&
+        partition_reduced) const {
+  CHECK(query_mem_desc_.getQueryDescriptionType() ==
+        QueryDescriptionType::GroupByBaselineHash);
+  CHECK(!query_mem_desc_.didOutputColumnar());
+  CHECK(reduction_code.ir_reduce_loop);
+  const auto row_bytes = get_row_bytes(query_mem_desc_);
+  if (spilled_partitions) {
+    CHECK_EQ(spilled_partitions->getPartitionCount(), partitions.getPartitionCount());
+    CHECK_EQ(spilled_partitions->row_bytes, row_bytes);
+  }
+  const std::vector<SpilledRadixPartitions::Run> no_runs;
+  const auto& spilled_runs = spilled_partitions ? spilled_partitions->runs : no_runs;
+  threading::parallel_for(
+      threading::blocked_range<size_t>(0, partitions.getPartitionCount()),
+      [this,
+       &storages,
+       &partitions,
+       &reduction_code,
+       &spilled_runs,
+       &partition_reduced,
+       executor_id,
+       row_bytes,
+       spilled_partitions](auto r) {
+        std::vector<int64_t> spilled_rows;
+        std::vector<int64_t> partition_table;
+        for (size_t partition = r.begin(); partition < r.end(); ++partition) {
+          // Partition tables are sized to fit in cache, so the aggregation of
+          // duplicate keys doesn't access the whole output.
+          const auto partition_entry_count =
+              partitions.partition_entry_counts[partition];
+          auto partition_query_mem_desc = query_mem_desc_;
+          partition_query_mem_desc.setEntryCount(partition_entry_count);
+          partition_query_mem_desc.setRadixPartitionedLayout(false);
+          partition_table.resize(partition_entry_count * row_bytes / sizeof(int64_t));
+          auto partition_buff = reinterpret_cast<int8_t*>(partition_table.data());
+          initialize_baseline_rowwise(
+              partition_buff, partition_query_mem_desc, target_init_vals_);
+          for (const auto& chunk : partitions.chunks) {
+            const auto that = storages[chunk.storage_idx];
+            for (auto i = chunk.partition_offsets[partition];
+                 i < chunk.partition_offsets[partition + 1];
+                 ++i) {
+              const auto entry_idx = chunk.entries[i];
+              run_reduction_code(executor_id,
+                                 reduction_code,
+                                 partition_buff,
+                                 that->buff_,
+                                 entry_idx,
+                                 entry_idx + 1,
+                                 that->query_mem_desc_.getEntryCount(),
+                                 &partition_query_mem_desc,
+                                 &that->query_mem_desc_,
+                                 nullptr);
+            }
+          }
+          for (const auto& run : spilled_runs) {
+            reduce_spilled_segment(*spilled_partitions,
+                                   run.segment_offsets[partition],
+                                   run.segment_rows[partition],
+                                   partition_buff,
+                                   partition_query_mem_desc,
+                                   reduction_code,
+                                   executor_id,
+                                   spilled_rows);
+          }
+          partition_reduced(partition, partition_buff, partition_query_mem_desc);
+        }
+      });
+}
+
+void ResultSetStorage::spillRadixPartitions(
+    SpilledRadixPartitions& spilled_partitions) const {
+  CHECK(query_mem_desc_.getQueryDescriptionType() ==
+        QueryDescriptionType::GroupByBaselineHash);
+  CHECK(!query_mem_desc_.didOutputColumnar());
+  CHECK(buff_);
+  const auto partition_count = spilled_partitions.getPartitionCount();
+  const auto partition_bits = get_radix_partition_bits(partition_count);
+  const auto row_bytes = get_row_bytes(query_mem_desc_);
+  CHECK_EQ(spilled_partitions.row_bytes, row_bytes);
+  const auto key_bytes =
+      query_mem_desc_.getGroupbyColCount() * query_mem_desc_.getEffectiveKeyWidth();
+  const auto layout_partition_entry_count =
+      get_layout_partition_entry_count(query_mem_desc_, partition_count);
+
+  // Group entries by partition, then write every partition as a single segment.
+  std::vector<uint32_t> non_empty_entries;
+  std::vector<uint32_t> entry_partitions;
+  std::vector<size_t> partition_offsets(partition_count + 1, 0);
+  for (size_t entry_idx = 0; entry_idx < query_mem_desc_.getEntryCount(); ++entry_idx) {
+    if (isEmptyEntry(entry_idx, buff_)) {
+      continue;
+    }
+    const auto partition =
+        layout_partition_entry_count
+            ? entry_idx / layout_partition_entry_count
+            : get_radix_partition(
+                  buff_ + entry_idx * row_bytes, key_bytes, partition_bits);
+    non_empty_entries.push_back(entry_idx);
+    entry_partitions.push_back(partition);
+    ++partition_offsets[partition + 1];
+  }
+  std::partial_sum(
+      partition_offsets.begin(), partition_offsets.end(), partition_offsets.begin());
+  auto partition_cursors = partition_offsets;
+  std::vector<uint32_t> partitioned_entries(non_empty_entries.size());
+  for (size_t i = 0; i < non_empty_entries.size(); ++i) {
+    partitioned_entries[partition_cursors[entry_partitions[i]]++] = non_empty_entries[i];
+  }
+
+  SpilledRadixPartitions::Run run;
+  run.segment_offsets.resize(partition_count, 0);
+  run.segment_rows.resize(partition_count, 0);
+  std::vector<int8_t> segment;
+  for (size_t partition = 0; partition < partition_count; ++partition) {
+    const auto begin = partition_offsets[partition];
+    const auto end = partition_offsets[partition + 1];
+    if (begin == end) {
+      continue;
+    }
+    segment.resize((end - begin) * row_bytes);
+    for (auto i = begin; i < end; ++i) {
+      memcpy(segment.data() + (i - begin) * row_bytes,
+             buff_ + partitioned_entries[i] * row_bytes,
+             row_bytes);
+    }
+    run.segment_offsets[partition] =
+        spilled_partitions.file->append(segment.data(), segment.size());
+    run.segment_rows[partition] = end - begin;
+  }
+  spilled_partitions.addRun(std::move(run));
+}
+
 namespace {
 
 ALWAYS_INLINE void check_watchdog() {
@@ -993,6 +1527,47 @@ void ResultSet::initializeStorage() const {
   }
 }
 
+namespace {
+
+// Reduces all the storages into the first one, in parallel.
+void reduce_parallel(const std::vector<const ResultSetStorage*>& storages,
+                     const ReductionCode& reduction_code,
+                     const size_t executor_id) {
+  const auto result = storages.front();
+  const auto entry_count = result->getEntryCount();
+  if (use_multithreaded_reduction(entry_count)) {
+    // Large outputs: each thread owns a range of the output hash table and
+    // merges all inputs into it, keeping the range in cache.
+    const std::vector<const ResultSetStorage*> those(storages.begin() + 1,
+                                                     storages.end());
+    threading::parallel_for(
+        threading::blocked_range<size_t>(0, entry_count),
+        [result, &those, &reduction_code, executor_id](auto r) {
+          result->reduceEntries(those, r.begin(), r.end(), reduction_code, executor_id);
+        });
+    return;
+  }
+  // Small outputs: pairwise tree reduction, log2(N) rounds of independent
+  // reductions. The first storage receives the final result.
+  for (size_t stride = 1; stride < storages.size(); stride *= 2) {
+    const size_t num_pairs = (storages.size() - 1) / (2 * stride) + 1;
+    threading::parallel_for(
+        threading::blocked_range<size_t>(0, num_pairs),
+        [&storages, &reduction_code, executor_id, stride](auto r) {
+          for (size_t pair_idx = r.begin(); pair_idx < r.end(); ++pair_idx) {
+            const size_t dst_idx = pair_idx * 2 * stride;
+            const size_t src_idx = dst_idx + stride;
+            if (src_idx < storages.size()) {
+              storages[dst_idx]->reduce(
+                  *storages[src_idx], {}, reduction_code, executor_id);
+            }
+          }
+        });
+  }
+}
+
+}  // namespace
+
 // Driver for reductions. Needed because the result of a reduction on the baseline
 // layout, which can have collisions, cannot be done in place and something needs
 // to take the ownership of the new result set with the bigger underlying buffer.
@@ -1009,16 +1584,31 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets,
   }
   if (first_result.query_mem_desc_.getQueryDescriptionType() ==
       QueryDescriptionType::GroupByBaselineHash) {
+    std::vector<const ResultSetStorage*> storages;
+    std::optional<RadixPartitionedEntries> radix_partitions;
+    if (result_set::use_radix_partitioned_reduction(first_result.query_mem_desc_,
+                                                    result_sets.size()) &&
+        result_rs->serialized_varlen_buffer_.empty()) {
+      for (const auto result_set : result_sets) {
+        storages.push_back(result_set->storage_.get());
+      }
+      radix_partitions = ResultSetStorage::radixPartitionEntries(
+          storages, first_result.query_mem_desc_.getRadixPartitionCount());
+    }
     const auto total_entry_count =
-        std::accumulate(result_sets.begin(),
-                        result_sets.end(),
-                        size_t(0),
-                        [](const size_t init, const ResultSet* rs) {
-                          return init + rs->query_mem_desc_.getEntryCount();
-                        });
+        radix_partitions
+            ? radix_partitions->getOutputEntryCount()
+            : std::accumulate(result_sets.begin(),
+                              result_sets.end(),
+                              size_t(0),
+                              [](const size_t init, const ResultSet* rs) {
+                                return init + rs->query_mem_desc_.getEntryCount();
+                              });
     CHECK(total_entry_count);
     auto query_mem_desc = first_result.query_mem_desc_;
     query_mem_desc.setEntryCount(total_entry_count);
+    // The output is hashed globally, kernel partition ranges are not kept.
+    query_mem_desc.setRadixPartitionedLayout(false);
     rs_.reset(new ResultSet(first_result.targets_,
                             ExecutorDeviceType::CPU,
                             query_mem_desc,
@@ -1029,6 +1619,15 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets,
                             0));
     auto result_storage = rs_->allocateStorage(first_result.target_init_vals_);
     rs_->initializeStorage();
+    if (radix_partitions) {
+      ResultSetReductionJIT reduction_jit(rs_->getQueryMemDesc(),
+                                          rs_->getTargetInfos(),
+                                          rs_->getTargetInitVals(),
+                                          executor_id);
+      result_storage->reduceRadixPartitions(
+          storages, *radix_partitions, reduction_jit.codegen(), executor_id);
+      return rs_.get();
+    }
     switch (query_mem_desc.getEffectiveKeyWidth()) {
       case 4:
         first_result.moveEntriesToBuffer<int32_t>(result_storage->getUnderlyingBuffer(),
@@ -1062,6 +1661,17 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets,
                                       result_rs->getTargetInitVals(),
                                       executor_id);
   auto reduction_code = reduction_jit.codegen();
+  if (g_enable_parallel_reduction && result_sets.size() > 2 &&
+      serialized_varlen_buffer.empty() &&
+      result->query_mem_desc_.getQueryDescriptionType() !=
+          QueryDescriptionType::GroupByBaselineHash) {
+    std::vector<const ResultSetStorage*> storages;
+    for (auto result_set : result_sets) {
+      storages.push_back(result_set->storage_.get());
+    }
+    reduce_parallel(storages, reduction_code, executor_id);
+    return result_rs;
+  }
   size_t ctr = 1;
   for (auto result_it = result_sets.begin() + 1; result_it != result_sets.end();
        ++result_it) {
@@ -1106,38 +1716,7 @@ void ResultSetStorage::fillOneEntryRowWise(const std::vector<int64_t>& entry) {
 }
 
 void ResultSetStorage::initializeRowWise() const {
-  const auto key_count = query_mem_desc_.getGroupbyColCount();
-  const auto row_size = get_row_bytes(query_mem_desc_);
-  CHECK_EQ(row_size % 8, 0u);
-  const auto key_bytes_with_padding =
-      align_to_int64(get_key_bytes_rowwise(query_mem_desc_));
-  CHECK(!query_mem_desc_.hasKeylessHash());
-  switch (query_mem_desc_.getEffectiveKeyWidth()) {
-    case 4: {
-      for (size_t i = 0; i < query_mem_desc_.getEntryCount(); ++i) {
-        auto row_ptr = buff_ + i * row_size;
-        fill_empty_key_32(reinterpret_cast<int32_t*>(row_ptr), key_count);
-        auto slot_ptr = reinterpret_cast<int64_t*>(row_ptr + key_bytes_with_padding);
-        for (size_t j = 0; j < target_init_vals_.size(); ++j) {
-          slot_ptr[j] = target_init_vals_[j];
-        }
-      }
-      break;
-    }
-    case 8: {
-      for (size_t i = 0; i < query_mem_desc_.getEntryCount(); ++i) {
-        auto row_ptr = buff_ + i * row_size;
-        fill_empty_key_64(reinterpret_cast<int64_t*>(row_ptr), key_count);
-        auto slot_ptr = reinterpret_cast<int64_t*>(row_ptr + key_bytes_with_padding);
-        for (size_t j = 0; j < target_init_vals_.size(); ++j) {
-          slot_ptr[j] = target_init_vals_[j];
-        }
-      }
-      break;
-    }
-    default:
-      CHECK(false);
-  }
+  initialize_baseline_rowwise(buff_, query_mem_desc_, target_init_vals_);
 }
 
 void ResultSetStorage::fillOneEntryColWise(const std::vector<int64_t>& entry) {
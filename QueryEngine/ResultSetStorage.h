@@ -28,6 +28,7 @@
 #include "CardinalityEstimator.h"
 #include "DataMgr/Chunk/Chunk.h"
 #include "ResultSetBufferAccessors.h"
+#include "SpillManager.h"
 #include "TargetValue.h"
 
 #include <atomic>
@@ -95,6 +96,52 @@ struct VarlenOutputInfo {
   int8_t* computeCpuOffset(const int64_t gpu_offset_address) const;
 };
 
+// Non-empty entries of baseline hash storages scattered into radix partitions by
+// a hash of their keys.
+struct RadixPartitionedEntries {
+  struct Chunk {
+    size_t storage_idx;
+    // Indexes of the chunk's entries grouped by partition. Partition p owns
+    // [partition_offsets[p], partition_offsets[p + 1]).
+    std::vector<uint32_t> entries;
+    std::vector<size_t> partition_offsets;
+  };
+  std::vector<Chunk> chunks;
+  // Sizes of hash tables partitions are aggregated in. The output table is sized
+  // for all of them.
+  std::vector<size_t> partition_entry_counts;
+  size_t output_entry_count = 0;
+
+  size_t getPartitionCount() const { return partition_entry_counts.size(); }
+  size_t getOutputEntryCount() const { return output_entry_count; }
+};
+
+// Rows of baseline hash results written to a spill file instead of being held in
+// memory until the reduction. Every spilled result is a run of per-partition
+// segments of rows laid out as in a row-wise buffer.
+struct SpilledRadixPartitions {
+  struct Run {
+    std::vector<size_t> segment_offsets;
+    std::vector<size_t> segment_rows;
+  };
+
+  SpilledRadixPartitions(SpillManager& spill_manager,
+                         const size_t partition_count,
+                         const size_t row_bytes);
+
+  size_t getPartitionCount() const { return partition_count; }
+  size_t getResultCount() const;
+  size_t getRowCount(const size_t partition) const;
+
+  void addRun(Run run);
+
+  std::unique_ptr<SpillFile> file;
+  const size_t partition_count;
+  const size_t row_bytes;
+  std::vector<Run> runs;
+  mutable std::mutex runs_mutex;
+};
+
 class ResultSetStorage {
  private:
   ResultSetStorage(const std::vector<TargetInfo>& targets,
@@ -108,6 +155,58 @@ class ResultSetStorage {
               const ReductionCode& reduction_code,
               const size_t executor_id) const;
 
+  // Reduce entries [start_entry, end_entry) of all storages into this one.
+  // Different ranges don't overlap, so they can be reduced concurrently. Baseline
+  // hash layouts and serialized varlen buffers are not supported.
+  void reduceEntries(const std::vector<const ResultSetStorage*>& those,
+                     const size_t start_entry,
+                     const size_t end_entry,
+                     const ReductionCode& reduction_code,
+                     const size_t executor_id) const;
+
+  // Scatter non-empty entries of row-wise baseline hash storages into
+  // partition_count partitions, which must be a power of two. Every thread
+  // partitions its own chunks of entries. Partition tables and the output are
+  // sized for the spilled rows of partitions too.
+  static RadixPartitionedEntries radixPartitionEntries(
+      const std::vector<const ResultSetStorage*>& storages,
+      const size_t partition_count,
+      const SpilledRadixPartitions* spilled_partitions = nullptr);
+
+  // Aggregate every partition independently in a partition-sized hash table, then
+  // insert its groups into this storage, which must have
+  // partitions.getOutputEntryCount() entries. Partitions have no common keys, so
+  // they are inserted concurrently, and the result is a regular hash table which
+  // can be probed by any key. Spilled rows are read back and aggregated partition
+  // by partition.
+  void reduceRadixPartitions(
+      const std::vector<const ResultSetStorage*>& storages,
+      const RadixPartitionedEntries& partitions,
+      const ReductionCode& reduction_code,
+      const size_t executor_id,
+      const SpilledRadixPartitions* spilled_partitions = nullptr) const;
+
+  // Same as reduceRadixPartitions, but groups of every partition are appended to
+  // reduced_partitions as a segment of a single run instead of being inserted
+  // into this storage, which only provides the layout. At most one partition
+  // table per thread is held in memory.
+  void spillReducedRadixPartitions(const std::vector<const ResultSetStorage*>& storages,
+                                   const RadixPartitionedEntries& partitions,
+                                   const ReductionCode& reduction_code,
+                                   const size_t executor_id,
+                                   const SpilledRadixPartitions* spilled_partitions,
+                                   SpilledRadixPartitions& reduced_partitions) const;
+
+  // Insert the groups written by spillReducedRadixPartitions into this storage.
+  // Partitions are read back in batches and inserted concurrently.
+  void reduceSpilledRadixPartitions(const SpilledRadixPartitions& reduced_partitions,
+                                    const ReductionCode& reduction_code,
+                                    const size_t executor_id) const;
+
+  // Append non-empty entries of this row-wise baseline hash storage to the spill
+  // file as a run of per-partition segments.
+  void spillRadixPartitions(SpilledRadixPartitions& spilled_partitions) const;
+
   void rewriteAggregateBufferOffsets(
       const std::vector<std::string>& serialized_varlen_buffer) const;
 
@@ -162,6 +261,18 @@ class ResultSetStorage {
                       int8_t* this_buff,
                       const int8_t* that_buff) const;
 
+  // Aggregate every partition in a partition-sized table with the layout of this
+  // storage and pass the table to partition_reduced. Called concurrently for
+  // different partitions.
+  void reduceRadixPartitionsImpl(
+      const std::vector<const ResultSetStorage*>& storages,
+      const RadixPartitionedEntries& partitions,
+      const ReductionCode& reduction_code,
+      const size_t executor_id,
+      const SpilledRadixPartitions* spilled_partitions,
+      const std::function<void(size_t, int8_t*, const QueryMemoryDescriptor&)>&
+          partition_reduced) const;
+
   bool isEmptyEntry(const size_t entry_idx, const int8_t* buff) const;
   bool isEmptyEntry(const size_t entry_idx) const;
   bool isEmptyEntryColumnar(const size_t entry_idx, const int8_t* buff) const;
@@ -265,6 +376,11 @@ int64_t lazy_decode(const ColumnLazyFetchInfo& col_lazy_fetch,
 
 void fill_empty_key(void* key_ptr, const size_t key_count, const size_t key_width);
 
+// Whether baseline hash results are reduced through radix partitioning, see
+// ResultSetStorage::radixPartitionEntries.
+bool use_radix_partitioned_reduction(const QueryMemoryDescriptor& query_mem_desc,
+                                     const size_t result_set_count);
+
 int8_t get_width_for_slot(const size_t target_slot_idx,
                           const bool float_argument_input,
                           const QueryMemoryDescriptor& query_mem_desc);
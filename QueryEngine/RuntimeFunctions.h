@@ -148,6 +148,15 @@ extern "C" RUNTIME_EXPORT int64_t* get_group_value_with_watchdog(
     const uint32_t key_width,
     const uint32_t row_size_quad);
 
+extern "C" RUNTIME_EXPORT int64_t* get_group_value_radix_partitioned(
+    int64_t* groups_buffer,
+    const uint32_t groups_buffer_entry_count,
+    const int64_t* key,
+    const uint32_t key_count,
+    const uint32_t key_width,
+    const uint32_t row_size_quad,
+    const uint32_t partition_bits);
+
 extern "C" RUNTIME_EXPORT int64_t* get_group_value_columnar(
     int64_t* groups_buffer,
     const uint32_t groups_buffer_entry_count,
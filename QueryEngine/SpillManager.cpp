@@ -0,0 +1,131 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/SpillManager.h"
+#include "Logger/Logger.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include <unistd.h>
+
+bool g_enable_spill{false};
+std::string g_spill_dir{};
+size_t g_spill_max_bytes{size_t(64) << 30};
+// Zero means half of the system memory.
+size_t g_spill_memory_threshold{0};
+
+namespace {
+
+std::string errno_message() {
+  return std::strerror(errno);
+}
+
+}  // namespace
+
+SpillFile::SpillFile(SpillManager* manager, int fd) : manager_(manager), fd_(fd) {}
+
+SpillFile::~SpillFile() {
+  close(fd_);
+  manager_->release(size_);
+}
+
+size_t SpillFile::append(const void* data, size_t num_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  manager_->reserve(num_bytes);
+  auto src = reinterpret_cast<const int8_t*>(data);
+  size_t written = 0;
+  while (written < num_bytes) {
+    auto res = pwrite(fd_, src + written, num_bytes - written, size_ + written);
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      manager_->release(num_bytes);
+      throw std::runtime_error("Cannot write spill file: " + errno_message());
+    }
+    written += res;
+  }
+  auto offset = size_;
+  size_ += num_bytes;
+  return offset;
+}
+
+void SpillFile::read(size_t offset, void* data, size_t num_bytes) const {
+  CHECK_LE(offset + num_bytes, size());
+  auto dst = reinterpret_cast<int8_t*>(data);
+  size_t done = 0;
+  while (done < num_bytes) {
+    auto res = pread(fd_, dst + done, num_bytes - done, offset + done);
+    if (res < 0 && errno == EINTR) {
+      continue;
+    }
+    if (res <= 0) {
+      throw std::runtime_error("Cannot read spill file: " + errno_message());
+    }
+    done += res;
+  }
+}
+
+size_t SpillFile::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_;
+}
+
+SpillManager::SpillManager(const std::string& dir, size_t max_bytes)
+    : dir_(dir), max_bytes_(max_bytes) {
+  if (dir_.empty()) {
+    dir_ = std::filesystem::temp_directory_path().string();
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(dir_, ec);
+  if (ec) {
+    LOG(WARNING) << "Cannot create spill directory " << dir_ << ": " << ec.message();
+  }
+}
+
+SpillManager& SpillManager::get() {
+  static SpillManager manager(g_spill_dir, g_spill_max_bytes);
+  return manager;
+}
+
+std::unique_ptr<SpillFile> SpillManager::createFile() {
+  auto path = (std::filesystem::path(dir_) / "omnisci_spill_XXXXXX").string();
+  std::vector<char> path_buf(path.begin(), path.end());
+  path_buf.push_back('\0');
+  int fd = mkstemp(path_buf.data());
+  if (fd < 0) {
+    throw std::runtime_error("Cannot create spill file in " + dir_ + ": " +
+                             errno_message());
+  }
+  unlink(path_buf.data());
+  return std::unique_ptr<SpillFile>(new SpillFile(this, fd));
+}
+
+void SpillManager::reserve(size_t num_bytes) {
+  auto used = used_bytes_.load();
+  do {
+    if (used + num_bytes > max_bytes_) {
+      throw SpillBudgetExceeded(max_bytes_);
+    }
+  } while (!used_bytes_.compare_exchange_weak(used, used + num_bytes));
+}
+
+void SpillManager::release(size_t num_bytes) {
+  CHECK_GE(used_bytes_.load(), num_bytes);
+  used_bytes_ -= num_bytes;
+}
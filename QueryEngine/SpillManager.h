@@ -0,0 +1,97 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+extern bool g_enable_spill;
+extern std::string g_spill_dir;
+extern size_t g_spill_max_bytes;
+extern size_t g_spill_memory_threshold;
+
+class SpillBudgetExceeded : public std::runtime_error {
+ public:
+  explicit SpillBudgetExceeded(size_t max_bytes)
+      : std::runtime_error("Spill space limit of " + std::to_string(max_bytes) +
+                           " bytes exceeded.") {}
+};
+
+class SpillManager;
+
+/**
+ * Scratch file of the spill directory. The file is unlinked right after its
+ * creation, so its space is reclaimed on close even if the process crashes.
+ * Appends are thread safe.
+ */
+class SpillFile {
+ public:
+  ~SpillFile();
+
+  SpillFile(const SpillFile&) = delete;
+  SpillFile& operator=(const SpillFile&) = delete;
+
+  // Return the offset of the appended data.
+  size_t append(const void* data, size_t num_bytes);
+  void read(size_t offset, void* data, size_t num_bytes) const;
+
+  size_t size() const;
+
+ private:
+  SpillFile(SpillManager* manager, int fd);
+
+  SpillManager* manager_;
+  int fd_;
+  mutable std::mutex mutex_;
+  size_t size_{0};
+
+  friend class SpillManager;
+};
+
+/**
+ * Creates spill files in a scratch directory and limits their total size.
+ * Only baseline hash group by results are spilled so far.
+ * TODO: external merge sort for ResultSet::sort and grace hash join for
+ * BaselineJoinHashTable are tracked as separate follow-up requests.
+ */
+class SpillManager {
+ public:
+  // Empty dir means the system temporary directory.
+  SpillManager(const std::string& dir, size_t max_bytes);
+
+  // Manager configured by --spill-dir and --spill-max-bytes.
+  static SpillManager& get();
+
+  std::unique_ptr<SpillFile> createFile();
+
+  const std::string& getDir() const { return dir_; }
+  size_t getMaxBytes() const { return max_bytes_; }
+  size_t getUsedBytes() const { return used_bytes_.load(); }
+
+ private:
+  // Throw SpillBudgetExceeded if the limit doesn't allow num_bytes more.
+  void reserve(size_t num_bytes);
+  void release(size_t num_bytes);
+
+  std::string dir_;
+  const size_t max_bytes_;
+  std::atomic<size_t> used_bytes_{0};
+
+  friend class SpillFile;
+};
@@ -0,0 +1,741 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/VectorizedInterpreter.h"
+#include "Logger/Logger.h"
+#include "QueryEngine/ColumnFetcher.h"
+#include "QueryEngine/DynamicWatchdog.h"
+#include "QueryEngine/ErrorHandling.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/OutputBufferInitialization.h"
+#include "QueryEngine/PlanState.h"
+#include "QueryEngine/RuntimeFunctions.h"
+#include "QueryEngine/TypePunning.h"
+#include "Shared/InlineNullValues.h"
+
+#include <functional>
+#include <unordered_map>
+
+bool g_enable_vectorized_interpreter{false};
+size_t g_vectorized_interpreter_max_rows{100000};
+
+namespace {
+
+constexpr size_t kBatchSize{1024};
+
+// Predicate values in SQL three-valued logic.
+constexpr int8_t kFalse{0};
+constexpr int8_t kTrue{1};
+constexpr int8_t kNull{2};
+
+bool is_supported_type(const SQLTypeInfo& ti) {
+  if (ti.get_compression() != kENCODING_NONE) {
+    return false;
+  }
+  if (ti.is_fp() || ti.is_integer() || ti.is_decimal()) {
+    return true;
+  }
+  if (ti.is_boolean()) {
+    return ti.get_size() == 1;
+  }
+  // Null sentinels of the time types are 64-bit.
+  if (ti.is_time()) {
+    return ti.get_size() == 8;
+  }
+  return false;
+}
+
+bool is_int_agg_arg_type(const SQLTypeInfo& ti) {
+  return ti.is_integer() || ti.is_decimal();
+}
+
+const Analyzer::ColumnVar* as_column(const Analyzer::Expr* expr) {
+  const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr);
+  if (!col_var || dynamic_cast<const Analyzer::Var*>(expr) || col_var->get_rte_idx() ||
+      !is_supported_type(col_var->get_type_info())) {
+    return nullptr;
+  }
+  return col_var;
+}
+
+bool is_supported_operand(const Analyzer::Expr* expr) {
+  if (as_column(expr)) {
+    return true;
+  }
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  return constant && !constant->get_is_null() &&
+         is_supported_type(constant->get_type_info());
+}
+
+bool are_comparable(const SQLTypeInfo& lhs, const SQLTypeInfo& rhs) {
+  if (lhs.is_fp() || rhs.is_fp()) {
+    return lhs.is_fp() && rhs.is_fp();
+  }
+  if (lhs.is_time() || rhs.is_time()) {
+    return lhs.get_type() == rhs.get_type() &&
+           lhs.get_dimension() == rhs.get_dimension();
+  }
+  if (lhs.is_boolean() || rhs.is_boolean()) {
+    return lhs.is_boolean() && rhs.is_boolean();
+  }
+  return lhs.get_scale() == rhs.get_scale();
+}
+
+bool is_supported_predicate(const Analyzer::Expr* expr) {
+  if (const auto col_var = as_column(expr)) {
+    return col_var->get_type_info().is_boolean();
+  }
+  if (const auto uoper = dynamic_cast<const Analyzer::UOper*>(expr)) {
+    switch (uoper->get_optype()) {
+      case kNOT:
+        return is_supported_predicate(uoper->get_operand());
+      case kISNULL:
+        return as_column(uoper->get_operand()) != nullptr;
+      default:
+        return false;
+    }
+  }
+  if (const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(expr)) {
+    const auto lhs = bin_oper->get_left_operand();
+    const auto rhs = bin_oper->get_right_operand();
+    switch (bin_oper->get_optype()) {
+      case kAND:
+      case kOR:
+        return is_supported_predicate(lhs) && is_supported_predicate(rhs);
+      case kEQ:
+      case kNE:
+      case kLT:
+      case kLE:
+      case kGT:
+      case kGE:
+        return bin_oper->get_qualifier() == kONE && is_supported_operand(lhs) &&
+               is_supported_operand(rhs) &&
+               are_comparable(lhs->get_type_info(), rhs->get_type_info());
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+bool is_supported_agg(const Analyzer::AggExpr* agg_expr) {
+  if (agg_expr->get_is_distinct()) {
+    return false;
+  }
+  const auto arg = agg_expr->get_arg();
+  if (agg_expr->get_aggtype() == kCOUNT) {
+    return !arg || as_column(arg);
+  }
+  if (!arg || !as_column(arg)) {
+    return false;
+  }
+  const auto& arg_ti = arg->get_type_info();
+  switch (agg_expr->get_aggtype()) {
+    case kSUM:
+    case kAVG:
+      return is_int_agg_arg_type(arg_ti) || arg_ti.get_type() == kDOUBLE;
+    case kMIN:
+    case kMAX:
+      return !arg_ti.is_fp() || arg_ti.get_type() == kDOUBLE;
+    default:
+      return false;
+  }
+}
+
+// Values of an operand for the current batch. Null flags are kept separately,
+// so all the integer types share the same representation. A constant is
+// represented by a single value.
+struct ValueVector {
+  bool is_fp{false};
+  bool is_constant{false};
+  std::vector<int64_t> ints;
+  std::vector<double> fps;
+  std::vector<int8_t> nulls;
+
+  size_t step() const { return is_constant ? 0 : 1; }
+};
+
+template <typename T>
+void decode_ints(const int8_t* col_buffer,
+                 const size_t start,
+                 const size_t count,
+                 const int64_t null_val,
+                 ValueVector& out) {
+  const auto vals = reinterpret_cast<const T*>(col_buffer) + start;
+  for (size_t i = 0; i < count; ++i) {
+    out.ints[i] = vals[i];
+    out.nulls[i] = out.ints[i] == null_val;
+  }
+}
+
+template <typename T>
+void decode_fps(const int8_t* col_buffer,
+                const size_t start,
+                const size_t count,
+                ValueVector& out) {
+  const auto vals = reinterpret_cast<const T*>(col_buffer) + start;
+  const auto null_val = inline_fp_null_value<T>();
+  for (size_t i = 0; i < count; ++i) {
+    out.fps[i] = vals[i];
+    out.nulls[i] = vals[i] == null_val;
+  }
+}
+
+void decode_column(const int8_t* col_buffer,
+                   const SQLTypeInfo& ti,
+                   const size_t start,
+                   const size_t count,
+                   ValueVector& out) {
+  CHECK(col_buffer);
+  out.is_fp = ti.is_fp();
+  out.nulls.resize(count);
+  if (out.is_fp) {
+    out.fps.resize(count);
+    if (ti.get_type() == kFLOAT) {
+      decode_fps<float>(col_buffer, start, count, out);
+    } else {
+      decode_fps<double>(col_buffer, start, count, out);
+    }
+    return;
+  }
+  out.ints.resize(count);
+  const auto null_val = inline_int_null_val(ti);
+  switch (ti.get_size()) {
+    case 1:
+      decode_ints<int8_t>(col_buffer, start, count, null_val, out);
+      break;
+    case 2:
+      decode_ints<int16_t>(col_buffer, start, count, null_val, out);
+      break;
+    case 4:
+      decode_ints<int32_t>(col_buffer, start, count, null_val, out);
+      break;
+    case 8:
+      decode_ints<int64_t>(col_buffer, start, count, null_val, out);
+      break;
+    default:
+      CHECK(false) << "Unexpected column width " << ti.get_size();
+  }
+}
+
+ValueVector make_constant(const Analyzer::Constant* constant) {
+  const auto& ti = constant->get_type_info();
+  ValueVector ret;
+  ret.is_constant = true;
+  ret.is_fp = ti.is_fp();
+  ret.nulls.push_back(0);
+  if (ret.is_fp) {
+    ret.fps.push_back(extract_fp_type_from_datum(constant->get_constval(), ti));
+  } else {
+    ret.ints.push_back(extract_int_type_from_datum(constant->get_constval(), ti));
+  }
+  return ret;
+}
+
+template <typename T, typename Cmp>
+void compare_loop(const T* lhs,
+                  const int8_t* lhs_nulls,
+                  const size_t lhs_step,
+                  const T* rhs,
+                  const int8_t* rhs_nulls,
+                  const size_t rhs_step,
+                  const size_t count,
+                  Cmp cmp,
+                  int8_t* out) {
+  for (size_t i = 0; i < count; ++i) {
+    const auto l = i * lhs_step;
+    const auto r = i * rhs_step;
+    out[i] = (lhs_nulls[l] | rhs_nulls[r]) ? kNull
+                                           : static_cast<int8_t>(cmp(lhs[l], rhs[r]));
+  }
+}
+
+template <typename T>
+void compare_values(const SQLOps op,
+                    const std::vector<T>& lhs,
+                    const ValueVector& lhs_vec,
+                    const std::vector<T>& rhs,
+                    const ValueVector& rhs_vec,
+                    const size_t count,
+                    int8_t* out) {
+  const auto run = [&](auto cmp) {
+    compare_loop(lhs.data(),
+                 lhs_vec.nulls.data(),
+                 lhs_vec.step(),
+                 rhs.data(),
+                 rhs_vec.nulls.data(),
+                 rhs_vec.step(),
+                 count,
+                 cmp,
+                 out);
+  };
+  switch (op) {
+    case kEQ:
+      run(std::equal_to<T>());
+      break;
+    case kNE:
+      run(std::not_equal_to<T>());
+      break;
+    case kLT:
+      run(std::less<T>());
+      break;
+    case kLE:
+      run(std::less_equal<T>());
+      break;
+    case kGT:
+      run(std::greater<T>());
+      break;
+    case kGE:
+      run(std::greater_equal<T>());
+      break;
+    default:
+      CHECK(false) << "Unexpected comparison " << op;
+  }
+}
+
+// Decodes the columns of a batch of rows and evaluates predicates over them.
+class BatchEvaluator {
+ public:
+  BatchEvaluator(const PlanState* plan_state) : plan_state_(plan_state) {}
+
+  void setBatch(const std::vector<const int8_t*>& col_buffers,
+                const size_t start,
+                const size_t count) {
+    col_buffers_ = &col_buffers;
+    start_ = start;
+    count_ = count;
+    columns_.clear();
+  }
+
+  size_t getStart() const { return start_; }
+  size_t getCount() const { return count_; }
+
+  const ValueVector& getColumn(const Analyzer::ColumnVar* col_var) {
+    InputColDescriptor col_desc(col_var->get_column_info(), col_var->get_rte_idx());
+    const auto col_id_it = plan_state_->global_to_local_col_ids_.find(col_desc);
+    CHECK(col_id_it != plan_state_->global_to_local_col_ids_.end());
+    const auto local_col_id = col_id_it->second;
+    auto it = columns_.find(local_col_id);
+    if (it == columns_.end()) {
+      CHECK_LT(local_col_id, col_buffers_->size());
+      it = columns_.emplace(local_col_id, ValueVector{}).first;
+      decode_column((*col_buffers_)[local_col_id],
+                    col_var->get_type_info(),
+                    start_,
+                    count_,
+                    it->second);
+    }
+    return it->second;
+  }
+
+  const ValueVector& getOperand(const Analyzer::Expr* expr) {
+    if (const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr)) {
+      return getColumn(col_var);
+    }
+    auto it = constants_.find(expr);
+    if (it == constants_.end()) {
+      const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+      CHECK(constant);
+      it = constants_.emplace(expr, make_constant(constant)).first;
+    }
+    return it->second;
+  }
+
+  void evalPredicate(const Analyzer::Expr* expr, std::vector<int8_t>& out) {
+    out.resize(count_);
+    if (const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr)) {
+      const auto& vals = getColumn(col_var);
+      for (size_t i = 0; i < count_; ++i) {
+        out[i] = vals.nulls[i] ? kNull : static_cast<int8_t>(vals.ints[i] != 0);
+      }
+      return;
+    }
+    if (const auto uoper = dynamic_cast<const Analyzer::UOper*>(expr)) {
+      if (uoper->get_optype() == kISNULL) {
+        const auto& vals = getOperand(uoper->get_operand());
+        for (size_t i = 0; i < count_; ++i) {
+          out[i] = vals.nulls[i] ? kTrue : kFalse;
+        }
+        return;
+      }
+      CHECK_EQ(kNOT, uoper->get_optype());
+      evalPredicate(uoper->get_operand(), out);
+      for (size_t i = 0; i < count_; ++i) {
+        out[i] = out[i] == kNull ? kNull : static_cast<int8_t>(out[i] == kFalse);
+      }
+      return;
+    }
+    const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(expr);
+    CHECK(bin_oper);
+    const auto optype = bin_oper->get_optype();
+    if (optype == kAND || optype == kOR) {
+      std::vector<int8_t> rhs;
+      evalPredicate(bin_oper->get_left_operand(), out);
+      evalPredicate(bin_oper->get_right_operand(), rhs);
+      const int8_t dominant = optype == kAND ? kFalse : kTrue;
+      for (size_t i = 0; i < count_; ++i) {
+        if (out[i] == dominant || rhs[i] == dominant) {
+          out[i] = dominant;
+        } else if (out[i] == kNull || rhs[i] == kNull) {
+          out[i] = kNull;
+        }
+      }
+      return;
+    }
+    const auto& lhs = getOperand(bin_oper->get_left_operand());
+    const auto& rhs = getOperand(bin_oper->get_right_operand());
+    CHECK_EQ(lhs.is_fp, rhs.is_fp);
+    if (lhs.is_fp) {
+      compare_values(optype, lhs.fps, lhs, rhs.fps, rhs, count_, out.data());
+    } else {
+      compare_values(optype, lhs.ints, lhs, rhs.ints, rhs, count_, out.data());
+    }
+  }
+
+  // Collect positions of the batch rows which pass all the filters.
+  void select(const RelAlgExecutionUnit& ra_exe_unit, std::vector<uint32_t>& selected) {
+    selected.clear();
+    std::vector<int8_t> passed(count_, kTrue);
+    std::vector<int8_t> qual_res;
+    for (const auto& quals : {&ra_exe_unit.simple_quals, &ra_exe_unit.quals}) {
+      for (const auto& qual : *quals) {
+        evalPredicate(qual.get(), qual_res);
+        for (size_t i = 0; i < count_; ++i) {
+          passed[i] &= qual_res[i] == kTrue;
+        }
+      }
+    }
+    for (size_t i = 0; i < count_; ++i) {
+      if (passed[i]) {
+        selected.push_back(i);
+      }
+    }
+  }
+
+ private:
+  const PlanState* plan_state_;
+  const std::vector<const int8_t*>* col_buffers_{nullptr};
+  size_t start_{0};
+  size_t count_{0};
+  std::unordered_map<size_t, ValueVector> columns_;
+  std::unordered_map<const Analyzer::Expr*, ValueVector> constants_;
+};
+
+int64_t fp_to_slot(const double val) {
+  return *reinterpret_cast<const int64_t*>(may_alias_ptr(&val));
+}
+
+struct AggState {
+  int64_t int_val{0};
+  double fp_val{0};
+  int64_t count{0};
+  bool has_value{false};
+};
+
+void update_agg(const Analyzer::AggExpr* agg_expr,
+                const ValueVector* arg,
+                const std::vector<uint32_t>& selected,
+                AggState& state) {
+  const auto agg_kind = agg_expr->get_aggtype();
+  if (!arg) {
+    CHECK_EQ(kCOUNT, agg_kind);
+    state.count += selected.size();
+    return;
+  }
+  for (const auto i : selected) {
+    if (arg->nulls[i]) {
+      continue;
+    }
+    ++state.count;
+    if (agg_kind == kCOUNT) {
+      continue;
+    }
+    const bool first = !state.has_value;
+    state.has_value = true;
+    if (arg->is_fp) {
+      const auto val = arg->fps[i];
+      switch (agg_kind) {
+        case kSUM:
+        case kAVG:
+          state.fp_val += val;
+          break;
+        case kMIN:
+          state.fp_val = first ? val : std::min(state.fp_val, val);
+          break;
+        case kMAX:
+          state.fp_val = first ? val : std::max(state.fp_val, val);
+          break;
+        default:
+          CHECK(false);
+      }
+      continue;
+    }
+    const auto val = arg->ints[i];
+    switch (agg_kind) {
+      case kSUM:
+      case kAVG:
+        if (__builtin_add_overflow(state.int_val, val, &state.int_val)) {
+          throw QueryExecutionError(Executor::ERR_OVERFLOW_OR_UNDERFLOW);
+        }
+        break;
+      case kMIN:
+        state.int_val = first ? val : std::min(state.int_val, val);
+        break;
+      case kMAX:
+        state.int_val = first ? val : std::max(state.int_val, val);
+        break;
+      default:
+        CHECK(false);
+    }
+  }
+}
+
+}  // namespace
+
+std::atomic<size_t> VectorizedInterpreter::run_count_{0};
+
+VectorizedInterpreter::VectorizedInterpreter(const RelAlgExecutionUnit& ra_exe_unit,
+                                             const PlanState* plan_state,
+                                             Executor* executor,
+                                             const ExecutionOptions& eo)
+    : ra_exe_unit_(ra_exe_unit)
+    , plan_state_(plan_state)
+    , executor_(executor)
+    , allow_runtime_interrupt_(eo.allow_runtime_query_interrupt)
+    , with_dynamic_watchdog_(eo.with_dynamic_watchdog) {
+  CHECK(plan_state_);
+  CHECK(executor_);
+}
+
+bool VectorizedInterpreter::canInterpret(const RelAlgExecutionUnit& ra_exe_unit,
+                                         const std::vector<InputTableInfo>& query_infos) {
+  if (ra_exe_unit.input_descs.size() != 1 || query_infos.size() != 1 ||
+      ra_exe_unit.input_descs.front().getSourceType() != InputSourceType::TABLE ||
+      !ra_exe_unit.join_quals.empty() || ra_exe_unit.estimator ||
+      ra_exe_unit.union_all || ra_exe_unit.use_bump_allocator ||
+      ra_exe_unit.sort_info.algorithm == SortAlgorithm::StreamingTopN) {
+    return false;
+  }
+  if (ra_exe_unit.groupby_exprs.size() != 1 || ra_exe_unit.groupby_exprs.front()) {
+    return false;
+  }
+  if (query_infos.front().info.getNumTuplesUpperBound() >
+      g_vectorized_interpreter_max_rows) {
+    return false;
+  }
+  for (const auto& quals : {&ra_exe_unit.simple_quals, &ra_exe_unit.quals}) {
+    for (const auto& qual : *quals) {
+      if (!is_supported_predicate(qual.get())) {
+        return false;
+      }
+    }
+  }
+  if (ra_exe_unit.target_exprs.empty()) {
+    return false;
+  }
+  const bool is_agg =
+      dynamic_cast<const Analyzer::AggExpr*>(ra_exe_unit.target_exprs.front());
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+    if (is_agg ? !agg_expr || !is_supported_agg(agg_expr) : !as_column(target_expr)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool VectorizedInterpreter::isSupportedLayout(
+    const QueryMemoryDescriptor& query_mem_desc) {
+  switch (query_mem_desc.getQueryDescriptionType()) {
+    case QueryDescriptionType::Projection:
+      if (query_mem_desc.didOutputColumnar()) {
+        return false;
+      }
+      break;
+    case QueryDescriptionType::NonGroupedAggregate:
+      break;
+    default:
+      return false;
+  }
+  for (size_t i = 0; i < query_mem_desc.getSlotCount(); ++i) {
+    if (query_mem_desc.getPaddedSlotWidthBytes(i) != sizeof(int64_t)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<ResultSet> VectorizedInterpreter::run(
+    const FetchResult& fetch_result,
+    const QueryMemoryDescriptor& query_mem_desc) const {
+  CHECK(isSupportedLayout(query_mem_desc));
+  ++run_count_;
+  if (query_mem_desc.getQueryDescriptionType() == QueryDescriptionType::Projection) {
+    return runProjection(fetch_result, query_mem_desc);
+  }
+  return runAggregate(fetch_result, query_mem_desc);
+}
+
+std::unique_ptr<ResultSet> VectorizedInterpreter::runProjection(
+    const FetchResult& fetch_result,
+    const QueryMemoryDescriptor& query_mem_desc) const {
+  const auto& target_exprs = ra_exe_unit_.target_exprs;
+  const auto slot_count = target_exprs.size();
+  CHECK_EQ(slot_count, query_mem_desc.getSlotCount());
+  const auto limit = ra_exe_unit_.scan_limit ? ra_exe_unit_.scan_limit
+                                             : std::numeric_limits<size_t>::max();
+  // Output rows are collected before the result set is allocated, because the
+  // number of rows passing the filters is unknown upfront.
+  std::vector<int64_t> row_offsets;
+  std::vector<int64_t> slots;
+  BatchEvaluator evaluator(plan_state_);
+  std::vector<uint32_t> selected;
+  for (size_t frag_idx = 0;
+       frag_idx < fetch_result.col_buffers.size() && row_offsets.size() < limit;
+       ++frag_idx) {
+    const auto num_rows = fetch_result.num_rows[frag_idx][0];
+    // Row offsets are global for the table, like the ones of generated code.
+    const int64_t frag_row_offset = fetch_result.frag_offsets[frag_idx][0];
+    for (int64_t start = 0; start < num_rows && row_offsets.size() < limit;
+         start += kBatchSize) {
+      checkInterrupt();
+      const auto count = std::min<size_t>(kBatchSize, num_rows - start);
+      evaluator.setBatch(fetch_result.col_buffers[frag_idx], start, count);
+      evaluator.select(ra_exe_unit_, selected);
+      if (selected.size() > limit - row_offsets.size()) {
+        selected.resize(limit - row_offsets.size());
+      }
+      const auto first_out_row = row_offsets.size();
+      slots.resize((first_out_row + selected.size()) * slot_count);
+      for (const auto i : selected) {
+        row_offsets.push_back(frag_row_offset + start + i);
+      }
+      for (size_t target_idx = 0; target_idx < slot_count; ++target_idx) {
+        const auto col_var =
+            dynamic_cast<const Analyzer::ColumnVar*>(target_exprs[target_idx]);
+        CHECK(col_var);
+        const auto& vals = evaluator.getColumn(col_var);
+        auto out = slots.data() + first_out_row * slot_count + target_idx;
+        for (const auto i : selected) {
+          *out = vals.is_fp ? fp_to_slot(vals.fps[i]) : vals.ints[i];
+          out += slot_count;
+        }
+      }
+    }
+  }
+
+  auto output_mem_desc = query_mem_desc;
+  const auto num_out_rows = row_offsets.size();
+  output_mem_desc.setEntryCount(num_out_rows);
+  auto rs = std::make_unique<ResultSet>(
+      target_exprs_to_infos(target_exprs, output_mem_desc),
+      ExecutorDeviceType::CPU,
+      output_mem_desc,
+      executor_->getRowSetMemoryOwner(),
+      executor_->getDataMgr(),
+      executor_->getBufferProvider(),
+      executor_->blockSize(),
+      executor_->gridSize());
+  const auto storage = rs->allocateStorage();
+  auto output_buffer = reinterpret_cast<int64_t*>(storage->getUnderlyingBuffer());
+  CHECK(!num_out_rows || output_buffer);
+  const auto row_size_quad = output_mem_desc.getRowSize() / sizeof(int64_t);
+  CHECK_EQ(row_size_quad, slot_count + 1);
+  for (size_t row_idx = 0; row_idx < num_out_rows; ++row_idx) {
+    auto row = output_buffer + row_idx * row_size_quad;
+    row[0] = row_offsets[row_idx];
+    std::copy_n(slots.data() + row_idx * slot_count, slot_count, row + 1);
+  }
+  return rs;
+}
+
+std::unique_ptr<ResultSet> VectorizedInterpreter::runAggregate(
+    const FetchResult& fetch_result,
+    const QueryMemoryDescriptor& query_mem_desc) const {
+  const auto& target_exprs = ra_exe_unit_.target_exprs;
+  std::vector<AggState> states(target_exprs.size());
+  BatchEvaluator evaluator(plan_state_);
+  std::vector<uint32_t> selected;
+  for (size_t frag_idx = 0; frag_idx < fetch_result.col_buffers.size(); ++frag_idx) {
+    const auto num_rows = fetch_result.num_rows[frag_idx][0];
+    for (int64_t start = 0; start < num_rows; start += kBatchSize) {
+      checkInterrupt();
+      const auto count = std::min<size_t>(kBatchSize, num_rows - start);
+      evaluator.setBatch(fetch_result.col_buffers[frag_idx], start, count);
+      evaluator.select(ra_exe_unit_, selected);
+      for (size_t target_idx = 0; target_idx < target_exprs.size(); ++target_idx) {
+        const auto agg_expr =
+            dynamic_cast<const Analyzer::AggExpr*>(target_exprs[target_idx]);
+        CHECK(agg_expr);
+        const auto arg =
+            dynamic_cast<const Analyzer::ColumnVar*>(agg_expr->get_arg());
+        update_agg(agg_expr,
+                   arg ? &evaluator.getColumn(arg) : nullptr,
+                   selected,
+                   states[target_idx]);
+      }
+    }
+  }
+
+  // Aggregates without input values keep their initial values, the same way
+  // they do in the generated code.
+  const auto init_vals =
+      init_agg_val_vec(target_exprs, ra_exe_unit_.quals, query_mem_desc);
+  auto entry = init_vals;
+  size_t slot_idx = 0;
+  for (size_t target_idx = 0; target_idx < target_exprs.size(); ++target_idx) {
+    const auto agg_expr =
+        dynamic_cast<const Analyzer::AggExpr*>(target_exprs[target_idx]);
+    CHECK(agg_expr);
+    const auto& state = states[target_idx];
+    const auto arg = agg_expr->get_arg();
+    const bool is_fp = arg && arg->get_type_info().is_fp();
+    CHECK_LT(slot_idx, entry.size());
+    if (agg_expr->get_aggtype() == kCOUNT) {
+      entry[slot_idx++] = state.count;
+      continue;
+    }
+    if (state.has_value) {
+      entry[slot_idx] = is_fp ? fp_to_slot(state.fp_val) : state.int_val;
+    }
+    ++slot_idx;
+    if (agg_expr->get_aggtype() == kAVG) {
+      CHECK_LT(slot_idx, entry.size());
+      entry[slot_idx++] = state.count;
+    }
+  }
+  CHECK_EQ(slot_idx, entry.size());
+
+  auto rs = std::make_unique<ResultSet>(
+      target_exprs_to_infos(target_exprs, query_mem_desc),
+      ExecutorDeviceType::CPU,
+      query_mem_desc,
+      executor_->getRowSetMemoryOwner(),
+      executor_->getDataMgr(),
+      executor_->getBufferProvider(),
+      executor_->blockSize(),
+      executor_->gridSize());
+  rs->allocateStorage(init_vals);
+  rs->fillOneEntry(entry);
+  return rs;
+}
+
+void VectorizedInterpreter::checkInterrupt() const {
+  if (allow_runtime_interrupt_ && check_interrupt()) {
+    throw QueryExecutionError(Executor::ERR_INTERRUPTED);
+  }
+  if (with_dynamic_watchdog_ && dynamic_watchdog()) {
+    throw QueryExecutionError(Executor::ERR_OUT_OF_TIME);
+  }
+}
@@ -0,0 +1,86 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/Descriptors/QueryMemoryDescriptor.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+#include "QueryEngine/ResultSet.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+extern bool g_enable_vectorized_interpreter;
+extern size_t g_vectorized_interpreter_max_rows;
+
+struct FetchResult;
+struct InputTableInfo;
+class Executor;
+class PlanState;
+
+/**
+ * Batch-at-a-time interpreter for simple execution units. Short queries over
+ * small inputs are dominated by LLVM optimization and code generation, so for
+ * them the filter, projection and non-grouped aggregation are evaluated by
+ * primitives working on column vectors instead of generated code.
+ *
+ * Only a single table without joins and group by is supported. Filters are
+ * comparisons, IS NULL and logical operators over uncompressed fixed width
+ * columns and literals. Targets are either plain columns or COUNT, SUM, MIN,
+ * MAX and AVG of a column.
+ */
+class VectorizedInterpreter {
+ public:
+  VectorizedInterpreter(const RelAlgExecutionUnit& ra_exe_unit,
+                        const PlanState* plan_state,
+                        Executor* executor,
+                        const ExecutionOptions& eo);
+
+  // Check if the unit can be executed by the interpreter and its input is small
+  // enough for the interpreter to be faster than compilation.
+  static bool canInterpret(const RelAlgExecutionUnit& ra_exe_unit,
+                           const std::vector<InputTableInfo>& query_infos);
+
+  // Check if the memory descriptor has the layout results are written with.
+  static bool isSupportedLayout(const QueryMemoryDescriptor& query_mem_desc);
+
+  std::unique_ptr<ResultSet> run(const FetchResult& fetch_result,
+                                 const QueryMemoryDescriptor& query_mem_desc) const;
+
+  // Number of fragment sets executed by interpreters since the start.
+  static size_t getRunCount() { return run_count_.load(); }
+
+ private:
+  std::unique_ptr<ResultSet> runProjection(
+      const FetchResult& fetch_result,
+      const QueryMemoryDescriptor& query_mem_desc) const;
+
+  std::unique_ptr<ResultSet> runAggregate(
+      const FetchResult& fetch_result,
+      const QueryMemoryDescriptor& query_mem_desc) const;
+
+  // Throws if the query is interrupted or out of its watchdog budget. Called once per
+  // batch, generated code does the same checks in its row loop.
+  void checkInterrupt() const;
+
+  const RelAlgExecutionUnit& ra_exe_unit_;
+  const PlanState* plan_state_;
+  Executor* executor_;
+  const bool allow_runtime_interrupt_;
+  const bool with_dynamic_watchdog_;
+
+  static std::atomic<size_t> run_count_;
+};
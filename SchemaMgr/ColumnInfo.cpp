@@ -10,5 +10,5 @@ std::string ColumnInfo::toString() const {
   return name + "(db_id=" + std::to_string(db_id) +
          ", table_id=" + std::to_string(table_id) +
          ", column_id=" + std::to_string(column_id) + " type=" + type.toString() +
-         (is_rowid ? " [rowid])" : "") + ")";
+         (is_rowid ? " [rowid])" : "") + (is_delete ? " [delete]" : "") + ")";
 }
\ No newline at end of file
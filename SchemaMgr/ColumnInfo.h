@@ -45,16 +45,20 @@ struct ColumnInfo : public ColumnRef {
              int column_id,
              const std::string name_,
              SQLTypeInfo type_,
-             bool is_rowid_)
+             bool is_rowid_,
+             bool is_delete_ = false)
       : ColumnRef(db_id, table_id, column_id)
       , name(name_)
       , type(type_)
-      , is_rowid(is_rowid_) {}
+      , is_rowid(is_rowid_)
+      , is_delete(is_delete_) {}
 
   std::string name;
   SQLTypeInfo type;
   // Virtual rowid column.
   bool is_rowid;
+  // Hidden column holding delete flags of table rows.
+  bool is_delete;
 
   std::string toString() const;
 };
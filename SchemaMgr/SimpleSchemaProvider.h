@@ -137,6 +137,20 @@ class SimpleSchemaProvider : public SchemaProvider {
         db_id, table_id, col_id, "rowid", SQLTypeInfo(SQLTypes::kBIGINT), true);
   }
 
+  ColumnInfoPtr addDeleteColumn(int db_id, int table_id) {
+    CHECK_EQ(column_index_by_name_.count({db_id, table_id}), (size_t)1);
+    int col_id = static_cast<int>(column_index_by_name_[{db_id, table_id}].size() + 1);
+    auto col_info = addColumnInfo(db_id,
+                                  table_id,
+                                  col_id,
+                                  "$deleted$",
+                                  SQLTypeInfo(SQLTypes::kTINYINT, true),
+                                  false,
+                                  true);
+    table_infos_.at({db_id, table_id})->delete_column = col_info;
+    return col_info;
+  }
+
   void dropTable(int db_id, int table_id) {
     auto tinfo = getTableInfo(db_id, table_id);
     CHECK(tinfo);
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "DataMgr/MemoryLevel.h"
+#include "SchemaMgr/ColumnInfo.h"
 #include "Shared/sqltypes.h"
 #include "Shared/toString.h"
 
@@ -60,6 +61,9 @@ struct TableInfo : public TableRef {
   // For add_window_function_pre_project in RelAlgDagBuilder.
   size_t fragments;
   bool is_stream;
+  // Hidden column with delete flags of table rows. Storage adds it on the first
+  // rows deletion.
+  ColumnInfoPtr delete_column;
 
   bool isTemporary() const {
     return persistence_level == Data_Namespace::MemoryLevel::CPU_LEVEL;
@@ -0,0 +1,140 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Shared/numa_utils.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace numa {
+
+namespace {
+
+thread_local int preferred_node = -1;
+
+// Parse CPU list in the sysfs format, e.g. "0-3,8-11".
+std::vector<int> parseCpuList(const std::string& list) {
+  std::vector<int> res;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) {
+      res.push_back(cpu);
+    }
+  }
+  return res;
+}
+
+std::vector<std::vector<int>> readNodeCpus() {
+  std::vector<std::vector<int>> res;
+#ifdef __linux__
+  const std::filesystem::path nodes_dir("/sys/devices/system/node");
+  std::error_code ec;
+  while (true) {
+    auto node_dir = nodes_dir / ("node" + std::to_string(res.size()));
+    if (!std::filesystem::exists(node_dir, ec)) {
+      break;
+    }
+    std::ifstream cpulist(node_dir / "cpulist");
+    std::string list;
+    std::getline(cpulist, list);
+    res.push_back(parseCpuList(list));
+  }
+#endif
+  if (res.empty()) {
+    res.emplace_back();
+  }
+  return res;
+}
+
+const std::vector<std::vector<int>>& nodeCpus() {
+  static const std::vector<std::vector<int>> node_cpus = readNodeCpus();
+  return node_cpus;
+}
+
+}  // namespace
+
+int getNodeCount() {
+  return static_cast<int>(nodeCpus().size());
+}
+
+const std::vector<int>& getNodeCpus(int node) {
+  return nodeCpus().at(node);
+}
+
+int getPreferredNode() {
+  return preferred_node;
+}
+
+bool bindMemory(void* ptr, size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  constexpr int kMpolBind = 2;
+  if (node < 0 || node >= 64) {
+    return false;
+  }
+  unsigned long node_mask = 1UL << node;
+  // The kernel reads maxnode - 1 bits of the mask.
+  return syscall(SYS_mbind,
+                 ptr,
+                 size,
+                 kMpolBind,
+                 &node_mask,
+                 sizeof(node_mask) * 8 + 1,
+                 0) == 0;
+#else
+  return false;
+#endif
+}
+
+ScopedNodeBinding::ScopedNodeBinding(int node) : prev_node_(preferred_node) {
+  preferred_node = node;
+#ifdef __linux__
+  const auto& cpus = getNodeCpus(node);
+  if (cpus.empty() || sched_getaffinity(0, sizeof(prev_cpus_), &prev_cpus_)) {
+    return;
+  }
+  cpu_set_t node_cpus;
+  CPU_ZERO(&node_cpus);
+  for (auto cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &node_cpus);
+    }
+  }
+  affinity_changed_ = sched_setaffinity(0, sizeof(node_cpus), &node_cpus) == 0;
+#endif
+}
+
+ScopedNodeBinding::~ScopedNodeBinding() {
+  preferred_node = prev_node_;
+#ifdef __linux__
+  if (affinity_changed_) {
+    sched_setaffinity(0, sizeof(prev_cpus_), &prev_cpus_);
+  }
+#endif
+}
+
+}  // namespace numa
@@ -0,0 +1,62 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace numa {
+
+// Number of NUMA nodes in the system. Systems with no NUMA information are
+// treated as having a single node.
+int getNodeCount();
+
+// CPUs belonging to the node.
+const std::vector<int>& getNodeCpus(int node);
+
+// Node preferred for memory allocations made by the current thread or -1 when
+// the thread has no preference.
+int getPreferredNode();
+
+// Bind physical pages of the memory range to the node. The range should not be
+// touched yet. Return false when the binding is not supported.
+bool bindMemory(void* ptr, size_t size, int node);
+
+/**
+ * Runs the current thread on CPUs of the specified node and makes the node
+ * preferred for thread's memory allocations. The previous CPU affinity and
+ * preference are restored on destruction.
+ */
+class ScopedNodeBinding {
+ public:
+  explicit ScopedNodeBinding(int node);
+  ~ScopedNodeBinding();
+
+  ScopedNodeBinding(const ScopedNodeBinding&) = delete;
+  ScopedNodeBinding& operator=(const ScopedNodeBinding&) = delete;
+
+ private:
+  int prev_node_;
+#ifdef __linux__
+  bool affinity_changed_ = false;
+  cpu_set_t prev_cpus_;
+#endif
+};
+
+}  // namespace numa
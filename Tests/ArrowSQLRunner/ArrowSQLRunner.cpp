@@ -18,6 +18,7 @@
 #include "DataMgr/DataMgr.h"
 #include "DataMgr/DataMgrDataProvider.h"
 #include "QueryEngine/CalciteAdapter.h"
+#include "QueryEngine/QueryPhysicalInputsCollector.h"
 #include "QueryEngine/RelAlgExecutor.h"
 
 #include "SQLiteComparator.h"
@@ -93,18 +94,56 @@ class ArrowSQLRunnerImpl {
         executor_.get(), storage_, data_mgr_->getDataProvider(), std::move(dag));
   }
 
+  // Number of chunks fetched by the query: the fragment count of each input
+  // table times the number of its referenced columns.
+  size_t estimateQueryCost(const RelAlgExecutor& ra_executor) {
+    size_t res = 0;
+    for (auto& col_desc : get_physical_inputs(&ra_executor.getRootRelAlgNode())) {
+      auto tinfo =
+          storage_->getTableInfo(col_desc.getDatabaseId(), col_desc.getTableId());
+      if (tinfo) {
+        res += tinfo->fragments;
+      }
+    }
+    return res;
+  }
+
   ExecutionResult runSqlQuery(const std::string& sql,
                               const CompilationOptions& co,
                               const ExecutionOptions& eo) {
     auto ra_executor = makeRelAlgExecutor(sql);
     ExecutionResult res;
-
-    execution_time_ += measure<std::chrono::microseconds>::execution(
-        [&]() { res = ra_executor->executeRelAlgQuery(co, eo, false); });
+    auto execute = [&]() {
+      execution_time_ += measure<std::chrono::microseconds>::execution(
+          [&]() { res = ra_executor->executeRelAlgQuery(co, eo, false); });
+    };
+
+    if (dispatch_queue_) {
+      auto task = std::make_shared<QueryDispatchQueue::Task>([&](size_t) { execute(); });
+      auto result = task->get_future();
+      QueryDispatchQueue::TaskDescriptor desc;
+      desc.estimated_cost = estimateQueryCost(*ra_executor);
+      dispatch_queue_->submit(task, false, desc);
+      result.get();
+    } else {
+      execute();
+    }
 
     return res;
   }
 
+  void setDispatchQueue(size_t num_workers, const QueryDispatchQueue::Config& config) {
+    dispatch_queue_.reset();
+    if (num_workers) {
+      dispatch_queue_ = std::make_unique<QueryDispatchQueue>(num_workers, config);
+    }
+  }
+
+  QueryDispatchQueue::Stats getDispatchQueueStats() {
+    CHECK(dispatch_queue_);
+    return dispatch_queue_->getStats();
+  }
+
   RegisteredQueryHint getParsedQueryHint(const std::string& query_str) {
     auto ra_executor = makeRelAlgExecutor(query_str);
     auto query_hints =
@@ -319,6 +358,7 @@ class ArrowSQLRunnerImpl {
   std::shared_ptr<CalciteJNI> getCalcite() { return calcite_; }
 
   ~ArrowSQLRunnerImpl() {
+    dispatch_queue_.reset();
     storage_.reset();
     executor_.reset();
     data_mgr_.reset();
@@ -373,6 +413,7 @@ class ArrowSQLRunnerImpl {
   std::shared_ptr<Executor> executor_;
   std::shared_ptr<CalciteJNI> calcite_;
   SQLiteComparator sqlite_comparator_;
+  std::unique_ptr<QueryDispatchQueue> dispatch_queue_;
   int64_t calcite_time_ = 0;
   int64_t execution_time_ = 0;
 
@@ -503,6 +544,14 @@ BufferPoolStats getBufferPoolStats(const Data_Namespace::MemoryLevel memory_leve
   return ArrowSQLRunnerImpl::get()->getBufferPoolStats(memory_level);
 }
 
+void setDispatchQueue(size_t num_workers, const QueryDispatchQueue::Config& config) {
+  ArrowSQLRunnerImpl::get()->setDispatchQueue(num_workers, config);
+}
+
+QueryDispatchQueue::Stats getDispatchQueueStats() {
+  return ArrowSQLRunnerImpl::get()->getDispatchQueueStats();
+}
+
 std::shared_ptr<ArrowStorage> getStorage() {
   return ArrowSQLRunnerImpl::get()->getStorage();
 }
@@ -20,6 +20,7 @@
 #include "QueryEngine/ArrowResultSet.h"
 #include "QueryEngine/CompilationOptions.h"
 #include "QueryEngine/Descriptors/RelAlgExecutionDescriptor.h"
+#include "QueryEngine/QueryDispatchQueue.h"
 #include "QueryEngine/QueryHint.h"
 
 #include "BufferPoolStats.h"
@@ -108,6 +109,14 @@ void clearCpuMemory();
 BufferPoolStats getBufferPoolStats(const Data_Namespace::MemoryLevel memory_level =
                                        Data_Namespace::MemoryLevel::CPU_LEVEL);
 
+// Run queries through a dispatch queue with the given number of workers, classifying
+// them by the number of chunks they fetch. Zero workers remove the queue.
+void setDispatchQueue(
+    size_t num_workers,
+    const QueryDispatchQueue::Config& config = QueryDispatchQueue::Config());
+
+QueryDispatchQueue::Stats getDispatchQueueStats();
+
 std::shared_ptr<ArrowStorage> getStorage();
 
 DataMgr* getDataMgr();
@@ -17,8 +17,12 @@
 #include "DataMgr/DataMgrBufferProvider.h"
 #include "DataMgr/DataMgrDataProvider.h"
 #include "QueryEngine/ArrowResultSet.h"
+#include "QueryEngine/BackgroundCompiler.h"
 #include "QueryEngine/CalciteAdapter.h"
 #include "QueryEngine/RelAlgExecutor.h"
+#include "QueryEngine/RuntimeFunctions.h"
+#include "QueryEngine/VectorizedInterpreter.h"
+#include "Shared/scope.h"
 
 #include "ArrowSQLRunner/ArrowSQLRunner.h"
 
@@ -27,6 +31,17 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>
+
+extern bool g_enable_chunk_prefetch;
+extern size_t g_chunk_prefetch_kernels;
+extern bool g_enable_cpu_sub_tasks;
+extern size_t g_cpu_sub_task_size;
+extern bool g_enable_morsel_execution;
+extern bool g_enable_vectorized_interpreter;
+extern bool g_enable_plan_code_cache;
+
 using namespace std::string_literals;
 using ArrowTestHelpers::compare_res_data;
 using namespace TestHelpers::ArrowSQLRunner;
@@ -119,10 +134,326 @@ TEST_P(ArrowStorageSqlTest, GroupByDict) {
                    std::vector<std::string>({"s0"s, "s1"s, "s2"s, "s3"s}));
 }
 
+TEST_P(ArrowStorageSqlTest, GroupByWithChunkPrefetch) {
+  auto prefetch_state = g_enable_chunk_prefetch;
+  auto prefetch_kernels = g_chunk_prefetch_kernels;
+  ScopeGuard reset_prefetch([&]() {
+    g_enable_chunk_prefetch = prefetch_state;
+    g_chunk_prefetch_kernels = prefetch_kernels;
+  });
+  g_enable_chunk_prefetch = true;
+  g_chunk_prefetch_kernels = 1;
+
+  auto res = runSqlQuery("SELECT SUM(col1), SUM(col2), col3 FROM "s + GetParam() +
+                         " WHERE col4 <> 'dd2' GROUP BY col3 ORDER BY col3;");
+  compare_res_data(res,
+                   std::vector<int64_t>({30, 40, 40, 30}),
+                   std::vector<float>({10.0f, 6.0f, 10.0f, 17.0f}),
+                   std::vector<std::string>({"s0"s, "s1"s, "s2"s, "s3"s}));
+}
+
+TEST_P(ArrowStorageSqlTest, GroupByWithMorsels) {
+  auto sub_tasks_state = g_enable_cpu_sub_tasks;
+  auto sub_task_size = g_cpu_sub_task_size;
+  auto morsels_state = g_enable_morsel_execution;
+  ScopeGuard reset_morsels([&]() {
+    g_enable_cpu_sub_tasks = sub_tasks_state;
+    g_cpu_sub_task_size = sub_task_size;
+    g_enable_morsel_execution = morsels_state;
+  });
+  g_enable_cpu_sub_tasks = true;
+  g_cpu_sub_task_size = 2;
+  g_enable_morsel_execution = true;
+
+  auto res = runSqlQuery("SELECT SUM(col1), SUM(col2), col3 FROM "s + GetParam() +
+                         " WHERE col4 <> 'dd2' GROUP BY col3 ORDER BY col3;");
+  compare_res_data(res,
+                   std::vector<int64_t>({30, 40, 40, 30}),
+                   std::vector<float>({10.0f, 6.0f, 10.0f, 17.0f}),
+                   std::vector<std::string>({"s0"s, "s1"s, "s2"s, "s3"s}));
+}
+
+TEST_P(ArrowStorageSqlTest, GroupByWithMorselsAndChunkPrefetch) {
+  auto prefetch_state = g_enable_chunk_prefetch;
+  auto prefetch_kernels = g_chunk_prefetch_kernels;
+  auto sub_tasks_state = g_enable_cpu_sub_tasks;
+  auto sub_task_size = g_cpu_sub_task_size;
+  auto morsels_state = g_enable_morsel_execution;
+  ScopeGuard reset_flags([&]() {
+    g_enable_chunk_prefetch = prefetch_state;
+    g_chunk_prefetch_kernels = prefetch_kernels;
+    g_enable_cpu_sub_tasks = sub_tasks_state;
+    g_cpu_sub_task_size = sub_task_size;
+    g_enable_morsel_execution = morsels_state;
+  });
+  // Chunks prefetched for a kernel stay pinned while its morsels are running.
+  g_enable_chunk_prefetch = true;
+  g_chunk_prefetch_kernels = 1;
+  g_enable_cpu_sub_tasks = true;
+  g_cpu_sub_task_size = 1;
+  g_enable_morsel_execution = true;
+
+  for (int i = 0; i < 5; ++i) {
+    auto res = runSqlQuery("SELECT SUM(col1), SUM(col2), col3 FROM "s + GetParam() +
+                           " WHERE col4 <> 'dd2' GROUP BY col3 ORDER BY col3;");
+    compare_res_data(res,
+                     std::vector<int64_t>({30, 40, 40, 30}),
+                     std::vector<float>({10.0f, 6.0f, 10.0f, 17.0f}),
+                     std::vector<std::string>({"s0"s, "s1"s, "s2"s, "s3"s}));
+  }
+}
+
+TEST_P(ArrowStorageSqlTest, VectorizedInterpreter) {
+  auto interpreter_state = g_enable_vectorized_interpreter;
+  ScopeGuard reset_interpreter(
+      [&]() { g_enable_vectorized_interpreter = interpreter_state; });
+  g_enable_vectorized_interpreter = true;
+
+  auto run_count = VectorizedInterpreter::getRunCount();
+  auto res = runSqlQuery("SELECT col1 FROM "s + GetParam() +
+                         " WHERE col1 > 15 OR col1 IS NULL;");
+  compare_res_data(res, std::vector<int32_t>({20, 20, 20, 20, 20}));
+  ASSERT_GT(VectorizedInterpreter::getRunCount(), run_count);
+
+  run_count = VectorizedInterpreter::getRunCount();
+  res = runSqlQuery("SELECT SUM(col1), MIN(col1), MAX(col1) FROM "s + GetParam() +
+                    " WHERE NOT col1 = 20;");
+  compare_res_data(res,
+                   std::vector<int64_t>({50}),
+                   std::vector<int32_t>({10}),
+                   std::vector<int32_t>({10}));
+  ASSERT_GT(VectorizedInterpreter::getRunCount(), run_count);
+}
+
+TEST_P(ArrowStorageSqlTest, VectorizedInterpreterMultiFrag) {
+  auto interpreter_state = g_enable_vectorized_interpreter;
+  ScopeGuard reset_interpreter(
+      [&]() { g_enable_vectorized_interpreter = interpreter_state; });
+  g_enable_vectorized_interpreter = true;
+
+  // Selected rows are in all four fragments of the multi-fragment table.
+  auto run_count = VectorizedInterpreter::getRunCount();
+  auto res = runSqlQuery("SELECT col1, col2 FROM "s + GetParam() + " WHERE col1 > 15;");
+  compare_res_data(res,
+                   std::vector<int32_t>({20, 20, 20, 20, 20}),
+                   std::vector<float>({1.0f, 3.0f, 5.0f, 7.0f, 9.0f}));
+  ASSERT_GT(VectorizedInterpreter::getRunCount(), run_count);
+
+  run_count = VectorizedInterpreter::getRunCount();
+  res = runSqlQuery("SELECT COUNT(*), SUM(col1) FROM "s + GetParam() + ";");
+  compare_res_data(res, std::vector<int64_t>({10}), std::vector<int64_t>({150}));
+  ASSERT_GT(VectorizedInterpreter::getRunCount(), run_count);
+}
+
+TEST_P(ArrowStorageSqlTest, VectorizedInterpreterInterrupt) {
+  auto interpreter_state = g_enable_vectorized_interpreter;
+  ScopeGuard reset_interpreter([&]() {
+    g_enable_vectorized_interpreter = interpreter_state;
+    check_interrupt_init(static_cast<unsigned>(INT_RESET));
+  });
+  g_enable_vectorized_interpreter = true;
+
+  // The interpreter checks the interrupt flag before its first batch.
+  auto eo = ExecutionOptions::defaults();
+  eo.allow_runtime_query_interrupt = true;
+  check_interrupt_init(static_cast<unsigned>(INT_ABORT));
+  auto run_count = VectorizedInterpreter::getRunCount();
+  EXPECT_ANY_THROW(TestHelpers::ArrowSQLRunner::runSqlQuery(
+      "SELECT SUM(col1) FROM "s + GetParam() + ";", CompilationOptions(), eo));
+  ASSERT_GT(VectorizedInterpreter::getRunCount(), run_count);
+
+  check_interrupt_init(static_cast<unsigned>(INT_RESET));
+  auto res = TestHelpers::ArrowSQLRunner::runSqlQuery(
+      "SELECT SUM(col1) FROM "s + GetParam() + ";", CompilationOptions(), eo);
+  compare_res_data(res, std::vector<int64_t>({150}));
+}
+
+TEST_P(ArrowStorageSqlTest, TieredCompilation) {
+  auto tiering_state = g_enable_tiered_compilation;
+  ScopeGuard reset_tiering([&]() { g_enable_tiered_compilation = tiering_state; });
+  g_enable_tiered_compilation = true;
+  // Start with a code cache miss, so the first run uses first-tier code.
+  Executor::cpu_code_accessor.clear();
+
+  const auto overwrite_count = Executor::cpu_code_accessor.getOverwriteCount();
+  const auto sql = "SELECT COUNT(*), SUM(col1 * 3) FROM "s + GetParam() +
+                   " WHERE col1 > 12;";
+  auto res = runSqlQuery(sql);
+  compare_res_data(res, std::vector<int64_t>({5}), std::vector<int64_t>({300}));
+  BackgroundCompiler::get().waitAll();
+#ifndef ENABLE_ORCJIT
+  // The optimized code replaces the first-tier entry.
+  ASSERT_GT(Executor::cpu_code_accessor.getOverwriteCount(), overwrite_count);
+#endif
+  res = runSqlQuery(sql);
+  compare_res_data(res, std::vector<int64_t>({5}), std::vector<int64_t>({300}));
+}
+
+TEST_P(ArrowStorageSqlTest, PlanCodeCache) {
+  auto cache_state = g_enable_plan_code_cache;
+  ScopeGuard reset_cache([&]() { g_enable_plan_code_cache = cache_state; });
+  g_enable_plan_code_cache = true;
+
+  // Repeated queries reuse the code, different constants must not.
+  for (int i = 0; i < 2; ++i) {
+    auto res = runSqlQuery("SELECT COUNT(*), SUM(col1 + 1) FROM "s + GetParam() +
+                           " WHERE col1 > 15;");
+    compare_res_data(res, std::vector<int64_t>({5}), std::vector<int64_t>({105}));
+    res = runSqlQuery("SELECT COUNT(*), SUM(col1 + 2) FROM "s + GetParam() +
+                      " WHERE col1 > 5;");
+    compare_res_data(res, std::vector<int64_t>({10}), std::vector<int64_t>({170}));
+  }
+}
+
+TEST_P(ArrowStorageSqlTest, DispatchQueueClasses) {
+  // The query cost is the number of fetched chunks, i.e. the number of
+  // referenced columns times the table's fragment count (1 or 4).
+  QueryDispatchQueue::Config config;
+  config.interactive_cost = 2;
+  config.batch_cost = 8;
+  setDispatchQueue(1, config);
+  ScopeGuard reset_queue([]() { setDispatchQueue(0); });
+
+  auto res = runSqlQuery("SELECT SUM(col1), SUM(col2) FROM "s + GetParam() + ";");
+  compare_res_data(res, std::vector<int64_t>({150}), std::vector<float>({45.0f}));
+  res = runSqlQuery("SELECT SUM(col1) FROM "s + GetParam() + ";");
+  compare_res_data(res, std::vector<int64_t>({150}));
+
+  using Priority = QueryDispatchQueue::Priority;
+  auto dispatched = [](const QueryDispatchQueue::Stats& stats, Priority priority) {
+    return stats.dispatched_per_priority[static_cast<size_t>(priority)];
+  };
+  auto stats = getDispatchQueueStats();
+  EXPECT_EQ(stats.dispatched, (size_t)2);
+  EXPECT_EQ(stats.queue_depth, (size_t)0);
+  if (GetParam() == "mixed_data") {
+    EXPECT_EQ(dispatched(stats, Priority::kInteractive), (size_t)2);
+  } else {
+    EXPECT_EQ(dispatched(stats, Priority::kBatch), (size_t)1);
+    EXPECT_EQ(dispatched(stats, Priority::kNormal), (size_t)1);
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(ArrowStorageSqlTest,
                          ArrowStorageSqlTest,
                          testing::Values("mixed_data"s, "mixed_data_multifrag"s));
 
+class ArrowStorageDeleteTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ArrowStorage::TableOptions table_options(2);
+    auto tinfo = getStorage()->createTable(
+        "delete_test",
+        {{"col1", SQLTypeInfo(kINT)}, {"col2", SQLTypeInfo(kFLOAT)}},
+        table_options);
+    ArrowStorage::CsvParseOptions parse_options;
+    parse_options.header = false;
+    getStorage()->appendCsvData(
+        "1,1.0\n2,2.0\n3,3.0\n4,4.0\n5,5.0\n6,6.0\n7,7.0\n8,8.0\n",
+        tinfo->table_id,
+        parse_options);
+  }
+
+  void TearDown() override { getStorage()->dropTable("delete_test"); }
+};
+
+TEST_F(ArrowStorageDeleteTest, DeleteAndCompact) {
+  // The first two fragments are completely deleted and skipped.
+  getStorage()->deleteRows("delete_test", {0, 1, 2, 3, 6});
+  auto res = runSqlQuery("SELECT COUNT(*), SUM(col1), SUM(col2) FROM delete_test;");
+  compare_res_data(res,
+                   std::vector<int64_t>({3}),
+                   std::vector<int64_t>({19}),
+                   std::vector<float>({19.0f}));
+
+  getStorage()->compactTable("delete_test");
+  res = runSqlQuery("SELECT col1 FROM delete_test ORDER BY col1;");
+  compare_res_data(res, std::vector<int32_t>({5, 6, 8}));
+}
+
+TEST_F(ArrowStorageDeleteTest, QueryDuringCompaction) {
+  ArrowStorage::TableOptions table_options(2);
+  auto tinfo = getStorage()->createTable(
+      "compact_test",
+      {{"col1", SQLTypeInfo(kINT)}, {"col2", SQLTypeInfo(kFLOAT)}},
+      table_options);
+  ScopeGuard drop_table([]() { getStorage()->dropTable("compact_test"); });
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.header = false;
+  getStorage()->appendCsvData(
+      "1,1.0\n1,1.0\n1,1.0\n1,1.0\n1,1.0\n", tinfo->table_id, parse_options);
+
+  arrow::Int32Builder col1_builder;
+  arrow::FloatBuilder col2_builder;
+  ASSERT_TRUE(col1_builder.Append(1).ok());
+  ASSERT_TRUE(col2_builder.Append(1.0f).ok());
+  auto at = arrow::Table::Make(arrow::schema({arrow::field("col1", arrow::int32()),
+                                              arrow::field("col2", arrow::float32())}),
+                               {col1_builder.Finish().ValueOrDie(),
+                                col2_builder.Finish().ValueOrDie()});
+
+  // Rows are replaced with equal ones, so every version of the table has the
+  // same content while compactions renumber fragments and move rows.
+  std::atomic<bool> done = false;
+  std::thread writer([&]() {
+    for (int i = 0; i < 20; ++i) {
+      getStorage()->updateRows(tinfo->table_id, {0}, at);
+      getStorage()->compactTable(tinfo->table_id);
+    }
+    done = true;
+  });
+  ScopeGuard join_writer([&]() { writer.join(); });
+
+  do {
+    auto res = runSqlQuery("SELECT COUNT(*), SUM(col1), SUM(col2) FROM compact_test;");
+    compare_res_data(res,
+                     std::vector<int64_t>({5}),
+                     std::vector<int64_t>({5}),
+                     std::vector<float>({5.0f}));
+  } while (!done);
+}
+
+TEST_F(ArrowStorageDeleteTest, JoinAfterCompaction) {
+  auto tinfo = getStorage()->createTable("join_test", {{"col1", SQLTypeInfo(kINT)}});
+  ScopeGuard drop_table([]() { getStorage()->dropTable("join_test"); });
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.header = false;
+  getStorage()->appendCsvData(
+      "1\n2\n3\n4\n5\n6\n7\n8\n9\n10\n", tinfo->table_id, parse_options);
+
+  // The hash table built over delete_test refers to its rows by position.
+  auto query =
+      "SELECT COUNT(*), SUM(d.col2) FROM join_test j, delete_test d WHERE j.col1 = "
+      "d.col1;"s;
+  auto res = runSqlQuery(query);
+  compare_res_data(res, std::vector<int64_t>({8}), std::vector<float>({36.0f}));
+
+  getStorage()->deleteRows("delete_test", {0, 1});
+  getStorage()->compactTable("delete_test");
+  res = runSqlQuery(query);
+  compare_res_data(res, std::vector<int64_t>({6}), std::vector<float>({33.0f}));
+}
+
+TEST_F(ArrowStorageDeleteTest, Update) {
+  runSqlQuery("SELECT SUM(col1) FROM delete_test;");
+
+  arrow::Int32Builder col1_builder;
+  arrow::FloatBuilder col2_builder;
+  ASSERT_TRUE(col1_builder.Append(10).ok());
+  ASSERT_TRUE(col2_builder.Append(10.0f).ok());
+  auto at = arrow::Table::Make(arrow::schema({arrow::field("col1", arrow::int32()),
+                                              arrow::field("col2", arrow::float32())}),
+                               {col1_builder.Finish().ValueOrDie(),
+                                col2_builder.Finish().ValueOrDie()});
+  getStorage()->updateRows("delete_test", {1}, at);
+
+  // Chunks cached by the previous query are not used for the updated fragment.
+  auto res = runSqlQuery("SELECT COUNT(*), SUM(col1) FROM delete_test WHERE col1 < 5;");
+  compare_res_data(res, std::vector<int64_t>({3}), std::vector<int64_t>({8}));
+  res = runSqlQuery("SELECT COUNT(*), SUM(col1) FROM delete_test;");
+  compare_res_data(res, std::vector<int64_t>({8}), std::vector<int64_t>({44}));
+}
+
 class ArrowStorageTaxiTest : public ::testing::Test {
  protected:
   static void SetUpTestSuite() {
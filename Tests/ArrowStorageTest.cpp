@@ -13,11 +13,17 @@
  */
 
 #include "ArrowStorage/ArrowStorage.h"
+#include "Shared/scope.h"
 
 #include "TestHelpers.h"
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
 constexpr int TEST_SCHEMA_ID = 1;
 constexpr int TEST_DB_ID = (TEST_SCHEMA_ID << 24) + 1;
 
@@ -836,6 +842,41 @@ TEST_F(ArrowStorageTest, AppendCsvData) {
       storage, tinfo->table_id, 3, 32'000'000, range(3, (int32_t)1), range(3, 10.0f));
 }
 
+TEST_F(ArrowStorageTest, AppendCsvData_Nulls) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  TableInfoPtr tinfo = storage.createTable(
+      "table1", {{"col1", SQLTypeInfo(kINT)}, {"col2", SQLTypeInfo(kFLOAT)}});
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.header = false;
+  storage.appendCsvData("1,\n,20.0\n3,30.0\n", tinfo->table_id, parse_options);
+  checkData(storage,
+            tinfo->table_id,
+            3,
+            32'000'000,
+            std::vector<int32_t>({1, inline_null_value<int32_t>(), 3}),
+            std::vector<float>({inline_null_value<float>(), 20.0f, 30.0f}));
+}
+
+TEST_F(ArrowStorageTest, AppendArrowTable_Nulls_InputNotModified) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  TableInfoPtr tinfo = storage.createTable("table1", {{"col1", SQLTypeInfo(kINT)}});
+  arrow::Int32Builder builder;
+  ASSERT_TRUE(builder.Append(1).ok());
+  ASSERT_TRUE(builder.AppendNull().ok());
+  ASSERT_TRUE(builder.Append(3).ok());
+  auto arr = std::static_pointer_cast<arrow::Int32Array>(builder.Finish().ValueOrDie());
+  auto at = arrow::Table::Make(arrow::schema({arrow::field("col1", arrow::int32())}),
+                               {arr});
+  storage.appendArrowTable(at, tinfo->table_id);
+  checkData(storage,
+            tinfo->table_id,
+            3,
+            32'000'000,
+            std::vector<int32_t>({1, inline_null_value<int32_t>(), 3}));
+  // User provided tables should never be modified.
+  ASSERT_NE(arr->raw_values()[1], inline_null_value<int32_t>());
+}
+
 void Test_AppendCsv_Numbers(size_t fragment_size) {
   ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
   ArrowStorage::TableOptions table_options;
@@ -974,6 +1015,173 @@ TEST_F(ArrowStorageTest, AppendCsv_Strings_NoSchema) {
   Test_ImportCsv_Strings(false, true, parse_options);
 }
 
+TEST_F(ArrowStorageTest, ImportCsv_Strings_Streaming) {
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.block_size = 50;
+  parse_options.max_batch_bytes = 1;
+  Test_ImportCsv_Strings(true, false, parse_options, 3);
+  Test_ImportCsv_Strings(true, false, parse_options, 1);
+  Test_ImportCsv_Strings(false, false, parse_options);
+}
+
+TEST_F(ArrowStorageTest, AppendCsv_Strings_Streaming) {
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.block_size = 50;
+  parse_options.max_batch_bytes = 1;
+  Test_ImportCsv_Strings(true, true, parse_options, 5);
+  Test_ImportCsv_Strings(true, true, parse_options, 2);
+}
+
+TEST_F(ArrowStorageTest, ImportCsv_Strings_ZeroCopy) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  ArrowStorage::TableOptions table_options(2);
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.block_size = 50;
+  auto tinfo = storage.importCsvFile(
+      getFilePath("strings.csv"),
+      "table1",
+      {{"col1", SQLTypeInfo(kTEXT)}, {"col2", SQLTypeInfo(kTEXT)}},
+      table_options,
+      parse_options);
+
+  std::vector<std::string> col1_expected = {"s1"s, "ss2"s, "sss3"s, "ssss4"s, "sssss5"s};
+  for (int frag_id = 1; frag_id <= 3; ++frag_id) {
+    size_t start_row = (frag_id - 1) * 2;
+    size_t end_row = std::min(start_row + 2, col1_expected.size());
+    std::string expected_data;
+    std::vector<uint32_t> expected_offsets;
+    for (size_t i = start_row; i < end_row; ++i) {
+      expected_offsets.push_back(expected_data.size());
+      expected_data += col1_expected[i];
+    }
+    expected_offsets.push_back(expected_data.size());
+
+    // Tokens alive at the same time reference the same memory only when they
+    // are not copies.
+    ChunkKey data_key{TEST_DB_ID, tinfo->table_id, 1, frag_id, 1};
+    auto data_token = storage.getZeroCopyBufferMemory(data_key, expected_data.size());
+    ASSERT_NE(data_token, nullptr);
+    ASSERT_EQ(data_token->getSize(), expected_data.size());
+    ASSERT_TRUE(data_token->getEncoderType());
+    ASSERT_EQ(std::string(reinterpret_cast<const char*>(data_token->getMemoryPtr()),
+                          data_token->getSize()),
+              expected_data);
+    auto data_token2 = storage.getZeroCopyBufferMemory(data_key, expected_data.size());
+    ASSERT_NE(data_token2, nullptr);
+    ASSERT_EQ(data_token2->getMemoryPtr(), data_token->getMemoryPtr());
+
+    // Offsets of every fragment are rebased on import and served as is.
+    ChunkKey index_key{TEST_DB_ID, tinfo->table_id, 1, frag_id, 2};
+    const size_t index_size = expected_offsets.size() * sizeof(uint32_t);
+    auto index_token = storage.getZeroCopyBufferMemory(index_key, index_size);
+    ASSERT_NE(index_token, nullptr);
+    ASSERT_EQ(index_token->getSize(), index_size);
+    auto offsets = reinterpret_cast<const uint32_t*>(index_token->getMemoryPtr());
+    for (size_t i = 0; i < expected_offsets.size(); ++i) {
+      ASSERT_EQ(offsets[i], expected_offsets[i]);
+    }
+    auto index_token2 = storage.getZeroCopyBufferMemory(index_key, index_size);
+    ASSERT_NE(index_token2, nullptr);
+    ASSERT_EQ(index_token2->getMemoryPtr(), index_token->getMemoryPtr());
+  }
+}
+
+TEST_F(ArrowStorageTest, AppendArrowTable_ZeroCopy) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  SQLTypeInfo int_array(kARRAY, false);
+  int_array.set_subtype(kINT);
+  TableInfoPtr tinfo = storage.createTable("table1",
+                                           {{"col1", SQLTypeInfo(kINT)},
+                                            {"col2", SQLTypeInfo(kTEXT)},
+                                            {"col3", int_array}},
+                                           ArrowStorage::TableOptions(2));
+
+  // A single chunk of five rows is split into three fragments.
+  std::vector<int32_t> ints{1, 2, 3, 4, 5};
+  std::vector<std::string> strs{"a"s, "bb"s, "ccc"s, "dddd"s, "eeeee"s};
+  std::vector<std::vector<int32_t>> arrays{{1}, {2, 2}, {}, {4, 4, 4}, {5}};
+  arrow::Int32Builder int_builder;
+  arrow::StringBuilder str_builder;
+  arrow::ListBuilder list_builder(arrow::default_memory_pool(),
+                                  std::make_shared<arrow::Int32Builder>());
+  auto elem_builder = static_cast<arrow::Int32Builder*>(list_builder.value_builder());
+  for (size_t i = 0; i < ints.size(); ++i) {
+    ASSERT_TRUE(int_builder.Append(ints[i]).ok());
+    ASSERT_TRUE(str_builder.Append(strs[i]).ok());
+    ASSERT_TRUE(list_builder.Append().ok());
+    ASSERT_TRUE(elem_builder->AppendValues(arrays[i]).ok());
+  }
+  auto int_arr = int_builder.Finish().ValueOrDie();
+  auto str_arr = str_builder.Finish().ValueOrDie();
+  auto list_arr = list_builder.Finish().ValueOrDie();
+  auto at = arrow::Table::Make(arrow::schema({arrow::field("col1", arrow::int32()),
+                                              arrow::field("col2", arrow::utf8()),
+                                              arrow::field("col3",
+                                                           arrow::list(arrow::int32()))}),
+                               {int_arr, str_arr, list_arr});
+  storage.appendArrowTable(at, tinfo->table_id);
+
+  // Fixed length and string values of user tables without nulls are served right
+  // from the input buffers, array values from the converted column. Offsets of
+  // every fragment start at zero.
+  auto int_values = reinterpret_cast<const int8_t*>(
+      std::static_pointer_cast<arrow::Int32Array>(int_arr)->raw_values());
+  auto str_values = reinterpret_cast<const int8_t*>(
+      std::static_pointer_cast<arrow::StringArray>(str_arr)->value_data()->data());
+  const int8_t* array_values = nullptr;
+  size_t str_offset = 0;
+  size_t array_offset = 0;
+  for (int frag_id = 1; frag_id <= 3; ++frag_id) {
+    size_t start_row = (frag_id - 1) * 2;
+    size_t end_row = std::min(start_row + 2, ints.size());
+    size_t row_count = end_row - start_row;
+
+    ChunkKey int_key{TEST_DB_ID, tinfo->table_id, 1, frag_id};
+    auto int_token =
+        storage.getZeroCopyBufferMemory(int_key, row_count * sizeof(int32_t));
+    ASSERT_NE(int_token, nullptr);
+    ASSERT_EQ(int_token->getMemoryPtr(), int_values + start_row * sizeof(int32_t));
+
+    std::vector<uint32_t> str_offsets{0};
+    std::vector<uint32_t> array_offsets{0};
+    for (size_t i = start_row; i < end_row; ++i) {
+      str_offsets.push_back(str_offsets.back() + strs[i].size());
+      array_offsets.push_back(array_offsets.back() + arrays[i].size() * sizeof(int32_t));
+    }
+    for (int col_id : {2, 3}) {
+      auto& expected_offsets = col_id == 2 ? str_offsets : array_offsets;
+      ChunkKey data_key{TEST_DB_ID, tinfo->table_id, col_id, frag_id, 1};
+      auto data_token =
+          storage.getZeroCopyBufferMemory(data_key, expected_offsets.back());
+      ASSERT_NE(data_token, nullptr);
+      ASSERT_EQ(data_token->getSize(), expected_offsets.back());
+      if (col_id == 2) {
+        ASSERT_EQ(data_token->getMemoryPtr(), str_values + str_offset);
+        str_offset += expected_offsets.back();
+      } else {
+        // Fragments of the converted column share its values buffer.
+        if (!array_values) {
+          array_values = data_token->getMemoryPtr();
+        }
+        ASSERT_EQ(data_token->getMemoryPtr(), array_values + array_offset);
+        array_offset += expected_offsets.back();
+      }
+
+      ChunkKey index_key{TEST_DB_ID, tinfo->table_id, col_id, frag_id, 2};
+      const size_t index_size = expected_offsets.size() * sizeof(uint32_t);
+      auto index_token = storage.getZeroCopyBufferMemory(index_key, index_size);
+      ASSERT_NE(index_token, nullptr);
+      auto offsets = reinterpret_cast<const uint32_t*>(index_token->getMemoryPtr());
+      for (size_t i = 0; i < expected_offsets.size(); ++i) {
+        ASSERT_EQ(offsets[i], expected_offsets[i]);
+      }
+      auto index_token2 = storage.getZeroCopyBufferMemory(index_key, index_size);
+      ASSERT_NE(index_token2, nullptr);
+      ASSERT_EQ(index_token2->getMemoryPtr(), index_token->getMemoryPtr());
+    }
+  }
+}
+
 void Test_ImportCsv_Dict(bool shared_dict,
                          bool read_twice,
                          const ArrowStorage::CsvParseOptions& parse_options,
@@ -1554,6 +1762,756 @@ TEST_F(ArrowStorageTest, ImportParquet) {
             std::vector<double>({1.1, 2.2, 3.3, 4.4, 5.5}));
 }
 
+TEST_F(ArrowStorageTest, ImportParquet_Streaming) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  ArrowStorage::ParquetParseOptions parse_options;
+  parse_options.max_batch_bytes = 1;
+  auto tinfo = storage.importParquetFile(
+      getFilePath("int_float.parquet"), "table1", {2}, parse_options);
+  storage.appendParquetFile(getFilePath("int_float.parquet"), "table1", parse_options);
+
+  checkData(storage,
+            tinfo->table_id,
+            10,
+            2,
+            std::vector<int64_t>({1, 2, 3, 4, 5, 1, 2, 3, 4, 5}),
+            std::vector<double>({1.1, 2.2, 3.3, 4.4, 5.5, 1.1, 2.2, 3.3, 4.4, 5.5}));
+}
+
+TEST_F(ArrowStorageTest, ImportCsv_Streaming_SmallBlocks) {
+  auto file_path = std::filesystem::temp_directory_path() / "streaming_frags.csv";
+  ScopeGuard remove_file([&]() { std::filesystem::remove(file_path); });
+  std::vector<int64_t> expected;
+  {
+    std::ofstream out(file_path);
+    out << "col1\n";
+    for (int64_t i = 0; i < 100; ++i) {
+      out << i << "\n";
+      expected.push_back(i);
+    }
+  }
+
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.block_size = 16;
+  parse_options.max_batch_bytes = 1;
+  auto tinfo = storage.importCsvFile(file_path.string(), "table1", {32}, parse_options);
+  checkData(storage, tinfo->table_id, 100, 32, expected);
+}
+
+TEST_F(ArrowStorageTest, ImportCsv_Streaming_TypeConflict) {
+  auto file_path = std::filesystem::temp_directory_path() / "streaming_types.csv";
+  ScopeGuard remove_file([&]() { std::filesystem::remove(file_path); });
+  {
+    std::ofstream out(file_path);
+    out << "col1\n";
+    for (int i = 0; i < 100; ++i) {
+      out << i << "\n";
+    }
+    out << "str\n";
+  }
+
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.block_size = 16;
+  parse_options.max_batch_bytes = 1;
+  ASSERT_THROW(storage.importCsvFile(file_path.string(), "table1", {32}, parse_options),
+               std::runtime_error);
+}
+
+template <typename T>
+void Test_ChunkCodec(const std::vector<T>& vals,
+                     const SQLTypeInfo& type,
+                     std::optional<ChunkCodec> expected_codec) {
+  // Split data into two arrays to check multi-chunk input.
+  using BuilderType = typename arrow::CTypeTraits<T>::BuilderType;
+  arrow::ArrayVector arrays;
+  size_t mid = vals.size() / 2;
+  for (auto [begin, end] : {std::pair(size_t(0), mid), std::pair(mid, vals.size())}) {
+    BuilderType builder;
+    for (size_t i = begin; i < end; ++i) {
+      CHECK(builder.Append(vals[i]).ok());
+    }
+    arrays.push_back(builder.Finish().ValueOrDie());
+  }
+  auto data = std::make_shared<arrow::ChunkedArray>(arrays);
+
+  bool has_nulls = std::any_of(
+      vals.begin(), vals.end(), [](T v) { return v == inline_null_value<T>(); });
+  auto chunk = compressChunk(data, type, has_nulls);
+  if (!expected_codec) {
+    ASSERT_FALSE(chunk);
+    return;
+  }
+  ASSERT_TRUE(chunk);
+  ASSERT_EQ(toString(chunk->codec), toString(*expected_codec));
+  ASSERT_LT(chunk->memoryUsage(), vals.size() * sizeof(T));
+
+  std::vector<T> decoded(vals.size());
+  decompressChunk(*chunk, vals.size(), reinterpret_cast<int8_t*>(decoded.data()));
+  ASSERT_EQ(decoded, vals);
+  // Partial decoding.
+  std::vector<T> head(mid);
+  decompressChunk(*chunk, mid, reinterpret_cast<int8_t*>(head.data()));
+  ASSERT_EQ(head, std::vector<T>(vals.begin(), vals.begin() + mid));
+}
+
+TEST_F(ArrowStorageTest, ChunkCodec_FrameOfReference) {
+  std::vector<int32_t> vals;
+  for (int32_t i = 0; i < 100; ++i) {
+    vals.push_back(i % 7 ? 1'000'000 + (i * 37) % 100 : inline_null_value<int32_t>());
+  }
+  Test_ChunkCodec(vals, SQLTypeInfo(kINT), ChunkCodec::kFrameOfReference);
+}
+
+TEST_F(ArrowStorageTest, ChunkCodec_Delta) {
+  std::vector<int64_t> vals;
+  for (int64_t i = 0; i < 100; ++i) {
+    vals.push_back(1'600'000'000'000 + i * 1000 + i % 3);
+  }
+  Test_ChunkCodec(vals, SQLTypeInfo(kTIMESTAMP), ChunkCodec::kDelta);
+}
+
+TEST_F(ArrowStorageTest, ChunkCodec_RunLength) {
+  std::vector<int64_t> vals;
+  for (int64_t i = 0; i < 100; ++i) {
+    vals.push_back(i < 50 ? std::numeric_limits<int64_t>::min() + 1
+                          : std::numeric_limits<int64_t>::max());
+  }
+  Test_ChunkCodec(vals, SQLTypeInfo(kBIGINT), ChunkCodec::kRunLength);
+}
+
+TEST_F(ArrowStorageTest, ChunkCodec_AllNulls) {
+  std::vector<int16_t> vals(100, inline_null_value<int16_t>());
+  Test_ChunkCodec(vals, SQLTypeInfo(kSMALLINT), ChunkCodec::kFrameOfReference);
+}
+
+TEST_F(ArrowStorageTest, ChunkCodec_Incompressible) {
+  std::vector<int32_t> vals;
+  for (int32_t i = 0; i < 100; ++i) {
+    vals.push_back(i % 2 ? std::numeric_limits<int32_t>::max() - i
+                         : std::numeric_limits<int32_t>::min() + 1 + i);
+  }
+  Test_ChunkCodec(vals, SQLTypeInfo(kINT), std::nullopt);
+}
+
+TEST_F(ArrowStorageTest, AppendCsv_Compressed_Multifrag) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  ArrowStorage::TableOptions table_options(4);
+  table_options.compression = true;
+  auto tinfo = storage.createTable("table1",
+                                   {{"col1", SQLTypeInfo(kINT)},
+                                    {"col2", SQLTypeInfo(kBIGINT)},
+                                    {"col3", SQLTypeInfo(kFLOAT)}},
+                                   table_options);
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.header = false;
+  storage.appendCsvData(
+      "1,1000,1.0\n1,2000,2.0\n1,3000,3.0\n1,4000,4.0\n2,5000,5.0\n,6000,6.0\n",
+      tinfo->table_id,
+      parse_options);
+  storage.appendCsvData(
+      "3,7000,7.0\n2,8000,8.0\n5,9000,9.0\n5,10000,10.0\n6,11000,11.0\n",
+      tinfo->table_id,
+      parse_options);
+
+  auto null_val = inline_null_value<int32_t>();
+  checkData(storage,
+            tinfo->table_id,
+            11,
+            4,
+            std::vector<int32_t>({1, 1, 1, 1, 2, null_val, 3, 2, 5, 5, 6}),
+            range(11, (int64_t)1000),
+            range(11, 1.0f));
+}
+
+TEST_F(ArrowStorageTest, ZeroCopy_Compressed) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  ArrowStorage::TableOptions table_options(4);
+  table_options.compression = true;
+  auto tinfo =
+      storage.createTable("table1", {{"col1", SQLTypeInfo(kBIGINT)}}, table_options);
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.header = false;
+  storage.appendCsvData(
+      "1000\n2000\n3000\n4000\n5000\n", tinfo->table_id, parse_options);
+
+  // The first fragment is compressed. Its data is decoded once and shared by
+  // all tokens while any of them is alive.
+  ChunkKey key{TEST_DB_ID, tinfo->table_id, 1, 1};
+  auto token1 = storage.getZeroCopyBufferMemory(key, 4 * sizeof(int64_t));
+  ASSERT_NE(token1, nullptr);
+  ASSERT_EQ(token1->getSize(), 4 * sizeof(int64_t));
+  auto vals = reinterpret_cast<const int64_t*>(token1->getMemoryPtr());
+  ASSERT_EQ(std::vector<int64_t>(vals, vals + 4),
+            std::vector<int64_t>({1000, 2000, 3000, 4000}));
+  auto token2 = storage.getZeroCopyBufferMemory(key, 2 * sizeof(int64_t));
+  ASSERT_NE(token2, nullptr);
+  ASSERT_EQ(token2->getSize(), 2 * sizeof(int64_t));
+  ASSERT_EQ(token2->getMemoryPtr(), token1->getMemoryPtr());
+
+  checkData(storage,
+            tinfo->table_id,
+            5,
+            4,
+            std::vector<int64_t>({1000, 2000, 3000, 4000, 5000}));
+}
+
+TEST_F(ArrowStorageTest, DeleteRows_Multifrag) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  auto tinfo = storage.createTable("table1", {{"col1", SQLTypeInfo(kINT)}}, {2});
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.header = false;
+  storage.appendCsvData("1\n2\n3\n4\n5\n", tinfo->table_id, parse_options);
+  ASSERT_THROW(storage.deleteRows(tinfo->table_id, {5}), std::runtime_error);
+
+  storage.deleteRows(tinfo->table_id, {1, 2, 3});
+  auto del_col_info = storage.getTableInfo(TEST_DB_ID, tinfo->table_id)->delete_column;
+  ASSERT_TRUE(del_col_info);
+  ASSERT_TRUE(del_col_info->is_delete);
+  int del_col_id = del_col_info->column_id;
+
+  auto meta = storage.getTableMetadata(TEST_DB_ID, tinfo->table_id);
+  ASSERT_EQ(meta.getNumTuples(), (size_t)5);
+  ASSERT_EQ(meta.fragments.size(), (size_t)3);
+  // Modified fragments get new ids.
+  ASSERT_NE(meta.fragments[0].fragmentId, 1);
+  ASSERT_NE(meta.fragments[1].fragmentId, 2);
+  ASSERT_EQ(meta.fragments[2].fragmentId, 3);
+  SQLTypeInfo del_type(kTINYINT, true);
+  checkChunkMeta(meta.fragments[0].getChunkMetadataMap().at(del_col_id),
+                 del_type,
+                 2,
+                 2,
+                 false,
+                 (int8_t)0,
+                 (int8_t)1);
+  checkChunkMeta(meta.fragments[1].getChunkMetadataMap().at(del_col_id),
+                 del_type,
+                 2,
+                 2,
+                 false,
+                 (int8_t)1,
+                 (int8_t)1);
+  checkChunkMeta(meta.fragments[2].getChunkMetadataMap().at(del_col_id),
+                 del_type,
+                 1,
+                 1,
+                 false,
+                 (int8_t)0,
+                 (int8_t)0);
+  checkFetchedData(storage,
+                   tinfo->table_id,
+                   del_col_id,
+                   meta.fragments[0].fragmentId,
+                   std::vector<int8_t>({0, 1}));
+  checkFetchedData(storage,
+                   tinfo->table_id,
+                   del_col_id,
+                   meta.fragments[1].fragmentId,
+                   std::vector<int8_t>({1, 1}));
+  // Old fragment ids are still valid.
+  checkFetchedData(storage, tinfo->table_id, 1, 1, std::vector<int32_t>({1, 2}));
+  checkFetchedData(storage,
+                   tinfo->table_id,
+                   1,
+                   meta.fragments[0].fragmentId,
+                   std::vector<int32_t>({1, 2}));
+}
+
+TEST_F(ArrowStorageTest, DeleteRows_Compaction) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  SQLTypeInfo int_array(kARRAY, false);
+  int_array.set_subtype(kINT);
+  auto tinfo = storage.createTable(
+      "table1", {{"col1", SQLTypeInfo(kINT)}, {"col2", int_array}}, {2});
+  storage.appendJsonData(R"___({"col1": 1, "col2": [1, 2, 3]}
+{"col1": 2, "col2": null}
+{"col1": 3, "col2": [7, 8]}
+{"col1": 4, "col2": null}
+{"col1": 5, "col2": [11]})___",
+                         tinfo->table_id);
+  storage.deleteRows(tinfo->table_id, {1, 2});
+  storage.compactTable(tinfo->table_id);
+
+  auto meta = storage.getTableMetadata(TEST_DB_ID, tinfo->table_id);
+  ASSERT_EQ(meta.getNumTuples(), (size_t)3);
+  ASSERT_EQ(meta.fragments.size(), (size_t)2);
+  int frag1_id = meta.fragments[0].fragmentId;
+  int frag2_id = meta.fragments[1].fragmentId;
+  // Compacted table has no rows to filter out.
+  ASSERT_EQ(meta.fragments[0].getChunkMetadataMap().size(), (size_t)2);
+  checkChunkMeta(meta.fragments[0].getChunkMetadataMap().at(1),
+                 SQLTypeInfo(kINT),
+                 2,
+                 8,
+                 false,
+                 (int32_t)1,
+                 (int32_t)4);
+  checkChunkMeta(meta.fragments[1].getChunkMetadataMap().at(1),
+                 SQLTypeInfo(kINT),
+                 1,
+                 4,
+                 false,
+                 (int32_t)5,
+                 (int32_t)5);
+  checkFetchedData(storage, tinfo->table_id, 1, frag1_id, std::vector<int32_t>({1, 4}));
+  checkFetchedData(storage, tinfo->table_id, 1, frag2_id, std::vector<int32_t>({5}));
+  checkFetchedData(storage,
+                   tinfo->table_id,
+                   2,
+                   frag1_id,
+                   std::vector<uint32_t>({0, 12, static_cast<uint32_t>(-12)}),
+                   {2});
+  checkFetchedData(
+      storage, tinfo->table_id, 2, frag1_id, std::vector<int32_t>({1, 2, 3}), {1});
+  checkFetchedData(
+      storage, tinfo->table_id, 2, frag2_id, std::vector<uint32_t>({0, 4}), {2});
+  checkFetchedData(
+      storage, tinfo->table_id, 2, frag2_id, std::vector<int32_t>({11}), {1});
+}
+
+TEST_F(ArrowStorageTest, DeleteRows_CompactionRetiredFragments) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  auto tinfo = storage.createTable("table1", {{"col1", SQLTypeInfo(kINT)}}, {2});
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.header = false;
+  storage.appendCsvData("1\n2\n3\n4\n5\n", tinfo->table_id, parse_options);
+  storage.deleteRows(tinfo->table_id, {1, 2});
+
+  auto old_meta = storage.getTableMetadata(TEST_DB_ID, tinfo->table_id);
+  int old_frag_id = old_meta.fragments[0].fragmentId;
+  storage.compactTable(tinfo->table_id);
+
+  // Fragments referenced by metadata acquired before the compaction are
+  // still readable and have the old data.
+  checkFetchedData(
+      storage, tinfo->table_id, 1, old_frag_id, std::vector<int32_t>({1, 2}));
+  checkFetchedData(storage,
+                   tinfo->table_id,
+                   1,
+                   old_meta.fragments[1].fragmentId,
+                   std::vector<int32_t>({3, 4}));
+  auto meta = storage.getTableMetadata(TEST_DB_ID, tinfo->table_id);
+  checkFetchedData(storage,
+                   tinfo->table_id,
+                   1,
+                   meta.fragments[0].fragmentId,
+                   std::vector<int32_t>({1, 4}));
+
+  // The old version is released along with the last metadata referencing it.
+  old_meta = TableFragmentsInfo();
+  TestBuffer dst(2 * sizeof(int32_t));
+  ChunkKey key{TEST_DB_ID, tinfo->table_id, 1, old_frag_id};
+  ASSERT_THROW(storage.fetchBuffer(key, &dst, 2 * sizeof(int32_t)), std::runtime_error);
+}
+
+TEST_F(ArrowStorageTest, UpdateRows) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  auto tinfo = storage.createTable("table1", {{"col1", SQLTypeInfo(kINT)}}, {2});
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.header = false;
+  storage.appendCsvData("1\n2\n3\n", tinfo->table_id, parse_options);
+
+  arrow::Int32Builder builder;
+  ASSERT_TRUE(builder.Append(10).ok());
+  ASSERT_TRUE(builder.Append(30).ok());
+  auto at = arrow::Table::Make(arrow::schema({arrow::field("col1", arrow::int32())}),
+                               {builder.Finish().ValueOrDie()});
+  ASSERT_THROW(storage.updateRows(tinfo->table_id, {0}, at), std::runtime_error);
+  storage.updateRows(tinfo->table_id, {0, 2}, at);
+
+  auto meta = storage.getTableMetadata(TEST_DB_ID, tinfo->table_id);
+  ASSERT_EQ(meta.getNumTuples(), (size_t)5);
+  ASSERT_EQ(meta.fragments.size(), (size_t)3);
+  int del_col_id =
+      storage.getTableInfo(TEST_DB_ID, tinfo->table_id)->delete_column->column_id;
+  checkFetchedData(storage,
+                   tinfo->table_id,
+                   del_col_id,
+                   meta.fragments[1].fragmentId,
+                   std::vector<int8_t>({1, 0}));
+  checkFetchedData(storage,
+                   tinfo->table_id,
+                   1,
+                   meta.fragments[1].fragmentId,
+                   std::vector<int32_t>({3, 10}));
+
+  storage.compactTable(tinfo->table_id);
+  meta = storage.getTableMetadata(TEST_DB_ID, tinfo->table_id);
+  ASSERT_EQ(meta.getNumTuples(), (size_t)3);
+  ASSERT_EQ(meta.fragments.size(), (size_t)2);
+  checkFetchedData(storage,
+                   tinfo->table_id,
+                   1,
+                   meta.fragments[0].fragmentId,
+                   std::vector<int32_t>({2, 10}));
+  checkFetchedData(storage,
+                   tinfo->table_id,
+                   1,
+                   meta.fragments[1].fragmentId,
+                   std::vector<int32_t>({30}));
+}
+
+TEST_F(ArrowStorageTest, DeleteRows_AutoCompaction) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  ArrowStorage::TableOptions table_options(2);
+  table_options.compaction_threshold = 0.5;
+  auto tinfo =
+      storage.createTable("table1", {{"col1", SQLTypeInfo(kINT)}}, table_options);
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.header = false;
+  storage.appendCsvData("1\n2\n3\n4\n", tinfo->table_id, parse_options);
+
+  storage.deleteRows(tinfo->table_id, {0});
+  ASSERT_EQ(storage.getTableMetadata(TEST_DB_ID, tinfo->table_id).getNumTuples(),
+            (size_t)4);
+  storage.deleteRows(tinfo->table_id, {3});
+  size_t num_tuples = 0;
+  for (int i = 0; i < 500 && num_tuples != 2; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    num_tuples = storage.getTableMetadata(TEST_DB_ID, tinfo->table_id).getNumTuples();
+  }
+  ASSERT_EQ(num_tuples, (size_t)2);
+}
+
+TEST_F(ArrowStorageTest, ConcurrentAppendAndRead) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  auto tinfo = storage.createTable("table1", {{"col1", SQLTypeInfo(kINT)}}, {10});
+  ArrowStorage::CsvParseOptions parse_options;
+  parse_options.header = false;
+
+  // Whole triples are deleted, so the table always consists of 1, 2, 3
+  // sequences before and after the compaction.
+  std::atomic<bool> done = false;
+  std::thread writer([&]() {
+    for (int i = 0; i < 100; ++i) {
+      storage.appendCsvData("1\n2\n3\n", tinfo->table_id, parse_options);
+      if (i % 10 == 9) {
+        storage.deleteRows(tinfo->table_id, {0, 1, 2});
+        storage.compactTable(tinfo->table_id);
+      }
+    }
+    done = true;
+  });
+
+  // Readers always observe a complete modification and fetch data of the
+  // version they got metadata for.
+  while (!done) {
+    auto meta = storage.getTableMetadata(TEST_DB_ID, tinfo->table_id);
+    size_t num_tuples = meta.getNumTuples();
+    EXPECT_EQ(num_tuples % 3, (size_t)0);
+    if (!num_tuples) {
+      continue;
+    }
+
+    size_t frag_tuples = 0;
+    for (size_t frag_idx = 0; frag_idx < meta.fragments.size(); ++frag_idx) {
+      auto& frag = meta.fragments[frag_idx];
+      std::vector<int32_t> expected;
+      for (size_t i = 0; i < frag.getNumTuples(); ++i) {
+        expected.push_back(static_cast<int32_t>((frag_tuples + i) % 3 + 1));
+      }
+      checkFetchedData(storage, tinfo->table_id, 1, frag.fragmentId, expected);
+      // Delete flags match the delete column metadata.
+      for (auto& [col_id, chunk_meta] : frag.getChunkMetadataMapPhysical()) {
+        if (col_id == 1) {
+          continue;
+        }
+        TestBuffer dst(frag.getNumTuples());
+        storage.fetchBuffer({TEST_DB_ID, tinfo->table_id, col_id, frag.fragmentId},
+                            &dst,
+                            frag.getNumTuples());
+        auto flags = reinterpret_cast<const int8_t*>(dst.getMemoryPtr());
+        bool has_deleted = std::any_of(
+            flags, flags + frag.getNumTuples(), [](int8_t flag) { return flag != 0; });
+        EXPECT_EQ(has_deleted, chunk_meta->chunkStats.max.tinyintval == 1);
+      }
+      frag_tuples += frag.getNumTuples();
+    }
+    EXPECT_EQ(frag_tuples, num_tuples);
+  }
+  writer.join();
+
+  ASSERT_EQ(storage.getTableMetadata(TEST_DB_ID, tinfo->table_id).getNumTuples(),
+            (size_t)270);
+}
+
+class ArrowStoragePersistTest : public ArrowStorageTest {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() / "ArrowStoragePersistTest";
+    std::filesystem::remove_all(dir_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  std::filesystem::path dir_;
+};
+
+TEST_F(ArrowStoragePersistTest, Dict_Multifrag) {
+  ArrowStorage::TableOptions table_options(2);
+  SQLTypeInfo dict_type(kTEXT, false, kENCODING_DICT);
+  dict_type.set_comp_param(-1);
+  {
+    ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+    storage.importCsvFile(getFilePath("strings.csv"),
+                          "table1",
+                          {{"col1", dict_type}, {"col2", dict_type}},
+                          table_options);
+    storage.persistTable("table1", dir_.string());
+  }
+
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  auto tinfo = storage.loadPersistedTable(dir_.string(), "table2");
+  auto col1_info = storage.getColumnInfo(*tinfo, "col1");
+  auto col2_info = storage.getColumnInfo(*tinfo, "col2");
+  ASSERT_EQ(col1_info->type.get_comp_param(), col2_info->type.get_comp_param());
+  auto dict = storage.getDictMetadata(col1_info->type.get_comp_param())->stringDict;
+  ASSERT_EQ(dict->storageEntryCount(), (size_t)10);
+
+  checkData(storage,
+            tinfo->table_id,
+            5,
+            2,
+            std::vector<std::string>({"s1"s, "ss2"s, "sss3"s, "ssss4"s, "sssss5"s}),
+            std::vector<std::string>(
+                {"dd1"s, "dddd2"s, "dddddd3"s, "dddddddd4"s, "dddddddddd5"s}));
+
+  storage.appendCsvFile(getFilePath("strings.csv"), "table2");
+  ASSERT_EQ(dict->storageEntryCount(), (size_t)10);
+}
+
+TEST_F(ArrowStoragePersistTest, Arrays_Multifrag) {
+  SQLTypeInfo int_array(kARRAY, false);
+  int_array.set_subtype(kINT);
+  SQLTypeInfo float2_array(kARRAY, false);
+  float2_array.set_subtype(kFLOAT);
+  float2_array.set_size(2 * sizeof(float));
+  {
+    ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+    auto tinfo = storage.createTable(
+        "table1", {{"col1", int_array}, {"col2", float2_array}}, {2});
+    storage.appendJsonData(R"___({"col1": [1, 2, 3], "col2": [null, 20.0]}
+{"col1": null, "col2": [40.0, null, 60.0]}
+{"col1": [7, 8], "col2": null}
+{"col1": null, "col2": [110.0]})___",
+                           tinfo->table_id);
+    storage.persistTable(tinfo->table_id, dir_.string());
+  }
+
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  auto tinfo = storage.loadPersistedTable(dir_.string(), "table1");
+  checkData(
+      storage,
+      tinfo->table_id,
+      4,
+      2,
+      std::vector<std::vector<int>>({std::vector<int>({1, 2, 3}),
+                                     std::vector<int>({inline_null_array_value<int>()}),
+                                     std::vector<int>({7, 8}),
+                                     std::vector<int>({inline_null_array_value<int>()})}),
+      std::vector<std::vector<float>>(
+          {std::vector<float>({inline_null_value<float>(), 20.0f}),
+           std::vector<float>({40.0f, inline_null_value<float>()}),
+           std::vector<float>(
+               {inline_null_array_value<float>(), inline_null_value<float>()}),
+           std::vector<float>({110.f, inline_null_value<float>()})}));
+}
+
+TEST_F(ArrowStoragePersistTest, Compressed_Multifrag) {
+  {
+    ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+    ArrowStorage::TableOptions table_options(2);
+    table_options.compression = true;
+    storage.importCsvFile(
+        getFilePath("numbers_header.csv"),
+        "table1",
+        {{"col1", SQLTypeInfo(kBIGINT)}, {"col2", SQLTypeInfo(kFLOAT)}},
+        table_options);
+    storage.persistTable("table1", dir_.string());
+  }
+
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  auto tinfo = storage.loadPersistedTable(dir_.string(), "table1");
+  checkData(storage, tinfo->table_id, 9, 2, range(9, (int64_t)1), range(9, 10.0f));
+}
+
+TEST_F(ArrowStoragePersistTest, DeletedRows) {
+  {
+    ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+    ArrowStorage::TableOptions table_options(2);
+    storage.importCsvFile(
+        getFilePath("numbers_header.csv"),
+        "table1",
+        {{"col1", SQLTypeInfo(kBIGINT)}, {"col2", SQLTypeInfo(kFLOAT)}},
+        table_options);
+    storage.deleteRows("table1", {0, 8});
+    storage.persistTable("table1", dir_.string());
+  }
+
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  auto tinfo = storage.loadPersistedTable(dir_.string(), "table1");
+  ASSERT_FALSE(tinfo->delete_column);
+  checkData(storage,
+            tinfo->table_id,
+            7,
+            2,
+            std::vector<int64_t>({2, 3, 4, 5, 6, 7, 8}),
+            std::vector<float>({20.0f, 30.0f, 40.0f, 50.0f, 60.0f, 70.0f, 80.0f}));
+}
+
+TEST_F(ArrowStoragePersistTest, EmptyTable) {
+  {
+    ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+    storage.createTable("table1", {{"col1", SQLTypeInfo(kINT)}});
+    storage.persistTable("table1", dir_.string());
+  }
+
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  auto tinfo = storage.loadPersistedTable(dir_.string(), "table1");
+  ASSERT_EQ(storage.getColumnInfo(*tinfo, "col1")->type, SQLTypeInfo(kINT));
+  ASSERT_EQ(storage.getTableMetadata(TEST_DB_ID, tinfo->table_id).getNumTuples(),
+            (size_t)0);
+}
+
+TEST_F(ArrowStoragePersistTest, Overwrite) {
+  ArrowStorage::TableOptions table_options(2);
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  storage.importCsvFile(getFilePath("numbers_header.csv"),
+                        "table1",
+                        {{"col1", SQLTypeInfo(kBIGINT)}, {"col2", SQLTypeInfo(kFLOAT)}},
+                        table_options);
+  storage.persistTable("table1", dir_.string());
+  auto tinfo2 = storage.loadPersistedTable(dir_.string(), "table2");
+
+  // Files mapped by table2 are replaced with a smaller table.
+  storage.deleteRows("table1", {0, 1, 2, 3, 4, 5});
+  storage.persistTable("table1", dir_.string());
+  checkData(storage, tinfo2->table_id, 9, 2, range(9, (int64_t)1), range(9, 10.0f));
+
+  std::vector<std::string> files;
+  for (auto& entry : std::filesystem::directory_iterator(dir_)) {
+    files.push_back(entry.path().filename().string());
+  }
+  std::sort(files.begin(), files.end());
+  ASSERT_EQ(files,
+            std::vector<std::string>(
+                {"fragment_2_0.arrow"s, "fragment_2_1.arrow"s, "table.json"s}));
+
+  auto tinfo3 = storage.loadPersistedTable(dir_.string(), "table3");
+  checkData(storage,
+            tinfo3->table_id,
+            3,
+            2,
+            std::vector<int64_t>({7, 8, 9}),
+            std::vector<float>({70.0f, 80.0f, 90.0f}));
+}
+
+TEST_F(ArrowStoragePersistTest, NoMetadata) {
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  ASSERT_THROW(storage.loadPersistedTable(dir_.string(), "table1"), std::runtime_error);
+}
+
+TEST_F(ArrowStoragePersistTest, InterruptedOverwrite) {
+  ArrowStorage::TableOptions table_options(2);
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  storage.importCsvFile(getFilePath("numbers_header.csv"),
+                        "table1",
+                        {{"col1", SQLTypeInfo(kBIGINT)}, {"col2", SQLTypeInfo(kFLOAT)}},
+                        table_options);
+  storage.persistTable("table1", dir_.string());
+
+  // Files left by an interrupted write of the next generation.
+  std::ofstream(dir_ / "fragment_2_0.arrow") << "partial";
+  std::ofstream(dir_ / "fragment_2_1.arrow.tmp") << "partial";
+  std::ofstream(dir_ / "table.json.tmp") << "{";
+
+  auto tinfo2 = storage.loadPersistedTable(dir_.string(), "table2");
+  checkData(storage, tinfo2->table_id, 9, 2, range(9, (int64_t)1), range(9, 10.0f));
+
+  storage.persistTable("table1", dir_.string());
+  auto tinfo3 = storage.loadPersistedTable(dir_.string(), "table3");
+  checkData(storage, tinfo3->table_id, 9, 2, range(9, (int64_t)1), range(9, 10.0f));
+  for (auto& entry : std::filesystem::directory_iterator(dir_)) {
+    ASSERT_NE(entry.path().extension(), ".tmp");
+  }
+}
+
+TEST_F(ArrowStoragePersistTest, CorruptFragment) {
+  {
+    ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+    ArrowStorage::TableOptions table_options(2);
+    storage.importCsvFile(
+        getFilePath("numbers_header.csv"),
+        "table1",
+        {{"col1", SQLTypeInfo(kBIGINT)}, {"col2", SQLTypeInfo(kFLOAT)}},
+        table_options);
+    storage.persistTable("table1", dir_.string());
+  }
+
+  auto frag_path = dir_ / "fragment_1_1.arrow";
+  std::filesystem::resize_file(frag_path, std::filesystem::file_size(frag_path) / 2);
+
+  ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+  try {
+    storage.loadPersistedTable(dir_.string(), "table1");
+    FAIL() << "Corrupt fragment file is loaded";
+  } catch (const std::runtime_error& e) {
+    ASSERT_NE(std::string(e.what()).find(frag_path.string()), std::string::npos);
+  }
+  ASSERT_FALSE(storage.getTableInfo(TEST_DB_ID, "table1"));
+}
+
+TEST_F(ArrowStoragePersistTest, CorruptMetadata) {
+  {
+    ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+    ArrowStorage::TableOptions table_options(2);
+    storage.importCsvFile(
+        getFilePath("numbers_header.csv"),
+        "table1",
+        {{"col1", SQLTypeInfo(kBIGINT)}, {"col2", SQLTypeInfo(kFLOAT)}},
+        table_options);
+    storage.persistTable("table1", dir_.string());
+  }
+
+  auto meta_path = dir_ / "table.json";
+  std::string meta;
+  {
+    std::ifstream file(meta_path);
+    meta.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  auto write_meta = [&](const std::string& str) {
+    std::ofstream(meta_path, std::ios::trunc) << str;
+  };
+  auto expect_error = [&](const std::filesystem::path& file_path) {
+    ArrowStorage storage(TEST_SCHEMA_ID, "test", TEST_DB_ID);
+    try {
+      storage.loadPersistedTable(dir_.string(), "table1");
+      FAIL() << "Corrupt table is loaded";
+    } catch (const std::runtime_error& e) {
+      ASSERT_NE(std::string(e.what()).find(file_path.string()), std::string::npos);
+    }
+    ASSERT_FALSE(storage.getTableInfo(TEST_DB_ID, "table1"));
+  };
+
+  write_meta(meta.substr(0, meta.size() / 2));
+  expect_error(meta_path);
+
+  // Row count doesn't match the fragment file.
+  auto pos = meta.find("\"row_count\":2");
+  ASSERT_NE(pos, std::string::npos);
+  write_meta(meta.substr(0, pos) + "\"row_count\":3" + meta.substr(pos + 13));
+  expect_error(dir_ / "fragment_1_0.arrow");
+
+  // Stats of a wrong type.
+  pos = meta.find("\"min\":");
+  ASSERT_NE(pos, std::string::npos);
+  write_meta(meta.substr(0, pos) + "\"min\":\"1\"," +
+             meta.substr(meta.find(',', pos) + 1));
+  expect_error(meta_path);
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
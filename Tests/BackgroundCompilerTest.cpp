@@ -0,0 +1,92 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/BackgroundCompiler.h"
+#include "TestHelpers.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+
+TEST(BackgroundCompiler, RunTasks) {
+  BackgroundCompiler compiler(2, 100);
+  std::atomic<int> done{0};
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(compiler.submit({std::to_string(i)}, [&done]() { ++done; }));
+  }
+  compiler.waitAll();
+  EXPECT_EQ(done.load(), 10);
+  EXPECT_EQ(compiler.getPendingCount(), (size_t)0);
+}
+
+TEST(BackgroundCompiler, SkipActiveKeys) {
+  BackgroundCompiler compiler(1, 100);
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::atomic<int> done{0};
+  EXPECT_TRUE(compiler.submit({"q1"}, [released, &done]() {
+    released.wait();
+    ++done;
+  }));
+  // The same key is skipped while its task is pending or running.
+  EXPECT_FALSE(compiler.submit({"q1"}, [&done]() { ++done; }));
+  EXPECT_TRUE(compiler.submit({"q2"}, [&done]() { ++done; }));
+  release.set_value();
+  compiler.waitAll();
+  EXPECT_EQ(done.load(), 2);
+  // Finished keys can be submitted again.
+  EXPECT_TRUE(compiler.submit({"q1"}, [&done]() { ++done; }));
+  compiler.waitAll();
+  EXPECT_EQ(done.load(), 3);
+}
+
+TEST(BackgroundCompiler, DropWhenFull) {
+  BackgroundCompiler compiler(1, 1);
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::promise<void> started;
+  EXPECT_TRUE(compiler.submit({"running"}, [released, &started]() {
+    started.set_value();
+    released.wait();
+  }));
+  started.get_future().wait();
+  EXPECT_TRUE(compiler.submit({"pending"}, []() {}));
+  EXPECT_FALSE(compiler.submit({"dropped"}, []() {}));
+  EXPECT_EQ(compiler.getPendingCount(), (size_t)1);
+  release.set_value();
+  compiler.waitAll();
+}
+
+TEST(BackgroundCompiler, FailedTask) {
+  BackgroundCompiler compiler(1, 10);
+  std::atomic<int> done{0};
+  EXPECT_TRUE(compiler.submit({"fail"}, []() { throw std::runtime_error("error"); }));
+  EXPECT_TRUE(compiler.submit({"ok"}, [&done]() { ++done; }));
+  compiler.waitAll();
+  EXPECT_EQ(done.load(), 1);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,173 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/BufferMgr/CpuBufferMgr/CpuBufferMgr.h"
+#include "Shared/numa_utils.h"
+#include "TestHelpers.h"
+
+#include <gtest/gtest.h>
+
+extern std::string g_buffer_eviction_policy;
+extern std::string g_cpu_buffer_huge_pages;
+extern bool g_enable_numa_aware_buffers;
+
+using namespace Buffer_Namespace;
+
+namespace {
+
+constexpr size_t kPageSize = 512;
+constexpr size_t kChunkSize = 2 * kPageSize;
+// Single slab holding four chunks.
+constexpr size_t kPoolSize = 4 * kChunkSize;
+
+ChunkKey makeKey(int id) {
+  return {1, 1, 1, id};
+}
+
+void createChunk(BufferMgr& mgr, int id) {
+  mgr.createBuffer(makeKey(id), kPageSize, kChunkSize)->unPin();
+}
+
+void touchChunk(BufferMgr& mgr, int id) {
+  mgr.getBuffer(makeKey(id))->unPin();
+}
+
+}  // namespace
+
+class BufferMgrEvictionTest : public ::testing::Test {
+ protected:
+  void SetUp() override { saved_policy_ = g_buffer_eviction_policy; }
+  void TearDown() override { g_buffer_eviction_policy = saved_policy_; }
+
+  // Create four chunks filling the pool, access the first one again and
+  // then run a scan over four new chunks.
+  std::unique_ptr<BufferMgr> runScan(const std::string& policy) {
+    g_buffer_eviction_policy = policy;
+    auto mgr = std::make_unique<CpuBufferMgr>(
+        0, kPoolSize, nullptr, kPoolSize, kPoolSize, kPageSize);
+    for (int id = 1; id <= 4; ++id) {
+      createChunk(*mgr, id);
+    }
+    touchChunk(*mgr, 1);
+    touchChunk(*mgr, 1);
+    for (int id = 5; id <= 8; ++id) {
+      createChunk(*mgr, id);
+    }
+    return mgr;
+  }
+
+  std::string saved_policy_;
+};
+
+TEST_F(BufferMgrEvictionTest, Lru) {
+  auto mgr = runScan("lru");
+  EXPECT_EQ(mgr->getEvictionPolicyName(), "lru");
+  EXPECT_FALSE(mgr->isBufferOnDevice(makeKey(1)));
+  for (int id = 5; id <= 8; ++id) {
+    EXPECT_TRUE(mgr->isBufferOnDevice(makeKey(id)));
+  }
+  EXPECT_EQ(mgr->getNumHits(), (size_t)2);
+  EXPECT_EQ(mgr->getNumEvictions(), (size_t)4);
+}
+
+TEST_F(BufferMgrEvictionTest, Lru2) {
+  auto mgr = runScan("lru2");
+  EXPECT_EQ(mgr->getEvictionPolicyName(), "lru2");
+  // The chunk accessed more than once survives the scan.
+  EXPECT_TRUE(mgr->isBufferOnDevice(makeKey(1)));
+  EXPECT_FALSE(mgr->isBufferOnDevice(makeKey(5)));
+  for (int id = 6; id <= 8; ++id) {
+    EXPECT_TRUE(mgr->isBufferOnDevice(makeKey(id)));
+  }
+  EXPECT_EQ(mgr->getNumHits(), (size_t)2);
+  EXPECT_EQ(mgr->getNumEvictions(), (size_t)4);
+}
+
+TEST_F(BufferMgrEvictionTest, UnknownPolicy) {
+  g_buffer_eviction_policy = "fifo";
+  EXPECT_THROW(CpuBufferMgr(0, kPoolSize, nullptr, kPoolSize, kPoolSize, kPageSize),
+               std::runtime_error);
+}
+
+class BufferMgrSlabTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    saved_huge_pages_ = g_cpu_buffer_huge_pages;
+    saved_numa_aware_ = g_enable_numa_aware_buffers;
+  }
+  void TearDown() override {
+    g_cpu_buffer_huge_pages = saved_huge_pages_;
+    g_enable_numa_aware_buffers = saved_numa_aware_;
+  }
+
+  // Fill two slabs with chunks and check chunks data survives.
+  void checkSlabs() {
+    auto mgr = std::make_unique<CpuBufferMgr>(
+        0, 2 * kPoolSize, nullptr, kPoolSize, kPoolSize, kPageSize);
+    for (int id = 1; id <= 8; ++id) {
+      auto buf = mgr->createBuffer(makeKey(id), kPageSize, kChunkSize);
+      std::memset(buf->getMemoryPtr(), id, kChunkSize);
+      buf->unPin();
+    }
+    EXPECT_EQ(mgr->getNumEvictions(), (size_t)0);
+    for (int id = 1; id <= 8; ++id) {
+      auto buf = mgr->getBuffer(makeKey(id));
+      for (size_t i = 0; i < kChunkSize; ++i) {
+        ASSERT_EQ(buf->getMemoryPtr()[i], static_cast<int8_t>(id));
+      }
+      buf->unPin();
+    }
+  }
+
+  std::string saved_huge_pages_;
+  bool saved_numa_aware_;
+};
+
+TEST_F(BufferMgrSlabTest, TransparentHugePages) {
+  g_cpu_buffer_huge_pages = "thp";
+  checkSlabs();
+}
+
+TEST_F(BufferMgrSlabTest, ExplicitHugePages) {
+  // Falls back to transparent huge pages when no huge pages are reserved.
+  g_cpu_buffer_huge_pages = "2mb";
+  checkSlabs();
+}
+
+TEST_F(BufferMgrSlabTest, NumaAware) {
+  g_enable_numa_aware_buffers = true;
+  checkSlabs();
+  numa::ScopedNodeBinding binding(numa::getNodeCount() - 1);
+  EXPECT_EQ(numa::getPreferredNode(), numa::getNodeCount() - 1);
+  checkSlabs();
+}
+
+TEST_F(BufferMgrSlabTest, UnknownHugePages) {
+  g_cpu_buffer_huge_pages = "4kb";
+  EXPECT_THROW(CpuBufferMgr(0, kPoolSize, nullptr, kPoolSize, kPoolSize, kPageSize),
+               std::runtime_error);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,246 @@
+/*
+ * Copyright 2022 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/JoinHashTable/Runtime/HashJoinKeyHandlers.h"
+#include "QueryEngine/JoinHashTable/Runtime/HashJoinRuntime.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+// One-to-many table over 16M rows of 1M distinct int32 keys.
+constexpr size_t kRowCount = 16 * 1024 * 1024;
+constexpr int64_t kKeyCount = 1024 * 1024;
+
+// The second benchmark argument. With the Zipf distribution (exponent 1) the most
+// frequent key is in about 7% of the rows, so threads contend on the same slots.
+enum KeyDistribution : int64_t { kUniform = 0, kZipf = 1 };
+
+class OneToManyBuildFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    const auto key_distribution = static_cast<KeyDistribution>(state.range(1));
+    if (!keys_.empty() && key_distribution == key_distribution_) {
+      return;
+    }
+    key_distribution_ = key_distribution;
+    std::mt19937 generator(42);
+    keys_.resize(kRowCount);
+    if (key_distribution == kZipf) {
+      std::vector<double> weights(kKeyCount);
+      for (int64_t key = 0; key < kKeyCount; ++key) {
+        weights[key] = 1.0 / (key + 1);
+      }
+      std::discrete_distribution<int32_t> distribution(weights.begin(), weights.end());
+      for (auto& key : keys_) {
+        key = distribution(generator);
+      }
+    } else {
+      std::uniform_int_distribution<int32_t> distribution(0, kKeyCount - 1);
+      for (auto& key : keys_) {
+        key = distribution(generator);
+      }
+    }
+    chunk_ = {reinterpret_cast<const int8_t*>(keys_.data()), keys_.size()};
+    buff_.resize(2 * kKeyCount + kRowCount);
+  }
+
+  template <typename FILL_FUNC>
+  void build(benchmark::State& state, FILL_FUNC fill_func) {
+    const unsigned thread_count = state.range(0);
+    const JoinColumn join_column{reinterpret_cast<const int8_t*>(&chunk_),
+                                 sizeof(JoinChunk),
+                                 1,
+                                 keys_.size(),
+                                 sizeof(int32_t)};
+    const JoinColumnTypeInfo type_info{sizeof(int32_t),
+                                       0,
+                                       kKeyCount - 1,
+                                       std::numeric_limits<int32_t>::min(),
+                                       false,
+                                       kKeyCount,
+                                       ColumnType::Signed};
+    const HashEntryInfo hash_entry_info{static_cast<size_t>(kKeyCount), 1};
+    for (auto _ : state) {
+      init_hash_join_buff(buff_.data(), kKeyCount, -1, 0, 1);
+      fill_func(buff_.data(),
+                hash_entry_info,
+                -1,
+                join_column,
+                type_info,
+                nullptr,
+                0,
+                thread_count);
+      benchmark::DoNotOptimize(buff_.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kRowCount);
+  }
+
+ private:
+  std::vector<int32_t> keys_;
+  KeyDistribution key_distribution_{kUniform};
+  JoinChunk chunk_;
+  std::vector<int32_t> buff_;
+};
+
+// One-to-one keyed table over 8M distinct int32 keys in random order. With the
+// value slot and twice as many entries as keys, the table takes 128MB.
+constexpr size_t kKeyedRowCount = 8 * 1024 * 1024;
+constexpr int64_t kKeyedEntryCount = 2 * kKeyedRowCount;
+constexpr size_t kKeyedEntrySize = 2 * sizeof(int32_t);
+// Default --radix-join-partition-bytes.
+constexpr size_t kKeyedPartitionBytes = 256 * 1024;
+
+class KeyedBuildFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    if (!keys_.empty()) {
+      return;
+    }
+    keys_.resize(kKeyedRowCount);
+    std::iota(keys_.begin(), keys_.end(), 0);
+    std::shuffle(keys_.begin(), keys_.end(), std::mt19937(42));
+    chunk_ = {reinterpret_cast<const int8_t*>(keys_.data()), keys_.size()};
+    buff_.resize(kKeyedEntrySize * kKeyedEntryCount);
+  }
+
+  template <typename FILL_FUNC>
+  void build(benchmark::State& state, FILL_FUNC fill_func) {
+    const int32_t thread_count = state.range(0);
+    const JoinColumn join_column{reinterpret_cast<const int8_t*>(&chunk_),
+                                 sizeof(JoinChunk),
+                                 1,
+                                 keys_.size(),
+                                 sizeof(int32_t)};
+    const JoinColumnTypeInfo type_info{sizeof(int32_t),
+                                       0,
+                                       static_cast<int64_t>(kKeyedRowCount) - 1,
+                                       std::numeric_limits<int32_t>::min(),
+                                       false,
+                                       0,
+                                       ColumnType::Signed};
+    const GenericKeyHandler key_handler(
+        1, true, &join_column, &type_info, nullptr, nullptr);
+    for (auto _ : state) {
+      init_baseline_hash_join_buff_32(buff_.data(), kKeyedEntryCount, 1, true, -1, 0, 1);
+      if (fill_func(buff_.data(), &key_handler, thread_count)) {
+        state.SkipWithError("Keyed hash table fill failed");
+        break;
+      }
+      benchmark::DoNotOptimize(buff_.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kKeyedRowCount);
+  }
+
+ private:
+  std::vector<int32_t> keys_;
+  JoinChunk chunk_;
+  std::vector<int8_t> buff_;
+};
+
+}  // namespace
+
+BENCHMARK_DEFINE_F(OneToManyBuildFixture, Atomic)(benchmark::State& state) {
+  build(state, fill_one_to_many_hash_table);
+}
+
+BENCHMARK_DEFINE_F(OneToManyBuildFixture, Partitioned)(benchmark::State& state) {
+  build(state, fill_one_to_many_hash_table_partitioned);
+}
+
+BENCHMARK_REGISTER_F(OneToManyBuildFixture, Atomic)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 128}, {kUniform, kZipf}})
+    ->ArgNames({"threads", "keys"})
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_REGISTER_F(OneToManyBuildFixture, Partitioned)
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 128}, {kUniform, kZipf}})
+    ->ArgNames({"threads", "keys"})
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(KeyedBuildFixture, Strided)(benchmark::State& state) {
+  build(state,
+        [](int8_t* buff, const GenericKeyHandler* key_handler, int32_t thread_count) {
+          std::vector<std::future<int>> threads;
+          for (int32_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+            threads.emplace_back(std::async(std::launch::async, [=]() {
+              return fill_baseline_hash_join_buff_32(buff,
+                                                     kKeyedEntryCount,
+                                                     -1,
+                                                     false,
+                                                     1,
+                                                     true,
+                                                     key_handler,
+                                                     kKeyedRowCount,
+                                                     thread_idx,
+                                                     thread_count);
+            }));
+          }
+          int err = 0;
+          for (auto& thread : threads) {
+            err = thread.get() ? -1 : err;
+          }
+          return err;
+        });
+}
+
+BENCHMARK_DEFINE_F(KeyedBuildFixture, Partitioned)(benchmark::State& state) {
+  build(state,
+        [](int8_t* buff, const GenericKeyHandler* key_handler, int32_t thread_count) {
+          constexpr size_t partition_count =
+              kKeyedEntrySize * kKeyedEntryCount / kKeyedPartitionBytes;
+          return fill_baseline_hash_join_buff_partitioned_32(buff,
+                                                             kKeyedEntryCount,
+                                                             -1,
+                                                             false,
+                                                             1,
+                                                             true,
+                                                             key_handler,
+                                                             partition_count,
+                                                             thread_count);
+        });
+}
+
+BENCHMARK_REGISTER_F(KeyedBuildFixture, Strided)
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->ArgName("threads")
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_REGISTER_F(KeyedBuildFixture, Partitioned)
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->ArgName("threads")
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -24,20 +24,31 @@
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
 #include "QueryEngine/ExternalCacheInvalidators.h"
+#include "QueryEngine/JoinHashTable/Runtime/HashJoinRuntime.h"
 #include "QueryEngine/ResultSet.h"
+#include "Shared/scope.h"
 
 #include <gtest/gtest.h>
 #include <boost/program_options.hpp>
 
+#include <algorithm>
 #include <exception>
 #include <memory>
 #include <ostream>
+#include <random>
 #include <set>
 #include <vector>
 
 using namespace TestHelpers;
 using namespace TestHelpers::ArrowSQLRunner;
 
+extern bool g_enable_radix_partitioned_join_build;
+extern size_t g_radix_join_partition_bytes;
+extern bool g_enable_join_key_filter;
+extern bool g_enable_range_join;
+extern bool g_enable_sorted_index_join;
+extern unsigned g_trivial_loop_join_threshold;
+
 namespace {
 ExecutorDeviceType g_device_type;
 }
@@ -147,6 +158,57 @@ std::pair<std::string, std::shared_ptr<HashJoin>> checkProperQualDetection(
                                         executor.get());
 }
 
+using OneToManyFillFunc = decltype(&fill_one_to_many_hash_table);
+
+// Fills a one-to-many table with the atomic and the partitioned builds and checks the
+// slots of both tables have the same positions, counts and row ids.
+template <typename T>
+void checkPartitionedOneToMany(const std::vector<T>& keys,
+                               const JoinColumnTypeInfo& type_info,
+                               const HashEntryInfo& hash_entry_info,
+                               const size_t entry_count,
+                               OneToManyFillFunc fill_func,
+                               OneToManyFillFunc partitioned_fill_func,
+                               const unsigned thread_count) {
+  const JoinChunk chunk{reinterpret_cast<const int8_t*>(keys.data()), keys.size()};
+  const JoinColumn join_column{reinterpret_cast<const int8_t*>(&chunk),
+                               sizeof(JoinChunk),
+                               1,
+                               keys.size(),
+                               sizeof(T)};
+  const auto build = [&](OneToManyFillFunc func) {
+    std::vector<int32_t> buff(2 * entry_count + keys.size());
+    init_hash_join_buff(buff.data(), entry_count, -1, 0, 1);
+    func(buff.data(),
+         hash_entry_info,
+         -1,
+         join_column,
+         type_info,
+         nullptr,
+         0,
+         thread_count);
+    return buff;
+  };
+  const auto expected = build(fill_func);
+  const auto actual = build(partitioned_fill_func);
+  const auto get_row_ids = [entry_count](const std::vector<int32_t>& buff,
+                                         const size_t slot) {
+    const auto begin = buff.begin() + 2 * entry_count + buff[slot];
+    std::vector<int32_t> row_ids(begin, begin + buff[entry_count + slot]);
+    std::sort(row_ids.begin(), row_ids.end());
+    return row_ids;
+  };
+  for (size_t slot = 0; slot < entry_count; ++slot) {
+    ASSERT_EQ(expected[slot], actual[slot]) << "slot " << slot;
+    ASSERT_EQ(expected[entry_count + slot], actual[entry_count + slot])
+        << "slot " << slot;
+    if (expected[entry_count + slot]) {
+      ASSERT_EQ(get_row_ids(expected, slot), get_row_ids(actual, slot))
+          << "slot " << slot;
+    }
+  }
+}
+
 TEST(Build, PerfectOneToOne1) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -455,6 +517,355 @@ TEST(Build, KeyedOneToMany) {
   }
 }
 
+TEST(Build, KeyedRadixPartitioned) {
+  auto executor =
+      Executor::getExecutor(TEST_DB_ID, getDataMgr(), getDataMgr()->getBufferProvider());
+  CHECK(executor);
+  auto storage = getStorage();
+  executor->setSchemaProvider(storage);
+
+  const auto partitioned_build = g_enable_radix_partitioned_join_build;
+  const auto partition_bytes = g_radix_join_partition_bytes;
+  ScopeGuard reset_flags([&]() {
+    g_enable_radix_partitioned_join_build = partitioned_build;
+    g_radix_join_partition_bytes = partition_bytes;
+  });
+
+  g_device_type = ExecutorDeviceType::CPU;
+
+  // The second table has every key twice, its hash table is one-to-many.
+  constexpr int row_count = 100'000;
+  for (int dup_count : {1, 2}) {
+    createTable("table1", {{"a1", SQLTypeInfo(kINT)}, {"a2", SQLTypeInfo(kINT)}});
+    insertCsvValues("table1", "1,2");
+
+    std::string csv;
+    for (int i = 0; i < row_count; ++i) {
+      const int key = i / dup_count;
+      csv += std::to_string(key) + "," + std::to_string(key % 1000) + "\n";
+    }
+    createTable("table2", {{"b1", SQLTypeInfo(kINT)}, {"b2", SQLTypeInfo(kINT)}});
+    insertCsvValues("table2", csv);
+
+    auto a1 = getSyntheticColumnVar(TEST_DB_ID, "table1", "a1", 0, executor.get());
+    auto a2 = getSyntheticColumnVar(TEST_DB_ID, "table1", "a2", 0, executor.get());
+    auto b1 = getSyntheticColumnVar(TEST_DB_ID, "table2", "b1", 1, executor.get());
+    auto b2 = getSyntheticColumnVar(TEST_DB_ID, "table2", "b2", 1, executor.get());
+
+    using VE = std::vector<std::shared_ptr<Analyzer::Expr>>;
+    auto et1 = std::make_shared<Analyzer::ExpressionTuple>(VE{a1, a2});
+    auto et2 = std::make_shared<Analyzer::ExpressionTuple>(VE{b1, b2});
+    // a1 = b1 and a2 = b2
+    auto op = std::make_shared<Analyzer::BinOper>(kBOOLEAN, kEQ, kONE, et1, et2);
+
+    std::vector<DecodedJoinHashBufferSet> sets;
+    for (bool partitioned : {false, true}) {
+      JoinHashTableCacheInvalidator::invalidateCaches();
+      g_enable_radix_partitioned_join_build = partitioned;
+      // Force partitioning of the small test table.
+      g_radix_join_partition_bytes = 4096;
+
+      auto hash_table = buildKeyed(op);
+      EXPECT_EQ(hash_table->getHashType(),
+                dup_count == 1 ? HashType::OneToOne : HashType::OneToMany);
+      sets.push_back(hash_table->toSet(g_device_type, 0));
+    }
+    EXPECT_EQ(sets[0].size(), static_cast<size_t>(row_count / dup_count));
+    EXPECT_EQ(sets[0], sets[1]);
+
+    dropTable("table1");
+    dropTable("table2");
+  }
+}
+
+TEST(Build, KeyFilters) {
+  g_device_type = ExecutorDeviceType::CPU;
+  JoinHashTableCacheInvalidator::invalidateCaches();
+
+  ArrowStorage::TableOptions small_frag_opts;
+  small_frag_opts.fragment_size = 5;
+  createTable("table1", {{"a", SQLTypeInfo(kINT)}}, small_frag_opts);
+  std::string csv;
+  for (int i = 0; i < 20; ++i) {
+    csv += std::to_string(i) + "\n";
+  }
+  insertCsvValues("table1", csv);
+
+  createTable("table2", {{"b", SQLTypeInfo(kINT)}});
+  insertCsvValues("table2", "7\n8\n1000");
+
+  auto hash_table = buildPerfect("table1", "a", "table2", "b");
+  const auto& key_filters = hash_table->getHashTableForDevice(0)->getKeyFilters();
+  ASSERT_EQ(key_filters.size(), size_t(1));
+  ASSERT_TRUE(key_filters[0]);
+  EXPECT_EQ(key_filters[0]->getMin(), 7);
+  EXPECT_EQ(key_filters[0]->getMax(), 1000);
+  EXPECT_TRUE(key_filters[0]->mayContain(5, 9));
+  EXPECT_TRUE(key_filters[0]->mayContain(1000, 2000));
+  EXPECT_FALSE(key_filters[0]->mayContain(0, 4));
+  EXPECT_FALSE(key_filters[0]->mayContain(10, 999));
+  EXPECT_FALSE(key_filters[0]->mayContain(1001, 2000));
+
+  // Only the second fragment of table1 has matches, the results must not change
+  // when the other fragments are skipped.
+  const auto join_key_filter = g_enable_join_key_filter;
+  ScopeGuard reset_flag([&]() { g_enable_join_key_filter = join_key_filter; });
+  for (bool enable_filter : {false, true}) {
+    g_enable_join_key_filter = enable_filter;
+    JoinHashTableCacheInvalidator::invalidateCaches();
+    EXPECT_EQ(v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM table1, table2 WHERE table1.a = table2.b;",
+                  ExecutorDeviceType::CPU)),
+              2);
+    EXPECT_EQ(v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM table1 WHERE a IN (SELECT b FROM table2);",
+                  ExecutorDeviceType::CPU)),
+              2);
+    EXPECT_EQ(v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM table1 LEFT JOIN table2 "
+                                        "ON table1.a = table2.b;",
+                                        ExecutorDeviceType::CPU)),
+              20);
+  }
+
+  dropTable("table1");
+  dropTable("table2");
+}
+
+TEST(Build, RangeJoin) {
+  g_device_type = ExecutorDeviceType::CPU;
+  JoinHashTableCacheInvalidator::invalidateCaches();
+
+  createTable("table1", {{"a", SQLTypeInfo(kINT)}});
+  std::string csv;
+  for (int i = 0; i < 100; ++i) {
+    csv += std::to_string(i) + "\n";
+  }
+  insertCsvValues("table1", csv);
+
+  createTable("table2", {{"s", SQLTypeInfo(kINT)}, {"e", SQLTypeInfo(kINT)}});
+  insertCsvValues("table2", "10,19\n50,54\n90,200\n30,20");
+
+  const auto range_join = g_enable_range_join;
+  const auto trivial_loop_join_threshold = g_trivial_loop_join_threshold;
+  ScopeGuard reset_flags([&]() {
+    g_enable_range_join = range_join;
+    g_trivial_loop_join_threshold = trivial_loop_join_threshold;
+  });
+  // Loop joins are not allowed for the queries below, they only run with the range
+  // hash table.
+  g_trivial_loop_join_threshold = 1;
+  const std::vector<std::pair<std::string, int64_t>> queries{
+      {"SELECT COUNT(*) FROM table1, table2 WHERE table1.a BETWEEN table2.s AND "
+       "table2.e;",
+       25},
+      {"SELECT COUNT(*) FROM table1, table2 WHERE table1.a < table2.s;", 180},
+      {"SELECT COUNT(*) FROM table1 LEFT JOIN table2 ON table1.a >= table2.s AND "
+       "table1.a <= table2.e;",
+       100}};
+  for (const auto& [query, expected] : queries) {
+    g_enable_range_join = false;
+    EXPECT_ANY_THROW(run_simple_agg(query, ExecutorDeviceType::CPU, false));
+    EXPECT_EQ(v<int64_t>(run_simple_agg(query, ExecutorDeviceType::CPU)), expected);
+    g_enable_range_join = true;
+    EXPECT_EQ(v<int64_t>(run_simple_agg(query, ExecutorDeviceType::CPU, false)),
+              expected);
+  }
+  // The BETWEEN and the LEFT JOIN queries share the table sorted by table2.s.
+  EXPECT_EQ(RangeJoinHashTable::getHashTableCache()->getCurrentNumCachedItems(
+                CacheItemType::RANGE_HT, DataRecyclerUtil::CPU_DEVICE_IDENTIFIER),
+            size_t(2));
+
+  // Semi and anti joins are not run with the range hash table, they fall back to
+  // loop joins.
+  const std::vector<std::pair<std::string, int64_t>> semi_anti_queries{
+      {"SELECT COUNT(*) FROM table1 WHERE EXISTS (SELECT * FROM table2 WHERE "
+       "table1.a >= table2.s AND table1.a <= table2.e);",
+       25},
+      {"SELECT COUNT(*) FROM table1 WHERE NOT EXISTS (SELECT * FROM table2 WHERE "
+       "table1.a >= table2.s AND table1.a <= table2.e);",
+       75}};
+  for (const auto& [query, expected] : semi_anti_queries) {
+    EXPECT_EQ(v<int64_t>(run_simple_agg(query, ExecutorDeviceType::CPU)), expected);
+  }
+  EXPECT_EQ(RangeJoinHashTable::getHashTableCache()->getCurrentNumCachedItems(
+                CacheItemType::RANGE_HT, DataRecyclerUtil::CPU_DEVICE_IDENTIFIER),
+            size_t(2));
+
+  // Replacing a row keeps the table size, the cached table must not be reused
+  // for the modified data.
+  arrow::Int32Builder s_builder;
+  arrow::Int32Builder e_builder;
+  ASSERT_TRUE(s_builder.Append(60).ok());
+  ASSERT_TRUE(e_builder.Append(64).ok());
+  auto at = arrow::Table::Make(arrow::schema({arrow::field("s", arrow::int32()),
+                                              arrow::field("e", arrow::int32())}),
+                               {s_builder.Finish().ValueOrDie(),
+                                e_builder.Finish().ValueOrDie()});
+  getStorage()->updateRows("table2", {0}, at);
+  getStorage()->compactTable("table2");
+  EXPECT_EQ(v<int64_t>(run_simple_agg(queries[0].first, ExecutorDeviceType::CPU, false)),
+            20);
+
+  dropTable("table1");
+  dropTable("table2");
+}
+
+TEST(Build, SortedIndexJoin) {
+  g_device_type = ExecutorDeviceType::CPU;
+  JoinHashTableCacheInvalidator::invalidateCaches();
+
+  // The keys are too sparse for a perfect hash table.
+  constexpr int64_t key_step = 1'000'000'000'000;
+  ArrowStorage::TableOptions small_frag_opts;
+  small_frag_opts.fragment_size = 5;
+  createTable("table1", {{"a", SQLTypeInfo(kBIGINT)}}, small_frag_opts);
+  std::string csv;
+  for (int i = 0; i < 30; ++i) {
+    csv += std::to_string(i * key_step) + "\n";
+  }
+  insertCsvValues("table1", csv);
+
+  // Every even key twice, sorted in table2 and in reverse order in table3.
+  std::vector<int64_t> keys;
+  for (int i = 0; i < 20; ++i) {
+    keys.push_back((i / 2) * 2 * key_step);
+  }
+  for (const auto& table : {"table2", "table3"}) {
+    createTable(table, {{"b", SQLTypeInfo(kBIGINT)}}, small_frag_opts);
+    csv.clear();
+    for (auto key : keys) {
+      csv += std::to_string(key) + "\n";
+    }
+    insertCsvValues(table, csv);
+    std::reverse(keys.begin(), keys.end());
+  }
+
+  const auto sorted_index_join = g_enable_sorted_index_join;
+  ScopeGuard reset_flag([&]() { g_enable_sorted_index_join = sorted_index_join; });
+  for (bool enable_sorted_index_join : {false, true}) {
+    g_enable_sorted_index_join = enable_sorted_index_join;
+    JoinHashTableCacheInvalidator::invalidateCaches();
+    for (const std::string table : {"table2", "table3"}) {
+      EXPECT_EQ(v<int64_t>(run_simple_agg(
+                    "SELECT COUNT(*) FROM table1, " + table + " WHERE table1.a = " +
+                        table + ".b;",
+                    ExecutorDeviceType::CPU)),
+                20);
+      EXPECT_EQ(v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM table1 LEFT JOIN " +
+                                              table + " ON table1.a = " + table + ".b;",
+                                          ExecutorDeviceType::CPU)),
+                40);
+      // Semi and anti joins use the keyed hash table.
+      EXPECT_EQ(v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM table1 WHERE a IN "
+                                          "(SELECT b FROM " +
+                                              table + ");",
+                                          ExecutorDeviceType::CPU)),
+                10);
+      EXPECT_EQ(v<int64_t>(run_simple_agg(
+                    "SELECT COUNT(*) FROM table1 WHERE NOT EXISTS (SELECT * FROM " +
+                        table + " WHERE " + table + ".b = table1.a);",
+                    ExecutorDeviceType::CPU)),
+                20);
+    }
+    // Only the sorted table2 is probed by the sorted index.
+    EXPECT_EQ(RangeJoinHashTable::getHashTableCache()->getCurrentNumCachedItems(
+                  CacheItemType::RANGE_HT, DataRecyclerUtil::CPU_DEVICE_IDENTIFIER),
+              enable_sorted_index_join ? size_t(1) : size_t(0));
+  }
+
+  dropTable("table1");
+  dropTable("table2");
+  dropTable("table3");
+}
+
+TEST(Build, PartitionedOneToMany) {
+  constexpr int32_t null_val = std::numeric_limits<int32_t>::min();
+  constexpr int64_t key_count = 1000;
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int32_t> key_distribution(0, key_count - 1);
+  std::vector<int32_t> keys(20000);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    // Every tenth key is a null and a third of the keys are the same to skew the
+    // partition of that key.
+    keys[i] = i % 10 == 0 ? null_val : i % 3 == 0 ? 7 : key_distribution(generator);
+  }
+  for (const bool uses_bw_eq : {false, true}) {
+    // The bitwise equality join stores the nulls in an extra slot after the keys.
+    const size_t entry_count = key_count + (uses_bw_eq ? 1 : 0);
+    const JoinColumnTypeInfo type_info{sizeof(int32_t),
+                                       0,
+                                       key_count - 1,
+                                       null_val,
+                                       uses_bw_eq,
+                                       key_count,
+                                       ColumnType::Signed};
+    const HashEntryInfo hash_entry_info{entry_count, 1};
+    for (const unsigned thread_count : {1u, 3u, 16u}) {
+      checkPartitionedOneToMany(keys,
+                                type_info,
+                                hash_entry_info,
+                                entry_count,
+                                fill_one_to_many_hash_table,
+                                fill_one_to_many_hash_table_partitioned,
+                                thread_count);
+    }
+  }
+
+  // More threads than rows and partitions without rows.
+  const std::vector<int32_t> few_keys{3, null_val, 3, 998};
+  const JoinColumnTypeInfo type_info{sizeof(int32_t),
+                                     0,
+                                     key_count - 1,
+                                     null_val,
+                                     false,
+                                     key_count,
+                                     ColumnType::Signed};
+  for (const unsigned thread_count : {8u, 64u}) {
+    checkPartitionedOneToMany(few_keys,
+                              type_info,
+                              HashEntryInfo{key_count, 1},
+                              key_count,
+                              fill_one_to_many_hash_table,
+                              fill_one_to_many_hash_table_partitioned,
+                              thread_count);
+  }
+}
+
+TEST(Build, PartitionedOneToManyBucketized) {
+  // DATE keys are stored in seconds and bucketized by days.
+  constexpr int64_t seconds_per_day = 86400;
+  constexpr int64_t day_count = 500;
+  constexpr int64_t min_date = 18000 * seconds_per_day;
+  constexpr int64_t null_val = std::numeric_limits<int64_t>::min();
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int64_t> date_distribution(0, day_count - 1);
+  std::vector<int64_t> keys(10000);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    keys[i] = i % 10 == 0  ? null_val
+              : i % 4 == 0 ? min_date
+                           : min_date + date_distribution(generator) * seconds_per_day;
+  }
+  const int64_t max_date = min_date + (day_count - 1) * seconds_per_day;
+  const JoinColumnTypeInfo type_info{sizeof(int64_t),
+                                     min_date,
+                                     max_date,
+                                     null_val,
+                                     false,
+                                     max_date + 1,
+                                     ColumnType::Signed};
+  const HashEntryInfo hash_entry_info{static_cast<size_t>(max_date - min_date + 1),
+                                      seconds_per_day};
+  for (const unsigned thread_count : {1u, 5u, 32u}) {
+    checkPartitionedOneToMany(keys,
+                              type_info,
+                              hash_entry_info,
+                              hash_entry_info.getNormalizedHashEntryCount(),
+                              fill_one_to_many_hash_table_bucketized,
+                              fill_one_to_many_hash_table_partitioned_bucketized,
+                              thread_count);
+  }
+}
+
 TEST(MultiFragment, PerfectOneToOne) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -0,0 +1,163 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/KernelScheduler.h"
+#include "TestHelpers.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void waitForWaiters(const KernelScheduler& scheduler, size_t num_waiters) {
+  while (scheduler.numWaitingKernels() != num_waiters) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+}  // namespace
+
+TEST(KernelScheduler, SlotsAreShared) {
+  KernelScheduler scheduler(2);
+  KernelScheduler::Query q1(scheduler, 0, 0);
+  KernelScheduler::Query q2(scheduler, 0, 0);
+  q1.acquireSlot();
+  q2.acquireSlot();
+  EXPECT_EQ(scheduler.numRunningKernels(), (size_t)2);
+
+  std::thread t([&]() {
+    q1.acquireSlot();
+    q1.releaseSlot();
+  });
+  waitForWaiters(scheduler, 1);
+  q2.releaseSlot();
+  t.join();
+  EXPECT_EQ(scheduler.numRunningKernels(), (size_t)1);
+  q1.releaseSlot();
+  EXPECT_EQ(scheduler.numRunningKernels(), (size_t)0);
+}
+
+TEST(KernelScheduler, Priority) {
+  KernelScheduler scheduler(1);
+  KernelScheduler::Query scan(scheduler, 0, 0);
+  KernelScheduler::Query low(scheduler, 0, 0);
+  KernelScheduler::Query high(scheduler, 1, 0);
+  scan.acquireSlot();
+
+  std::mutex order_mutex;
+  std::vector<int> order;
+  auto run_kernel = [&](KernelScheduler::Query& query, int id) {
+    query.acquireSlot();
+    {
+      std::lock_guard<std::mutex> lock(order_mutex);
+      order.push_back(id);
+    }
+    query.releaseSlot();
+  };
+  std::thread t1([&]() { run_kernel(low, 1); });
+  waitForWaiters(scheduler, 1);
+  std::thread t2([&]() { run_kernel(high, 2); });
+  waitForWaiters(scheduler, 2);
+
+  scan.releaseSlot();
+  t1.join();
+  t2.join();
+  EXPECT_EQ(order, std::vector<int>({2, 1}));
+}
+
+TEST(KernelScheduler, FairShare) {
+  KernelScheduler scheduler(2);
+  KernelScheduler::Query scan(scheduler, 0, 0);
+  KernelScheduler::Query dashboard(scheduler, 0, 0);
+  scan.acquireSlot();
+  scan.acquireSlot();
+
+  // The scan asks for its next slot first, but the query with no running
+  // kernels gets the free slot.
+  std::thread t1([&]() { scan.acquireSlot(); });
+  waitForWaiters(scheduler, 1);
+  std::thread t2([&]() { dashboard.acquireSlot(); });
+  waitForWaiters(scheduler, 2);
+
+  scan.releaseSlot();
+  t2.join();
+  EXPECT_EQ(scheduler.numWaitingKernels(), (size_t)1);
+  dashboard.releaseSlot();
+  t1.join();
+  scan.releaseSlot();
+  scan.releaseSlot();
+  EXPECT_EQ(scheduler.numRunningKernels(), (size_t)0);
+}
+
+TEST(KernelScheduler, QueryLimit) {
+  KernelScheduler scheduler(4);
+  KernelScheduler::Query limited(scheduler, 1, 1);
+  KernelScheduler::Query other(scheduler, 0, 0);
+  limited.acquireSlot();
+
+  std::thread t([&]() {
+    limited.acquireSlot();
+    limited.releaseSlot();
+  });
+  waitForWaiters(scheduler, 1);
+  // A blocked query doesn't block other queries despite its priority.
+  other.acquireSlot();
+  other.releaseSlot();
+  EXPECT_EQ(scheduler.numWaitingKernels(), (size_t)1);
+
+  limited.releaseSlot();
+  t.join();
+  EXPECT_EQ(scheduler.numRunningKernels(), (size_t)0);
+}
+
+TEST(KernelScheduler, Interrupt) {
+  KernelScheduler scheduler(1);
+  std::atomic<bool> interrupted{false};
+  KernelScheduler::Query scan(scheduler, 0, 0);
+  KernelScheduler::Query query(scheduler, 0, 0, &interrupted);
+  scan.acquireSlot();
+
+  std::optional<int64_t> wait_ms{0};
+  std::thread t([&]() { wait_ms = query.acquireSlot(); });
+  waitForWaiters(scheduler, 1);
+  interrupted = true;
+  scheduler.notifyInterrupted();
+  t.join();
+  EXPECT_FALSE(wait_ms);
+  EXPECT_EQ(scheduler.numWaitingKernels(), (size_t)0);
+  EXPECT_EQ(scheduler.numRunningKernels(), (size_t)1);
+
+  // An interrupted query doesn't get new slots even if they are free.
+  scan.releaseSlot();
+  EXPECT_FALSE(query.acquireSlot());
+  EXPECT_EQ(scheduler.numRunningKernels(), (size_t)0);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,133 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/MorselDispenser.h"
+#include "TestHelpers.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+TEST(MorselDispenser, AllRowsProcessedOnce) {
+  constexpr size_t kNumSources = 5;
+  constexpr size_t kRows = 1000;
+  MorselDispenser dispenser;
+  std::vector<std::vector<std::atomic<int>>> hits(kNumSources);
+  for (size_t i = 0; i < kNumSources; ++i) {
+    hits[i] = std::vector<std::atomic<int>>(kRows);
+    dispenser.addSource(10 * i, kRows, 7, -1, [&hits, i](size_t start, size_t num) {
+      for (size_t row = start; row < start + num; ++row) {
+        ++hits[i][row];
+      }
+    });
+  }
+
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < 4; ++i) {
+    workers.emplace_back([&dispenser, i]() { dispenser.runWorker(i % 2); });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  for (size_t i = 0; i < kNumSources; ++i) {
+    for (size_t row = 0; row < kRows; ++row) {
+      ASSERT_EQ(hits[i][row], row < 10 * i ? 0 : 1);
+    }
+  }
+  size_t morsels = 0;
+  for (const auto& [thread_id, stats] : dispenser.getThreadStats()) {
+    morsels += stats.morsels;
+  }
+  // Source i has ceil((1000 - 10 * i) / 7) morsels.
+  EXPECT_EQ(morsels, (size_t)(143 + 142 + 140 + 139 + 138));
+}
+
+TEST(MorselDispenser, StealingPrefersLocalNode) {
+  MorselDispenser dispenser;
+  std::vector<size_t> order;
+  auto make_fn = [&order](size_t source) {
+    return [&order, source](size_t, size_t) { order.push_back(source); };
+  };
+  dispenser.addSource(0, 10, 10, 0, make_fn(0));
+  dispenser.addSource(0, 30, 10, 1, make_fn(1));
+  dispenser.addSource(0, 20, 10, 0, make_fn(2));
+  dispenser.runWorker(0);
+  EXPECT_EQ(order, std::vector<size_t>({0, 2, 2, 1, 1, 1}));
+
+  auto stats = dispenser.getThreadStats().at(std::this_thread::get_id());
+  EXPECT_EQ(stats.morsels, (size_t)6);
+  EXPECT_EQ(stats.stolen_morsels, (size_t)5);
+}
+
+TEST(MorselDispenser, WorkersToLaunch) {
+  MorselDispenser dispenser;
+  auto small = dispenser.addSource(0, 25, 10, -1, [](size_t, size_t) {});
+  auto large = dispenser.addSource(0, 1000, 10, -1, [](size_t, size_t) {});
+  auto empty = dispenser.addSource(5, 5, 10, -1, [](size_t, size_t) {});
+  EXPECT_EQ(dispenser.workersToLaunch(small, 8), (size_t)3);
+  EXPECT_EQ(dispenser.workersToLaunch(large, 8), (size_t)8);
+  EXPECT_EQ(dispenser.workersToLaunch(empty, 8), (size_t)0);
+}
+
+TEST(MorselDispenser, ErrorStopsWorkers) {
+  MorselDispenser dispenser;
+  size_t processed = 0;
+  dispenser.addSource(0, 100, 10, -1, [&processed](size_t start, size_t) {
+    if (start == 20) {
+      throw std::runtime_error("morsel failed");
+    }
+    ++processed;
+  });
+  EXPECT_THROW(dispenser.runWorker(0), std::runtime_error);
+  EXPECT_EQ(processed, (size_t)2);
+  // Other workers don't take morsels after the failure.
+  dispenser.runWorker(0);
+  EXPECT_EQ(processed, (size_t)2);
+}
+
+TEST(MorselDispenser, FunctionReleasedWhenSourceDone) {
+  MorselDispenser dispenser;
+  auto done = std::make_shared<int>(0);
+  auto failed = std::make_shared<int>(0);
+  dispenser.addSource(0, 25, 10, -1, [done](size_t, size_t) {});
+  dispenser.addSource(0, 25, 10, -1, [failed](size_t start, size_t) {
+    if (start == 10) {
+      throw std::runtime_error("morsel failed");
+    }
+  });
+  EXPECT_EQ(done.use_count(), 2);
+  EXPECT_EQ(failed.use_count(), 2);
+
+  // Captured resources are released with the last morsel of the source.
+  EXPECT_THROW(dispenser.runWorker(0), std::runtime_error);
+  EXPECT_EQ(done.use_count(), 1);
+  EXPECT_EQ(failed.use_count(), 2);
+  // Sources left unfinished are released explicitly.
+  dispenser.releaseSources();
+  EXPECT_EQ(failed.use_count(), 1);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
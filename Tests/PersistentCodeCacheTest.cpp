@@ -0,0 +1,116 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/PersistentCodeCache.h"
+#include "TestHelpers.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+#include <unistd.h>
+
+namespace {
+
+class PersistentCodeCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() /
+           ("persistent_code_cache_test_" + std::to_string(getpid()));
+    std::filesystem::remove_all(dir_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  std::filesystem::path dir_;
+};
+
+}  // namespace
+
+TEST_F(PersistentCodeCacheTest, StoreAndLoad) {
+  const std::string obj = std::string("object\0code", 11);
+  {
+    PersistentCodeCache cache(dir_.string(), 1 << 20);
+    EXPECT_FALSE(cache.load("query1"));
+    cache.store("query1", obj.data(), obj.size());
+    EXPECT_GT(cache.getUsedBytes(), obj.size());
+  }
+  // Entries survive a restart.
+  PersistentCodeCache cache(dir_.string(), 1 << 20);
+  auto loaded = cache.load("query1");
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(*loaded, obj);
+  EXPECT_FALSE(cache.load("query2"));
+
+  const std::string new_obj = "new object";
+  cache.store("query1", new_obj.data(), new_obj.size());
+  loaded = cache.load("query1");
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(*loaded, new_obj);
+}
+
+TEST_F(PersistentCodeCacheTest, KeyMismatch) {
+  PersistentCodeCache cache(dir_.string(), 1 << 20);
+  const std::string obj = "object";
+  cache.store("query1", obj.data(), obj.size());
+  // Replace the entry with one stored for another key to emulate a hash collision.
+  auto it = std::filesystem::directory_iterator(dir_);
+  ASSERT_NE(it, std::filesystem::directory_iterator());
+  const auto path = it->path();
+  {
+    PersistentCodeCache other_cache((dir_ / "other").string(), 1 << 20);
+    other_cache.store("query2", obj.data(), obj.size());
+    auto other_it = std::filesystem::directory_iterator(dir_ / "other");
+    std::filesystem::rename(other_it->path(), path);
+  }
+  EXPECT_FALSE(cache.load("query1"));
+}
+
+TEST_F(PersistentCodeCacheTest, Eviction) {
+  const std::string obj(1000, 'x');
+  PersistentCodeCache cache(dir_.string(), 2500);
+  cache.store("query1", obj.data(), obj.size());
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  cache.store("query2", obj.data(), obj.size());
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  // A load makes query1 the most recently used entry.
+  EXPECT_TRUE(cache.load("query1"));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  cache.store("query3", obj.data(), obj.size());
+  EXPECT_TRUE(cache.load("query1"));
+  EXPECT_FALSE(cache.load("query2"));
+  EXPECT_TRUE(cache.load("query3"));
+  EXPECT_LE(cache.getUsedBytes(), (size_t)2500);
+
+  // Entries larger than the limit are not stored.
+  const std::string big_obj(3000, 'x');
+  cache.store("query4", big_obj.data(), big_obj.size());
+  EXPECT_FALSE(cache.load("query4"));
+  EXPECT_TRUE(cache.load("query3"));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,152 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/QueryDispatchQueue.h"
+#include "TestHelpers.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using Priority = QueryDispatchQueue::Priority;
+using TaskDescriptor = QueryDispatchQueue::TaskDescriptor;
+
+// Runs tasks on a single worker which is blocked until release() is called, so
+// the order of all tasks submitted before the release is defined by the queue.
+class OrderedRun {
+ public:
+  explicit OrderedRun(QueryDispatchQueue::Config config = {}) : queue_(1, config) {
+    auto blocker = std::make_shared<QueryDispatchQueue::Task>(
+        [this](size_t) { release_future_.wait(); });
+    tasks_.push_back(blocker);
+    queue_.submit(blocker, false);
+    while (queue_.getStats().running != 1) {
+      std::this_thread::yield();
+    }
+  }
+
+  void submit(int id, const TaskDescriptor& desc) {
+    auto task = std::make_shared<QueryDispatchQueue::Task>([this, id](size_t) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      order_.push_back(id);
+    });
+    tasks_.push_back(task);
+    queue_.submit(task, false, desc);
+  }
+
+  std::vector<int> run() {
+    release_.set_value();
+    for (auto& task : tasks_) {
+      task->get_future().wait();
+    }
+    return order_;
+  }
+
+  QueryDispatchQueue& queue() { return queue_; }
+
+ private:
+  std::promise<void> release_;
+  std::shared_future<void> release_future_{release_.get_future()};
+  std::mutex mutex_;
+  std::vector<int> order_;
+  std::vector<std::shared_ptr<QueryDispatchQueue::Task>> tasks_;
+  QueryDispatchQueue queue_;
+};
+
+}  // namespace
+
+TEST(QueryDispatchQueue, Fifo) {
+  OrderedRun run;
+  for (int id = 1; id <= 4; ++id) {
+    run.submit(id, {});
+  }
+  EXPECT_EQ(run.run(), std::vector<int>({1, 2, 3, 4}));
+}
+
+TEST(QueryDispatchQueue, PriorityClasses) {
+  OrderedRun run;
+  run.submit(1, {"", Priority::kBatch, 0});
+  run.submit(2, {"", Priority::kNormal, 0});
+  run.submit(3, {"", Priority::kInteractive, 0});
+  run.submit(4, {"", Priority::kNormal, 0});
+  EXPECT_EQ(run.run(), std::vector<int>({3, 2, 4, 1}));
+}
+
+TEST(QueryDispatchQueue, CostClassification) {
+  QueryDispatchQueue::Config config;
+  config.interactive_cost = 10;
+  config.batch_cost = 1000;
+  OrderedRun run(config);
+  run.submit(1, {"", Priority::kAuto, 5000});
+  run.submit(2, {"", Priority::kAuto, 100});
+  run.submit(3, {"", Priority::kAuto, 5});
+  // Unknown cost.
+  run.submit(4, {"", Priority::kAuto, 0});
+  auto stats = run.queue().getStats();
+  EXPECT_EQ(stats.queue_depth, (size_t)4);
+  EXPECT_EQ(stats.queue_depth_per_priority[0], (size_t)1);
+  EXPECT_EQ(stats.queue_depth_per_priority[1], (size_t)2);
+  EXPECT_EQ(stats.queue_depth_per_priority[2], (size_t)1);
+  EXPECT_EQ(run.run(), std::vector<int>({3, 2, 4, 1}));
+}
+
+TEST(QueryDispatchQueue, FairSessions) {
+  OrderedRun run;
+  for (int id = 1; id <= 3; ++id) {
+    run.submit(id, {"a", Priority::kNormal, 1});
+  }
+  for (int id = 4; id <= 6; ++id) {
+    run.submit(id, {"b", Priority::kNormal, 1});
+  }
+  EXPECT_EQ(run.run(), std::vector<int>({1, 4, 2, 5, 3, 6}));
+}
+
+TEST(QueryDispatchQueue, WeightedSessions) {
+  OrderedRun run;
+  run.queue().setSessionWeight("b", 2.0);
+  for (int id = 1; id <= 2; ++id) {
+    run.submit(id, {"a", Priority::kNormal, 1});
+  }
+  for (int id = 3; id <= 6; ++id) {
+    run.submit(id, {"b", Priority::kNormal, 1});
+  }
+  EXPECT_EQ(run.run(), std::vector<int>({1, 3, 4, 2, 5, 6}));
+}
+
+TEST(QueryDispatchQueue, Aging) {
+  QueryDispatchQueue::Config config;
+  config.aging_interval = std::chrono::milliseconds(50);
+  OrderedRun run(config);
+  run.submit(1, {"", Priority::kBatch, 0});
+  std::this_thread::sleep_for(std::chrono::milliseconds(120));
+  run.submit(2, {"", Priority::kInteractive, 0});
+  // The batch query waited long enough to be promoted to the interactive class.
+  EXPECT_EQ(run.run(), std::vector<int>({1, 2}));
+  auto stats = run.queue().getStats();
+  EXPECT_EQ(stats.dispatched, (size_t)3);
+  EXPECT_GE(stats.max_wait_ms, 100);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -998,6 +998,11 @@ std::vector<OneRow> get_rows_sorted_by_col(ResultSet& rs, const size_t col_idx)
   return result;
 }
 
+void check_reduced_rows(ResultSet* result_rs,
+                        const std::vector<TargetInfo>& target_infos,
+                        const int step,
+                        const bool sort);
+
 void run_reduction(const std::vector<TargetInfo>& target_infos,
                    const QueryMemoryDescriptor& query_mem_desc,
                    NumberGenerator& generator1,
@@ -1071,7 +1076,42 @@ void test_reduce(const std::vector<TargetInfo>& target_infos,
   ResultSetManager rs_manager;
   std::vector<ResultSet*> storage_set{rs1.get(), rs2.get()};
   auto result_rs = rs_manager.reduce(storage_set, Executor::UNITARY_EXECUTOR_ID);
+  check_reduced_rows(result_rs, target_infos, step, sort);
+}
+
+// Reduce num_result_sets storages with every other entry filled.
+void test_reduce_many(const std::vector<TargetInfo>& target_infos,
+                      const QueryMemoryDescriptor& query_mem_desc,
+                      const size_t num_result_sets) {
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>(
+      g_data_provider.get(), Executor::getArenaBlockSize());
+  row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
+  std::vector<std::unique_ptr<ResultSet>> result_sets;
+  std::vector<ResultSet*> storage_set;
+  for (size_t i = 0; i < num_result_sets; ++i) {
+    result_sets.push_back(std::make_unique<ResultSet>(target_infos,
+                                                      ExecutorDeviceType::CPU,
+                                                      query_mem_desc,
+                                                      row_set_mem_owner,
+                                                      nullptr,
+                                                      nullptr,
+                                                      0,
+                                                      0));
+    const auto storage = result_sets.back()->allocateStorage();
+    EvenNumberGenerator generator;
+    fill_storage_buffer(
+        storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, 2);
+    storage_set.push_back(result_sets.back().get());
+  }
+  ResultSetManager rs_manager;
+  auto result_rs = rs_manager.reduce(storage_set, Executor::UNITARY_EXECUTOR_ID);
+  check_reduced_rows(result_rs, target_infos, num_result_sets, false);
+}
 
+void check_reduced_rows(ResultSet* result_rs,
+                        const std::vector<TargetInfo>& target_infos,
+                        const int step,
+                        const bool sort) {
   if (sort) {
     std::list<Analyzer::OrderEntry> order_entries;
     order_entries.emplace_back(1, false, false);
@@ -1857,6 +1897,41 @@ TEST(Reduce, BaselineHashColumnar) {
   test_reduce(target_infos, query_mem_desc, generator1, generator2, 1, true);
 }
 
+TEST(ReduceMany, PerfectHashOneCol) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  for (size_t num_result_sets : {3, 4, 7}) {
+    test_reduce_many(target_infos, query_mem_desc, num_result_sets);
+  }
+}
+
+TEST(ReduceMany, PerfectHashOneColColumnar) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  query_mem_desc.setOutputColumnar(true);
+  test_reduce_many(target_infos, query_mem_desc, 5);
+}
+
+TEST(ReduceMany, PerfectHashTwoCol) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = perfect_hash_two_col_desc(target_infos, 8);
+  test_reduce_many(target_infos, query_mem_desc, 6);
+}
+
+TEST(ReduceMany, PerfectHashOneColLarge) {
+  // Large enough to be reduced by output ranges.
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 199999);
+  test_reduce_many(target_infos, query_mem_desc, 3);
+}
+
+TEST(ReduceMany, PerfectHashOneColColumnarLarge) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 199999);
+  query_mem_desc.setOutputColumnar(true);
+  test_reduce_many(target_infos, query_mem_desc, 3);
+}
+
 #ifndef HAVE_TSAN
 // The large buffers tests allocate too much memory to instrument under TSAN
 TEST(ReduceLargeBuffers, PerfectHashOne_Overflow32) {
@@ -2158,6 +2233,236 @@ TEST(MoreReduce, OffsetRewrite) {
   }
 }
 
+TEST(MoreReduce, BaselineHashRadixPartitionedProbe) {
+  std::vector<TargetInfo> target_infos;
+  SQLTypeInfo bigint_ti(kBIGINT, false);
+  SQLTypeInfo null_ti(kNULLT, false);
+  target_infos.push_back(TargetInfo{false, kMIN, bigint_ti, null_ti, true, false});
+  target_infos.push_back(TargetInfo{true, kCOUNT, bigint_ti, null_ti, true, false});
+  auto query_mem_desc = baseline_hash_two_col_desc_large(target_infos, 8);
+  query_mem_desc.setRadixPartitionCount(4);
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>(
+      g_data_provider.get(), Executor::getArenaBlockSize());
+  const auto rs1 = std::make_unique<ResultSet>(target_infos,
+                                               ExecutorDeviceType::CPU,
+                                               query_mem_desc,
+                                               row_set_mem_owner,
+                                               nullptr,
+                                               nullptr,
+                                               0,
+                                               0);
+  const auto storage1 = rs1->allocateStorage();
+  const auto rs2 = std::make_unique<ResultSet>(target_infos,
+                                               ExecutorDeviceType::CPU,
+                                               query_mem_desc,
+                                               row_set_mem_owner,
+                                               nullptr,
+                                               nullptr,
+                                               0,
+                                               0);
+  const auto storage2 = rs2->allocateStorage();
+  // Keys 0, 2, ..., 38 in the first result and 0, 2, ..., 18 in the second one.
+  EvenNumberGenerator generator1;
+  fill_storage_buffer(
+      storage1->getUnderlyingBuffer(), target_infos, query_mem_desc, generator1, 1);
+  EvenNumberGenerator generator2;
+  fill_storage_buffer(
+      storage2->getUnderlyingBuffer(), target_infos, query_mem_desc, generator2, 2);
+  ResultSetManager rs_manager;
+  std::vector<ResultSet*> storage_set{rs1.get(), rs2.get()};
+  auto result_rs = rs_manager.reduce(storage_set, Executor::UNITARY_EXECUTOR_ID);
+  // The reduced table is probed by the regular baseline hash, so reducing the
+  // second result once again must find all of its groups.
+  ResultSetReductionJIT reduction_jit(result_rs->getQueryMemDesc(),
+                                      result_rs->getTargetInfos(),
+                                      result_rs->getTargetInitVals(),
+                                      Executor::UNITARY_EXECUTOR_ID);
+  const auto reduction_code = reduction_jit.codegen();
+  result_rs->getStorage()->reduce(
+      *storage2, {}, reduction_code, Executor::UNITARY_EXECUTOR_ID);
+  const auto result = get_rows_sorted_by_col(*result_rs, 0);
+  ASSERT_EQ(size_t(20), result.size());
+  for (size_t i = 0; i < result.size(); ++i) {
+    const int64_t key = 2 * i;
+    ASSERT_EQ(key, v<int64_t>(result[i][0]));
+    ASSERT_EQ(key < 20 ? 3 * key : key, v<int64_t>(result[i][1]));
+  }
+}
+
+TEST(MoreReduce, BaselineHashRadixPartitionedLayout) {
+  std::vector<TargetInfo> target_infos;
+  SQLTypeInfo bigint_ti(kBIGINT, false);
+  SQLTypeInfo null_ti(kNULLT, false);
+  target_infos.push_back(TargetInfo{false, kMIN, bigint_ti, null_ti, true, false});
+  target_infos.push_back(TargetInfo{true, kCOUNT, bigint_ti, null_ti, true, false});
+  auto query_mem_desc = baseline_hash_two_col_desc_large(target_infos, 8);
+  query_mem_desc.setEntryCount(256);
+  query_mem_desc.setRadixPartitionCount(4);
+  query_mem_desc.setRadixPartitionedLayout(true);
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>(
+      g_data_provider.get(), Executor::getArenaBlockSize());
+  const auto rs1 = std::make_unique<ResultSet>(target_infos,
+                                               ExecutorDeviceType::CPU,
+                                               query_mem_desc,
+                                               row_set_mem_owner,
+                                               nullptr,
+                                               nullptr,
+                                               0,
+                                               0);
+  const auto storage1 = rs1->allocateStorage();
+  const auto rs2 = std::make_unique<ResultSet>(target_infos,
+                                               ExecutorDeviceType::CPU,
+                                               query_mem_desc,
+                                               row_set_mem_owner,
+                                               nullptr,
+                                               nullptr,
+                                               0,
+                                               0);
+  const auto storage2 = rs2->allocateStorage();
+  // Keys 0, 2, ..., 126 in the first result and 0, 2, ..., 62 in the second one.
+  EvenNumberGenerator generator1;
+  fill_storage_buffer(
+      storage1->getUnderlyingBuffer(), target_infos, query_mem_desc, generator1, 4);
+  EvenNumberGenerator generator2;
+  fill_storage_buffer(
+      storage2->getUnderlyingBuffer(), target_infos, query_mem_desc, generator2, 8);
+  // Every group must be stored inside the entry range of its partition, the same
+  // one in both results.
+  const auto partition_entry_count = query_mem_desc.getEntryCount() / 4;
+  const auto row_size_quad = query_mem_desc.getRowSize() / sizeof(int64_t);
+  for (int64_t val = 0; val < 64; val += 2) {
+    std::vector<int64_t> key(2, val);
+    const auto buff1 = reinterpret_cast<int64_t*>(storage1->getUnderlyingBuffer());
+    const auto buff2 = reinterpret_cast<int64_t*>(storage2->getUnderlyingBuffer());
+    const auto slots1 = get_group_value_radix_partitioned(
+        buff1, query_mem_desc.getEntryCount(), &key[0], 2, 8, row_size_quad, 2);
+    const auto slots2 = get_group_value_radix_partitioned(
+        buff2, query_mem_desc.getEntryCount(), &key[0], 2, 8, row_size_quad, 2);
+    ASSERT_TRUE(slots1 && slots2);
+    const size_t entry1 = (slots1 - buff1) / row_size_quad;
+    const size_t entry2 = (slots2 - buff2) / row_size_quad;
+    ASSERT_EQ(entry1 / partition_entry_count, entry2 / partition_entry_count);
+    ASSERT_EQ(val, buff1[entry1 * row_size_quad]);
+  }
+  ResultSetManager rs_manager;
+  std::vector<ResultSet*> storage_set{rs1.get(), rs2.get()};
+  auto result_rs = rs_manager.reduce(storage_set, Executor::UNITARY_EXECUTOR_ID);
+  ASSERT_FALSE(result_rs->getQueryMemDesc().hasRadixPartitionedLayout());
+  const auto result = get_rows_sorted_by_col(*result_rs, 0);
+  ASSERT_EQ(size_t(64), result.size());
+  for (size_t i = 0; i < result.size(); ++i) {
+    const int64_t key = 2 * i;
+    ASSERT_EQ(key, v<int64_t>(result[i][0]));
+    ASSERT_EQ(key < 64 ? 2 * key : key, v<int64_t>(result[i][1]));
+  }
+}
+
+TEST(MoreReduce, BaselineHashSpilledRadixPartitions) {
+  std::vector<TargetInfo> target_infos;
+  SQLTypeInfo bigint_ti(kBIGINT, false);
+  SQLTypeInfo null_ti(kNULLT, false);
+  target_infos.push_back(TargetInfo{false, kMIN, bigint_ti, null_ti, true, false});
+  target_infos.push_back(TargetInfo{true, kCOUNT, bigint_ti, null_ti, true, false});
+  auto query_mem_desc = baseline_hash_two_col_desc_large(target_infos, 8);
+  query_mem_desc.setRadixPartitionCount(4);
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>(
+      g_data_provider.get(), Executor::getArenaBlockSize());
+  const auto rs1 = std::make_unique<ResultSet>(target_infos,
+                                               ExecutorDeviceType::CPU,
+                                               query_mem_desc,
+                                               row_set_mem_owner,
+                                               nullptr,
+                                               nullptr,
+                                               0,
+                                               0);
+  const auto storage1 = rs1->allocateStorage();
+  const auto rs2 = std::make_unique<ResultSet>(target_infos,
+                                               ExecutorDeviceType::CPU,
+                                               query_mem_desc,
+                                               row_set_mem_owner,
+                                               nullptr,
+                                               nullptr,
+                                               0,
+                                               0);
+  const auto storage2 = rs2->allocateStorage();
+  // Keys 0, 2, ..., 38 in the first result and 0, 2, ..., 18 in the spilled one.
+  EvenNumberGenerator generator1;
+  fill_storage_buffer(
+      storage1->getUnderlyingBuffer(), target_infos, query_mem_desc, generator1, 1);
+  EvenNumberGenerator generator2;
+  fill_storage_buffer(
+      storage2->getUnderlyingBuffer(), target_infos, query_mem_desc, generator2, 2);
+  SpillManager spill_manager("", 1 << 20);
+  const auto row_bytes = get_row_bytes(query_mem_desc);
+  SpilledRadixPartitions spilled_partitions(spill_manager, 4, row_bytes);
+  storage2->spillRadixPartitions(spilled_partitions);
+
+  ResultSetReductionJIT reduction_jit(rs1->getQueryMemDesc(),
+                                      rs1->getTargetInfos(),
+                                      rs1->getTargetInitVals(),
+                                      Executor::UNITARY_EXECUTOR_ID);
+  const auto reduction_code = reduction_jit.codegen();
+  std::vector<const ResultSetStorage*> storages{storage1};
+  const auto partitions =
+      ResultSetStorage::radixPartitionEntries(storages, 4, &spilled_partitions);
+  SpilledRadixPartitions reduced_partitions(spill_manager, 4, row_bytes);
+  storage1->spillReducedRadixPartitions(storages,
+                                        partitions,
+                                        reduction_code,
+                                        Executor::UNITARY_EXECUTOR_ID,
+                                        &spilled_partitions,
+                                        reduced_partitions);
+  size_t group_count = 0;
+  for (size_t partition = 0; partition < 4; ++partition) {
+    group_count += reduced_partitions.getRowCount(partition);
+  }
+  ASSERT_EQ(size_t(20), group_count);
+
+  auto output_query_mem_desc = query_mem_desc;
+  output_query_mem_desc.setEntryCount(group_count + group_count / 2 + 1);
+  const auto result_rs = std::make_unique<ResultSet>(target_infos,
+                                                     ExecutorDeviceType::CPU,
+                                                     output_query_mem_desc,
+                                                     row_set_mem_owner,
+                                                     nullptr,
+                                                     nullptr,
+                                                     0,
+                                                     0);
+  const auto result_storage = result_rs->allocateStorage(rs1->getTargetInitVals());
+  result_rs->initializeStorage();
+  result_storage->reduceSpilledRadixPartitions(
+      reduced_partitions, reduction_code, Executor::UNITARY_EXECUTOR_ID);
+  const auto result = get_rows_sorted_by_col(*result_rs, 0);
+  ASSERT_EQ(size_t(20), result.size());
+  for (size_t i = 0; i < result.size(); ++i) {
+    const int64_t key = 2 * i;
+    ASSERT_EQ(key, v<int64_t>(result[i][0]));
+    ASSERT_EQ(key < 20 ? 2 * key : key, v<int64_t>(result[i][1]));
+  }
+}
+
+TEST(MoreReduce, ReleasableGroupByBuffers) {
+  RowSetMemoryOwner row_set_mem_owner(g_data_provider.get(),
+                                      Executor::getArenaBlockSize());
+  std::vector<std::pair<size_t, bool>> reserved;
+  row_set_mem_owner.setReleasableGroupByBuffers(
+      true, [&reserved](size_t num_bytes, bool failed) {
+        reserved.emplace_back(num_bytes, failed);
+      });
+  auto buffer1 = row_set_mem_owner.allocateGroupByBuffer(1024);
+  auto buffer2 = row_set_mem_owner.allocateGroupByBuffer(2048);
+  ASSERT_EQ(reserved,
+            (std::vector<std::pair<size_t, bool>>{{1024, false}, {2048, false}}));
+
+  // Storage may start past an index buffer.
+  ASSERT_EQ(row_set_mem_owner.releaseGroupByBuffer(buffer2 + 512), (size_t)2048);
+  ASSERT_EQ(row_set_mem_owner.releaseGroupByBuffer(buffer1), (size_t)1024);
+
+  row_set_mem_owner.setReleasableGroupByBuffers(false);
+  row_set_mem_owner.allocateGroupByBuffer(1024);
+  ASSERT_EQ(reserved.size(), (size_t)2);
+}
+
 /* FLOW #1: Perfect_Hash_Row_Based testcases */
 TEST(ReduceRandomGroups, PerfectHashOneCol_Small_2525) {
   const auto target_infos = generate_random_groups_target_infos();
@@ -2370,6 +2675,42 @@ TEST(ReduceRandomGroups, BaselineHash_Large_0075) {
       target_infos, query_mem_desc, gen1, gen2, prct1, prct2, silent);
 }
 
+TEST(ReduceRandomGroups, BaselineHashRadixPartitioned_Large_5050) {
+  const auto target_infos = generate_random_groups_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc_large(target_infos, 8);
+  query_mem_desc.setRadixPartitionCount(4);
+  EvenNumberGenerator gen1;
+  EvenNumberGenerator gen2;
+  const int prct1 = 50, prct2 = 50;
+  bool silent = true;
+  test_reduce_random_groups(
+      target_infos, query_mem_desc, gen1, gen2, prct1, prct2, silent);
+}
+
+TEST(ReduceRandomGroups, BaselineHashRadixPartitioned_Large_1020) {
+  const auto target_infos = generate_random_groups_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc_large(target_infos, 8);
+  query_mem_desc.setRadixPartitionCount(16);
+  EvenNumberGenerator gen1;
+  EvenNumberGenerator gen2;
+  const int prct1 = 10, prct2 = 20;
+  bool silent = true;
+  test_reduce_random_groups(
+      target_infos, query_mem_desc, gen1, gen2, prct1, prct2, silent);
+}
+
+TEST(ReduceRandomGroups, BaselineHashRadixPartitioned_Large_100100) {
+  const auto target_infos = generate_random_groups_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc_large(target_infos, 8);
+  query_mem_desc.setRadixPartitionCount(2);
+  EvenNumberGenerator gen1;
+  EvenNumberGenerator gen2;
+  const int prct1 = 100, prct2 = 100;
+  bool silent = true;
+  test_reduce_random_groups(
+      target_infos, query_mem_desc, gen1, gen2, prct1, prct2, silent);
+}
+
 /*  FLOW #3: Perfect_Hash_Column_Based testcases */
 TEST(ReduceRandomGroups, PerfectHashOneColColumnar_Small_5050) {
   const auto target_infos = generate_random_groups_target_infos();
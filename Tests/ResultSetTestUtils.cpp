@@ -419,12 +419,22 @@ void fill_storage_buffer_baseline_rowwise(int8_t* buff,
   for (size_t i = 0; i < query_mem_desc.getEntryCount(); i += step) {
     const auto v = generator.getNextValue();
     std::vector<int64_t> key(key_component_count, v);
-    auto value_slots = get_group_value(i64_buff,
-                                       query_mem_desc.getEntryCount(),
-                                       &key[0],
-                                       key.size(),
-                                       sizeof(int64_t),
-                                       key_component_count + target_slot_count);
+    auto value_slots =
+        query_mem_desc.hasRadixPartitionedLayout()
+            ? get_group_value_radix_partitioned(
+                  i64_buff,
+                  query_mem_desc.getEntryCount(),
+                  &key[0],
+                  key.size(),
+                  sizeof(int64_t),
+                  key_component_count + target_slot_count,
+                  __builtin_ctzll(query_mem_desc.getRadixPartitionCount()))
+            : get_group_value(i64_buff,
+                              query_mem_desc.getEntryCount(),
+                              &key[0],
+                              key.size(),
+                              sizeof(int64_t),
+                              key_component_count + target_slot_count);
     CHECK(value_slots);
     fill_one_entry_baseline(value_slots, v, target_infos);
   }
@@ -0,0 +1,103 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/SpillManager.h"
+#include "TestHelpers.h"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <thread>
+#include <vector>
+
+TEST(SpillManager, WriteRead) {
+  SpillManager manager("", 1 << 20);
+  auto file = manager.createFile();
+  std::vector<int64_t> data(1000);
+  std::iota(data.begin(), data.end(), 0);
+  EXPECT_EQ(file->append(data.data(), 500 * sizeof(int64_t)), (size_t)0);
+  EXPECT_EQ(file->append(data.data() + 500, 500 * sizeof(int64_t)),
+            500 * sizeof(int64_t));
+  EXPECT_EQ(file->size(), data.size() * sizeof(int64_t));
+
+  std::vector<int64_t> res(100);
+  file->read(450 * sizeof(int64_t), res.data(), res.size() * sizeof(int64_t));
+  for (size_t i = 0; i < res.size(); ++i) {
+    EXPECT_EQ(res[i], (int64_t)(450 + i));
+  }
+}
+
+TEST(SpillManager, Budget) {
+  SpillManager manager("", 1000);
+  {
+    auto file1 = manager.createFile();
+    auto file2 = manager.createFile();
+    std::vector<int8_t> data(400);
+    file1->append(data.data(), data.size());
+    file2->append(data.data(), data.size());
+    EXPECT_EQ(manager.getUsedBytes(), (size_t)800);
+    EXPECT_THROW(file1->append(data.data(), data.size()), SpillBudgetExceeded);
+    // Failed append doesn't change the file.
+    EXPECT_EQ(file1->size(), (size_t)400);
+    EXPECT_EQ(manager.getUsedBytes(), (size_t)800);
+  }
+  // Space is released on close.
+  EXPECT_EQ(manager.getUsedBytes(), (size_t)0);
+}
+
+TEST(SpillManager, ConcurrentAppends) {
+  constexpr size_t kThreads = 4;
+  constexpr size_t kAppends = 100;
+  constexpr size_t kBlockSize = 64;
+  SpillManager manager("", 1 << 20);
+  auto file = manager.createFile();
+  std::vector<std::vector<size_t>> offsets(kThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&file, &offsets, t]() {
+      std::vector<int8_t> block(kBlockSize, static_cast<int8_t>(t));
+      for (size_t i = 0; i < kAppends; ++i) {
+        offsets[t].push_back(file->append(block.data(), block.size()));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(file->size(), kThreads * kAppends * kBlockSize);
+
+  // Every block is written contiguously at its offset.
+  std::vector<int8_t> block(kBlockSize);
+  for (size_t t = 0; t < kThreads; ++t) {
+    for (auto offset : offsets[t]) {
+      file->read(offset, block.data(), block.size());
+      for (auto val : block) {
+        ASSERT_EQ(val, static_cast<int8_t>(t));
+      }
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
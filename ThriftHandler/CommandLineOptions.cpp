@@ -401,6 +401,29 @@ void CommandLineOptions::fillOptions() {
                               ->implicit_value(true),
                           "Enable additional tiers of CPU memory (PMEM, etc...)");
   help_desc.add_options()("pmem-size", po::value<size_t>(&g_pmem_size)->default_value(0));
+  help_desc.add_options()(
+      "buffer-eviction-policy",
+      po::value<std::string>(&g_buffer_eviction_policy)
+          ->default_value(g_buffer_eviction_policy),
+      "Eviction policy for CPU and GPU buffer pools: lru or lru2 (scan resistant).");
+  help_desc.add_options()(
+      "cpu-buffer-huge-pages",
+      po::value<std::string>(&g_cpu_buffer_huge_pages)
+          ->default_value(g_cpu_buffer_huge_pages),
+      "Page size backing CPU buffer pool slabs: none, thp (transparent huge pages), "
+      "2mb or 1gb (explicit huge pages, fall back to thp when not reserved).");
+  help_desc.add_options()(
+      "enable-numa-aware-buffers",
+      po::value<bool>(&g_enable_numa_aware_buffers)
+          ->default_value(g_enable_numa_aware_buffers)
+          ->implicit_value(true),
+      "Bind CPU buffer pool slabs to NUMA nodes and run CPU kernels on the node "
+      "holding their fragments.");
+  help_desc.add_options()(
+      "max-kernels-per-query",
+      po::value<size_t>(&g_max_kernels_per_query)->default_value(g_max_kernels_per_query),
+      "Max number of CPU kernels a single query runs concurrently when CPU threads are "
+      "shared by concurrent queries (0 = no limit).");
 
   help_desc.add(log_options_.get_options());
 }
@@ -533,6 +556,119 @@ void CommandLineOptions::fillAdvancedOptions() {
       "cpu-sub-task-size",
       po::value<size_t>(&g_cpu_sub_task_size)->default_value(g_cpu_sub_task_size),
       "Set CPU sub-task size in rows.");
+  developer_desc.add_options()(
+      "enable-morsel-execution",
+      po::value<bool>(&g_enable_morsel_execution)
+          ->default_value(g_enable_morsel_execution)
+          ->implicit_value(true),
+      "Process CPU sub-tasks as morsels of cpu-sub-task-size rows pulled by worker "
+      "tasks which steal morsels of other kernels of the query when idle. Requires "
+      "enable-cpu-sub-tasks.");
+  developer_desc.add_options()(
+      "enable-parallel-reduction",
+      po::value<bool>(&g_enable_parallel_reduction)
+          ->default_value(g_enable_parallel_reduction)
+          ->implicit_value(true),
+      "Reduce results of more than two kernels in parallel: by a pairwise tree for "
+      "small outputs and by output ranges for large ones.");
+  developer_desc.add_options()(
+      "enable-radix-partitioned-group-by",
+      po::value<bool>(&g_enable_radix_partitioned_group_by)
+          ->default_value(g_enable_radix_partitioned_group_by)
+          ->implicit_value(true),
+      "Reduce high-cardinality baseline hash group by results on CPU by radix "
+      "partitioning their keys and aggregating each partition independently.");
+  developer_desc.add_options()(
+      "radix-partitioned-group-by-threshold",
+      po::value<size_t>(&g_radix_partitioned_group_by_threshold)
+          ->default_value(g_radix_partitioned_group_by_threshold),
+      "Min estimated number of groups to use radix-partitioned group by reduction.");
+  developer_desc.add_options()(
+      "enable-spill",
+      po::value<bool>(&g_enable_spill)
+          ->default_value(g_enable_spill)
+          ->implicit_value(true),
+      "Spill results of high-cardinality group by queries on CPU to disk by radix "
+      "partition when they don't fit in memory.");
+  developer_desc.add_options()(
+      "spill-dir",
+      po::value<std::string>(&g_spill_dir)->default_value(g_spill_dir),
+      "Directory for spill files. The system temporary directory is used by default.");
+  developer_desc.add_options()(
+      "spill-max-bytes",
+      po::value<size_t>(&g_spill_max_bytes)->default_value(g_spill_max_bytes),
+      "Max total size of spill files. Queries exceeding it fail as out of memory.");
+  developer_desc.add_options()(
+      "spill-memory-threshold",
+      po::value<size_t>(&g_spill_memory_threshold)
+          ->default_value(g_spill_memory_threshold),
+      "Size of group by results held in memory by a query before further results are "
+      "spilled. Zero means half of the system memory.");
+  developer_desc.add_options()(
+      "enable-vectorized-interpreter",
+      po::value<bool>(&g_enable_vectorized_interpreter)
+          ->default_value(g_enable_vectorized_interpreter)
+          ->implicit_value(true),
+      "Execute simple queries over small tables with the vectorized interpreter "
+      "instead of the code generation.");
+  developer_desc.add_options()(
+      "vectorized-interpreter-max-rows",
+      po::value<size_t>(&g_vectorized_interpreter_max_rows)
+          ->default_value(g_vectorized_interpreter_max_rows),
+      "Max number of input rows for queries executed with the vectorized interpreter.");
+  developer_desc.add_options()(
+      "enable-tiered-compilation",
+      po::value<bool>(&g_enable_tiered_compilation)
+          ->default_value(g_enable_tiered_compilation)
+          ->implicit_value(true),
+      "Execute new CPU queries with quickly compiled code and replace it in the code "
+      "cache with fully optimized code compiled in background.");
+  developer_desc.add_options()(
+      "background-compilation-threads",
+      po::value<size_t>(&g_background_compilation_threads)
+          ->default_value(g_background_compilation_threads),
+      "Number of threads compiling optimized code for tiered compilation.");
+  developer_desc.add_options()(
+      "enable-persistent-code-cache",
+      po::value<bool>(&g_enable_persistent_code_cache)
+          ->default_value(g_enable_persistent_code_cache)
+          ->implicit_value(true),
+      "Store compiled CPU code on disk and reuse it after server restarts.");
+  developer_desc.add_options()(
+      "persistent-code-cache-dir",
+      po::value<std::string>(&g_persistent_code_cache_dir)
+          ->default_value(g_persistent_code_cache_dir),
+      "Directory of the persistent code cache, a temporary directory by default.");
+  developer_desc.add_options()(
+      "persistent-code-cache-max-bytes",
+      po::value<size_t>(&g_persistent_code_cache_max_bytes)
+          ->default_value(g_persistent_code_cache_max_bytes),
+      "Size limit of the persistent code cache, least recently used code is removed "
+      "when it is exceeded.");
+  developer_desc.add_options()(
+      "enable-plan-code-cache",
+      po::value<bool>(&g_enable_plan_code_cache)
+          ->default_value(g_enable_plan_code_cache)
+          ->implicit_value(true),
+      "Look up compiled CPU code by the fingerprint of the execution unit and skip "
+      "the code generation for identical execution units.");
+  developer_desc.add_options()(
+      "enable-chunk-prefetch",
+      po::value<bool>(&g_enable_chunk_prefetch)
+          ->default_value(g_enable_chunk_prefetch)
+          ->implicit_value(true),
+      "Load chunks required by pending execution kernels into the CPU buffer pool in "
+      "background while earlier kernels run.");
+  developer_desc.add_options()(
+      "chunk-prefetch-kernels",
+      po::value<size_t>(&g_chunk_prefetch_kernels)
+          ->default_value(g_chunk_prefetch_kernels),
+      "Max number of kernels to prefetch chunks for ahead of the running ones.");
+  developer_desc.add_options()(
+      "chunk-prefetch-max-bytes",
+      po::value<size_t>(&g_chunk_prefetch_max_bytes)
+          ->default_value(g_chunk_prefetch_max_bytes),
+      "Max total size of pinned prefetched chunks, 0 means 1/16 of the buffer pool.");
   developer_desc.add_options()(
       "skip-intermediate-count",
       po::value<bool>(&g_skip_intermediate_count)
@@ -546,6 +682,47 @@ void CommandLineOptions::fillAdvancedOptions() {
           ->implicit_value(true),
       "Remove quals from the filtered count if they are covered by a "
       "join condition (currently only ST_Contains).");
+  developer_desc.add_options()(
+      "enable-radix-partitioned-join-build",
+      po::value<bool>(&g_enable_radix_partitioned_join_build)
+          ->default_value(g_enable_radix_partitioned_join_build)
+          ->implicit_value(true),
+      "Fill CPU keyed join hash tables larger than radix-join-partition-bytes by "
+      "cache sized partitions.");
+  developer_desc.add_options()(
+      "radix-join-partition-bytes",
+      po::value<size_t>(&g_radix_join_partition_bytes)
+          ->default_value(g_radix_join_partition_bytes),
+      "Size of a partition of a radix partitioned join hash table build.");
+  developer_desc.add_options()(
+      "enable-join-key-filter",
+      po::value<bool>(&g_enable_join_key_filter)
+          ->default_value(g_enable_join_key_filter)
+          ->implicit_value(true),
+      "Skip outer table fragments without matches in the keys of inner join hash "
+      "tables.");
+  developer_desc.add_options()(
+      "enable-range-join",
+      po::value<bool>(&g_enable_range_join)
+          ->default_value(g_enable_range_join)
+          ->implicit_value(true),
+      "Use sorted range hash tables for joins on inequalities instead of loop "
+      "joins (CPU only).");
+  developer_desc.add_options()(
+      "enable-sorted-index-join",
+      po::value<bool>(&g_enable_sorted_index_join)
+          ->default_value(g_enable_sorted_index_join)
+          ->implicit_value(true),
+      "Probe inner columns ordered across fragments by a binary search over the "
+      "materialized sorted column instead of a keyed hash table when a perfect hash "
+      "table cannot be built (CPU only).");
+  developer_desc.add_options()(
+      "enable-partitioned-one-to-many-build",
+      po::value<bool>(&g_enable_partitioned_one_to_many_build)
+          ->default_value(g_enable_partitioned_one_to_many_build)
+          ->implicit_value(true),
+      "Build CPU one-to-many perfect hash tables by per thread histograms and "
+      "partitions of the hash slots instead of atomic counters.");
 
   developer_desc.add_options()(
       "min-cpu-slab-size",
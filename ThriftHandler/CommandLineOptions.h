@@ -145,6 +145,12 @@ extern size_t g_filter_push_down_passing_row_ubound;
 extern bool g_enable_columnar_output;
 extern bool g_optimize_row_initialization;
 extern bool g_strip_join_covered_quals;
+extern bool g_enable_radix_partitioned_join_build;
+extern size_t g_radix_join_partition_bytes;
+extern bool g_enable_join_key_filter;
+extern bool g_enable_range_join;
+extern bool g_enable_sorted_index_join;
+extern bool g_enable_partitioned_one_to_many_build;
 extern size_t g_constrained_by_in_threshold;
 extern size_t g_big_group_threshold;
 extern bool g_enable_window_functions;
@@ -174,6 +180,25 @@ extern bool g_enable_experimental_string_functions;
 extern bool g_enable_interop;
 extern bool g_enable_union;
 extern bool g_enable_cpu_sub_tasks;
+extern bool g_enable_morsel_execution;
+extern bool g_enable_parallel_reduction;
+extern bool g_enable_radix_partitioned_group_by;
+extern size_t g_radix_partitioned_group_by_threshold;
+extern bool g_enable_spill;
+extern std::string g_spill_dir;
+extern size_t g_spill_max_bytes;
+extern size_t g_spill_memory_threshold;
+extern bool g_enable_vectorized_interpreter;
+extern size_t g_vectorized_interpreter_max_rows;
+extern bool g_enable_tiered_compilation;
+extern size_t g_background_compilation_threads;
+extern bool g_enable_persistent_code_cache;
+extern std::string g_persistent_code_cache_dir;
+extern size_t g_persistent_code_cache_max_bytes;
+extern bool g_enable_plan_code_cache;
+extern bool g_enable_chunk_prefetch;
+extern size_t g_chunk_prefetch_kernels;
+extern size_t g_chunk_prefetch_max_bytes;
 extern size_t g_cpu_sub_task_size;
 extern bool g_enable_filter_function;
 extern bool g_enable_automatic_ir_metadata;
@@ -181,6 +206,10 @@ extern size_t g_enable_parallel_linearization;
 extern size_t g_max_log_length;
 extern bool g_enable_tiered_cpu_mem;
 extern size_t g_pmem_size;
+extern std::string g_buffer_eviction_policy;
+extern std::string g_cpu_buffer_huge_pages;
+extern bool g_enable_numa_aware_buffers;
+extern size_t g_max_kernels_per_query;
 extern bool g_enable_data_recycler;
 extern bool g_use_hashtable_cache;
 extern size_t g_hashtable_cache_total_bytes;